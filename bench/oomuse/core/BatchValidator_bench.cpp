@@ -0,0 +1,147 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/BatchValidator.h"
+
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "oomuse/core/FixedArray.h"
+#include "oomuse/core/Validator.h"
+#include "oomuse/core/ValidatorExpressions.h"
+#include "oomuse/core/Validators.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::BatchValidationResult;
+using oomuse::BatchValidator;
+using oomuse::FixedArray;
+using oomuse::Validator;
+using oomuse::Validators;
+using std::string;
+using std::unique_ptr;
+
+namespace v = oomuse::validation;
+
+namespace {
+
+
+const std::size_t NUM_SAMPLES = 1 << 20;  // 4 MB of floats.
+
+
+/** Audio samples, all within [-1, 1]. */
+FixedArray<float> makeSamples() {
+  FixedArray<float> samples(NUM_SAMPLES);
+  for (std::size_t i = 0; i < samples.length(); ++i) {
+    samples[i] = static_cast<float>(i % 2001) / 1000.0f - 1.0f;
+  }
+  return samples;
+}
+
+
+unique_ptr<Validator<float>> makeSampleValidator() {
+  return Validators<float>::allOf(Validators<float>::greaterOrEqual(-1.0f),
+                                  Validators<float>::lessOrEqual(1.0f));
+}
+
+
+void setBytesProcessed(benchmark::State& state) {
+  state.SetBytesProcessed(static_cast<int64>(state.iterations())
+                          * static_cast<int64>(NUM_SAMPLES * sizeof(float)));
+}
+
+
+void BM_samples_perValue_checkValidationErrors(benchmark::State& state) {
+  FixedArray<float> samples = makeSamples();
+  auto isSample = makeSampleValidator();
+  for (auto _ : state) {
+    std::size_t numFailures = 0;
+    for (float sample : samples) {
+      numFailures += isSample->checkValidationErrors(sample).empty() ? 0 : 1;
+    }
+    benchmark::DoNotOptimize(numFailures);
+  }
+  setBytesProcessed(state);
+}
+
+
+void BM_samples_perValue_isValid(benchmark::State& state) {
+  FixedArray<float> samples = makeSamples();
+  auto isSample = makeSampleValidator();
+  for (auto _ : state) {
+    std::size_t numFailures = 0;
+    for (float sample : samples) {
+      numFailures += isSample->isValid(sample) ? 0 : 1;
+    }
+    benchmark::DoNotOptimize(numFailures);
+  }
+  setBytesProcessed(state);
+}
+
+
+/** Batch validation with range(0) threads (at most). */
+void BM_samples_batch(benchmark::State& state) {
+  FixedArray<float> samples = makeSamples();
+  auto isSample = makeSampleValidator();
+  BatchValidator<float> batchValidator(
+      *isSample, static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    BatchValidationResult result = batchValidator.validate(samples);
+    benchmark::DoNotOptimize(result.numFailures());
+  }
+  setBytesProcessed(state);
+}
+
+
+/** Same, with a compile-time expression instead of allOf(). */
+void BM_samples_batch_expression(benchmark::State& state) {
+  FixedArray<float> samples = makeSamples();
+  auto isSample = v::toValidator<float>(
+      v::greaterOrEqual(-1.0f) && v::lessOrEqual(1.0f));
+  BatchValidator<float> batchValidator(*isSample);
+  for (auto _ : state) {
+    BatchValidationResult result = batchValidator.validate(samples);
+    benchmark::DoNotOptimize(result.numFailures());
+  }
+  setBytesProcessed(state);
+}
+
+
+/** Batch validation of MIDI values (as int32), to compare with floats. */
+void BM_midiValues_batch(benchmark::State& state) {
+  FixedArray<int32> values(NUM_SAMPLES);
+  for (std::size_t i = 0; i < values.length(); ++i) {
+    values[i] = static_cast<int32>(i % 128);
+  }
+  auto isMidiValue = Validators<int32>::allOf(
+      Validators<int32>::greaterOrEqual(0), Validators<int32>::less(128));
+  BatchValidator<int32> batchValidator(*isMidiValue);
+  for (auto _ : state) {
+    BatchValidationResult result = batchValidator.validate(values);
+    benchmark::DoNotOptimize(result.numFailures());
+  }
+  setBytesProcessed(state);
+}
+
+
+BENCHMARK(BM_samples_perValue_checkValidationErrors);
+BENCHMARK(BM_samples_perValue_isValid);
+BENCHMARK(BM_samples_batch)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+BENCHMARK(BM_samples_batch_expression);
+BENCHMARK(BM_midiValues_batch);
+
+
+}  // namespace
@@ -0,0 +1,110 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/InstrumentedValidator.h"
+
+#include <cstddef>
+#include <memory>
+
+#include "benchmark/benchmark.h"
+#include "oomuse/core/FixedArray.h"
+#include "oomuse/core/Validator.h"
+#include "oomuse/core/Validators.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::FixedArray;
+using oomuse::Validator;
+using oomuse::ValidatorStatsRegistry;
+using oomuse::Validators;
+using oomuse::instrument;
+using std::unique_ptr;
+
+namespace {
+
+
+const std::size_t NUM_VALUES = 4096;
+
+
+FixedArray<int32> makeValues() {
+  FixedArray<int32> values(NUM_VALUES);
+  for (std::size_t i = 0; i < values.length(); ++i) {
+    values[i] = static_cast<int32>(i % 160);
+  }
+  return values;
+}
+
+
+unique_ptr<Validator<int32>> makeMidiValidator() {
+  return Validators<int32>::allOf(Validators<int32>::greaterOrEqual(0),
+                                  Validators<int32>::less(128));
+}
+
+
+void runIsValid(benchmark::State& state, const Validator<int32>& validator) {
+  FixedArray<int32> values = makeValues();
+  for (auto _ : state) {
+    std::size_t numFailures = 0;
+    for (int32 value : values) {
+      numFailures += validator.isValid(value) ? 0 : 1;
+    }
+    benchmark::DoNotOptimize(numFailures);
+  }
+  state.SetItemsProcessed(static_cast<int64>(state.iterations())
+                          * static_cast<int64>(NUM_VALUES));
+}
+
+
+/** Baseline: not instrumented (same as OOMUSE_CORE_NO_VALIDATOR_STATS). */
+void BM_isValid_uninstrumented(benchmark::State& state) {
+  runIsValid(state, *makeMidiValidator());
+}
+
+
+void BM_isValid_instrumented_disabled(benchmark::State& state) {
+  ValidatorStatsRegistry registry;
+  registry.setEnabled(false);
+  runIsValid(state, *instrument("midiValue", makeMidiValidator(), registry));
+}
+
+
+void BM_isValid_instrumented_enabled(benchmark::State& state) {
+  ValidatorStatsRegistry registry;
+  runIsValid(state, *instrument("midiValue", makeMidiValidator(), registry));
+}
+
+
+/** Batches only record once per markValid() call, even when enabled. */
+void BM_markValid_instrumented_enabled(benchmark::State& state) {
+  ValidatorStatsRegistry registry;
+  auto isMidiValue = instrument("midiValue", makeMidiValidator(), registry);
+  FixedArray<int32> values = makeValues();
+  FixedArray<uint64> validBits(NUM_VALUES / 64);
+  for (auto _ : state) {
+    isMidiValue->markValid(values.data(), values.length(), validBits.data());
+    benchmark::DoNotOptimize(validBits[0]);
+  }
+  state.SetItemsProcessed(static_cast<int64>(state.iterations())
+                          * static_cast<int64>(NUM_VALUES));
+}
+
+
+BENCHMARK(BM_isValid_uninstrumented);
+BENCHMARK(BM_isValid_instrumented_disabled);
+BENCHMARK(BM_isValid_instrumented_enabled);
+BENCHMARK(BM_markValid_instrumented_enabled);
+
+
+}  // namespace
@@ -0,0 +1,170 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/OptionalArray.h"
+
+#include <cstddef>
+#include <random>
+
+#include "benchmark/benchmark.h"
+#include "oomuse/core/FixedArray.h"
+#include "oomuse/core/Optional.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::FixedArray;
+using oomuse::Optional;
+using oomuse::OptionalArray;
+
+namespace {
+
+
+/** Returns whether element i should be present (~70% are, in runs). */
+bool isPresent(std::size_t i, std::minstd_rand* random) {
+  // Mix in long runs of present values, like sparse automation lanes.
+  return ((i / 256) % 4 != 3) && ((*random)() % 10 != 0);
+}
+
+
+void BM_fixedArrayOfOptional_sum(benchmark::State& state) {
+  const std::size_t length = static_cast<std::size_t>(state.range(0));
+  FixedArray<Optional<float>> optionals(length);
+  std::minstd_rand random(42);
+  for (std::size_t i = 0; i < length; ++i) {
+    if (isPresent(i, &random)) {
+      optionals[i] = static_cast<float>(i % 100);
+    }
+  }
+
+  for (auto _ : state) {
+    float sum = 0.0F;
+    for (const Optional<float>& optional : optionals) {
+      if (optional.hasValue()) {
+        sum += optional.value();
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.counters["bytesPerElement"] = sizeof(Optional<float>);
+  state.SetItemsProcessed(static_cast<int64>(state.iterations() * length));
+}
+
+
+void BM_optionalArray_sum(benchmark::State& state) {
+  const std::size_t length = static_cast<std::size_t>(state.range(0));
+  OptionalArray<float> optionals(length);
+  std::minstd_rand random(42);
+  for (std::size_t i = 0; i < length; ++i) {
+    if (isPresent(i, &random)) {
+      optionals.set(i, static_cast<float>(i % 100));
+    }
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(optionals.sum());
+  }
+  state.counters["bytesPerElement"] = sizeof(float) + 1.0 / 8.0;
+  state.SetItemsProcessed(static_cast<int64>(state.iterations() * length));
+}
+
+
+void BM_fixedArrayOfOptional_countValid(benchmark::State& state) {
+  const std::size_t length = static_cast<std::size_t>(state.range(0));
+  FixedArray<Optional<float>> optionals(length);
+  std::minstd_rand random(42);
+  for (std::size_t i = 0; i < length; ++i) {
+    if (isPresent(i, &random)) {
+      optionals[i] = 1.0F;
+    }
+  }
+
+  for (auto _ : state) {
+    std::size_t numValid = 0;
+    for (const Optional<float>& optional : optionals) {
+      numValid += optional.hasValue() ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(numValid);
+  }
+  state.SetItemsProcessed(static_cast<int64>(state.iterations() * length));
+}
+
+
+void BM_optionalArray_countValid(benchmark::State& state) {
+  const std::size_t length = static_cast<std::size_t>(state.range(0));
+  OptionalArray<float> optionals(length);
+  std::minstd_rand random(42);
+  for (std::size_t i = 0; i < length; ++i) {
+    if (isPresent(i, &random)) {
+      optionals.set(i, 1.0F);
+    }
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(optionals.countValid());
+  }
+  state.SetItemsProcessed(static_cast<int64>(state.iterations() * length));
+}
+
+
+void BM_fixedArrayOfOptional_max(benchmark::State& state) {
+  const std::size_t length = static_cast<std::size_t>(state.range(0));
+  FixedArray<Optional<int32>> optionals(length);
+  std::minstd_rand random(42);
+  for (std::size_t i = 0; i < length; ++i) {
+    if (isPresent(i, &random)) {
+      optionals[i] = static_cast<int32>(random() % 1000);
+    }
+  }
+
+  for (auto _ : state) {
+    Optional<int32> maxValue;
+    for (const Optional<int32>& optional : optionals) {
+      if (optional.hasValue()
+          && (!maxValue.hasValue() || (maxValue.value() < optional.value()))) {
+        maxValue = optional.value();
+      }
+    }
+    benchmark::DoNotOptimize(maxValue);
+  }
+  state.SetItemsProcessed(static_cast<int64>(state.iterations() * length));
+}
+
+
+void BM_optionalArray_max(benchmark::State& state) {
+  const std::size_t length = static_cast<std::size_t>(state.range(0));
+  OptionalArray<int32> optionals(length);
+  std::minstd_rand random(42);
+  for (std::size_t i = 0; i < length; ++i) {
+    if (isPresent(i, &random)) {
+      optionals.set(i, static_cast<int32>(random() % 1000));
+    }
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(optionals.max());
+  }
+  state.SetItemsProcessed(static_cast<int64>(state.iterations() * length));
+}
+
+
+BENCHMARK(BM_fixedArrayOfOptional_sum)->Range(1 << 12, 1 << 22);
+BENCHMARK(BM_optionalArray_sum)->Range(1 << 12, 1 << 22);
+BENCHMARK(BM_fixedArrayOfOptional_countValid)->Range(1 << 12, 1 << 22);
+BENCHMARK(BM_optionalArray_countValid)->Range(1 << 12, 1 << 22);
+BENCHMARK(BM_fixedArrayOfOptional_max)->Range(1 << 12, 1 << 22);
+BENCHMARK(BM_optionalArray_max)->Range(1 << 12, 1 << 22);
+
+
+}  // namespace
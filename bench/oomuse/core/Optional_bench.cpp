@@ -0,0 +1,80 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/Optional.h"
+
+#include <cstddef>
+
+#include "benchmark/benchmark.h"
+#include "oomuse/core/FixedArray.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::CompactOptional;
+using oomuse::FixedArray;
+using oomuse::Optional;
+using oomuse::SentinelOptionalPolicy;
+
+namespace {
+
+
+/** Fills every third element with a value, leaving the rest empty. */
+template<typename OptionalType>
+void fillSparse(FixedArray<OptionalType>* optionals) {
+  for (std::size_t i = 0; i < optionals->length(); i += 3) {
+    (*optionals)[i] = static_cast<typename OptionalType::value_type>(i + 1);
+  }
+}
+
+
+/** Sums the present values of a large array of optionals. */
+template<typename OptionalType>
+void BM_scanOptionals(benchmark::State& state) {
+  FixedArray<OptionalType> optionals(static_cast<std::size_t>(state.range(0)));
+  fillSparse(&optionals);
+
+  for (auto _ : state) {
+    typename OptionalType::value_type sum = 0;
+    for (const OptionalType& optional : optionals) {
+      if (optional.hasValue()) {
+        sum += optional.value();
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+
+  const double arrayBytes =
+      static_cast<double>(optionals.length() * sizeof(OptionalType));
+  state.counters["bytesPerElement"] = sizeof(OptionalType);
+  state.counters["arrayMiB"] = arrayBytes / (1024.0 * 1024.0);
+  state.SetBytesProcessed(
+      static_cast<int64>(state.iterations() * arrayBytes));
+}
+
+
+using OptionalIndex = Optional<int32, SentinelOptionalPolicy<int32, -1>>;
+
+BENCHMARK_TEMPLATE(BM_scanOptionals, Optional<float>)->Range(1 << 12, 1 << 22);
+BENCHMARK_TEMPLATE(BM_scanOptionals, CompactOptional<float>)
+    ->Range(1 << 12, 1 << 22);
+BENCHMARK_TEMPLATE(BM_scanOptionals, Optional<double>)
+    ->Range(1 << 12, 1 << 22);
+BENCHMARK_TEMPLATE(BM_scanOptionals, CompactOptional<double>)
+    ->Range(1 << 12, 1 << 22);
+BENCHMARK_TEMPLATE(BM_scanOptionals, Optional<int32>)->Range(1 << 12, 1 << 22);
+BENCHMARK_TEMPLATE(BM_scanOptionals, OptionalIndex)->Range(1 << 12, 1 << 22);
+
+
+}  // namespace
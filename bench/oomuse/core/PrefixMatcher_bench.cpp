@@ -0,0 +1,132 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/PrefixMatcher.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "oomuse/core/Optional.h"
+#include "oomuse/core/int_types.h"
+#include "oomuse/core/strings.h"
+
+using oomuse::Optional;
+using oomuse::PrefixMatcher;
+using std::string;
+
+namespace strings = oomuse::strings;
+
+namespace {
+
+
+const std::size_t NUM_ADDRESSES = 256;
+
+
+/**
+ * Route prefixes like "/synth12/osc3/", which share leading segments the way
+ * a real address space does.
+ */
+std::vector<string> makeRoutes(std::size_t numRoutes) {
+  std::vector<string> routes;
+  routes.reserve(numRoutes);
+  for (std::size_t i = 0; i < numRoutes; ++i) {
+    routes.push_back("/synth" + std::to_string(i / 16) + "/osc"
+                     + std::to_string(i % 16) + "/");
+  }
+  return routes;
+}
+
+
+/** Addresses to route, half of which match one of the given routes. */
+std::vector<string> makeAddresses(const std::vector<string>& routes) {
+  std::vector<string> addresses;
+  addresses.reserve(NUM_ADDRESSES);
+  for (std::size_t i = 0; i < NUM_ADDRESSES; ++i) {
+    const string& route = routes[(i * 7919) % routes.size()];
+    addresses.push_back((i % 2 == 0) ? route + "freq" : "/mixer" + route);
+  }
+  return addresses;
+}
+
+
+void setItemsProcessed(benchmark::State& state) {
+  state.SetItemsProcessed(static_cast<int64>(state.iterations())
+                          * static_cast<int64>(NUM_ADDRESSES));
+}
+
+
+/** Finds the longest matching route by looping over strings::startsWith(). */
+void BM_longestRoute_loopedStartsWith(benchmark::State& state) {
+  const std::vector<string> routes =
+      makeRoutes(static_cast<std::size_t>(state.range(0)));
+  const std::vector<string> addresses = makeAddresses(routes);
+
+  for (auto _ : state) {
+    for (const string& address : addresses) {
+      Optional<std::size_t> longest;
+      for (std::size_t i = 0; i < routes.size(); ++i) {
+        if (strings::startsWith(address, routes[i])
+            && (!longest.hasValue()
+                || (routes[i].size() > routes[longest.value()].size()))) {
+          longest = i;
+        }
+      }
+      benchmark::DoNotOptimize(longest);
+    }
+  }
+  setItemsProcessed(state);
+}
+
+
+/** Finds the longest matching route with PrefixMatcher::longestMatch(). */
+void BM_longestRoute_prefixMatcher(benchmark::State& state) {
+  const std::vector<string> routes =
+      makeRoutes(static_cast<std::size_t>(state.range(0)));
+  const std::vector<string> addresses = makeAddresses(routes);
+  const PrefixMatcher matcher(routes);
+
+  for (auto _ : state) {
+    for (const string& address : addresses) {
+      Optional<std::size_t> longest = matcher.longestMatch(address);
+      benchmark::DoNotOptimize(longest);
+    }
+  }
+  setItemsProcessed(state);
+}
+
+
+/** Compiles a PrefixMatcher (a one-time cost, amortized over lookups). */
+void BM_buildPrefixMatcher(benchmark::State& state) {
+  const std::vector<string> routes =
+      makeRoutes(static_cast<std::size_t>(state.range(0)));
+
+  for (auto _ : state) {
+    PrefixMatcher matcher(routes);
+    benchmark::DoNotOptimize(&matcher);
+  }
+  state.SetItemsProcessed(static_cast<int64>(state.iterations())
+                          * static_cast<int64>(routes.size()));
+}
+
+
+BENCHMARK(BM_longestRoute_loopedStartsWith)->Arg(10)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_longestRoute_prefixMatcher)->Arg(10)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_buildPrefixMatcher)->Arg(10)->Arg(1000)->Arg(100000);
+
+
+}  // namespace
@@ -0,0 +1,153 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/Result.h"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "oomuse/core/Validator.h"
+#include "oomuse/core/Validators.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::Error;
+using oomuse::Result;
+using oomuse::Validator;
+using oomuse::Validators;
+using std::string;
+using std::to_string;
+using std::unique_ptr;
+using std::vector;
+
+namespace {
+
+
+const uint32 NOT_A_NUMBER = 1;
+const uint32 OUT_OF_RANGE = 2;
+
+
+/** Returns tokens where roughly half fail to parse or fail validation. */
+vector<string> makeTokens() {
+  std::minstd_rand random(7);
+  vector<string> tokens;
+  for (int32 i = 0; i < 4096; ++i) {
+    switch (random() % 4) {
+      case 0: tokens.push_back(to_string(random() % 128)); break;
+      case 1: tokens.push_back(to_string(random() % 100)); break;
+      case 2: tokens.push_back(to_string(128 + random() % 1000)); break;
+      default: tokens.push_back("n/a"); break;
+    }
+  }
+  return tokens;
+}
+
+
+/** String-returning style: error message out, value via out-param. */
+string parseDigitsOrError(const string& token, int32* value) {
+  int32 parsed = 0;
+  for (char c : token) {
+    if ((c < '0') || (c > '9')) {
+      return "Not a number: " + token;
+    }
+    parsed = parsed * 10 + (c - '0');
+  }
+  *value = parsed;
+  return "";
+}
+
+
+void BM_stringErrors_parseAndValidate(benchmark::State& state) {
+  const vector<string> tokens = makeTokens();
+  unique_ptr<Validator<int32>> isMidiValue = Validators<int32>::allOf(
+      Validators<int32>::greaterOrEqual(0), Validators<int32>::less(128));
+
+  for (auto _ : state) {
+    int64 sum = 0;
+    int32 numErrors = 0;
+    for (const string& token : tokens) {
+      int32 value = 0;
+      string error = parseDigitsOrError(token, &value);
+      if (error.empty()) {
+        error = isMidiValue->checkValidationErrors(value);
+      }
+      if (error.empty()) {
+        sum += value;
+      } else {
+        ++numErrors;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+    benchmark::DoNotOptimize(numErrors);
+  }
+  state.SetItemsProcessed(
+      static_cast<int64>(state.iterations() * tokens.size()));
+}
+
+
+string formatOutOfRange(const Error& error) {
+  return "Out of MIDI range: " + to_string(error.context());
+}
+
+Result<int32> parseDigits(const string& token) {
+  int32 parsed = 0;
+  for (char c : token) {
+    if ((c < '0') || (c > '9')) {
+      return Result<int32>::failure(Error(NOT_A_NUMBER, "Not a number"));
+    }
+    parsed = parsed * 10 + (c - '0');
+  }
+  return Result<int32>::success(parsed);
+}
+
+Result<int32> checkMidiRange(int32 value) {
+  if ((value < 0) || (value >= 128)) {
+    return Result<int32>::failure(
+        Error(OUT_OF_RANGE, "Out of MIDI range", &formatOutOfRange, value));
+  }
+  return Result<int32>::success(value);
+}
+
+
+void BM_resultErrors_parseAndValidate(benchmark::State& state) {
+  const vector<string> tokens = makeTokens();
+
+  for (auto _ : state) {
+    int64 sum = 0;
+    int32 numErrors = 0;
+    for (const string& token : tokens) {
+      Result<int32> result = parseDigits(token).andThen(&checkMidiRange);
+      if (result.isOk()) {
+        sum += result.value();
+      } else {
+        ++numErrors;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+    benchmark::DoNotOptimize(numErrors);
+  }
+  state.SetItemsProcessed(
+      static_cast<int64>(state.iterations() * tokens.size()));
+}
+
+
+BENCHMARK(BM_stringErrors_parseAndValidate);
+BENCHMARK(BM_resultErrors_parseAndValidate);
+
+
+}  // namespace
@@ -0,0 +1,168 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/StringArena.h"
+
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "oomuse/core/StringRef.h"
+#include "oomuse/core/int_types.h"
+#include "oomuse/core/strings.h"
+
+using oomuse::StringArena;
+using oomuse::StringRef;
+using std::string;
+
+namespace strings = oomuse::strings;
+
+namespace {
+
+
+/**
+ * User-entered tags of mixed length (a third fit in std::string's small
+ * buffer), with whitespace padding and mixed case.
+ */
+std::vector<string> makeTags(std::size_t numTags) {
+  const char* const words[] = {
+      "Jazz", " Minor Key ", "  Late Romantic Piano Repertoire ",
+      "Blues\t", "Twelve-Tone Serialism ", "  Gregorian Chant"};
+  std::vector<string> tags;
+  tags.reserve(numTags);
+  for (std::size_t i = 0; i < numTags; ++i) {
+    tags.push_back(words[i % 6] + std::to_string(i));
+  }
+  return tags;
+}
+
+
+/** Reports items/s and heap allocations per iteration. */
+void setCounters(benchmark::State& state, double allocationsPerIteration,
+                 std::size_t numTags) {
+  state.counters["allocs/iter"] = allocationsPerIteration;
+  state.SetItemsProcessed(static_cast<int64>(state.iterations())
+                          * static_cast<int64>(numTags));
+}
+
+
+/**
+ * Returns how many of the given strings need heap memory of their own (i.e.
+ * don't fit in std::string's small string buffer).
+ */
+std::size_t countHeapStrings(const std::vector<string>& strs) {
+  const std::size_t smallCapacity = string().capacity();
+  std::size_t numHeapStrings = 0;
+  for (const string& str : strs) {
+    numHeapStrings += (str.length() > smallCapacity) ? 1 : 0;
+  }
+  return numHeapStrings;
+}
+
+
+/** Normalizes (trims & lowercases) tags through the per-string API. */
+void BM_normalizeTags_perString(benchmark::State& state) {
+  const std::vector<string> tags =
+      makeTags(static_cast<std::size_t>(state.range(0)));
+  std::vector<string> normalized;
+  normalized.reserve(tags.size());
+
+  for (auto _ : state) {
+    normalized.clear();
+    for (const string& tag : tags) {
+      normalized.push_back(strings::toLowerCase(strings::trimWhitespace(
+          StringRef(tag))));
+    }
+    benchmark::DoNotOptimize(normalized.data());
+  }
+  setCounters(state, static_cast<double>(countHeapStrings(normalized)),
+              tags.size());
+}
+
+
+/** Normalizes tags into a StringArena that's cleared each iteration. */
+void BM_normalizeTags_arena(benchmark::State& state) {
+  const std::vector<string> tags =
+      makeTags(static_cast<std::size_t>(state.range(0)));
+  std::vector<StringRef> normalized;
+  normalized.reserve(tags.size());
+  StringArena arena;
+
+  for (auto _ : state) {
+    arena.clear();
+    normalized.clear();
+    for (const string& tag : tags) {
+      normalized.push_back(strings::toLowerCase(
+          strings::trimWhitespace(StringRef(tag)), arena));
+    }
+    benchmark::DoNotOptimize(normalized.data());
+  }
+  // clear() keeps blocks for reuse, so only the first iteration allocates.
+  setCounters(state,
+              static_cast<double>(arena.numBlocks())
+                  / static_cast<double>(state.iterations()),
+              tags.size());
+}
+
+
+/** Lowercases tags via the per-string API. */
+void BM_lowerCaseTags_perString(benchmark::State& state) {
+  const std::vector<string> tags =
+      makeTags(static_cast<std::size_t>(state.range(0)));
+  std::vector<string> lower;
+  lower.reserve(tags.size());
+
+  for (auto _ : state) {
+    lower.clear();
+    for (const string& tag : tags) {
+      lower.push_back(strings::toLowerCase(tag));
+    }
+    benchmark::DoNotOptimize(lower.data());
+  }
+  setCounters(state, static_cast<double>(countHeapStrings(lower)),
+              tags.size());
+}
+
+
+/** Lowercases tags via the batch toLowerCaseAll(). */
+void BM_lowerCaseTags_batch(benchmark::State& state) {
+  const std::vector<string> tags =
+      makeTags(static_cast<std::size_t>(state.range(0)));
+  std::vector<StringRef> lower(tags.size());
+  StringArena arena;
+
+  for (auto _ : state) {
+    arena.clear();
+    strings::toLowerCaseAll(tags.begin(), tags.end(), arena, lower.begin());
+    benchmark::DoNotOptimize(lower.data());
+  }
+  // clear() keeps blocks for reuse, so only the first iteration allocates.
+  setCounters(state,
+              static_cast<double>(arena.numBlocks())
+                  / static_cast<double>(state.iterations()),
+              tags.size());
+}
+
+
+BENCHMARK(BM_normalizeTags_perString)->Arg(16)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_normalizeTags_arena)->Arg(16)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_lowerCaseTags_perString)->Arg(16)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_lowerCaseTags_batch)->Arg(16)->Arg(1024)->Arg(65536);
+
+
+}  // namespace
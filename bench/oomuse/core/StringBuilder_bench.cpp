@@ -0,0 +1,139 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/StringBuilder.h"
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::StringBuilder;
+using std::string;
+
+namespace {
+
+
+const std::size_t NUM_MESSAGES = 1024;
+
+
+/** Parameter names, values & limits for messages like log lines. */
+struct MessageInputs {
+  std::vector<string> names;
+  std::vector<int64> values;
+  std::vector<double> limits;
+};
+
+
+MessageInputs makeMessageInputs() {
+  const char* const names[] = {"tempo", "velocity", "pitchBend",
+                               "modulationWheelDepth"};
+  MessageInputs inputs;
+  uint64 state = 12345;
+  for (std::size_t i = 0; i < NUM_MESSAGES; ++i) {
+    state = (state * 6364136223846793005ULL) + 1442695040888963407ULL;
+    inputs.names.push_back(names[i % 4]);
+    inputs.values.push_back(static_cast<int64>(state >> 44) - 500000);
+    inputs.limits.push_back(static_cast<double>(state % 100000) / 8);
+  }
+  return inputs;
+}
+
+
+void setMessagesProcessed(benchmark::State& state) {
+  state.SetItemsProcessed(static_cast<int64>(state.iterations())
+                          * static_cast<int64>(NUM_MESSAGES));
+}
+
+
+void BM_buildMessage_stringstream(benchmark::State& state) {
+  const MessageInputs inputs = makeMessageInputs();
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < NUM_MESSAGES; ++i) {
+      std::stringstream message;
+      message << "Parameter '" << inputs.names[i] << "' was "
+              << inputs.values[i] << ", above its limit of "
+              << inputs.limits[i] << ".";
+      string str = message.str();
+      benchmark::DoNotOptimize(str);
+    }
+  }
+  setMessagesProcessed(state);
+}
+
+
+void BM_buildMessage_stringAppend(benchmark::State& state) {
+  const MessageInputs inputs = makeMessageInputs();
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < NUM_MESSAGES; ++i) {
+      string message = "Parameter '";
+      message += inputs.names[i];
+      message += "' was ";
+      message += std::to_string(inputs.values[i]);
+      message += ", above its limit of ";
+      message += std::to_string(inputs.limits[i]);
+      message += '.';
+      benchmark::DoNotOptimize(message);
+    }
+  }
+  setMessagesProcessed(state);
+}
+
+
+void BM_buildMessage_stringBuilder(benchmark::State& state) {
+  const MessageInputs inputs = makeMessageInputs();
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < NUM_MESSAGES; ++i) {
+      StringBuilder message;
+      message.append("Parameter '").append(inputs.names[i]).append("' was ")
+          .append(inputs.values[i]).append(", above its limit of ")
+          .append(inputs.limits[i]).append('.');
+      string str = message.toString();
+      benchmark::DoNotOptimize(str);
+    }
+  }
+  setMessagesProcessed(state);
+}
+
+
+void BM_buildMessage_stringBuilderReused(benchmark::State& state) {
+  // Reuses one builder & only views the result (e.g. to write it to a log).
+  const MessageInputs inputs = makeMessageInputs();
+  StringBuilder message;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < NUM_MESSAGES; ++i) {
+      message.reset();
+      message.append("Parameter '").append(inputs.names[i]).append("' was ")
+          .append(inputs.values[i]).append(", above its limit of ")
+          .append(inputs.limits[i]).append('.');
+      benchmark::DoNotOptimize(message.data());
+      benchmark::ClobberMemory();
+    }
+  }
+  setMessagesProcessed(state);
+}
+
+
+BENCHMARK(BM_buildMessage_stringstream);
+BENCHMARK(BM_buildMessage_stringAppend);
+BENCHMARK(BM_buildMessage_stringBuilder);
+BENCHMARK(BM_buildMessage_stringBuilderReused);
+
+
+}  // namespace
@@ -0,0 +1,218 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/StringValidators.h"
+
+#include <cstddef>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "oomuse/core/CharacterSet.h"
+#include "oomuse/core/int_types.h"
+#include "oomuse/core/strings.h"
+
+using oomuse::CharacterSet;
+using oomuse::StringValidators;
+using std::string;
+
+namespace strings = oomuse::strings;
+
+namespace {
+
+
+/** Returns range(0) bytes of mostly-ASCII text, with a few 2-byte chars. */
+string makeText(const benchmark::State& state) {
+  const std::size_t length = static_cast<std::size_t>(state.range(0));
+  const string words = "The quick brown fox jumps over the lazy dog. "
+                       "Caf\xC3\xA9 m\xC3\xBAsica na\xC3\xAFve. ";
+  string text;
+  text.reserve(length + words.length());
+  while (text.length() + words.length() <= length) {
+    text += words;
+  }
+  text.append(length - text.length(), 'x');
+  return text;
+}
+
+
+/** Returns range(0) bytes of plain ASCII text. */
+string makeAsciiText(const benchmark::State& state) {
+  string text = makeText(state);
+  for (char& c : text) {
+    if ((static_cast<uint8>(c) & 0x80) != 0) {
+      c = 'e';
+    }
+  }
+  return text;
+}
+
+
+void setBytesProcessed(benchmark::State& state) {
+  state.SetBytesProcessed(static_cast<int64>(state.iterations())
+                          * state.range(0));
+}
+
+
+// Byte-at-a-time versions, like the hand-written loops these replace.
+
+bool isAsciiByteLoop(const string& str) {
+  for (char c : str) {
+    if ((static_cast<uint8>(c) & 0x80) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+bool hasControlCharactersByteLoop(const string& str) {
+  for (char c : str) {
+    const uint8 byte = static_cast<uint8>(c);
+    if ((byte < 0x20) || (byte == 0x7F)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+bool isValidUtf8ByteLoop(const string& str) {
+  std::size_t numContinuationBytes = 0;
+  for (char c : str) {
+    const uint8 byte = static_cast<uint8>(c);
+    if (numContinuationBytes > 0) {
+      if ((byte & 0xC0) != 0x80) {
+        return false;
+      }
+      --numContinuationBytes;
+    } else if (byte >= 0xF0) {
+      numContinuationBytes = 3;
+    } else if (byte >= 0xE0) {
+      numContinuationBytes = 2;
+    } else if (byte >= 0xC0) {
+      numContinuationBytes = 1;
+    } else if (byte >= 0x80) {
+      return false;
+    }
+  }
+  return (numContinuationBytes == 0);  // Note: less strict than isValidUtf8.
+}
+
+
+std::size_t countCodePointsByteLoop(const string& str) {
+  std::size_t numCodePoints = 0;
+  for (char c : str) {
+    numCodePoints += ((static_cast<uint8>(c) & 0xC0) != 0x80) ? 1 : 0;
+  }
+  return numCodePoints;
+}
+
+
+bool containsAllByteLoop(const string& allowed, const string& str) {
+  for (char c : str) {
+    if (allowed.find(c) == string::npos) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+void BM_isAscii(benchmark::State& state) {
+  const string text = makeAsciiText(state);
+  const bool byteLoop = (state.range(1) == 0);
+  for (auto _ : state) {
+    bool isAscii =
+        byteLoop ? isAsciiByteLoop(text) : strings::isAscii(text);
+    benchmark::DoNotOptimize(isAscii);
+  }
+  setBytesProcessed(state);
+  state.SetLabel(byteLoop ? "byte loop" : "strings::isAscii");
+}
+
+
+void BM_hasControlCharacters(benchmark::State& state) {
+  const string text = makeText(state);
+  const bool byteLoop = (state.range(1) == 0);
+  for (auto _ : state) {
+    bool hasControls = byteLoop ? hasControlCharactersByteLoop(text)
+                                : strings::hasControlCharacters(text);
+    benchmark::DoNotOptimize(hasControls);
+  }
+  setBytesProcessed(state);
+  state.SetLabel(byteLoop ? "byte loop" : "strings::hasControlCharacters");
+}
+
+
+void BM_isValidUtf8(benchmark::State& state) {
+  const string text = makeText(state);
+  const bool byteLoop = (state.range(1) == 0);
+  for (auto _ : state) {
+    bool isValid =
+        byteLoop ? isValidUtf8ByteLoop(text) : strings::isValidUtf8(text);
+    benchmark::DoNotOptimize(isValid);
+  }
+  setBytesProcessed(state);
+  state.SetLabel(byteLoop ? "byte loop (less strict)"
+                          : "strings::isValidUtf8");
+}
+
+
+void BM_countCodePoints(benchmark::State& state) {
+  const string text = makeText(state);
+  const bool byteLoop = (state.range(1) == 0);
+  for (auto _ : state) {
+    std::size_t numCodePoints = byteLoop ? countCodePointsByteLoop(text)
+                                         : strings::countCodePoints(text);
+    benchmark::DoNotOptimize(numCodePoints);
+  }
+  setBytesProcessed(state);
+  state.SetLabel(byteLoop ? "byte loop" : "strings::countCodePoints");
+}
+
+
+void BM_charactersIn(benchmark::State& state) {
+  const string text = makeAsciiText(state);
+  const string allowed = "abcdefghijklmnopqrstuvwxyz"
+                         "ABCDEFGHIJKLMNOPQRSTUVWXYZ .";
+  auto validator = StringValidators::charactersIn(CharacterSet(allowed));
+  const bool byteLoop = (state.range(1) == 0);
+  for (auto _ : state) {
+    bool isValid = byteLoop ? containsAllByteLoop(allowed, text)
+                            : validator->isValid(text);
+    benchmark::DoNotOptimize(isValid);
+  }
+  setBytesProcessed(state);
+  state.SetLabel(byteLoop ? "byte loop (string::find)"
+                          : "StringValidators::charactersIn");
+}
+
+
+void sizesAndImplementations(benchmark::internal::Benchmark* b) {
+  for (int length : {1 << 10, 1 << 16, 1 << 20}) {
+    b->Args({length, 0})->Args({length, 1});
+  }
+}
+
+
+BENCHMARK(BM_isAscii)->Apply(sizesAndImplementations);
+BENCHMARK(BM_hasControlCharacters)->Apply(sizesAndImplementations);
+BENCHMARK(BM_isValidUtf8)->Apply(sizesAndImplementations);
+BENCHMARK(BM_countCodePoints)->Apply(sizesAndImplementations);
+BENCHMARK(BM_charactersIn)->Apply(sizesAndImplementations);
+
+
+}  // namespace
@@ -0,0 +1,171 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/SymbolTable.h"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::Symbol;
+using oomuse::SymbolTable;
+using std::string;
+
+namespace {
+
+
+const std::size_t NUM_NAMES = 1024;
+
+
+/**
+ * Parameter / event names like a synth patch would use; most are too long
+ * for std::string's small buffer.
+ */
+std::vector<string> makeNames() {
+  const char* const stems[] = {
+      "oscillator.frequency.", "filter.cutoff.", "envelope.attack.",
+      "lfo.rate.", "noteOn.", "gain."};
+  std::vector<string> names;
+  names.reserve(NUM_NAMES);
+  for (std::size_t i = 0; i < NUM_NAMES; ++i) {
+    names.push_back(stems[i % 6] + std::to_string(i));
+  }
+  return names;
+}
+
+
+/** Baseline: a mutex-guarded std::string map, as a naive intern table. */
+class LockedStringTable {
+ public:
+  uint32 intern(const string& str) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto inserted = ids_.emplace(str, static_cast<uint32>(ids_.size()));
+    return inserted.first->second;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<string, uint32> ids_;
+};
+
+
+// Shared by all threads of the concurrent intern benchmarks; set up by thread
+// 0, before the timing loop (which all threads start together).
+std::vector<string> sharedNames;
+std::unique_ptr<SymbolTable> sharedSymbols;
+std::unique_ptr<LockedStringTable> sharedLockedTable;
+
+
+/** Interns already-known names (the lock-free read path) from N threads. */
+void BM_intern_symbolTable(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    sharedNames = makeNames();
+    sharedSymbols.reset(new SymbolTable());
+    for (const string& name : sharedNames) {
+      sharedSymbols->intern(name);
+    }
+  }
+
+  std::size_t i = static_cast<std::size_t>(state.thread_index()) * 97;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        sharedSymbols->intern(sharedNames[i++ % NUM_NAMES]));
+  }
+  state.SetItemsProcessed(static_cast<int64>(state.iterations()));
+}
+
+
+void BM_intern_lockedStringMap(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    sharedNames = makeNames();
+    sharedLockedTable.reset(new LockedStringTable());
+    for (const string& name : sharedNames) {
+      sharedLockedTable->intern(name);
+    }
+  }
+
+  std::size_t i = static_cast<std::size_t>(state.thread_index()) * 97;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        sharedLockedTable->intern(sharedNames[i++ % NUM_NAMES]));
+  }
+  state.SetItemsProcessed(static_cast<int64>(state.iterations()));
+}
+
+
+/** Interns brand-new names (the locked write path), single-threaded. */
+void BM_intern_newNames(benchmark::State& state) {
+  const std::vector<string> names = makeNames();
+  for (auto _ : state) {
+    SymbolTable symbols;
+    for (const string& name : names) {
+      benchmark::DoNotOptimize(symbols.intern(name));
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64>(state.iterations())
+                          * static_cast<int64>(NUM_NAMES));
+}
+
+
+/** Finds a value by name in a std::string-keyed map. */
+void BM_mapFind_string(benchmark::State& state) {
+  const std::vector<string> names = makeNames();
+  std::unordered_map<string, int32> values;
+  for (std::size_t i = 0; i < NUM_NAMES; ++i) {
+    values[names[i]] = static_cast<int32>(i);
+  }
+
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(values.find(names[i++ % NUM_NAMES]));
+  }
+  state.SetItemsProcessed(static_cast<int64>(state.iterations()));
+}
+
+
+/** Finds the same values by Symbol (interned once, up front). */
+void BM_mapFind_symbol(benchmark::State& state) {
+  const std::vector<string> names = makeNames();
+  SymbolTable symbols;
+  std::vector<Symbol> keys;
+  std::unordered_map<Symbol, int32> values;
+  for (std::size_t i = 0; i < NUM_NAMES; ++i) {
+    keys.push_back(symbols.intern(names[i]));
+    values[keys.back()] = static_cast<int32>(i);
+  }
+
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(values.find(keys[i++ % NUM_NAMES]));
+  }
+  state.SetItemsProcessed(static_cast<int64>(state.iterations()));
+}
+
+
+BENCHMARK(BM_intern_symbolTable)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_intern_lockedStringMap)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_intern_newNames);
+BENCHMARK(BM_mapFind_string);
+BENCHMARK(BM_mapFind_symbol);
+
+
+}  // namespace
@@ -0,0 +1,153 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/Validated.h"
+
+#include <cstddef>
+#include <memory>
+
+#include "benchmark/benchmark.h"
+#include "oomuse/core/FixedArray.h"
+#include "oomuse/core/Optional.h"
+#include "oomuse/core/Validator.h"
+#include "oomuse/core/ValidatorExpressions.h"
+#include "oomuse/core/Validators.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::FixedArray;
+using oomuse::Optional;
+using oomuse::Validated;
+using oomuse::Validator;
+using oomuse::Validators;
+using std::unique_ptr;
+
+namespace v = oomuse::validation;
+
+// Keeps each layer a real function call, like an API boundary would be.
+#if defined(__GNUC__) || defined(__clang__)
+  #define BENCH_NOINLINE  __attribute__((noinline))
+#elif defined(_MSC_VER)
+  #define BENCH_NOINLINE  __declspec(noinline)
+#else
+  #define BENCH_NOINLINE
+#endif
+
+namespace {
+
+
+struct MidiRange {
+  static constexpr auto expression() {
+    return v::greaterOrEqual(0) && v::less(128);
+  }
+};
+
+using MidiValue = Validated<int32, MidiRange>;
+
+
+const std::size_t NUM_NOTES = 4096;
+
+const Validator<int32>& midiValidator() {
+  static const unique_ptr<Validator<int32>> isMidiValue =
+      Validators<int32>::allOf(Validators<int32>::greaterOrEqual(0),
+                               Validators<int32>::less(128));
+  return *isMidiValue;
+}
+
+
+// Four layers that each re-check their plain int32 argument (returning -1 if
+// invalid), as code without a validated type has to.
+
+BENCH_NOINLINE int32 checkedLayer4(int32 note) {
+  return midiValidator().isValid(note) ? (note * 3) : -1;
+}
+
+BENCH_NOINLINE int32 checkedLayer3(int32 note) {
+  return midiValidator().isValid(note) ? (checkedLayer4(note) + 1) : -1;
+}
+
+BENCH_NOINLINE int32 checkedLayer2(int32 note) {
+  return midiValidator().isValid(note) ? (checkedLayer3(note) + 1) : -1;
+}
+
+BENCH_NOINLINE int32 checkedLayer1(int32 note) {
+  return midiValidator().isValid(note) ? (checkedLayer2(note) + 1) : -1;
+}
+
+
+// The same four layers taking a MidiValue, checked once at the entry point.
+
+BENCH_NOINLINE int32 validatedLayer4(MidiValue note) { return note * 3; }
+
+BENCH_NOINLINE int32 validatedLayer3(MidiValue note) {
+  return validatedLayer4(note) + 1;
+}
+
+BENCH_NOINLINE int32 validatedLayer2(MidiValue note) {
+  return validatedLayer3(note) + 1;
+}
+
+BENCH_NOINLINE int32 validatedLayer1(MidiValue note) {
+  return validatedLayer2(note) + 1;
+}
+
+
+FixedArray<int32> makeNotes() {
+  FixedArray<int32> notes(NUM_NOTES);
+  for (std::size_t i = 0; i < notes.length(); ++i) {
+    notes[i] = static_cast<int32>(i % 140);  // Some out of range.
+  }
+  return notes;
+}
+
+
+void setItemsProcessed(benchmark::State& state) {
+  state.SetItemsProcessed(static_cast<int64>(state.iterations())
+                          * static_cast<int64>(NUM_NOTES));
+}
+
+
+void BM_callChain_revalidatedAtEachLayer(benchmark::State& state) {
+  FixedArray<int32> notes = makeNotes();
+  for (auto _ : state) {
+    int64 sum = 0;
+    for (int32 note : notes) {
+      sum += checkedLayer1(note);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  setItemsProcessed(state);
+}
+
+
+void BM_callChain_validatedOnce(benchmark::State& state) {
+  FixedArray<int32> notes = makeNotes();
+  for (auto _ : state) {
+    int64 sum = 0;
+    for (int32 note : notes) {
+      Optional<MidiValue> validNote = MidiValue::of(note);
+      sum += validNote.hasValue() ? validatedLayer1(validNote.value()) : -1;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  setItemsProcessed(state);
+}
+
+
+BENCHMARK(BM_callChain_revalidatedAtEachLayer);
+BENCHMARK(BM_callChain_validatedOnce);
+
+
+}  // namespace
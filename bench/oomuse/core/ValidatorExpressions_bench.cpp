@@ -0,0 +1,111 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/ValidatorExpressions.h"
+
+#include <memory>
+
+#include "benchmark/benchmark.h"
+#include "oomuse/core/Validator.h"
+#include "oomuse/core/Validators.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::Validator;
+using oomuse::Validators;
+using std::unique_ptr;
+
+namespace v = oomuse::validation;
+
+namespace {
+
+
+/** Three-clause rule built from the heap-allocated Validators factories. */
+unique_ptr<Validator<int32>> makeFactoryValidator() {
+  return Validators<int32>::allOf(
+      Validators<int32>::greaterOrEqual(0),
+      Validators<int32>::notEqual(64),
+      Validators<int32>::less(128));
+}
+
+
+/** Same three-clause rule as a validator expression. */
+constexpr auto kExpression =
+    v::greaterOrEqual(0) && v::notEqual(64) && v::less(128);
+
+
+void BM_factoryValidator_construct(benchmark::State& state) {
+  for (auto _ : state) {
+    unique_ptr<Validator<int32>> validator = makeFactoryValidator();
+    benchmark::DoNotOptimize(validator.get());
+  }
+}
+
+
+void BM_expression_construct(benchmark::State& state) {
+  for (auto _ : state) {
+    auto expression = v::greaterOrEqual(0) && v::notEqual(64) && v::less(128);
+    benchmark::DoNotOptimize(&expression);
+  }
+}
+
+
+void BM_factoryValidator_isValid(benchmark::State& state) {
+  unique_ptr<Validator<int32>> validator = makeFactoryValidator();
+  int32 numValid = 0;
+  for (auto _ : state) {
+    for (int32 value = -64; value < 192; ++value) {
+      numValid += validator->isValid(value) ? 1 : 0;
+    }
+  }
+  benchmark::DoNotOptimize(numValid);
+  state.SetItemsProcessed(state.iterations() * 256);
+}
+
+
+void BM_expression_isValid(benchmark::State& state) {
+  int32 numValid = 0;
+  for (auto _ : state) {
+    for (int32 value = -64; value < 192; ++value) {
+      benchmark::DoNotOptimize(value);
+      numValid += kExpression.isValid(value) ? 1 : 0;
+    }
+  }
+  benchmark::DoNotOptimize(numValid);
+  state.SetItemsProcessed(state.iterations() * 256);
+}
+
+
+void BM_typeErasedExpression_isValid(benchmark::State& state) {
+  unique_ptr<Validator<int32>> validator = v::toValidator<int32>(kExpression);
+  int32 numValid = 0;
+  for (auto _ : state) {
+    for (int32 value = -64; value < 192; ++value) {
+      numValid += validator->isValid(value) ? 1 : 0;
+    }
+  }
+  benchmark::DoNotOptimize(numValid);
+  state.SetItemsProcessed(state.iterations() * 256);
+}
+
+
+BENCHMARK(BM_factoryValidator_construct);
+BENCHMARK(BM_expression_construct);
+BENCHMARK(BM_factoryValidator_isValid);
+BENCHMARK(BM_expression_isValid);
+BENCHMARK(BM_typeErasedExpression_isValid);
+
+
+}  // namespace
@@ -0,0 +1,150 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/ValidatorSet.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "oomuse/core/Validator.h"
+#include "oomuse/core/Validators.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::Validator;
+using oomuse::ValidatorSet;
+using oomuse::Validators;
+using std::unique_ptr;
+
+namespace {
+
+
+/** How each benchmark lays out its validator trees (from state.range(0)). */
+enum Layout {NESTED_PAIRS, FLAT, VALIDATOR_SET};
+
+const char* layoutLabel(int64 layout) {
+  switch (layout) {
+    case NESTED_PAIRS: return "nested pairs";
+    case FLAT: return "flat";
+    default: return "ValidatorSet";
+  }
+}
+
+
+/** Returns allOf(>= 10 * i, < 10 * i + 5) for the i-th allowed range. */
+unique_ptr<Validator<int32>> makeRange(int32 i) {
+  return Validators<int32>::allOf(Validators<int32>::greaterOrEqual(10 * i),
+                                  Validators<int32>::less(10 * i + 5));
+}
+
+
+/**
+ * Returns anyOf() over numRanges ranges (2 leaves each), built the only way
+ * possible before variadic anyOf(): by nesting pairs.
+ */
+unique_ptr<Validator<int32>> makeNestedPairsTree(int32 numRanges) {
+  auto validator = makeRange(0);
+  for (int32 i = 1; i < numRanges; ++i) {
+    validator = Validators<int32>::anyOf(std::move(validator), makeRange(i));
+  }
+  return validator;
+}
+
+
+/** Returns the same rule as a single anyOf() node. */
+unique_ptr<Validator<int32>> makeFlatTree(int32 numRanges) {
+  std::vector<unique_ptr<Validator<int32>>> ranges;
+  ranges.reserve(numRanges);
+  for (int32 i = 0; i < numRanges; ++i) {
+    ranges.emplace_back(makeRange(i));
+  }
+  return Validators<int32>::anyOf(std::move(ranges));
+}
+
+
+/** Returns the same rule laid out in a single ValidatorSet allocation. */
+unique_ptr<Validator<int32>> makeValidatorSet(int32 numRanges) {
+  ValidatorSet<int32>::Builder builder;
+  std::vector<ValidatorSet<int32>::NodeId> ranges;
+  ranges.reserve(numRanges);
+  for (int32 i = 0; i < numRanges; ++i) {
+    ranges.push_back(builder.allOf({builder.greaterOrEqual(10 * i),
+                                    builder.less(10 * i + 5)}));
+  }
+  return std::make_unique<ValidatorSet<int32>>(
+      builder.build(builder.anyOf(std::move(ranges))));
+}
+
+
+unique_ptr<Validator<int32>> makeTree(int64 layout, int32 numRanges) {
+  switch (layout) {
+    case NESTED_PAIRS: return makeNestedPairsTree(numRanges);
+    case FLAT: return makeFlatTree(numRanges);
+    default: return makeValidatorSet(numRanges);
+  }
+}
+
+
+void BM_build(benchmark::State& state) {
+  const int32 numRanges = static_cast<int32>(state.range(1));
+  for (auto _ : state) {
+    auto validator = makeTree(state.range(0), numRanges);
+    benchmark::DoNotOptimize(validator);
+  }
+  state.SetLabel(layoutLabel(state.range(0)));
+}
+
+
+/**
+ * Evaluates many separately built trees round-robin, so that (like a real
+ * rule set checked once per incoming message) nodes are often not in cache.
+ */
+void BM_manyTrees_isValid(benchmark::State& state) {
+  const int32 numRanges = static_cast<int32>(state.range(1));
+  const int32 numTrees = 1024;
+  std::vector<unique_ptr<Validator<int32>>> validators;
+  for (int32 i = 0; i < numTrees; ++i) {
+    validators.emplace_back(makeTree(state.range(0), numRanges));
+  }
+
+  int32 numValid = 0;
+  int32 i = 0;
+  for (auto _ : state) {
+    // Values near the end of the ranges check (almost) every leaf.
+    const int32 value = 10 * numRanges - 1 - (i & 15);
+    numValid += validators[i & (numTrees - 1)]->isValid(value) ? 1 : 0;
+    ++i;
+  }
+  benchmark::DoNotOptimize(numValid);
+  state.SetLabel(layoutLabel(state.range(0)));
+}
+
+
+void layoutsAndSizes(benchmark::internal::Benchmark* b) {
+  for (int layout : {NESTED_PAIRS, FLAT, VALIDATOR_SET}) {
+    for (int numRanges : {4, 32, 128}) {  // 8, 64, and 256 leaves.
+      b->Args({layout, numRanges});
+    }
+  }
+}
+
+
+BENCHMARK(BM_build)->Apply(layoutsAndSizes);
+BENCHMARK(BM_manyTrees_isValid)->Apply(layoutsAndSizes);
+
+
+}  // namespace
@@ -0,0 +1,138 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/Validators.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "oomuse/core/Validator.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::ValidationErrorCode;
+using oomuse::Validator;
+using oomuse::Validators;
+using std::string;
+using std::unique_ptr;
+
+namespace {
+
+
+/** A three-clause rule: (0 <= value < 128) or value == 255. */
+unique_ptr<Validator<int32>> makeMidiOrSentinelValidator() {
+  return Validators<int32>::anyOf(
+      Validators<int32>::allOf(
+          Validators<int32>::greaterOrEqual(0),
+          Validators<int32>::less(128)),
+      Validators<int32>::equal(255));
+}
+
+
+/** Cycles through values that mostly pass (range(0) == 0) or all fail. */
+int32 nextValue(int32 i, bool passing) {
+  return passing ? (i & 127) : (128 + (i & 63));
+}
+
+
+void BM_checkValidationErrors(benchmark::State& state) {
+  auto validator = makeMidiOrSentinelValidator();
+  const bool passing = (state.range(0) == 0);
+  int32 i = 0;
+  for (auto _ : state) {
+    string errors = validator->checkValidationErrors(nextValue(i++, passing));
+    benchmark::DoNotOptimize(errors);
+  }
+  state.SetLabel(passing ? "passing" : "failing");
+}
+
+
+void BM_isValid(benchmark::State& state) {
+  auto validator = makeMidiOrSentinelValidator();
+  const bool passing = (state.range(0) == 0);
+  int32 i = 0;
+  for (auto _ : state) {
+    bool isValid = validator->isValid(nextValue(i++, passing));
+    benchmark::DoNotOptimize(isValid);
+  }
+  state.SetLabel(passing ? "passing" : "failing");
+}
+
+
+void BM_checkValidationErrorCode(benchmark::State& state) {
+  auto validator = makeMidiOrSentinelValidator();
+  const bool passing = (state.range(0) == 0);
+  int32 i = 0;
+  for (auto _ : state) {
+    ValidationErrorCode errorCode =
+        validator->checkValidationErrorCode(nextValue(i++, passing));
+    benchmark::DoNotOptimize(errorCode);
+  }
+  state.SetLabel(passing ? "passing" : "failing");
+}
+
+
+/**
+ * Returns a deep tree of nested anyOf(allOf(>= lo, < hi), ...) ranges, with
+ * 3^depth ranges in total (like a config-driven list of allowed ranges).
+ */
+unique_ptr<Validator<int32>> makeDeepRangeTree(int32 depth, int32* nextLow) {
+  if (depth == 0) {
+    const int32 low = *nextLow;
+    *nextLow += 10;
+    return Validators<int32>::allOf(
+        Validators<int32>::greaterOrEqual(low),
+        Validators<int32>::less(low + 5));
+  }
+  auto first = makeDeepRangeTree(depth - 1, nextLow);
+  auto second = makeDeepRangeTree(depth - 1, nextLow);
+  auto third = makeDeepRangeTree(depth - 1, nextLow);
+  return Validators<int32>::anyOf(
+      std::move(first), std::move(second), std::move(third));
+}
+
+
+void BM_deepTree_isValid(benchmark::State& state) {
+  int32 nextLow = 0;
+  auto validator =
+      makeDeepRangeTree(static_cast<int32>(state.range(0)), &nextLow);
+  if (state.range(1) != 0) {
+    validator = Validators<int32>::compile(std::move(validator));
+  }
+
+  int32 numValid = 0;
+  int32 value = 0;
+  for (auto _ : state) {
+    numValid += validator->isValid(value) ? 1 : 0;
+    value = (value + 7) % nextLow;
+  }
+  benchmark::DoNotOptimize(numValid);
+  state.SetLabel(state.range(1) ? "compiled" : "tree");
+}
+
+
+BENCHMARK(BM_checkValidationErrors)->Arg(0)->Arg(1);
+BENCHMARK(BM_isValid)->Arg(0)->Arg(1);
+BENCHMARK(BM_checkValidationErrorCode)->Arg(0)->Arg(1);
+BENCHMARK(BM_deepTree_isValid)->Apply([](benchmark::internal::Benchmark* b) {
+  for (int depth = 1; depth <= 4; ++depth) {
+    b->Args({depth, 0})->Args({depth, 1});
+  }
+});
+
+
+}  // namespace
@@ -0,0 +1,951 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/strings.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <codecvt>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <locale>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "oomuse/core/CharacterSet.h"
+#include "oomuse/core/LocaleTables.h"
+#include "oomuse/core/Optional.h"
+#include "oomuse/core/StringRef.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::CharacterSet;
+using oomuse::LocaleTables;
+using oomuse::Optional;
+using oomuse::StringRef;
+using std::string;
+
+using oomuse::strings::SplitOptions;
+
+namespace strings = oomuse::strings;
+
+namespace {
+
+
+/** Returns a config file of about numBytes: comments, blanks, key = value. */
+string makeConfigText(std::size_t numBytes) {
+  string text;
+  text.reserve(numBytes + 64);
+  for (std::size_t line = 0; text.length() < numBytes; ++line) {
+    switch (line % 8) {
+      case 0:
+        text += "# Settings for instrument " + std::to_string(line) + "\n";
+        break;
+      case 1:
+        text += "   \t\n";
+        break;
+      default:
+        text += "  instrument" + std::to_string(line)
+            + ".volume  =  0.75  \n";
+        break;
+    }
+  }
+  return text;
+}
+
+
+const string& configText(std::size_t numBytes) {
+  static string text;
+  if (text.length() < numBytes) {
+    text = makeConfigText(numBytes);
+  }
+  return text;
+}
+
+
+void setBytesProcessed(benchmark::State& state, std::size_t numBytes) {
+  state.SetBytesProcessed(static_cast<int64>(state.iterations())
+                          * static_cast<int64>(numBytes));
+}
+
+
+/** Parses key = value lines through std::string copies of each piece. */
+void BM_parseConfig_stdString(benchmark::State& state) {
+  const string& text = configText(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    std::size_t numEntries = 0;
+    std::size_t totalValueLength = 0;
+    std::size_t lineStart = 0;
+    while (lineStart < text.length()) {
+      std::size_t lineEnd = text.find('\n', lineStart);
+      if (lineEnd == string::npos) {
+        lineEnd = text.length();
+      }
+      string line =
+          strings::trimWhitespace(text.substr(lineStart, lineEnd - lineStart));
+      lineStart = lineEnd + 1;
+      if (line.empty() || strings::startsWith(line, "#")) {
+        continue;
+      }
+
+      const std::size_t equals = line.find('=');
+      if (equals != string::npos) {
+        string key = strings::trimWhitespace(line.substr(0, equals));
+        string value = strings::trimWhitespace(line.substr(equals + 1));
+        numEntries += key.empty() ? 0 : 1;
+        totalValueLength += value.length();
+      }
+    }
+    benchmark::DoNotOptimize(numEntries);
+    benchmark::DoNotOptimize(totalValueLength);
+  }
+  setBytesProcessed(state, text.length());
+}
+
+
+/** Same parsing through StringRef views, without any allocation. */
+void BM_parseConfig_stringRef(benchmark::State& state) {
+  const string& text = configText(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    std::size_t numEntries = 0;
+    std::size_t totalValueLength = 0;
+    StringRef remaining(text);
+    while (!remaining.empty()) {
+      std::size_t lineEnd = remaining.find('\n');
+      if (lineEnd == StringRef::npos) {
+        lineEnd = remaining.length();
+      }
+      StringRef line = strings::trimWhitespace(remaining.substr(0, lineEnd));
+      remaining.removePrefix(
+          (lineEnd < remaining.length()) ? (lineEnd + 1) : lineEnd);
+      if (line.empty() || strings::startsWith(line, "#")) {
+        continue;
+      }
+
+      const std::size_t equals = line.find('=');
+      if (equals != StringRef::npos) {
+        StringRef key = strings::trimWhitespace(line.substr(0, equals));
+        StringRef value = strings::trimWhitespace(line.substr(equals + 1));
+        numEntries += key.empty() ? 0 : 1;
+        totalValueLength += value.length();
+      }
+    }
+    benchmark::DoNotOptimize(numEntries);
+    benchmark::DoNotOptimize(totalValueLength);
+  }
+  setBytesProcessed(state, text.length());
+}
+
+
+/** Mostly-ASCII mixed-case text of the given length. */
+string makeMixedCaseText(std::size_t length) {
+  const string words = "The Quick Brown Fox Jumps Over The Lazy Dog. ";
+  string text;
+  text.reserve(length);
+  while (text.length() < length) {
+    text += words;
+  }
+  text.resize(length);
+  return text;
+}
+
+
+/** Previous implementation: copy, then std::tolower() every char. */
+void BM_toLowerCase_transform(benchmark::State& state) {
+  const string text =
+      makeMixedCaseText(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    string lowerText = text;
+    std::transform(lowerText.begin(), lowerText.end(), lowerText.begin(),
+                   [](char c) { return std::tolower(c); });
+    benchmark::DoNotOptimize(lowerText.data());
+  }
+  setBytesProcessed(state, text.length());
+}
+
+
+void BM_toLowerCase(benchmark::State& state) {
+  const string text =
+      makeMixedCaseText(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    string lowerText = strings::toLowerCase(text);
+    benchmark::DoNotOptimize(lowerText.data());
+  }
+  setBytesProcessed(state, text.length());
+}
+
+
+void BM_toLowerCaseInto(benchmark::State& state) {
+  const string text =
+      makeMixedCaseText(static_cast<std::size_t>(state.range(0)));
+  string buffer(text.length(), '\0');
+  for (auto _ : state) {
+    strings::toLowerCaseInto(text, &buffer[0]);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  setBytesProcessed(state, text.length());
+}
+
+
+/** A line with range(0) whitespace chars on each side of some text. */
+string makePaddedLine(benchmark::State& state) {
+  const string padding(static_cast<std::size_t>(state.range(0)), ' ');
+  return padding + "\t value \t" + padding;
+}
+
+
+/** Previous implementation: find_if() with std::isspace() from each end. */
+void BM_trimWhitespace_byChar(benchmark::State& state) {
+  const string line = makePaddedLine(state);
+  for (auto _ : state) {
+    auto isNotSpace = [](char c) { return !std::isspace(c); };
+    auto first = std::find_if(line.begin(), line.end(), isNotSpace);
+    auto last = std::find_if(line.rbegin(), line.rend(), isNotSpace);
+    const auto begin = first - line.begin();
+    const auto end = line.rend() - last;
+    StringRef trimmed(line.data() + begin,
+                      static_cast<std::size_t>(end - begin));
+    benchmark::DoNotOptimize(trimmed.data());
+  }
+  setBytesProcessed(state, line.length());
+}
+
+
+void BM_trimWhitespace(benchmark::State& state) {
+  const string line = makePaddedLine(state);
+  for (auto _ : state) {
+    StringRef trimmed = strings::trimWhitespace(StringRef(line));
+    benchmark::DoNotOptimize(trimmed.data());
+  }
+  setBytesProcessed(state, line.length());
+}
+
+
+/** Previous implementation: all_of() with std::isspace(). */
+void BM_isEmptyOrWhitespace_byChar(benchmark::State& state) {
+  const string blank(static_cast<std::size_t>(state.range(0)), '\t');
+  for (auto _ : state) {
+    bool isBlank = std::all_of(blank.begin(), blank.end(),
+                               [](char c) { return std::isspace(c); });
+    benchmark::DoNotOptimize(isBlank);
+  }
+  setBytesProcessed(state, blank.length());
+}
+
+
+void BM_isEmptyOrWhitespace(benchmark::State& state) {
+  const string blank(static_cast<std::size_t>(state.range(0)), '\t');
+  for (auto _ : state) {
+    bool isBlank = strings::isEmptyOrWhitespace(blank);
+    benchmark::DoNotOptimize(isBlank);
+  }
+  setBytesProcessed(state, blank.length());
+}
+
+
+/** Previous locale trim: std::isspace(c, loc) (a facet lookup) per char. */
+void BM_trimWhitespace_locale_byChar(benchmark::State& state) {
+  const string line = makePaddedLine(state);
+  const std::locale loc;
+  for (auto _ : state) {
+    auto isNotSpace = [&loc](char c) { return !std::isspace(c, loc); };
+    auto first = std::find_if(line.begin(), line.end(), isNotSpace);
+    auto last = std::find_if(line.rbegin(), line.rend(), isNotSpace);
+    const auto begin = first - line.begin();
+    const auto end = line.rend() - last;
+    StringRef trimmed(line.data() + begin,
+                      static_cast<std::size_t>(end - begin));
+    benchmark::DoNotOptimize(trimmed.data());
+  }
+  setBytesProcessed(state, line.length());
+}
+
+
+void BM_trimWhitespace_locale(benchmark::State& state) {
+  const string line = makePaddedLine(state);
+  const std::locale loc;
+  for (auto _ : state) {
+    StringRef trimmed = strings::trimWhitespace(StringRef(line), loc);
+    benchmark::DoNotOptimize(trimmed.data());
+  }
+  setBytesProcessed(state, line.length());
+}
+
+
+void BM_trimWhitespace_localeTables(benchmark::State& state) {
+  const string line = makePaddedLine(state);
+  const LocaleTables tables{std::locale()};
+  for (auto _ : state) {
+    StringRef trimmed = strings::trimWhitespace(StringRef(line), tables);
+    benchmark::DoNotOptimize(trimmed.data());
+  }
+  setBytesProcessed(state, line.length());
+}
+
+
+/** Previous locale toLowerCase: std::tolower(c, loc) per char. */
+void BM_toLowerCase_locale_transform(benchmark::State& state) {
+  const string text =
+      makeMixedCaseText(static_cast<std::size_t>(state.range(0)));
+  const std::locale loc;
+  for (auto _ : state) {
+    string lowerText = text;
+    std::transform(lowerText.begin(), lowerText.end(), lowerText.begin(),
+                   [&loc](char c) { return std::tolower(c, loc); });
+    benchmark::DoNotOptimize(lowerText.data());
+  }
+  setBytesProcessed(state, text.length());
+}
+
+
+void BM_toLowerCase_locale(benchmark::State& state) {
+  const string text =
+      makeMixedCaseText(static_cast<std::size_t>(state.range(0)));
+  const std::locale loc;
+  for (auto _ : state) {
+    string lowerText = strings::toLowerCase(text, loc);
+    benchmark::DoNotOptimize(lowerText.data());
+  }
+  setBytesProcessed(state, text.length());
+}
+
+
+void BM_toLowerCase_localeTables(benchmark::State& state) {
+  const string text =
+      makeMixedCaseText(static_cast<std::size_t>(state.range(0)));
+  const LocaleTables tables{std::locale()};
+  for (auto _ : state) {
+    string lowerText = strings::toLowerCase(text, tables);
+    benchmark::DoNotOptimize(lowerText.data());
+  }
+  setBytesProcessed(state, text.length());
+}
+
+
+/** Building LocaleTables, to amortize over calls. */
+void BM_LocaleTables_construct(benchmark::State& state) {
+  const std::locale loc;
+  for (auto _ : state) {
+    LocaleTables tables(loc);
+    benchmark::DoNotOptimize(&tables);
+  }
+}
+
+
+/** Kinds of text for the UTF-8 benchmarks, selected by range(0). */
+enum class TextKind {ASCII, MIXED, CJK};
+
+
+/**
+ * Returns text of about numBytes: preset names in pure ASCII, mixed Latin
+ * with some accented letters, or Japanese (3-byte CJK & kana).
+ */
+string makeUtf8Text(benchmark::State& state, std::size_t numBytes) {
+  const char* const phrases[] = {
+      "Grand Piano Bright Hall, ",
+      "Pr\xC3\xA9lude \xC3\x89tude \xC3\x91" "and\xC3\xBA "
+      "Gr\xC3\x96\xC3\x9F" "e, ",
+      "\xE3\x82\xB0\xE3\x83\xA9\xE3\x83\xB3\xE3\x83\x89\xE3\x83\x94\xE3\x82\xA2"
+      "\xE3\x83\x8E\xE9\x9F\xB3\xE8\x89\xB2\xE3\x80\x81"};
+  const char* const labels[] = {"ascii", "mixed", "cjk"};
+  const std::size_t kind = static_cast<std::size_t>(state.range(0));
+  state.SetLabel(labels[kind]);
+
+  string text;
+  while (text.length() < numBytes) {
+    text += phrases[kind];
+  }
+  return text;
+}
+
+
+/**
+ * Standard library approach: decode to wchar_t, std::ctype<wchar_t>::
+ * tolower() for a UTF-8 locale (if installed), and encode again.
+ */
+void BM_toLowerCaseUtf8_wstringConvert(benchmark::State& state) {
+  const string text = makeUtf8Text(state, 4096);
+  std::locale loc;
+  try {
+    loc = std::locale("C.UTF-8");
+  } catch (const std::runtime_error&) {
+    // Fall back to the classic locale (ASCII only).
+  }
+  const std::ctype<wchar_t>& ctype = std::use_facet<std::ctype<wchar_t>>(loc);
+  std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+  for (auto _ : state) {
+    std::wstring wideText = converter.from_bytes(text);
+    ctype.tolower(&wideText[0], &wideText[0] + wideText.length());
+    string lowerText = converter.to_bytes(wideText);
+    benchmark::DoNotOptimize(lowerText.data());
+  }
+  setBytesProcessed(state, text.length());
+}
+
+
+void BM_toLowerCaseUtf8(benchmark::State& state) {
+  const string text = makeUtf8Text(state, 4096);
+  for (auto _ : state) {
+    string lowerText = strings::toLowerCaseUtf8(text);
+    benchmark::DoNotOptimize(lowerText.data());
+  }
+  setBytesProcessed(state, text.length());
+}
+
+
+void BM_foldCase(benchmark::State& state) {
+  const string text = makeUtf8Text(state, 4096);
+  for (auto _ : state) {
+    string foldedText = strings::foldCase(text);
+    benchmark::DoNotOptimize(foldedText.data());
+  }
+  setBytesProcessed(state, text.length());
+}
+
+
+/** Trims 64 ASCII spaces and an ideographic space from each end. */
+void BM_trimUnicodeWhitespace(benchmark::State& state) {
+  const string padding = string(64, ' ') + "\xE3\x80\x80";
+  const string line = padding + makeUtf8Text(state, 64) + padding;
+  for (auto _ : state) {
+    StringRef trimmed = strings::trimUnicodeWhitespace(StringRef(line));
+    benchmark::DoNotOptimize(trimmed.data());
+  }
+  setBytesProcessed(state, line.length());
+}
+
+
+/** Returns CSV-like preset rows (5 fields each) of about numBytes. */
+const string& csvText(std::size_t numBytes) {
+  static string text;
+  if (text.length() < numBytes) {
+    text.clear();
+    text.reserve(numBytes + 64);
+    for (std::size_t row = 0; text.length() < numBytes; ++row) {
+      const string id = std::to_string(row);
+      text += id + ",Grand Piano " + id + ", 0.75 ,piano;bright,"
+          + (((row % 3) == 0) ? "true\n" : "false\n");
+    }
+  }
+  return text;
+}
+
+
+/** Typical hand-written splitting: find() & substr() for every field. */
+void BM_splitCsv_substr(benchmark::State& state) {
+  const string& text = csvText(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    std::size_t numFields = 0;
+    std::size_t totalLength = 0;
+    std::size_t lineStart = 0;
+    while (lineStart < text.length()) {
+      std::size_t lineEnd = text.find('\n', lineStart);
+      if (lineEnd == string::npos) {
+        lineEnd = text.length();
+      }
+      const string line = text.substr(lineStart, lineEnd - lineStart);
+      lineStart = lineEnd + 1;
+
+      std::size_t fieldStart = 0;
+      while (true) {
+        std::size_t fieldEnd = line.find(',', fieldStart);
+        const string field = line.substr(
+            fieldStart, (fieldEnd == string::npos) ? string::npos
+                                                   : (fieldEnd - fieldStart));
+        ++numFields;
+        totalLength += field.length();
+        if (fieldEnd == string::npos) {
+          break;
+        }
+        fieldStart = fieldEnd + 1;
+      }
+    }
+    benchmark::DoNotOptimize(numFields);
+    benchmark::DoNotOptimize(totalLength);
+  }
+  setBytesProcessed(state, text.length());
+}
+
+
+/** split() into lines, then split() each line into fields. */
+void BM_splitCsv_split(benchmark::State& state) {
+  const string& text = csvText(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    std::size_t numFields = 0;
+    std::size_t totalLength = 0;
+    for (StringRef line :
+         strings::split(text, '\n', SplitOptions::SKIP_EMPTY)) {
+      for (StringRef field : strings::split(line, ',')) {
+        ++numFields;
+        totalLength += field.length();
+      }
+    }
+    benchmark::DoNotOptimize(numFields);
+    benchmark::DoNotOptimize(totalLength);
+  }
+  setBytesProcessed(state, text.length());
+}
+
+
+/** Same, but trimming each field. */
+void BM_splitCsv_splitTrimmed(benchmark::State& state) {
+  const string& text = csvText(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    std::size_t numFields = 0;
+    std::size_t totalLength = 0;
+    for (StringRef line :
+         strings::split(text, '\n', SplitOptions::SKIP_EMPTY)) {
+      for (StringRef field :
+           strings::split(line, ',', SplitOptions::TRIM_WHITESPACE)) {
+        ++numFields;
+        totalLength += field.length();
+      }
+    }
+    benchmark::DoNotOptimize(numFields);
+    benchmark::DoNotOptimize(totalLength);
+  }
+  setBytesProcessed(state, text.length());
+}
+
+
+/** One split() of the whole text by both ',' and '\n'. */
+void BM_splitCsv_characterSet(benchmark::State& state) {
+  const string& text = csvText(static_cast<std::size_t>(state.range(0)));
+  const CharacterSet delimiters(",\n");
+  for (auto _ : state) {
+    std::size_t numFields = 0;
+    std::size_t totalLength = 0;
+    for (StringRef field : strings::split(text, delimiters)) {
+      ++numFields;
+      totalLength += field.length();
+    }
+    benchmark::DoNotOptimize(numFields);
+    benchmark::DoNotOptimize(totalLength);
+  }
+  setBytesProcessed(state, text.length());
+}
+
+
+/** Typical hand-written joining: += each part, growing as needed. */
+void BM_join_append(benchmark::State& state) {
+  const std::vector<string> parts(static_cast<std::size_t>(state.range(0)),
+                                  "Grand Piano Bright");
+  for (auto _ : state) {
+    string joined;
+    for (std::size_t i = 0; i < parts.size(); ++i) {
+      if (i > 0) {
+        joined += ", ";
+      }
+      joined += parts[i];
+    }
+    benchmark::DoNotOptimize(joined.data());
+  }
+  state.SetItemsProcessed(static_cast<int64>(state.iterations())
+                          * state.range(0));
+}
+
+
+void BM_join(benchmark::State& state) {
+  const std::vector<string> parts(static_cast<std::size_t>(state.range(0)),
+                                  "Grand Piano Bright");
+  for (auto _ : state) {
+    string joined = strings::join(parts, ", ");
+    benchmark::DoNotOptimize(joined.data());
+  }
+  state.SetItemsProcessed(static_cast<int64>(state.iterations())
+                          * state.range(0));
+}
+
+
+/**
+ * Synth parameter names like "Osc12FilterCutoff", and the same names as
+ * users type them (in varying case), for case-insensitive lookups.
+ */
+void makeParamNames(std::size_t numParams, std::vector<string>* names,
+                    std::vector<string>* queries) {
+  const char* const suffixes[] = {"FilterCutoff", "Gain", "EnvelopeAttack",
+                                  "LfoRate"};
+  for (std::size_t i = 0; i < numParams; ++i) {
+    names->push_back("Osc" + std::to_string(i / 4) + suffixes[i % 4]);
+  }
+  for (std::size_t i = 0; i < numParams; ++i) {
+    const string& name = (*names)[(i * 7919) % numParams];
+    queries->push_back((i % 2 == 0) ? strings::toLowerCase(name)
+                                    : strings::toUpperCase(name));
+  }
+}
+
+
+/** Typical case-insensitive lookup: lowercase keys and each query. */
+void BM_paramLookup_lowerCaseCopy(benchmark::State& state) {
+  std::vector<string> names;
+  std::vector<string> queries;
+  makeParamNames(static_cast<std::size_t>(state.range(0)), &names, &queries);
+  std::unordered_map<string, std::size_t> params;
+  for (std::size_t i = 0; i < names.size(); ++i) {
+    params[strings::toLowerCase(names[i])] = i;
+  }
+
+  for (auto _ : state) {
+    for (const string& query : queries) {
+      auto found = params.find(strings::toLowerCase(query));
+      benchmark::DoNotOptimize(found);
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64>(state.iterations())
+                          * state.range(0));
+}
+
+
+void BM_paramLookup_ignoreCase(benchmark::State& state) {
+  std::vector<string> names;
+  std::vector<string> queries;
+  makeParamNames(static_cast<std::size_t>(state.range(0)), &names, &queries);
+  std::unordered_map<string, std::size_t, strings::IgnoreCaseHash,
+                     strings::IgnoreCaseEqual> params;
+  for (std::size_t i = 0; i < names.size(); ++i) {
+    params[names[i]] = i;
+  }
+
+  for (auto _ : state) {
+    for (const string& query : queries) {
+      auto found = params.find(query);
+      benchmark::DoNotOptimize(found);
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64>(state.iterations())
+                          * state.range(0));
+}
+
+
+const std::size_t NUM_NUMBERS = 1024;
+
+
+/** Integers of mixed lengths & signs, as in config or protocol text. */
+std::vector<string> makeIntegerStrings() {
+  std::vector<string> numbers;
+  uint64 state = 12345;
+  for (std::size_t i = 0; i < NUM_NUMBERS; ++i) {
+    state = (state * 6364136223846793005ULL) + 1442695040888963407ULL;
+    const int64 value = static_cast<int64>(state >> (1 + (i % 60)));
+    numbers.push_back(std::to_string((i % 3 == 0) ? -value : value));
+  }
+  return numbers;
+}
+
+
+/** Decimals like "-123.4567" and "6.02e23", as in config text. */
+std::vector<string> makeDecimalStrings() {
+  std::vector<string> numbers;
+  uint64 state = 12345;
+  char buffer[32];
+  for (std::size_t i = 0; i < NUM_NUMBERS; ++i) {
+    state = (state * 6364136223846793005ULL) + 1442695040888963407ULL;
+    const double value = static_cast<double>(state >> 11) / (1ULL << 40);
+    std::snprintf(buffer, sizeof(buffer), (i % 4 == 0) ? "%.6e" : "%.4f",
+                  (i % 3 == 0) ? -value : value);
+    numbers.push_back(buffer);
+  }
+  return numbers;
+}
+
+
+void setNumbersProcessed(benchmark::State& state) {
+  state.SetItemsProcessed(static_cast<int64>(state.iterations())
+                          * static_cast<int64>(NUM_NUMBERS));
+}
+
+
+void BM_parseInt64_strtoll(benchmark::State& state) {
+  const std::vector<string> numbers = makeIntegerStrings();
+  for (auto _ : state) {
+    for (const string& number : numbers) {
+      // Checking errno & the end pointer like parseInt() does.
+      char* end;
+      errno = 0;
+      const long long value = std::strtoll(number.c_str(), &end, 10);
+      const bool ok = (errno == 0) && (*end == '\0') && (end != number.c_str());
+      benchmark::DoNotOptimize(value);
+      benchmark::DoNotOptimize(ok);
+    }
+  }
+  setNumbersProcessed(state);
+}
+
+
+void BM_parseInt64_istringstream(benchmark::State& state) {
+  const std::vector<string> numbers = makeIntegerStrings();
+  for (auto _ : state) {
+    for (const string& number : numbers) {
+      std::istringstream stream(number);
+      int64 value;
+      stream >> value;
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  setNumbersProcessed(state);
+}
+
+
+void BM_parseInt64(benchmark::State& state) {
+  const std::vector<string> numbers = makeIntegerStrings();
+  for (auto _ : state) {
+    for (const string& number : numbers) {
+      Optional<int64> value = strings::parseInt<int64>(number);
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  setNumbersProcessed(state);
+}
+
+
+void BM_parseDouble_stod(benchmark::State& state) {
+  const std::vector<string> numbers = makeDecimalStrings();
+  for (auto _ : state) {
+    for (const string& number : numbers) {
+      double value = std::stod(number);
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  setNumbersProcessed(state);
+}
+
+
+void BM_parseDouble_strtod(benchmark::State& state) {
+  const std::vector<string> numbers = makeDecimalStrings();
+  for (auto _ : state) {
+    for (const string& number : numbers) {
+      char* end;
+      double value = std::strtod(number.c_str(), &end);
+      benchmark::DoNotOptimize(value);
+      benchmark::DoNotOptimize(end);
+    }
+  }
+  setNumbersProcessed(state);
+}
+
+
+void BM_parseDouble_istringstream(benchmark::State& state) {
+  const std::vector<string> numbers = makeDecimalStrings();
+  for (auto _ : state) {
+    for (const string& number : numbers) {
+      std::istringstream stream(number);
+      double value;
+      stream >> value;
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  setNumbersProcessed(state);
+}
+
+
+void BM_parseDouble(benchmark::State& state) {
+  const std::vector<string> numbers = makeDecimalStrings();
+  for (auto _ : state) {
+    for (const string& number : numbers) {
+      Optional<double> value = strings::parseFloat<double>(number);
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  setNumbersProcessed(state);
+}
+
+
+/** The integers of makeIntegerStrings(), for formatting. */
+std::vector<int64> makeIntegers() {
+  std::vector<int64> numbers;
+  for (const string& number : makeIntegerStrings()) {
+    numbers.push_back(std::stoll(number));
+  }
+  return numbers;
+}
+
+
+/** Doubles that need all 17 significant digits, like measurements. */
+std::vector<double> makeDoubles() {
+  std::vector<double> numbers;
+  uint64 state = 12345;
+  for (std::size_t i = 0; i < NUM_NUMBERS; ++i) {
+    state = (state * 6364136223846793005ULL) + 1442695040888963407ULL;
+    const double value = static_cast<double>(state >> 11) / (1ULL << 40);
+    numbers.push_back((i % 3 == 0) ? -value : value);
+  }
+  return numbers;
+}
+
+
+void BM_formatInt64_stringstream(benchmark::State& state) {
+  const std::vector<int64> numbers = makeIntegers();
+  for (auto _ : state) {
+    for (int64 number : numbers) {
+      std::stringstream stream;
+      stream << number;
+      string str = stream.str();
+      benchmark::DoNotOptimize(str);
+    }
+  }
+  setNumbersProcessed(state);
+}
+
+
+void BM_formatInt64_snprintf(benchmark::State& state) {
+  const std::vector<int64> numbers = makeIntegers();
+  char buffer[32];
+  for (auto _ : state) {
+    for (int64 number : numbers) {
+      int length = std::snprintf(buffer, sizeof(buffer), "%lld",
+                                 static_cast<long long>(number));
+      benchmark::DoNotOptimize(length);
+      benchmark::ClobberMemory();
+    }
+  }
+  setNumbersProcessed(state);
+}
+
+
+void BM_formatInt64_toString(benchmark::State& state) {
+  const std::vector<int64> numbers = makeIntegers();
+  for (auto _ : state) {
+    for (int64 number : numbers) {
+      string str = std::to_string(number);
+      benchmark::DoNotOptimize(str);
+    }
+  }
+  setNumbersProcessed(state);
+}
+
+
+void BM_formatInt64(benchmark::State& state) {
+  const std::vector<int64> numbers = makeIntegers();
+  char buffer[strings::MAX_INT_CHARS];
+  for (auto _ : state) {
+    for (int64 number : numbers) {
+      char* end = strings::formatInt(number, buffer);
+      benchmark::DoNotOptimize(end);
+      benchmark::ClobberMemory();
+    }
+  }
+  setNumbersProcessed(state);
+}
+
+
+void BM_formatDouble_stringstream(benchmark::State& state) {
+  const std::vector<double> numbers = makeDoubles();
+  for (auto _ : state) {
+    for (double number : numbers) {
+      std::stringstream stream;
+      stream.precision(17);  // Enough to round-trip.
+      stream << number;
+      string str = stream.str();
+      benchmark::DoNotOptimize(str);
+    }
+  }
+  setNumbersProcessed(state);
+}
+
+
+void BM_formatDouble_snprintf(benchmark::State& state) {
+  const std::vector<double> numbers = makeDoubles();
+  char buffer[32];
+  for (auto _ : state) {
+    for (double number : numbers) {
+      int length = std::snprintf(buffer, sizeof(buffer), "%.17g", number);
+      benchmark::DoNotOptimize(length);
+      benchmark::ClobberMemory();
+    }
+  }
+  setNumbersProcessed(state);
+}
+
+
+void BM_formatDouble_toString(benchmark::State& state) {
+  // Only 6 decimal places, so this doesn't round-trip (unlike the others).
+  const std::vector<double> numbers = makeDoubles();
+  for (auto _ : state) {
+    for (double number : numbers) {
+      string str = std::to_string(number);
+      benchmark::DoNotOptimize(str);
+    }
+  }
+  setNumbersProcessed(state);
+}
+
+
+void BM_formatDouble(benchmark::State& state) {
+  const std::vector<double> numbers = makeDoubles();
+  char buffer[strings::MAX_FLOAT_CHARS];
+  for (auto _ : state) {
+    for (double number : numbers) {
+      char* end = strings::formatFloat(number, buffer);
+      benchmark::DoNotOptimize(end);
+      benchmark::ClobberMemory();
+    }
+  }
+  setNumbersProcessed(state);
+}
+
+
+BENCHMARK(BM_parseConfig_stdString)->Arg(100 << 20);
+BENCHMARK(BM_parseConfig_stringRef)->Arg(100 << 20);
+BENCHMARK(BM_toLowerCase_transform)->RangeMultiplier(8)->Range(8, 1 << 20);
+BENCHMARK(BM_toLowerCase)->RangeMultiplier(8)->Range(8, 1 << 20);
+BENCHMARK(BM_toLowerCaseInto)->RangeMultiplier(8)->Range(8, 1 << 20);
+BENCHMARK(BM_trimWhitespace_byChar)->Arg(4)->Arg(64)->Arg(4096);
+BENCHMARK(BM_trimWhitespace)->Arg(4)->Arg(64)->Arg(4096);
+BENCHMARK(BM_isEmptyOrWhitespace_byChar)->Arg(64)->Arg(1 << 20);
+BENCHMARK(BM_isEmptyOrWhitespace)->Arg(64)->Arg(1 << 20);
+BENCHMARK(BM_trimWhitespace_locale_byChar)->Arg(4)->Arg(64);
+BENCHMARK(BM_trimWhitespace_locale)->Arg(4)->Arg(64);
+BENCHMARK(BM_trimWhitespace_localeTables)->Arg(4)->Arg(64);
+BENCHMARK(BM_toLowerCase_locale_transform)->Arg(64)->Arg(4096);
+BENCHMARK(BM_toLowerCase_locale)->Arg(64)->Arg(4096);
+BENCHMARK(BM_toLowerCase_localeTables)->Arg(64)->Arg(4096);
+BENCHMARK(BM_LocaleTables_construct);
+BENCHMARK(BM_toLowerCaseUtf8_wstringConvert)->DenseRange(0, 2);
+BENCHMARK(BM_toLowerCaseUtf8)->DenseRange(0, 2);
+BENCHMARK(BM_foldCase)->DenseRange(0, 2);
+BENCHMARK(BM_trimUnicodeWhitespace)->DenseRange(0, 2);
+BENCHMARK(BM_splitCsv_substr)->Arg(500 << 20);
+BENCHMARK(BM_splitCsv_split)->Arg(500 << 20);
+BENCHMARK(BM_splitCsv_splitTrimmed)->Arg(500 << 20);
+BENCHMARK(BM_splitCsv_characterSet)->Arg(500 << 20);
+BENCHMARK(BM_join_append)->Arg(16)->Arg(4096);
+BENCHMARK(BM_join)->Arg(16)->Arg(4096);
+BENCHMARK(BM_paramLookup_lowerCaseCopy)->Arg(16)->Arg(1024);
+BENCHMARK(BM_paramLookup_ignoreCase)->Arg(16)->Arg(1024);
+BENCHMARK(BM_parseInt64_strtoll);
+BENCHMARK(BM_parseInt64_istringstream);
+BENCHMARK(BM_parseInt64);
+BENCHMARK(BM_parseDouble_stod);
+BENCHMARK(BM_parseDouble_strtod);
+BENCHMARK(BM_parseDouble_istringstream);
+BENCHMARK(BM_parseDouble);
+BENCHMARK(BM_formatInt64_stringstream);
+BENCHMARK(BM_formatInt64_snprintf);
+BENCHMARK(BM_formatInt64_toString);
+BENCHMARK(BM_formatInt64);
+BENCHMARK(BM_formatDouble_stringstream);
+BENCHMARK(BM_formatDouble_snprintf);
+BENCHMARK(BM_formatDouble_toString);
+BENCHMARK(BM_formatDouble);
+
+
+}  // namespace
@@ -12,6 +12,8 @@
 ## See the License for the specific language governing permissions and
 ## limitations under the License.
 
+import os
+
 import conans
 
 
@@ -37,6 +39,7 @@ class OOMuseCoreConan(conans.ConanFile):
   #=============================================================================
 
   options = {
+    "benchmarking": [False, True],
     "include_pdbs": [False, True],
     "testing": [False, True],
   }
@@ -47,7 +50,8 @@ class OOMuseCoreConan(conans.ConanFile):
 
   # Note that gtest in shared mode produces compiler warnings, so link against
   # as a static library so this build can treat warnings as errors.
-  default_options = "include_pdbs=False", "testing=False", "gtest:shared=False"
+  default_options = ("benchmarking=False", "include_pdbs=False", "testing=False",
+                     "gtest:shared=False")
 
 
   #=============================================================================
@@ -58,6 +62,8 @@ class OOMuseCoreConan(conans.ConanFile):
     """Defines the conan.io packages required to build & test this package."""
     if self.options.testing:
       self.requires("gtest/1.8.0@lasote/stable")
+    if self.options.benchmarking:
+      self.requires("benchmark/1.5.0")
 
   def imports(self):
     """Copies dynamic libs from deps needed to run & test this package."""
@@ -77,15 +83,22 @@ class OOMuseCoreConan(conans.ConanFile):
     cmake = conans.CMake(self.settings)
 
     cmake_test_def = "-DOOMUSE_CORE_TESTING=1" if self.options.testing else ""
-    self.run("cmake %s %s %s" % (self.conanfile_directory,
-                                 cmake.command_line,
-                                 cmake_test_def))
+    cmake_bench_def = ("-DOOMUSE_CORE_BENCHMARKING=1"
+                       if self.options.benchmarking else "")
+    self.run("cmake %s %s %s %s" % (self.conanfile_directory,
+                                    cmake.command_line,
+                                    cmake_test_def,
+                                    cmake_bench_def))
     self.run("cmake --build . %s" % cmake.build_config)
 
     # If testing, run unit tests to make sure library works before packaging.
     if self.options.testing:
       self.run("ctest -C %s --output-on-failure" % self.settings.build_type)
 
+    # If benchmarking, run benchmarks (best with -s build_type=Release).
+    if self.options.benchmarking:
+      self.run(os.path.join(".", "bin", "oomuse-core_bench"))
+
 
   #=============================================================================
   # Configuring this built package for clients to depend on and use
@@ -0,0 +1,263 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OOMUSE_CORE_BATCHVALIDATOR_H
+#define OOMUSE_CORE_BATCHVALIDATOR_H
+
+#include <cassert>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "oomuse/core/FixedArray.h"
+#include "oomuse/core/Optional.h"
+#include "oomuse/core/Validator.h"
+#include "oomuse/core/bits.h"
+#include "oomuse/core/int_types.h"
+#include "oomuse/core/readability_macros.h"
+
+namespace oomuse {
+
+
+template<typename T>
+class BatchValidator;
+
+
+/**
+ * Pass/fail results for a whole batch of values: a packed bitmap (bit i % 64
+ * of word i / 64 is set iff value i passed), plus the number of failures and
+ * the index of the first one.
+ */
+class BatchValidationResult {
+ public:
+  /** Moves another result into this newly constructed one. */
+  BatchValidationResult(BatchValidationResult&& other) = default;
+
+  /** Returns the number of values that were checked. */
+  std::size_t length() const { return length_; }
+
+  /** Returns true if the value at the given index passed. */
+  bool isValid(std::size_t index) const {
+    assert(index < length_);
+    return ((validBits_[index / 64] >> (index % 64)) & 1) != 0;
+  }
+
+  /** Returns true if every value passed. */
+  bool allValid() const { return (numFailures_ == 0); }
+
+  /** Returns the number of values that failed. */
+  std::size_t numFailures() const { return numFailures_; }
+
+  /** Returns the index of the first value that failed, if any. */
+  Optional<std::size_t> firstFailure() const { return firstFailure_; }
+
+  /** Returns the packed pass/fail bits, (length() + 63) / 64 words long. */
+  const FixedArray<uint64>& validBits() const { return validBits_; }
+
+ private:
+  CANT_COPY(BatchValidationResult);
+
+  // Set BatchValidator as a friend so that only it can construct this type.
+  template<typename T>
+  friend class BatchValidator;
+
+  explicit BatchValidationResult(std::size_t length)
+      : validBits_((length + 63) / 64, FixedArray<uint64>::SKIP_DEFAULT_INIT),
+        length_(length), numFailures_(0) {}
+
+  FixedArray<uint64> validBits_;
+  std::size_t length_;
+  std::size_t numFailures_;
+  Optional<std::size_t> firstFailure_;
+};
+
+
+/**
+ * Checks whole arrays of values against a Validator at once, through
+ * Validator::markValid() (which comparison validators implement with
+ * vectorizable compares), instead of one virtual call per value. Very large
+ * batches can be split across threads; results don't depend on how, since
+ * each thread fills in its own range of the bitmap. The Validator must be
+ * safe to call from multiple threads at once (all the standard ones are).
+ *
+ *   BatchValidator<float> isSample(*Validators<float>::allOf(
+ *       Validators<float>::greaterOrEqual(-1.0f),
+ *       Validators<float>::lessOrEqual(1.0f)));
+ *   BatchValidationResult result = isSample.validate(samples);
+ *   if (!result.allValid()) {
+ *     reportError(result.firstFailure().value(), ...);
+ *   }
+ */
+template<typename T>
+class BatchValidator {
+ public:
+  /** Default for the minimum number of values worth a separate thread. */
+  static const std::size_t DEFAULT_MIN_VALUES_PER_THREAD = 1 << 18;
+
+  /**
+   * Constructs a BatchValidator that checks values against validator (which
+   * must outlive this), split across up to maxThreads threads (including the
+   * calling one) for batches of at least 2 * minValuesPerThread values.
+   */
+  explicit BatchValidator(
+      const Validator<T>& validator, std::size_t maxThreads = 1,
+      std::size_t minValuesPerThread = DEFAULT_MIN_VALUES_PER_THREAD)
+      : validator_(validator), maxThreads_(maxThreads),
+        minValuesPerThread_(minValuesPerThread) {
+    assert(maxThreads >= 1);
+  }
+
+  /** Checks every value in the given array. */
+  template<typename Allocator>
+  BatchValidationResult validate(const FixedArray<T, Allocator>& values) const {
+    return validate(values.data(), values.length());
+  }
+
+  /** Checks the given length values. */
+  BatchValidationResult validate(const T* values, std::size_t length) const {
+    BatchValidationResult result(length);
+    if (length == 0) {
+      return result;
+    }
+
+    // Split on 64-value word boundaries, so threads never share a word.
+    const std::size_t numWords = result.validBits_.length();
+    const std::size_t numThreads = chooseNumThreads(length);
+    const std::size_t wordsPerThread = (numWords + numThreads - 1) / numThreads;
+    std::vector<std::size_t> numValid(numThreads, 0);
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    // If starting a thread (or validating on this one) throws, the threads
+    // already started must still be joined before they're destroyed.
+    ThreadJoiner joiner(&threads);
+    for (std::size_t i = 0; i < numThreads; ++i) {
+      const std::size_t firstWord = i * wordsPerThread;
+      const std::size_t endWord =
+          (firstWord + wordsPerThread < numWords) ? (firstWord + wordsPerThread)
+                                                  : numWords;
+      if (firstWord >= endWord) {
+        break;
+      }
+
+      const T* rangeValues = values + (firstWord * 64);
+      const std::size_t rangeLength =
+          ((endWord * 64 < length) ? (endWord * 64) : length)
+          - (firstWord * 64);
+      uint64* rangeBits = result.validBits_.data() + firstWord;
+      std::size_t* rangeNumValid = &numValid[i];
+      auto validateRange = [this, rangeValues, rangeLength, rangeBits,
+                            rangeNumValid]() {
+        validator_.markValid(rangeValues, rangeLength, rangeBits);
+        *rangeNumValid = countBits(rangeBits, (rangeLength + 63) / 64);
+      };
+
+      if (i + 1 < numThreads) {
+        threads.emplace_back(validateRange);
+      } else {
+        validateRange();  // Use the calling thread for the last range.
+      }
+    }
+    joiner.joinAll();
+
+    // Aggregate in index order, so results are deterministic.
+    std::size_t totalValid = 0;
+    for (std::size_t count : numValid) {
+      totalValid += count;
+    }
+    result.numFailures_ = length - totalValid;
+    if (result.numFailures_ > 0) {
+      result.firstFailure_ = findFirstFailure(result.validBits_, length);
+    }
+
+    return result;
+  }
+
+ private:
+  CANT_COPY(BatchValidator);
+
+  /** Joins all (joinable) threads on joinAll() or destruction. */
+  class ThreadJoiner {
+   public:
+    explicit ThreadJoiner(std::vector<std::thread>* threads)
+        : threads_(threads) {}
+
+    ~ThreadJoiner() { joinAll(); }
+
+    void joinAll() {
+      for (auto& thread : *threads_) {
+        if (thread.joinable()) {
+          thread.join();
+        }
+      }
+    }
+
+   private:
+    CANT_COPY(ThreadJoiner);
+
+    std::vector<std::thread>* threads_;
+  };
+
+  std::size_t chooseNumThreads(std::size_t length) const {
+    const std::size_t maxUseful =
+        (minValuesPerThread_ > 0) ? (length / minValuesPerThread_) : length;
+    if (maxUseful < 2) {
+      return 1;
+    }
+    return (maxUseful < maxThreads_) ? maxUseful : maxThreads_;
+  }
+
+  static std::size_t countBits(const uint64* words, std::size_t numWords) {
+    std::size_t numBits = 0;
+    for (std::size_t i = 0; i < numWords; ++i) {
+      numBits += bits::countBits(words[i]);
+    }
+    return numBits;
+  }
+
+  static std::size_t findFirstFailure(const FixedArray<uint64>& validBits,
+                                      std::size_t length) {
+    for (std::size_t word = 0; word < validBits.length(); ++word) {
+      // Unused bits past the end are 0, so mask them off as "valid".
+      const std::size_t numBits =
+          (length - (word * 64) < 64) ? (length - (word * 64)) : 64;
+      const uint64 usedBits = (numBits == 64)
+          ? ~static_cast<uint64>(0) : ((static_cast<uint64>(1) << numBits) - 1);
+      const uint64 failedBits = ~validBits[word] & usedBits;
+      if (failedBits != 0) {
+        std::size_t bit = 0;
+        while (((failedBits >> bit) & 1) == 0) {
+          ++bit;
+        }
+        return (word * 64) + bit;
+      }
+    }
+    assert(false);  // Only called if there's a failure.
+    return length;
+  }
+
+  const Validator<T>& validator_;
+  const std::size_t maxThreads_;
+  const std::size_t minValuesPerThread_;
+};
+
+
+template<typename T>
+const std::size_t BatchValidator<T>::DEFAULT_MIN_VALUES_PER_THREAD;
+
+
+}  // namespace oomuse
+
+#endif  // OOMUSE_CORE_BATCHVALIDATOR_H
@@ -0,0 +1,145 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OOMUSE_CORE_CHARACTERSET_H
+#define OOMUSE_CORE_CHARACTERSET_H
+
+#include <cstddef>
+#include <string>
+
+#include "oomuse/core/int_types.h"
+
+namespace oomuse {
+
+
+/**
+ * A set of allowed bytes (e.g. for names or tags), stored as a 256-bit bitmap
+ * so that checking a byte is a shift & mask. For example:
+ *
+ *   CharacterSet tagChars = CharacterSet::range('a', 'z')
+ *       | CharacterSet::range('0', '9') | CharacterSet("-_");
+ */
+class CharacterSet {
+ public:
+  /** Constructs an empty CharacterSet. */
+  CharacterSet() : bits_{0, 0, 0, 0} {}
+
+  /** Constructs a CharacterSet containing each character of characters. */
+  explicit CharacterSet(const std::string& characters)
+      : bits_{0, 0, 0, 0} {
+    for (char c : characters) {
+      add(c);
+    }
+  }
+
+  /** Returns a CharacterSet containing first through last (inclusive). */
+  static CharacterSet range(char first, char last) {
+    CharacterSet characterSet;
+    for (uint32 c = toByte(first); c <= toByte(last); ++c) {
+      characterSet.add(static_cast<char>(c));
+    }
+    return characterSet;
+  }
+
+  /** Adds c to this set. */
+  CharacterSet& add(char c) {
+    bits_[toByte(c) / 64] |= bitFor(c);
+    return *this;
+  }
+
+  /** Returns true if c is in this set. */
+  bool contains(char c) const {
+    return (bits_[toByte(c) / 64] & bitFor(c)) != 0;
+  }
+
+  /** Returns true if every character of str is in this set. */
+  bool containsAll(const std::string& str) const {
+    const char* chars = str.data();
+    const std::size_t length = str.length();
+    std::size_t i = 0;
+
+    // AND together 8 lookups at a time, so there's only one branch per 8.
+    for (; i + 8 <= length; i += 8) {
+      const bool allContained = contains(chars[i]) & contains(chars[i + 1])
+          & contains(chars[i + 2]) & contains(chars[i + 3])
+          & contains(chars[i + 4]) & contains(chars[i + 5])
+          & contains(chars[i + 6]) & contains(chars[i + 7]);
+      if (!allContained) {
+        return false;
+      }
+    }
+    for (; i < length; ++i) {
+      if (!contains(chars[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Copies up to maxChars members of this set (lowest bytes first) to chars,
+   * and returns the total number of members.
+   */
+  std::size_t copyMembers(char* chars, std::size_t maxChars) const {
+    std::size_t numMembers = 0;
+    for (std::size_t i = 0; i < 4; ++i) {
+      for (uint64 bits = bits_[i]; bits != 0; bits &= (bits - 1)) {
+        if (numMembers < maxChars) {
+          chars[numMembers] =
+              static_cast<char>((i * 64) + countTrailingZeros(bits));
+        }
+        ++numMembers;
+      }
+    }
+    return numMembers;
+  }
+
+  /** Returns the union of two CharacterSets. */
+  friend CharacterSet operator|(const CharacterSet& a, const CharacterSet& b) {
+    CharacterSet both;
+    for (std::size_t i = 0; i < 4; ++i) {
+      both.bits_[i] = a.bits_[i] | b.bits_[i];
+    }
+    return both;
+  }
+
+ private:
+  static uint32 toByte(char c) { return static_cast<uint8>(c); }
+
+  static uint64 bitFor(char c) {
+    return static_cast<uint64>(1) << (toByte(c) % 64);
+  }
+
+  /** Returns the index of the lowest set bit of (nonzero) bits. */
+  static std::size_t countTrailingZeros(uint64 bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_ctzll(bits));
+#else
+    std::size_t index = 0;
+    for (; (bits & 1) == 0; bits >>= 1) {
+      ++index;
+    }
+    return index;
+#endif
+  }
+
+  uint64 bits_[4];
+};
+
+
+}  // namespace oomuse
+
+#endif  // OOMUSE_CORE_CHARACTERSET_H
@@ -0,0 +1,357 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OOMUSE_CORE_INSTRUMENTEDVALIDATOR_H
+#define OOMUSE_CORE_INSTRUMENTEDVALIDATOR_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "oomuse/core/StringBuilder.h"
+#include "oomuse/core/Validator.h"
+#include "oomuse/core/int_types.h"
+#include "oomuse/core/readability_macros.h"
+
+namespace oomuse {
+
+
+class ValidatorStats;
+class ValidatorStatsRegistry;
+
+
+/**
+ * Point-in-time totals for one named validator: how often it was called, how
+ * often it rejected a value, and a histogram of call latencies.
+ */
+class ValidatorStatsSnapshot {
+ public:
+  /**
+   * Number of latency histogram buckets. Bucket 0 counts calls that took 0 ns
+   * (below clock resolution), and bucket i > 0 counts calls that took
+   * [2^(i - 1), 2^i) ns. The last bucket also counts anything slower.
+   */
+  static const std::size_t NUM_LATENCY_BUCKETS = 32;
+
+  /** Name the validator was instrumented under. */
+  const std::string& name() const { return name_; }
+
+  /** Number of values checked. */
+  uint64 numCalls() const { return numCalls_; }
+
+  /** Number of values that failed validation. */
+  uint64 numFailures() const { return numFailures_; }
+
+  /** Returns numFailures() / numCalls(), or 0 if never called. */
+  double failureRate() const {
+    return (numCalls_ > 0) ? (static_cast<double>(numFailures_) / numCalls_)
+                           : 0.0;
+  }
+
+  /**
+   * Number of timed calls in each latency bucket (see NUM_LATENCY_BUCKETS).
+   * Only a sample of calls are timed (see ValidatorStats).
+   */
+  const std::array<uint64, NUM_LATENCY_BUCKETS>& latencyHistogram() const {
+    return latencyHistogram_;
+  }
+
+  /**
+   * Returns an upper bound (in ns) on the given latency percentile (in [0,
+   * 100]) of timed calls, from the histogram bucket it falls in; 0 if none.
+   */
+  uint64 latencyPercentileNanos(double percentile) const;
+
+ private:
+  // Set ValidatorStats as a friend so that only it can construct this type.
+  friend class ValidatorStats;
+
+  explicit ValidatorStatsSnapshot(const std::string& name)
+      : name_(name), numCalls_(0), numFailures_(0), latencyHistogram_() {}
+
+  std::string name_;
+  uint64 numCalls_;
+  uint64 numFailures_;
+  std::array<uint64, NUM_LATENCY_BUCKETS> latencyHistogram_;
+};
+
+
+/**
+ * Live counters for one named validator (see InstrumentedValidator). Counters
+ * are sharded, with each thread always writing to the same shard (padded onto
+ * its own cache lines), so that validating from many threads at once doesn't
+ * contend on a single shared counter.
+ *
+ * Calls and failures are always counted, but reading the clock costs more
+ * than most validators do, so only every LATENCY_SAMPLE_INTERVAL-th call on
+ * each thread gets timed for the latency histogram.
+ */
+class ValidatorStats {
+ public:
+  /** Number of counter shards that threads get spread across. */
+  static const std::size_t NUM_SHARDS = 16;
+
+  /** One of every this many calls (per thread) gets timed. */
+  static const uint32 LATENCY_SAMPLE_INTERVAL = 16;
+
+  /** Name the validator was instrumented under. */
+  const std::string& name() const { return name_; }
+
+  /** Returns true if the owning registry is currently recording. */
+  bool isEnabled() const {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  /** Returns true if the current thread's next call should be timed. */
+  static bool shouldTimeNextCall();
+
+  /** Records one untimed call. */
+  void record(bool isValid);
+
+  /** Records one timed call. */
+  void record(bool isValid, uint64 latencyNanos);
+
+  /**
+   * Records a batch of length values checked in one call (see
+   * Validator::markValid()), counting failures from validBits. Batches are
+   * always timed, with each value counted in the histogram at the batch's
+   * average latency per value.
+   */
+  void recordBatch(const uint64* validBits, std::size_t length,
+                   uint64 latencyNanos);
+
+  /**
+   * Sums up all shards. Calls still in progress on other threads may or may
+   * not be included.
+   */
+  ValidatorStatsSnapshot snapshot() const;
+
+  /** Sets all counters back to 0. */
+  void reset();
+
+ private:
+  CANT_COPY(ValidatorStats);
+  CANT_MOVE(ValidatorStats);
+
+  // Set ValidatorStatsRegistry as a friend so that only it can construct this
+  // type.
+  friend class ValidatorStatsRegistry;
+
+  ValidatorStats(const std::string& name, const std::atomic<bool>& enabled);
+
+  struct Shard {
+    std::atomic<uint64> numCalls;
+    std::atomic<uint64> numFailures;
+    std::atomic<uint64>
+        latencyHistogram[ValidatorStatsSnapshot::NUM_LATENCY_BUCKETS];
+
+    // Keeps neighboring shards' counters off of this shard's cache lines,
+    // without relying on over-aligned new (which C++14 doesn't guarantee).
+    char padding[64];
+  };
+
+  const std::string name_;
+  const std::atomic<bool>& enabled_;
+  std::unique_ptr<Shard[]> shards_;
+};
+
+
+/**
+ * Owns the ValidatorStats for a set of named validators. Recording can be
+ * turned on and off at runtime (it starts enabled); while off, instrumented
+ * validators only pay for one relaxed atomic load per call.
+ */
+class ValidatorStatsRegistry {
+ public:
+  /** Constructs a new, empty, enabled registry. */
+  ValidatorStatsRegistry() : enabled_(true) {}
+
+  /** Returns the process-wide registry that instrument() uses by default. */
+  static ValidatorStatsRegistry& global();
+
+  /** Turns recording on or off for all validators in this registry. */
+  void setEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+
+  /** Returns true if recording is on. */
+  bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  /**
+   * Returns the stats for the given name, creating them if needed. Validators
+   * instrumented under the same name share stats. The returned reference
+   * stays valid for the lifetime of this registry.
+   */
+  ValidatorStats& statsFor(const std::string& name);
+
+  /** Returns snapshots of all stats, sorted by name. */
+  std::vector<ValidatorStatsSnapshot> snapshot() const;
+
+  /**
+   * Returns a human-readable summary, one line per validator, e.g.:
+   *   midiNote: 1000 calls, 25 failures (2.5%), p50 <= 16 ns, p99 <= 64 ns
+   */
+  std::string dump() const;
+
+  /** Sets all counters back to 0 (keeping the named stats). */
+  void reset();
+
+ private:
+  CANT_COPY(ValidatorStatsRegistry);
+
+  std::atomic<bool> enabled_;
+  mutable std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<ValidatorStats>> statsByName_;
+};
+
+
+/**
+ * Decorator that forwards to another Validator, recording call counts,
+ * failure counts, and latencies into ValidatorStats. Use instrument() to
+ * create one:
+ *
+ *   auto isMidiNote = instrument("midiNote", Validators<int32>::allOf(
+ *       Validators<int32>::greaterOrEqual(0), Validators<int32>::less(128)));
+ *   ...
+ *   std::cerr << ValidatorStatsRegistry::global().dump();
+ */
+template<typename T>
+class InstrumentedValidator : public Validator<T> {
+ public:
+  /** Wraps validator, recording into stats (which must outlive this). */
+  InstrumentedValidator(std::unique_ptr<Validator<T>> validator,
+                        ValidatorStats& stats)
+      : validator_(std::move(validator)), stats_(stats) {}
+
+  virtual bool isValid(const T& value) const {
+    if (!stats_.isEnabled()) {
+      return validator_->isValid(value);
+    }
+
+    if (!ValidatorStats::shouldTimeNextCall()) {
+      const bool isValidValue = validator_->isValid(value);
+      stats_.record(isValidValue);
+      return isValidValue;
+    }
+
+    const auto start = Clock::now();
+    const bool isValidValue = validator_->isValid(value);
+    stats_.record(isValidValue, nanosSince(start));
+    return isValidValue;
+  }
+
+  virtual ValidationErrorCode checkValidationErrorCode(const T& value) const {
+    if (!stats_.isEnabled()) {
+      return validator_->checkValidationErrorCode(value);
+    }
+
+    if (!ValidatorStats::shouldTimeNextCall()) {
+      const ValidationErrorCode errorCode =
+          validator_->checkValidationErrorCode(value);
+      stats_.record(errorCode == ValidationErrorCode::NONE);
+      return errorCode;
+    }
+
+    const auto start = Clock::now();
+    const ValidationErrorCode errorCode =
+        validator_->checkValidationErrorCode(value);
+    stats_.record(errorCode == ValidationErrorCode::NONE, nanosSince(start));
+    return errorCode;
+  }
+
+  virtual std::string checkValidationErrors(const T& value) const {
+    if (!stats_.isEnabled()) {
+      return validator_->checkValidationErrors(value);
+    }
+
+    // Always timed, since formatting messages is slow anyway.
+    const auto start = Clock::now();
+    std::string validationErrors = validator_->checkValidationErrors(value);
+    stats_.record(validationErrors.empty(), nanosSince(start));
+    return validationErrors;
+  }
+
+  virtual void appendValidationErrors(const T& value,
+                                      StringBuilder& out) const {
+    if (!stats_.isEnabled()) {
+      validator_->appendValidationErrors(value, out);
+      return;
+    }
+
+    const auto start = Clock::now();
+    const std::size_t lengthBefore = out.length();
+    validator_->appendValidationErrors(value, out);
+    stats_.record(out.length() == lengthBefore, nanosSince(start));
+  }
+
+  virtual void markValid(const T* values, std::size_t length,
+                         uint64* validBits) const {
+    if (!stats_.isEnabled()) {
+      validator_->markValid(values, length, validBits);
+      return;
+    }
+
+    const auto start = Clock::now();
+    validator_->markValid(values, length, validBits);
+    stats_.recordBatch(validBits, length, nanosSince(start));
+  }
+
+ private:
+  CANT_COPY(InstrumentedValidator);
+
+  using Clock = std::chrono::steady_clock;
+
+  static uint64 nanosSince(Clock::time_point start) {
+    return static_cast<uint64>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - start).count());
+  }
+
+  const std::unique_ptr<Validator<T>> validator_;
+  ValidatorStats& stats_;
+};
+
+
+/**
+ * Wraps validator to record stats under the given name in registry (see
+ * InstrumentedValidator). When built with OOMUSE_CORE_NO_VALIDATOR_STATS
+ * defined, this returns validator itself, for no overhead at all.
+ */
+template<typename T>
+std::unique_ptr<Validator<T>> instrument(
+    const std::string& name, std::unique_ptr<Validator<T>> validator,
+    ValidatorStatsRegistry& registry = ValidatorStatsRegistry::global()) {
+#ifdef OOMUSE_CORE_NO_VALIDATOR_STATS
+  UNREF_PARAM(name);
+  UNREF_PARAM(registry);
+  return validator;
+#else
+  return std::make_unique<InstrumentedValidator<T>>(std::move(validator),
+                                                    registry.statsFor(name));
+#endif
+}
+
+
+}  // namespace oomuse
+
+#endif  // OOMUSE_CORE_INSTRUMENTEDVALIDATOR_H
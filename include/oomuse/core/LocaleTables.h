@@ -0,0 +1,74 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OOMUSE_CORE_LOCALETABLES_H
+#define OOMUSE_CORE_LOCALETABLES_H
+
+#include <locale>
+
+#include "oomuse/core/int_types.h"
+
+namespace oomuse {
+
+
+/**
+ * Whitespace classification and case mapping for every char value in a
+ * std::locale, precomputed from its std::ctype<char> facet. Each lookup is
+ * then a plain table read, instead of a facet lookup (with locking and
+ * reference counting) per char like std::isspace(c, loc). Build one up front
+ * and reuse it; see the LocaleTables overloads in strings.h.
+ *
+ *   LocaleTables tables(userLocale);
+ *   for (const std::string& line : lines) {
+ *     process(strings::trimWhitespace(line, tables));
+ *   }
+ *
+ * Only copies the tables; doesn't keep a reference to the locale.
+ */
+class LocaleTables {
+ public:
+  /** Builds tables from loc's std::ctype<char> facet. */
+  explicit LocaleTables(const std::locale& loc);
+
+  /** Returns the same as std::isspace(c, loc). */
+  bool isSpace(char c) const { return (isSpace_[toIndex(c)] != 0); }
+
+  /** Returns the same as std::tolower(c, loc). */
+  char toLower(char c) const { return toLower_[toIndex(c)]; }
+
+  /** Returns the same as std::toupper(c, loc). */
+  char toUpper(char c) const { return toUpper_[toIndex(c)]; }
+
+  /**
+   * Returns true if ASCII chars (< 0x80) classify and convert the same as in
+   * the default "C" locale (true for almost all locales), so that ASCII runs
+   * can take the same fast paths as the non-locale strings functions.
+   */
+  bool hasStandardAscii() const { return hasStandardAscii_; }
+
+ private:
+  static uint8 toIndex(char c) { return static_cast<uint8>(c); }
+
+  uint8 isSpace_[256];
+  char toLower_[256];
+  char toUpper_[256];
+  bool hasStandardAscii_;
+};
+
+
+}  // namespace oomuse
+
+#endif  // OOMUSE_CORE_LOCALETABLES_H
@@ -18,30 +18,244 @@
 #define OOMUSE_CORE_OPTIONAL_H
 
 #include <cassert>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
 
+#include "oomuse/core/constexpr_assert.h"
 #include "oomuse/core/int_types.h"
 
 namespace oomuse {
 
 
-/** Base template class for Optional (don't use directly). */
-template<uint64 numBytes>
+template<typename T, typename Policy>
+class Optional;
+
+
+/**
+ * Default Optional policy, which tracks whether a value is present with a
+ * separate hasValue flag. Works for any value type.
+ */
+struct FlagOptionalPolicy {};
+
+
+/**
+ * Compact Optional policy for floating point types, which uses a quiet NaN to
+ * represent the empty state. NaN values therefore can't be stored.
+ */
+template<typename T>
+struct NanOptionalPolicy {
+  static_assert(std::numeric_limits<T>::has_quiet_NaN,
+                "NanOptionalPolicy requires a type with a quiet NaN");
+
+  static constexpr T emptyValue() {
+    return std::numeric_limits<T>::quiet_NaN();
+  }
+  static constexpr bool isEmpty(const T& value) { return value != value; }
+};
+
+
+/**
+ * Compact Optional policy for pointer types, which uses nullptr to represent
+ * the empty state. Null pointers therefore can't be stored.
+ */
+template<typename T>
+struct NullOptionalPolicy {
+  static_assert(std::is_pointer<T>::value,
+                "NullOptionalPolicy requires a pointer type");
+
+  static constexpr T emptyValue() { return nullptr; }
+  static constexpr bool isEmpty(const T& value) { return value == nullptr; }
+};
+
+
+/**
+ * Compact Optional policy for integral (or enum) types, which uses a
+ * user-declared invalidValue to represent the empty state. For example,
+ * Optional<int32, SentinelOptionalPolicy<int32, -1>> for a non-negative index.
+ */
+template<typename T, T invalidValue>
+struct SentinelOptionalPolicy {
+  static constexpr T emptyValue() { return invalidValue; }
+  static constexpr bool isEmpty(const T& value) {
+    return value == invalidValue;
+  }
+};
+
+
+/**
+ * Base template class for Optional with a sentinel policy (don't use
+ * directly). The value is always stored, with the policy's sentinel value
+ * meaning empty.
+ */
+template<typename T, typename Policy,
+         bool isTrivial = std::is_trivially_copyable<T>::value>
 class OptionalStorage {
+ private:
+  static_assert(isTrivial,
+                "Sentinel Optional policies require trivial value types");
+
+  // Set Optional as a friend so that only it can construct this type.
+  template<typename U, typename P>
+  friend class Optional;
+
+  constexpr OptionalStorage() : value_(Policy::emptyValue()) {}
+
+  constexpr OptionalStorage(const T& value)
+      : value_(CONSTEXPR_ASSERT(!Policy::isEmpty(value),
+                                "can't store the sentinel value", value)) {}
+
+  constexpr bool hasStoredValue() const { return !Policy::isEmpty(value_); }
+
+  constexpr const T& storedValue() const { return value_; }
+  constexpr T& storedValue() { return value_; }
+
+  void constructValue(const T& value) {
+    assert(!Policy::isEmpty(value));  // Can't store the sentinel itself.
+    value_ = value;
+  }
+
+  void destroyValue() { value_ = Policy::emptyValue(); }
+
+  T value_;
+};
+
+
+/**
+ * Base template class for Optional with the default policy and a trivial value
+ * type (don't use directly). Trivially copyable & destructible itself, so that
+ * Optional can be used in constexpr contexts.
+ */
+template<typename T>
+class OptionalStorage<T, FlagOptionalPolicy, true> {
  private:
   // Set Optional as a friend so that only it can construct this type.
-  template<typename T>
+  template<typename U, typename P>
   friend class Optional;
 
-  OptionalStorage() : hasValue_(false) {}
+  constexpr OptionalStorage() : empty_(), hasValue_(false) {}
+
+  constexpr OptionalStorage(const T& value) : value_(value), hasValue_(true) {}
+
+  constexpr bool hasStoredValue() const { return hasValue_; }
+
+  constexpr const T& storedValue() const { return value_; }
+  constexpr T& storedValue() { return value_; }
+
+  void constructValue(const T& value) {
+    new (&value_) T(value);
+    hasValue_ = true;
+  }
 
-  uint8 data_[numBytes];
+  void destroyValue() { hasValue_ = false; }
+
+  // The union gives value_ the correct size & alignment for T, without
+  // constructing it until a value is set.
+  union {
+    uint8 empty_;
+    T value_;
+  };
+  bool hasValue_;
+};
+
+
+/**
+ * Base template class for Optional with the default policy and a non-trivial
+ * value type (don't use directly). Constructs & destructs the value in place.
+ */
+template<typename T>
+class OptionalStorage<T, FlagOptionalPolicy, false> {
+ private:
+  // Set Optional as a friend so that only it can construct this type.
+  template<typename U, typename P>
+  friend class Optional;
+
+  OptionalStorage() : empty_(), hasValue_(false) {}
+
+  OptionalStorage(const T& value) : value_(value), hasValue_(true) {}
+
+  OptionalStorage(const OptionalStorage& other) : empty_(), hasValue_(false) {
+    if (other.hasValue_) {
+      constructValue(other.value_);
+    }
+  }
+
+  OptionalStorage(OptionalStorage&& other) : empty_(), hasValue_(false) {
+    if (other.hasValue_) {
+      new (&value_) T(std::move(other.value_));
+      hasValue_ = true;
+    }
+  }
+
+  OptionalStorage& operator=(const OptionalStorage& other) {
+    if (this != &other) {
+      if (hasValue_) {
+        destroyValue();
+      }
+      if (other.hasValue_) {
+        constructValue(other.value_);
+      }
+    }
+    return *this;
+  }
+
+  OptionalStorage& operator=(OptionalStorage&& other) {
+    if (this != &other) {
+      if (hasValue_) {
+        destroyValue();
+      }
+      if (other.hasValue_) {
+        new (&value_) T(std::move(other.value_));
+        hasValue_ = true;
+      }
+    }
+    return *this;
+  }
+
+  ~OptionalStorage() {
+    if (hasValue_) {
+      destroyValue();
+    }
+  }
+
+  bool hasStoredValue() const { return hasValue_; }
+
+  const T& storedValue() const { return value_; }
+  T& storedValue() { return value_; }
+
+  void constructValue(const T& value) {
+    // Use placement new to construct value within the union.
+    new (&value_) T(value);
+    hasValue_ = true;
+  }
+
+  void destroyValue() {
+    // Placement new requires calling destructor explicitly.
+    value_.~T();
+    hasValue_ = false;
+  }
+
+  union {
+    uint8 empty_;
+    T value_;
+  };
   bool hasValue_;
 };
 
 
 /**
  * Represents an optional value, which may not be present. The value is stored
- * within this Optional object (via placement new).
+ * within this Optional object (via placement new), with the size & alignment
+ * of T.
+ *
+ * By default, presence is tracked with a separate flag, so Optional<T> is
+ * larger than T. A compact policy (see CompactOptional below, or
+ * SentinelOptionalPolicy) instead reserves one value of T to mean "empty", so
+ * that sizeof(Optional<T, Policy>) == sizeof(T).
+ *
+ * For trivially copyable T, Optional is itself a literal type, so it can be
+ * constructed and read in constexpr contexts (e.g. compile-time tables).
  *
  * This class is inspired by boost's optional type and the optional type
  * discussed in Mike McShaffry's Game Coding Complete, 3rd Edition.
@@ -50,77 +264,75 @@ class OptionalStorage {
  * std::optional, once that gets fully incorporated into the C++ Standard
  * Library.
  */
-template<typename T>
-class Optional : private OptionalStorage<sizeof(T)> {
+template<typename T, typename Policy = FlagOptionalPolicy>
+class Optional : private OptionalStorage<T, Policy> {
  public:
   /** Type of element this holds. */
   using value_type = T;
 
+  /** Policy used to represent the empty state. */
+  using policy_type = Policy;
+
   /** Constructs a new Optional with no value set. */
-  Optional() {}
+  constexpr Optional() {}
 
   /** Constructs a new Optional with the given value set. */
-  Optional(const T& value) { setValue(value); }
-
-  ~Optional() { clear(); }
+  constexpr Optional(const T& value) : OptionalStorage<T, Policy>(value) {}
 
   /** Returns true if this has a value set. */
-  bool hasValue() const { return this->hasValue_; }
+  constexpr bool hasValue() const { return this->hasStoredValue(); }
 
   /** Returns constant value. Should only be called if hasValue(). */
-  const T& value() const {
-    assert(this->hasValue_);
-    return *getValuePtr();
+  constexpr const T& value() const {
+    return CONSTEXPR_ASSERT(hasValue(), "Optional has no value",
+                            this->storedValue());
   }
 
   /** Returns value. Should only be called if hasValue(). */
   T& value() {
-    assert(this->hasValue_);
-    return *getValuePtr();
+    assert(hasValue());
+    return this->storedValue();
   }
 
   /** Clears the existing value, if any. */
   void clear() {
-    if (this->hasValue_) {
-      // Placement new requires calling destructor explicitly.
-      getValuePtr()->~T();
-      this->hasValue_ = false;
+    if (hasValue()) {
+      this->destroyValue();
     }
   }
 
   /** Assigns a new value. */
-  Optional<T>& operator=(const T& value) {
+  Optional& operator=(const T& value) {
     clear();
-    setValue(value);
+    this->constructValue(value);
     return *this;
   }
+};
 
- private:
-  void setValue(const T& value) {
-    // Use placement new to construct value in data_[].
-    new (getValuePtr()) T(value);
-    this->hasValue_ = true;
-  }
-
-  const T* getValuePtr() const {
-    return reinterpret_cast<const T*>(this->data_);
-  }
 
-  T* getValuePtr() { return reinterpret_cast<T*>(this->data_); }
-};
+/**
+ * Optional that stores its empty state in-band, with sizeof(CompactOptional<T>)
+ * == sizeof(T). Supported for floating point types (empty is NaN) and pointer
+ * types (empty is nullptr).
+ */
+template<typename T>
+using CompactOptional = Optional<
+    T, typename std::conditional<std::is_floating_point<T>::value,
+                                 NanOptionalPolicy<T>,
+                                 NullOptionalPolicy<T>>::type>;
 
 
 /** Returns true if the given Optional values are equal. */
-template<typename T, typename U>
-bool operator==(const Optional<T>& a, const Optional<U>& b) {
+template<typename T, typename P, typename U, typename Q>
+bool operator==(const Optional<T, P>& a, const Optional<U, Q>& b) {
   return (a.hasValue() == b.hasValue())
       && (!a.hasValue() || (a.value() == b.value()));
 }
 
 
 /** Returns true if the first Optional value is less than the second. */
-template<typename T, typename U>
-bool operator<(const Optional<T>& a, const Optional<U>& b) {
+template<typename T, typename P, typename U, typename Q>
+bool operator<(const Optional<T, P>& a, const Optional<U, Q>& b) {
   // If both have values, compare them.
   if (a.hasValue() && b.hasValue()) {
     return (a.value() < b.value());
@@ -128,7 +340,7 @@ bool operator<(const Optional<T>& a, const Optional<U>& b) {
 
   // If both are empty, use memory addresses for stable comparison.
   if (!a.hasValue() && !b.hasValue()) {
-    return (&a < &b);
+    return (static_cast<const void*>(&a) < static_cast<const void*>(&b));
   }
 
   // Otherwise, treat the missing value as less than the present one.
@@ -0,0 +1,301 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OOMUSE_CORE_OPTIONALARRAY_H
+#define OOMUSE_CORE_OPTIONALARRAY_H
+
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+
+#include "oomuse/core/FixedArray.h"
+#include "oomuse/core/Optional.h"
+#include "oomuse/core/bits.h"
+#include "oomuse/core/int_types.h"
+#include "oomuse/core/readability_macros.h"
+
+namespace oomuse {
+
+
+/**
+ * A fixed-length (runtime determined) array of optional values, stored in
+ * columnar form: all values live contiguously in one FixedArray<T>, and whether
+ * each one is present is tracked in a separate packed bitmap (1 bit/element).
+ *
+ * Compared to FixedArray<Optional<T>>, this avoids per-element flags & padding,
+ * and lets the null-aware kernels below (countValid(), sum(), min(), max(),
+ * fillNulls()) process whole 64-element blocks at a time. Missing positions
+ * still occupy a slot in the values array, which always holds T().
+ */
+template<typename T>
+class OptionalArray {
+ public:
+  /** Type of element this holds. */
+  using value_type = T;
+
+  /** Number of elements tracked by each word of the validity bitmap. */
+  static const std::size_t BITS_PER_WORD = 64;
+
+  /** Constructs a new OptionalArray of the given length, with no values set. */
+  explicit OptionalArray(std::size_t length)
+      : values_(length), validity_(numWordsFor(length)) {}
+
+  /** Constructs a new OptionalArray containing the given optional elements. */
+  OptionalArray(std::initializer_list<Optional<T>> initElements)
+      : values_(initElements.size()),
+        validity_(numWordsFor(initElements.size())) {
+    std::size_t index = 0;
+    for (const Optional<T>& element : initElements) {
+      set(index++, element);
+    }
+  }
+
+  /** Returns the number of elements in this OptionalArray. */
+  std::size_t length() const { return values_.length(); }
+
+  /** Returns true if the element at the given index has a value. */
+  bool isValid(std::size_t index) const {
+    assert(index < length());
+    return ((validity_[index / BITS_PER_WORD] >> (index % BITS_PER_WORD)) & 1)
+        != 0;
+  }
+
+  /** Returns the element at the given index as a (copied) Optional. */
+  Optional<T> get(std::size_t index) const {
+    return isValid(index) ? Optional<T>(values_[index]) : Optional<T>();
+  }
+
+  /** Sets the element at the given index to value. */
+  void set(std::size_t index, const T& value) {
+    assert(index < length());
+    values_[index] = value;
+    validity_[index / BITS_PER_WORD] |= bitFor(index);
+  }
+
+  /** Sets the element at the given index to value, or clears it if empty. */
+  void set(std::size_t index, const Optional<T>& value) {
+    if (value.hasValue()) {
+      set(index, value.value());
+    } else {
+      clear(index);
+    }
+  }
+
+  /** Clears the element at the given index, if set. */
+  void clear(std::size_t index) {
+    assert(index < length());
+    values_[index] = T();
+    validity_[index / BITS_PER_WORD] &= ~bitFor(index);
+  }
+
+  /**
+   * Returns the contiguous values array, where missing positions hold T().
+   * Check isValid() or validityBitmap() to tell those apart from present T()s.
+   */
+  const FixedArray<T>& values() const { return values_; }
+
+  /**
+   * Returns the packed validity bitmap: bit (i % 64) of word (i / 64) is set if
+   * element i has a value. Unused bits of the last word are always 0.
+   */
+  const uint64* validityBitmap() const { return validity_.data(); }
+
+  /** Returns the number of words in validityBitmap(). */
+  std::size_t validityBitmapLength() const { return validity_.length(); }
+
+  /** Returns the number of elements that have a value. */
+  std::size_t countValid() const {
+    std::size_t numValid = 0;
+    for (uint64 word : validity_) {
+      numValid += bits::countBits(word);
+    }
+    return numValid;
+  }
+
+  /** Returns the number of elements that don't have a value. */
+  std::size_t countNulls() const { return length() - countValid(); }
+
+  /** Returns the sum of all present values (T() if there are none). */
+  T sum() const {
+    // Missing positions always hold T(), so they can be summed right along
+    // with present ones. Independent per-lane partial sums then let the
+    // compiler vectorize this loop (even for floating point types).
+    const T* values = values_.data();
+    const std::size_t numElements = length();
+    const std::size_t numRemaining = numElements % NUM_LANES;
+    const std::size_t numInLanes = numElements - numRemaining;
+
+    T lanes[NUM_LANES] = {};
+    for (std::size_t i = 0; i < numInLanes; i += NUM_LANES) {
+      for (std::size_t lane = 0; lane < NUM_LANES; ++lane) {
+        lanes[lane] += values[i + lane];
+      }
+    }
+    // Bounding the tail by NUM_LANES (rather than numElements) lets GCC prove
+    // it in range, avoiding a bogus -Waggressive-loop-optimizations error.
+    for (std::size_t lane = 0; lane < numRemaining; ++lane) {
+      lanes[lane] += values[numInLanes + lane];
+    }
+
+    T total = T();
+    for (const T& laneTotal : lanes) {
+      total += laneTotal;
+    }
+    return total;
+  }
+
+  /** Returns the smallest present value, or empty if there are none. */
+  Optional<T> min() const {
+    return reduce([](const T& a, const T& b) { return (b < a) ? b : a; });
+  }
+
+  /** Returns the largest present value, or empty if there are none. */
+  Optional<T> max() const {
+    return reduce([](const T& a, const T& b) { return (a < b) ? b : a; });
+  }
+
+  /** Replaces every missing element with value, so all elements are valid. */
+  void fillNulls(const T& value) {
+    const std::size_t numElements = length();
+    for (std::size_t w = 0; w < validity_.length(); ++w) {
+      const uint64 word = validity_[w];
+      const std::size_t blockStart = w * BITS_PER_WORD;
+      const std::size_t blockLength = blockSize(blockStart, numElements);
+      if (word != ALL_VALID) {
+        T* values = &values_[blockStart];
+        for (std::size_t i = 0; i < blockLength; ++i) {
+          values[i] = ((word >> i) & 1) ? values[i] : value;
+        }
+      }
+      validity_[w] = lowBits(blockLength);
+    }
+  }
+
+ private:
+  CANT_COPY(OptionalArray);
+
+  static const uint64 ALL_VALID = ~static_cast<uint64>(0);
+
+  /** Number of independent accumulators used by the reduction kernels. */
+  static const std::size_t NUM_LANES = 8;
+
+  static std::size_t numWordsFor(std::size_t length) {
+    return (length + BITS_PER_WORD - 1) / BITS_PER_WORD;
+  }
+
+  static uint64 bitFor(std::size_t index) {
+    return static_cast<uint64>(1) << (index % BITS_PER_WORD);
+  }
+
+  static uint64 lowBits(std::size_t numBits) {
+    return (numBits >= BITS_PER_WORD)
+        ? ALL_VALID : ((static_cast<uint64>(1) << numBits) - 1);
+  }
+
+  static std::size_t blockSize(std::size_t blockStart, std::size_t length) {
+    return (length - blockStart < BITS_PER_WORD)
+        ? (length - blockStart) : BITS_PER_WORD;
+  }
+
+  /**
+   * Visits the values in 64-element blocks: fully valid blocks are passed to
+   * denseFn(values, n), partially valid blocks to maskedFn(values, n, word),
+   * and blocks with no values are skipped.
+   */
+  template<typename DenseFn, typename MaskedFn>
+  void forEachBlock(DenseFn denseFn, MaskedFn maskedFn) const {
+    const std::size_t numElements = length();
+    for (std::size_t w = 0; w < validity_.length(); ++w) {
+      const uint64 word = validity_[w];
+      if (word == 0) {
+        continue;
+      }
+
+      const std::size_t blockStart = w * BITS_PER_WORD;
+      const std::size_t blockLength = blockSize(blockStart, numElements);
+      if (word == lowBits(blockLength)) {
+        denseFn(&values_[blockStart], blockLength);
+      } else {
+        maskedFn(&values_[blockStart], blockLength, word);
+      }
+    }
+  }
+
+  /** Combines all present values with pickFn(a, b), or empty if none. */
+  template<typename PickFn>
+  Optional<T> reduce(PickFn pickFn) const {
+    // Seed every lane with the first present value, so that fully valid blocks
+    // can be reduced in independent (vectorizable) lanes.
+    Optional<T> firstValue = findFirstValid();
+    if (!firstValue.hasValue()) {
+      return firstValue;
+    }
+
+    T lanes[NUM_LANES];
+    for (T& lane : lanes) {
+      lane = firstValue.value();
+    }
+
+    forEachBlock(
+        [&](const T* values, std::size_t n) {
+          std::size_t i = 0;
+          for (; i + NUM_LANES <= n; i += NUM_LANES) {
+            for (std::size_t lane = 0; lane < NUM_LANES; ++lane) {
+              lanes[lane] = pickFn(lanes[lane], values[i + lane]);
+            }
+          }
+          for (; i < n; ++i) {
+            lanes[0] = pickFn(lanes[0], values[i]);
+          }
+        },
+        [&](const T* values, std::size_t n, uint64 word) {
+          for (std::size_t i = 0; i < n; ++i) {
+            if ((word >> i) & 1) {
+              lanes[0] = pickFn(lanes[0], values[i]);
+            }
+          }
+        });
+
+    T result = lanes[0];
+    for (std::size_t lane = 1; lane < NUM_LANES; ++lane) {
+      result = pickFn(result, lanes[lane]);
+    }
+    return result;
+  }
+
+  /** Returns the first present value, or empty if there are none. */
+  Optional<T> findFirstValid() const {
+    for (std::size_t w = 0; w < validity_.length(); ++w) {
+      const uint64 word = validity_[w];
+      if (word != 0) {
+        std::size_t bit = 0;
+        while (((word >> bit) & 1) == 0) {
+          ++bit;
+        }
+        return values_[w * BITS_PER_WORD + bit];
+      }
+    }
+    return Optional<T>();
+  }
+
+  FixedArray<T> values_;
+  FixedArray<uint64> validity_;
+};
+
+
+}  // namespace oomuse
+
+#endif  // OOMUSE_CORE_OPTIONALARRAY_H
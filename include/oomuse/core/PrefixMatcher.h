@@ -0,0 +1,243 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OOMUSE_CORE_PREFIXMATCHER_H
+#define OOMUSE_CORE_PREFIXMATCHER_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "oomuse/core/FixedArray.h"
+#include "oomuse/core/Optional.h"
+#include "oomuse/core/StringRef.h"
+#include "oomuse/core/int_types.h"
+#include "oomuse/core/readability_macros.h"
+
+namespace oomuse {
+
+
+/**
+ * Compiled set of byte string patterns, as a double-array trie (shared by
+ * PrefixMatcher and SuffixMatcher; don't use directly). Each trie state is an
+ * index into three flat arrays: the transition on byte c from state s goes to
+ * t = base[s] + c, which is valid iff check[t] == s. So each input byte costs
+ * one add and two array reads, however many patterns there are.
+ */
+class PatternTrie {
+ private:
+  friend class PrefixMatcher;
+  friend class SuffixMatcher;
+
+  /** Trie arrays during construction. */
+  struct Arrays {
+    std::vector<int32> base;
+    std::vector<int32> check;
+    std::vector<int32> patternIndex;
+  };
+
+  /**
+   * Builds a trie of the given keys (optionally reversed). Where keys are
+   * duplicated, the lowest index is stored.
+   */
+  PatternTrie(const std::vector<std::string>& keys, bool reverseKeys);
+
+  explicit PatternTrie(const Arrays& arrays);
+
+  static Arrays build(const std::vector<std::string>& keys, bool reverseKeys);
+
+  /** Returns the state after byte c from state, or -1 if none. */
+  int32 next(int32 state, char c) const {
+    const int32 target = base_[state] + static_cast<uint8>(c);
+    return ((static_cast<std::size_t>(target) < check_.length())
+            && (check_[target] == state)) ? target : -1;
+  }
+
+  /**
+   * Walks chars [begin, end) from the root, calling onMatch(patternIndex) for
+   * each pattern matched along the way (shortest first) until it returns
+   * false.
+   */
+  template<typename CharIt, typename OnMatch>
+  void walk(CharIt begin, CharIt end, OnMatch onMatch) const {
+    int32 state = 0;
+    if ((patternIndex_[0] >= 0) && !onMatch(patternIndex_[0])) {
+      return;
+    }
+    for (CharIt c = begin; c != end; ++c) {
+      state = next(state, *c);
+      if (state < 0) {
+        return;
+      }
+      if ((patternIndex_[state] >= 0) && !onMatch(patternIndex_[state])) {
+        return;
+      }
+    }
+  }
+
+  /** Returns the last pattern matched by walk(), if any. */
+  template<typename CharIt>
+  Optional<std::size_t> longestMatch(CharIt begin, CharIt end) const {
+    int32 longest = -1;
+    walk(begin, end, [&longest](int32 patternIndex) {
+      longest = patternIndex;
+      return true;
+    });
+    return (longest >= 0) ? Optional<std::size_t>(longest)
+                          : Optional<std::size_t>();
+  }
+
+  /** Returns true if walk() matches any pattern. */
+  template<typename CharIt>
+  bool matchesAny(CharIt begin, CharIt end) const {
+    bool matched = false;
+    walk(begin, end, [&matched](int32) {
+      matched = true;
+      return false;
+    });
+    return matched;
+  }
+
+  /** Returns all patterns matched by walk() (shortest first). */
+  template<typename CharIt>
+  std::vector<std::size_t> allMatches(CharIt begin, CharIt end) const {
+    std::vector<std::size_t> matches;
+    walk(begin, end, [&matches](int32 patternIndex) {
+      matches.push_back(static_cast<std::size_t>(patternIndex));
+      return true;
+    });
+    return matches;
+  }
+
+  FixedArray<int32> base_;
+  FixedArray<int32> check_;
+  FixedArray<int32> patternIndex_;  // Pattern ending at each state, or -1.
+};
+
+
+/**
+ * Finds which of a set of patterns (e.g. ~thousands of route prefixes) are
+ * prefixes of an input string, in time proportional to the input's length
+ * rather than the number of patterns. Patterns are compiled once, into a
+ * compact trie (see PatternTrie). For example:
+ *
+ *   PrefixMatcher routes({"/synth/", "/synth/osc/", "/mixer/"});
+ *   Optional<std::size_t> route = routes.longestMatch("/synth/osc/1/freq");
+ *   // route.value() == 1, for "/synth/osc/"
+ *
+ * Where a pattern appears more than once, matches report its lowest index.
+ */
+class PrefixMatcher {
+ public:
+  /** Compiles a matcher for the given patterns. */
+  explicit PrefixMatcher(const std::vector<std::string>& patterns)
+      : patterns_(patterns), trie_(patterns_, false) {}
+
+  /** Compiles a matcher for the given patterns. */
+  PrefixMatcher(std::initializer_list<StringRef> patterns)
+      : patterns_(patterns.begin(), patterns.end()), trie_(patterns_, false) {}
+
+  /** Returns the number of patterns (including any duplicates). */
+  std::size_t numPatterns() const { return patterns_.size(); }
+
+  /** Returns the pattern with the given index. */
+  const std::string& pattern(std::size_t index) const {
+    return patterns_[index];
+  }
+
+  /** Returns true if any pattern is a prefix of str. */
+  bool matchesAny(StringRef str) const {
+    return trie_.matchesAny(str.begin(), str.end());
+  }
+
+  /** Returns the index of the longest pattern that's a prefix of str. */
+  Optional<std::size_t> longestMatch(StringRef str) const {
+    return trie_.longestMatch(str.begin(), str.end());
+  }
+
+  /** Returns the indices of all patterns that are prefixes of str. */
+  std::vector<std::size_t> allMatches(StringRef str) const {
+    return trie_.allMatches(str.begin(), str.end());
+  }
+
+ private:
+  CANT_COPY(PrefixMatcher);
+
+  std::vector<std::string> patterns_;
+  PatternTrie trie_;
+};
+
+
+/**
+ * Same as PrefixMatcher, but finds patterns that are suffixes of an input
+ * string (e.g. file extensions or domain names). The trie holds reversed
+ * patterns, and is walked from the end of the input.
+ */
+class SuffixMatcher {
+ public:
+  /** Compiles a matcher for the given patterns. */
+  explicit SuffixMatcher(const std::vector<std::string>& patterns)
+      : patterns_(patterns), trie_(patterns_, true) {}
+
+  /** Compiles a matcher for the given patterns. */
+  SuffixMatcher(std::initializer_list<StringRef> patterns)
+      : patterns_(patterns.begin(), patterns.end()), trie_(patterns_, true) {}
+
+  /** Returns the number of patterns (including any duplicates). */
+  std::size_t numPatterns() const { return patterns_.size(); }
+
+  /** Returns the pattern with the given index. */
+  const std::string& pattern(std::size_t index) const {
+    return patterns_[index];
+  }
+
+  /** Returns true if any pattern is a suffix of str. */
+  bool matchesAny(StringRef str) const {
+    return trie_.matchesAny(reverseBegin(str), reverseEnd(str));
+  }
+
+  /** Returns the index of the longest pattern that's a suffix of str. */
+  Optional<std::size_t> longestMatch(StringRef str) const {
+    return trie_.longestMatch(reverseBegin(str), reverseEnd(str));
+  }
+
+  /** Returns the indices of all patterns that are suffixes of str. */
+  std::vector<std::size_t> allMatches(StringRef str) const {
+    return trie_.allMatches(reverseBegin(str), reverseEnd(str));
+  }
+
+ private:
+  CANT_COPY(SuffixMatcher);
+
+  using ReverseIterator = std::reverse_iterator<const char*>;
+
+  static ReverseIterator reverseBegin(StringRef str) {
+    return ReverseIterator(str.end());
+  }
+  static ReverseIterator reverseEnd(StringRef str) {
+    return ReverseIterator(str.begin());
+  }
+
+  std::vector<std::string> patterns_;
+  PatternTrie trie_;
+};
+
+
+}  // namespace oomuse
+
+#endif  // OOMUSE_CORE_PREFIXMATCHER_H
@@ -0,0 +1,350 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OOMUSE_CORE_RESULT_H
+#define OOMUSE_CORE_RESULT_H
+
+#include <cassert>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "oomuse/core/Optional.h"
+#include "oomuse/core/constexpr_assert.h"
+#include "oomuse/core/int_types.h"
+
+namespace oomuse {
+
+
+/**
+ * Compact error value: a numeric code, a static description, and optional
+ * integer context. The full message is only formatted (and allocated) if
+ * message() is called, so creating, returning, and checking errors is cheap.
+ * Trivially copyable.
+ */
+class Error {
+ public:
+  /** Formats the full message for an error. Only called by message(). */
+  using FormatFn = std::string (*)(const Error& error);
+
+  /** Constructs an error whose message is just the static description. */
+  constexpr Error(uint32 code, const char* description)
+      : code_(code), description_(description), formatFn_(nullptr),
+        context_(0) {}
+
+  /**
+   * Constructs an error whose message is lazily formatted by formatFn, which
+   * can use the given context value (e.g. an offending index or value).
+   */
+  constexpr Error(uint32 code, const char* description, FormatFn formatFn,
+                  int64 context)
+      : code_(code), description_(description), formatFn_(formatFn),
+        context_(context) {}
+
+  /** Returns the numeric error code. */
+  constexpr uint32 code() const { return code_; }
+
+  /** Returns the static description (never null, never allocates). */
+  constexpr const char* description() const { return description_; }
+
+  /** Returns the integer context value (0 if none). */
+  constexpr int64 context() const { return context_; }
+
+  /** Returns the full error message, formatting it now if needed. */
+  std::string message() const {
+    return (formatFn_ != nullptr) ? formatFn_(*this)
+                                  : std::string(description_);
+  }
+
+ private:
+  uint32 code_;
+  const char* description_;
+  FormatFn formatFn_;
+  int64 context_;
+};
+
+
+/** Tag type selecting the success constructor of ResultStorage. */
+struct ResultSuccessTag {};
+
+/** Tag type selecting the failure constructor of ResultStorage. */
+struct ResultFailureTag {};
+
+
+/**
+ * Base template class for Result with trivial value & error types (don't use
+ * directly). Trivially copyable itself, so Result is too.
+ */
+template<typename T, typename E,
+         bool isTrivial = std::is_trivially_copyable<T>::value
+             && std::is_trivially_copyable<E>::value>
+class ResultStorage {
+ private:
+  // Set Result as a friend so that only it can construct this type.
+  template<typename U, typename F>
+  friend class Result;
+
+  constexpr ResultStorage(ResultSuccessTag, const T& value)
+      : value_(value), isOk_(true) {}
+
+  constexpr ResultStorage(ResultFailureTag, const E& error)
+      : error_(error), isOk_(false) {}
+
+  union {
+    T value_;
+    E error_;
+  };
+  bool isOk_;
+};
+
+
+/**
+ * Base template class for Result with a non-trivial value or error type
+ * (don't use directly). Constructs & destructs the active member in place.
+ * Assignment needs T and E to be nothrow move constructible (as most types
+ * are), so that a throwing copy or move never leaves a destroyed member.
+ */
+template<typename T, typename E>
+class ResultStorage<T, E, false> {
+ private:
+  // Set Result as a friend so that only it can construct this type.
+  template<typename U, typename F>
+  friend class Result;
+
+  ResultStorage(ResultSuccessTag, const T& value)
+      : value_(value), isOk_(true) {}
+
+  ResultStorage(ResultSuccessTag, T&& value)
+      : value_(std::move(value)), isOk_(true) {}
+
+  ResultStorage(ResultFailureTag, const E& error)
+      : error_(error), isOk_(false) {}
+
+  ResultStorage(ResultFailureTag, E&& error)
+      : error_(std::move(error)), isOk_(false) {}
+
+  ResultStorage(const ResultStorage& other) : isOk_(other.isOk_) {
+    if (isOk_) {
+      new (&value_) T(other.value_);
+    } else {
+      new (&error_) E(other.error_);
+    }
+  }
+
+  ResultStorage(ResultStorage&& other) : isOk_(other.isOk_) {
+    if (isOk_) {
+      new (&value_) T(std::move(other.value_));
+    } else {
+      new (&error_) E(std::move(other.error_));
+    }
+  }
+
+  ResultStorage& operator=(const ResultStorage& other) {
+    if (isOk_ && other.isOk_) {
+      value_ = other.value_;
+    } else if (!isOk_ && !other.isOk_) {
+      error_ = other.error_;
+    } else if (other.isOk_) {
+      // Copy before destroying the old error, so a throwing copy leaves this
+      // unchanged.
+      T value(other.value_);
+      replaceErrorWithValue(std::move(value));
+    } else {
+      E error(other.error_);
+      replaceValueWithError(std::move(error));
+    }
+    return *this;
+  }
+
+  ResultStorage& operator=(ResultStorage&& other) {
+    if (isOk_ && other.isOk_) {
+      value_ = std::move(other.value_);
+    } else if (!isOk_ && !other.isOk_) {
+      error_ = std::move(other.error_);
+    } else if (other.isOk_) {
+      replaceErrorWithValue(std::move(other.value_));
+    } else {
+      replaceValueWithError(std::move(other.error_));
+    }
+    return *this;
+  }
+
+  ~ResultStorage() { destroy(); }
+
+  // Switching alternatives destroys the old member before constructing the
+  // new one in its place, which is only safe if that can't throw.
+  void replaceErrorWithValue(T&& value) {
+    static_assert(std::is_nothrow_move_constructible<T>::value,
+                  "Assigning Results requires a nothrow move constructor");
+    error_.~E();
+    new (&value_) T(std::move(value));
+    isOk_ = true;
+  }
+
+  void replaceValueWithError(E&& error) {
+    static_assert(std::is_nothrow_move_constructible<E>::value,
+                  "Assigning Results requires a nothrow move constructor");
+    value_.~T();
+    new (&error_) E(std::move(error));
+    isOk_ = false;
+  }
+
+  void destroy() {
+    // Placement new requires calling destructors explicitly.
+    if (isOk_) {
+      value_.~T();
+    } else {
+      error_.~E();
+    }
+  }
+
+  union {
+    T value_;
+    E error_;
+  };
+  bool isOk_;
+};
+
+
+/**
+ * Holds either a successful value of type T or an error of type E (Error by
+ * default), as a return type for operations that can fail without throwing.
+ * Both are stored inline, so creating a Result never allocates; if T and E are
+ * trivially copyable, so is Result.
+ *
+ * Results can be chained without checking each step, for example:
+ *
+ * Result<int32> parsed = parseInt(text);
+ * Result<int32> note = parsed.andThen(checkMidiRange).map(transpose);
+ * if (!note.isOk()) { log(note.error().message()); }
+ */
+template<typename T, typename E = Error>
+class Result : private ResultStorage<T, E> {
+ public:
+  /** Type of value this holds on success. */
+  using value_type = T;
+
+  /** Type of error this holds on failure. */
+  using error_type = E;
+
+  /** Returns a successful Result holding value. */
+  static constexpr Result success(const T& value) {
+    return Result(ResultSuccessTag(), value);
+  }
+
+  /** Returns a successful Result holding (moved) value. */
+  static constexpr Result success(T&& value) {
+    return Result(ResultSuccessTag(), std::move(value));
+  }
+
+  /** Returns a failed Result holding error. */
+  static constexpr Result failure(const E& error) {
+    return Result(ResultFailureTag(), error);
+  }
+
+  /** Returns a failed Result holding (moved) error. */
+  static constexpr Result failure(E&& error) {
+    return Result(ResultFailureTag(), std::move(error));
+  }
+
+  /** Returns true if this holds a value, false if it holds an error. */
+  constexpr bool isOk() const { return this->isOk_; }
+
+  /** Returns true if this holds an error. */
+  constexpr bool hasError() const { return !this->isOk_; }
+
+  /** Returns constant value. Should only be called if isOk(). */
+  constexpr const T& value() const & {
+    return CONSTEXPR_ASSERT(isOk(), "Result holds an error", this->value_);
+  }
+
+  /** Returns value. Should only be called if isOk(). */
+  T& value() & {
+    assert(isOk());
+    return this->value_;
+  }
+
+  /** Returns value for moving out. Should only be called if isOk(). */
+  T&& value() && {
+    assert(isOk());
+    return std::move(this->value_);
+  }
+
+  /** Returns constant error. Should only be called if hasError(). */
+  constexpr const E& error() const {
+    return CONSTEXPR_ASSERT(hasError(), "Result holds a value", this->error_);
+  }
+
+  /** Returns the value if isOk(), otherwise fallback. */
+  T valueOr(const T& fallback) const {
+    return isOk() ? this->value_ : fallback;
+  }
+
+  /** Returns the value as an Optional, dropping any error. */
+  Optional<T> toOptional() const {
+    return isOk() ? Optional<T>(this->value_) : Optional<T>();
+  }
+
+  /**
+   * Returns Result<U, E> holding fn(value()) if isOk(), or else this error.
+   */
+  template<typename Fn>
+  auto map(Fn fn) const -> Result<decltype(fn(std::declval<const T&>())), E> {
+    using Mapped = Result<decltype(fn(std::declval<const T&>())), E>;
+    return isOk() ? Mapped::success(fn(this->value_))
+                  : Mapped::failure(this->error_);
+  }
+
+  /**
+   * Returns fn(value()) if isOk(), or else this error. fn must itself return a
+   * Result<U, E>, so failures short-circuit through a chain of steps.
+   */
+  template<typename Fn>
+  auto andThen(Fn fn) const -> decltype(fn(std::declval<const T&>())) {
+    using Chained = decltype(fn(std::declval<const T&>()));
+    return isOk() ? fn(this->value_) : Chained::failure(this->error_);
+  }
+
+  /**
+   * Returns Result<T, F> holding fn(error()) if hasError(), or else this value.
+   */
+  template<typename Fn>
+  auto mapError(Fn fn) const
+      -> Result<T, decltype(fn(std::declval<const E&>()))> {
+    using Mapped = Result<T, decltype(fn(std::declval<const E&>()))>;
+    return isOk() ? Mapped::success(this->value_)
+                  : Mapped::failure(fn(this->error_));
+  }
+
+ private:
+  constexpr Result(ResultSuccessTag tag, const T& value)
+      : ResultStorage<T, E>(tag, value) {}
+
+  constexpr Result(ResultSuccessTag tag, T&& value)
+      : ResultStorage<T, E>(tag, std::move(value)) {}
+
+  constexpr Result(ResultFailureTag tag, const E& error)
+      : ResultStorage<T, E>(tag, error) {}
+
+  constexpr Result(ResultFailureTag tag, E&& error)
+      : ResultStorage<T, E>(tag, std::move(error)) {}
+};
+
+
+}  // namespace oomuse
+
+#endif  // OOMUSE_CORE_RESULT_H
@@ -0,0 +1,114 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OOMUSE_CORE_STRINGARENA_H
+#define OOMUSE_CORE_STRINGARENA_H
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "oomuse/core/StringRef.h"
+#include "oomuse/core/readability_macros.h"
+
+namespace oomuse {
+
+
+/**
+ * Bump allocator for many (typically short) immutable strings. Chars are
+ * carved out of large blocks, so each string costs a pointer increment
+ * instead of a heap allocation, and all of them are freed at once when the
+ * arena is cleared or destroyed. StringRefs into the arena stay valid until
+ * then. See also the StringArena overloads in strings.h.
+ *
+ *   StringArena arena;
+ *   std::vector<StringRef> tags;
+ *   for (StringRef tag : rawTags) {
+ *     tags.push_back(strings::toLowerCase(strings::trimWhitespace(tag),
+ *                                         arena));
+ *   }
+ *
+ * Not thread-safe; use one arena per thread.
+ */
+class StringArena {
+ public:
+  /** Default number of chars per block. */
+  static const std::size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+  /**
+   * Constructs an empty arena that allocates blockSize chars at a time (no
+   * memory is allocated until first use). Strings longer than a quarter of
+   * blockSize get blocks of their own.
+   */
+  explicit StringArena(std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+  /**
+   * Returns space for length chars (uninitialized, not null-terminated),
+   * valid until clear() or destruction.
+   */
+  char* allocate(std::size_t length) {
+    if (static_cast<std::size_t>(end_ - next_) >= length) {
+      char* chars = next_;
+      next_ += length;
+      numBytesUsed_ += length;
+      return chars;
+    }
+    return allocateSlow(length);
+  }
+
+  /** Copies str into the arena, returning a view of the copy. */
+  StringRef copy(StringRef str) {
+    char* chars = allocate(str.length());
+    if (!str.empty()) {
+      std::memcpy(chars, str.data(), str.length());
+    }
+    return StringRef(chars, str.length());
+  }
+
+  /**
+   * Frees all strings at once (invalidating views into them). Standard-sized
+   * blocks are kept for reuse, so that an arena cleared between batches stops
+   * allocating once it has grown to fit the largest batch.
+   */
+  void clear();
+
+  /** Returns the total number of chars allocated from this arena. */
+  std::size_t numBytesUsed() const { return numBytesUsed_; }
+
+  /** Returns the number of blocks (heap allocations) currently held. */
+  std::size_t numBlocks() const {
+    return blocks_.size() + largeBlocks_.size();
+  }
+
+ private:
+  CANT_COPY(StringArena);
+
+  char* allocateSlow(std::size_t length);
+
+  std::size_t blockSize_;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  std::size_t numBlocksInUse_;
+  std::vector<std::unique_ptr<char[]>> largeBlocks_;
+  char* next_;
+  char* end_;
+  std::size_t numBytesUsed_;
+};
+
+
+}  // namespace oomuse
+
+#endif  // OOMUSE_CORE_STRINGARENA_H
@@ -0,0 +1,206 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OOMUSE_CORE_STRINGBUILDER_H
+#define OOMUSE_CORE_STRINGBUILDER_H
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include "oomuse/core/StringRef.h"
+#include "oomuse/core/int_types.h"
+#include "oomuse/core/readability_macros.h"
+#include "oomuse/core/strings.h"
+
+namespace oomuse {
+
+
+/**
+ * Builds a string by appending strings, chars, and numbers, as a much lighter
+ * alternative to std::stringstream. The first INLINE_CAPACITY chars live in
+ * the builder itself, so short messages never touch the heap until
+ * toString(); longer ones grow a heap buffer geometrically. Numbers are
+ * formatted with strings::formatInt() and formatFloat(), independent of
+ * locale.
+ *
+ *   StringBuilder message;
+ *   message.append("Expected ").append(expected).append(" items, got ")
+ *       .append(actual).append('.');
+ *   return message.toString();
+ *
+ * A builder that is reset() between uses keeps its buffer, so one reused
+ * builder stops allocating once it has grown to fit the longest string.
+ */
+class StringBuilder {
+ public:
+  /** Number of chars held without any heap allocation. */
+  static const std::size_t INLINE_CAPACITY = 256;
+
+  StringBuilder() : data_(inlineChars_), length_(0),
+                    capacity_(INLINE_CAPACITY) {}
+
+  /** Appends str (e.g. a std::string, literal, or StringRef). */
+  StringBuilder& append(StringRef str) {
+    if (capacity_ - length_ < str.length()) {
+      return appendGrowing(str);
+    }
+    if (!str.empty()) {
+      std::memcpy(data_ + length_, str.data(), str.length());
+      length_ += str.length();
+    }
+    return *this;
+  }
+
+  /** Appends c. */
+  StringBuilder& append(char c) {
+    *extend(1) = c;
+    return *this;
+  }
+
+  /** Appends count copies of c. */
+  StringBuilder& append(std::size_t count, char c) {
+    std::memset(extend(count), c, count);
+    return *this;
+  }
+
+  /**
+   * Appends value in decimal, as strings::formatInt(), for any integer type
+   * (int8 through uint64, long long, std::size_t, ...) except char and bool.
+   */
+  template<typename T>
+  std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, char>::value
+                   && !std::is_same<T, bool>::value, StringBuilder&>
+  append(T value) {
+    using Widest = std::conditional_t<std::is_signed<T>::value, int64, uint64>;
+    return appendInt(static_cast<Widest>(value));
+  }
+
+  /** Appends value in the shortest form, as strings::formatFloat(). */
+  StringBuilder& append(float value) { return appendFloat(value); }
+  StringBuilder& append(double value) { return appendFloat(value); }
+
+  /**
+   * Appends value of any type: integers and floating point numbers like
+   * append() (int8 and uint8 as numbers, like strings::formatValue()), and
+   * anything else (including char) with operator<<.
+   */
+  template<typename T>
+  std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, char>::value,
+                   StringBuilder&>
+  appendValue(T value) {
+    using Widest = std::conditional_t<std::is_signed<T>::value, int64, uint64>;
+    return appendInt(static_cast<Widest>(value));
+  }
+
+  template<typename T>
+  std::enable_if_t<std::is_floating_point<T>::value, StringBuilder&>
+  appendValue(T value) {
+    // Floats format as themselves (0.1f is "0.1"); long doubles as doubles.
+    using Formatted = std::conditional_t<std::is_same<T, float>::value, float,
+                                         double>;
+    return appendFloat(static_cast<Formatted>(value));
+  }
+
+  template<typename T>
+  std::enable_if_t<!std::is_arithmetic<T>::value
+                   || std::is_same<T, char>::value, StringBuilder&>
+  appendValue(const T& value) {
+    std::ostringstream stream;
+    stream << value;
+    return append(stream.str());
+  }
+
+  /** Makes room for capacity chars in total, so appends up to it can't grow. */
+  void reserve(std::size_t capacity) {
+    if (capacity > capacity_) {
+      grow(capacity);
+    }
+  }
+
+  /** Empties the builder, keeping its buffer for reuse. */
+  void reset() { length_ = 0; }
+
+  /** Returns the number of chars appended (since the last reset()). */
+  std::size_t length() const { return length_; }
+
+  /** Returns true if nothing has been appended (since the last reset()). */
+  bool empty() const { return (length_ == 0); }
+
+  /** Returns the number of chars that fit without growing. */
+  std::size_t capacity() const { return capacity_; }
+
+  /** Returns the chars appended so far (not null-terminated). */
+  const char* data() const { return data_; }
+
+  /** Returns a view of the chars appended so far, valid until the next call. */
+  StringRef toStringRef() const { return StringRef(data_, length_); }
+
+  /** Returns a copy of the chars appended so far. */
+  std::string toString() const { return std::string(data_, length_); }
+
+ private:
+  CANT_COPY(StringBuilder);
+
+  /** Returns space for length more chars, growing if needed. */
+  char* extend(std::size_t length) {
+    if (capacity_ - length_ < length) {
+      grow(length_ + length);
+    }
+    char* chars = data_ + length_;
+    length_ += length;
+    return chars;
+  }
+
+  template<typename T>
+  StringBuilder& appendInt(T value) {
+    reserve(length_ + strings::MAX_INT_CHARS);
+    length_ = static_cast<std::size_t>(
+        strings::formatInt(value, data_ + length_) - data_);
+    return *this;
+  }
+
+  template<typename T>
+  StringBuilder& appendFloat(T value) {
+    reserve(length_ + strings::MAX_FLOAT_CHARS);
+    length_ = static_cast<std::size_t>(
+        strings::formatFloat(value, data_ + length_) - data_);
+    return *this;
+  }
+
+  /**
+   * Appends str after growing, which is safe even if str views this builder's
+   * own chars (e.g. append(toStringRef())).
+   */
+  StringBuilder& appendGrowing(StringRef str);
+
+  /** Moves to a heap buffer of at least minCapacity (and 2x the old one). */
+  void grow(std::size_t minCapacity);
+
+  char* data_;
+  std::size_t length_;
+  std::size_t capacity_;
+  std::unique_ptr<char[]> heapChars_;
+  char inlineChars_[INLINE_CAPACITY];
+};
+
+
+}  // namespace oomuse
+
+#endif  // OOMUSE_CORE_STRINGBUILDER_H
@@ -0,0 +1,167 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OOMUSE_CORE_STRINGREF_H
+#define OOMUSE_CORE_STRINGREF_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+#include "oomuse/core/constexpr_assert.h"
+
+namespace oomuse {
+
+
+/**
+ * Non-owning, read-only view of a sequence of chars (a pointer & a length),
+ * so that functions can accept std::strings, string literals, char buffers,
+ * and substrings of any of them without copying. The viewed chars must
+ * outlive the StringRef, and needn't be null-terminated.
+ *
+ * Note that this class will be deprecated in the future in favor of
+ * std::string_view, once this library moves to C++17.
+ */
+class StringRef {
+ public:
+  /** Returned by find() when not found. */
+  static const std::size_t npos = static_cast<std::size_t>(-1);
+
+  /** Constructs an empty StringRef. */
+  constexpr StringRef() : data_(""), length_(0) {}
+
+  /** Views the given null-terminated string (not including the null). */
+  StringRef(const char* str) : data_(str), length_(std::strlen(str)) {}
+
+  /** Views length chars starting at data. */
+  constexpr StringRef(const char* data, std::size_t length)
+      : data_(data), length_(length) {}
+
+  /** Views the contents of str, which must outlive this StringRef. */
+  StringRef(const std::string& str)
+      : data_(str.data()), length_(str.length()) {}
+
+  /** Returns a pointer to the first char (not necessarily null-terminated). */
+  constexpr const char* data() const { return data_; }
+
+  /** Returns the number of chars. */
+  constexpr std::size_t length() const { return length_; }
+
+  /** Same as length(). */
+  constexpr std::size_t size() const { return length_; }
+
+  /** Returns true if this has no chars. */
+  constexpr bool empty() const { return (length_ == 0); }
+
+  /** Returns the char at the given index. */
+  constexpr char operator[](std::size_t index) const { return data_[index]; }
+
+  /** Returns pointer to the first char, for iteration. */
+  constexpr const char* begin() const { return data_; }
+
+  /** Returns pointer to one past the last char, for iteration. */
+  constexpr const char* end() const { return data_ + length_; }
+
+  /**
+   * Returns a view of up to length chars starting at index pos (which must be
+   * <= length()).
+   */
+  constexpr StringRef substr(std::size_t pos,
+                             std::size_t length = npos) const {
+    return CONSTEXPR_ASSERT(
+        pos <= length_, "substr() pos out of range",
+        StringRef(data_ + pos,
+                  (length < length_ - pos) ? length : (length_ - pos)));
+  }
+
+  /** Drops the first n chars (n must be <= length()). */
+  void removePrefix(std::size_t n) {
+    assert(n <= length_);
+    data_ += n;
+    length_ -= n;
+  }
+
+  /** Drops the last n chars (n must be <= length()). */
+  void removeSuffix(std::size_t n) {
+    assert(n <= length_);
+    length_ -= n;
+  }
+
+  /** Returns the index of the first c at or after pos, or npos if none. */
+  std::size_t find(char c, std::size_t pos = 0) const {
+    if (pos >= length_) {
+      return npos;
+    }
+    const void* found = std::memchr(data_ + pos, c, length_ - pos);
+    return (found != nullptr)
+        ? static_cast<std::size_t>(static_cast<const char*>(found) - data_)
+        : npos;
+  }
+
+  /**
+   * Compares chars lexicographically (as unsigned chars, like std::string),
+   * returning < 0, 0, or > 0.
+   */
+  int compare(StringRef other) const {
+    const std::size_t minLength =
+        (length_ < other.length_) ? length_ : other.length_;
+    const int result =
+        (minLength > 0) ? std::memcmp(data_, other.data_, minLength) : 0;
+    if (result != 0) {
+      return result;
+    }
+    return (length_ < other.length_) ? -1 : ((length_ > other.length_) ? 1 : 0);
+  }
+
+  /** Returns a new std::string copy of the viewed chars. */
+  std::string toString() const { return std::string(data_, length_); }
+
+  /** Same as toString(). */
+  explicit operator std::string() const { return toString(); }
+
+ private:
+  const char* data_;
+  std::size_t length_;
+};
+
+
+/** Returns true if a and b have the same chars. */
+inline bool operator==(StringRef a, StringRef b) {
+  return (a.length() == b.length())
+      && ((a.length() == 0) || (std::memcmp(a.data(), b.data(), a.length())
+                                == 0));
+}
+
+
+/** Returns true if a and b have different chars. */
+inline bool operator!=(StringRef a, StringRef b) { return !(a == b); }
+
+
+/** Returns true if a is lexicographically less than b. */
+inline bool operator<(StringRef a, StringRef b) { return (a.compare(b) < 0); }
+
+
+/** Writes the viewed chars to out. */
+inline std::ostream& operator<<(std::ostream& out, StringRef str) {
+  return out.write(str.data(), static_cast<std::streamsize>(str.length()));
+}
+
+
+}  // namespace oomuse
+
+#endif  // OOMUSE_CORE_STRINGREF_H
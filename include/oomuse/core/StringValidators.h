@@ -0,0 +1,156 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OOMUSE_CORE_STRINGVALIDATORS_H
+#define OOMUSE_CORE_STRINGVALIDATORS_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "oomuse/core/CharacterSet.h"
+#include "oomuse/core/Optional.h"
+#include "oomuse/core/StringBuilder.h"
+#include "oomuse/core/StringRef.h"
+#include "oomuse/core/Validator.h"
+#include "oomuse/core/strings.h"
+#include "oomuse/core/readability_macros.h"
+
+namespace oomuse {
+
+
+/**
+ * Static factory functions for common std::string content validators (for
+ * user-supplied names, paths, tags, etc.), to combine with Validators. For
+ * example:
+ *
+ *   auto isTag = Validators<std::string>::allOf(
+ *       StringValidators::validUtf8(),
+ *       StringValidators::noControlCharacters(),
+ *       StringValidators::maxCodePoints(32));
+ *
+ * These scan 8 or more bytes per step where possible (see strings.h).
+ */
+class StringValidators {
+ public:
+  /** Returns a Validator requiring all bytes to be 7-bit ASCII. */
+  static std::unique_ptr<Validator<std::string>> asciiOnly();
+
+  /** Returns a Validator rejecting ASCII control characters (incl. \t, \n). */
+  static std::unique_ptr<Validator<std::string>> noControlCharacters();
+
+  /** Returns a Validator requiring well-formed UTF-8. */
+  static std::unique_ptr<Validator<std::string>> validUtf8();
+
+  /** Returns a Validator requiring every byte to be in allowedCharacters. */
+  static std::unique_ptr<Validator<std::string>> charactersIn(
+      const CharacterSet& allowedCharacters);
+
+  /**
+   * Returns a Validator requiring (UTF-8) values to have <= maxCodePoints code
+   * points. Combine with validUtf8() to also reject malformed UTF-8.
+   */
+  static std::unique_ptr<Validator<std::string>> maxCodePoints(
+      std::size_t maxCodePoints);
+
+  /**
+   * Returns a Validator requiring values to parse as a T (an int_types integer
+   * via strings::parseInt(), or float or double via strings::parseFloat()),
+   * which must then pass numberValidator, if given. For example:
+   *
+   *   auto isMidiNote = StringValidators::parsesAs<int32>(
+   *       Validators<int32>::allOf(Validators<int32>::greaterOrEqual(0),
+   *                                Validators<int32>::lessOrEqual(127)));
+   */
+  template<typename T>
+  static std::unique_ptr<Validator<std::string>> parsesAs(
+      std::unique_ptr<Validator<T>> numberValidator = nullptr);
+
+ private:
+  CANT_INSTANTIATE(StringValidators);
+};
+
+
+/**
+ * Validates that a string parses as a number of type T, which then passes
+ * another (e.g. range) Validator, if any.
+ */
+template<typename T>
+class ParsedNumberValidator : public Validator<std::string> {
+ public:
+  explicit ParsedNumberValidator(
+      std::unique_ptr<Validator<T>> numberValidator)
+      : numberValidator_(std::move(numberValidator)) {}
+
+  virtual bool isValid(const std::string& value) const {
+    const Optional<T> number = parse(value, std::is_integral<T>());
+    return number.hasValue()
+        && ((numberValidator_ == nullptr)
+            || numberValidator_->isValid(number.value()));
+  }
+
+  virtual ValidationErrorCode checkValidationErrorCode(
+      const std::string& value) const {
+    const Optional<T> number = parse(value, std::is_integral<T>());
+    if (!number.hasValue()) {
+      return ValidationErrorCode::MUST_BE_NUMBER;
+    }
+    return (numberValidator_ == nullptr)
+        ? ValidationErrorCode::NONE
+        : numberValidator_->checkValidationErrorCode(number.value());
+  }
+
+  virtual std::string checkValidationErrors(const std::string& value) const {
+    return this->formatValidationErrors(value);
+  }
+
+  virtual void appendValidationErrors(const std::string& value,
+                                      StringBuilder& out) const {
+    const Optional<T> number = parse(value, std::is_integral<T>());
+    if (!number.hasValue()) {
+      out.append(std::is_integral<T>::value ? "Must be an integer in range."
+                                            : "Must be a number in range.");
+    } else if (numberValidator_ != nullptr) {
+      numberValidator_->appendValidationErrors(number.value(), out);
+    }
+  }
+
+ private:
+  static Optional<T> parse(StringRef str, std::true_type /* isIntegral */) {
+    return strings::parseInt<T>(str);
+  }
+
+  static Optional<T> parse(StringRef str, std::false_type /* isIntegral */) {
+    return strings::parseFloat<T>(str);
+  }
+
+  const std::unique_ptr<Validator<T>> numberValidator_;
+};
+
+
+template<typename T>
+std::unique_ptr<Validator<std::string>> StringValidators::parsesAs(
+    std::unique_ptr<Validator<T>> numberValidator) {
+  return std::make_unique<ParsedNumberValidator<T>>(
+      std::move(numberValidator));
+}
+
+
+}  // namespace oomuse
+
+#endif  // OOMUSE_CORE_STRINGVALIDATORS_H
@@ -0,0 +1,198 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OOMUSE_CORE_SYMBOLTABLE_H
+#define OOMUSE_CORE_SYMBOLTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "oomuse/core/Optional.h"
+#include "oomuse/core/StringArena.h"
+#include "oomuse/core/StringRef.h"
+#include "oomuse/core/bits.h"
+#include "oomuse/core/int_types.h"
+#include "oomuse/core/readability_macros.h"
+
+namespace oomuse {
+
+
+/**
+ * 32-bit handle to a string interned in a SymbolTable. Symbols from the same
+ * table are equal exactly when their strings are, so comparing or hashing
+ * one is a single integer operation. The default Symbol is the empty string,
+ * which every table interns as id 0.
+ */
+class Symbol {
+ public:
+  constexpr Symbol() : id_(0) {}
+
+  /**
+   * Returns this symbol's id: dense (0, 1, 2, ... in order of first intern)
+   * and unique within its table, so it doubles as a perfect hash.
+   */
+  constexpr uint32 id() const { return id_; }
+
+  friend constexpr bool operator==(Symbol a, Symbol b) {
+    return a.id_ == b.id_;
+  }
+  friend constexpr bool operator!=(Symbol a, Symbol b) {
+    return a.id_ != b.id_;
+  }
+  /** Orders by id (i.e. first intern), not alphabetically. */
+  friend constexpr bool operator<(Symbol a, Symbol b) {
+    return a.id_ < b.id_;
+  }
+
+ private:
+  friend class SymbolTable;
+
+  explicit constexpr Symbol(uint32 id) : id_(id) {}
+
+  uint32 id_;
+};
+
+
+/**
+ * Thread-safe table of interned strings. Each distinct string is copied once
+ * into arena-backed storage and given a Symbol, for cheap comparison and
+ * hashing of names used over and over (e.g. parameter and event names):
+ *
+ *   SymbolTable symbols;
+ *   const Symbol cutoff = symbols.intern("CutoffFrequency");
+ *   std::unordered_map<Symbol, Param> paramsBySymbol;
+ *   ...
+ *   auto it = paramsBySymbol.find(symbols.intern(eventName));
+ *
+ * Looking up an already interned string (intern(), find(), and str()) is
+ * lock-free and never allocates; only the first intern() of a new string
+ * takes a lock. Interned strings live as long as the table.
+ */
+class SymbolTable {
+ public:
+  /** Constructs a table holding just the empty string (as Symbol()). */
+  SymbolTable();
+  ~SymbolTable();
+
+  /** Returns the symbol for str, interning a copy of it if it's new. */
+  Symbol intern(StringRef str);
+
+  /** Returns the symbol for str if it has been interned, without adding it. */
+  Optional<Symbol> find(StringRef str) const;
+
+  /**
+   * Returns the interned chars for symbol (which must have come from this
+   * table), valid for the table's lifetime.
+   */
+  StringRef str(Symbol symbol) const {
+    const Entry& entry = entryAt(symbol.id());
+    return StringRef(entry.chars, entry.length);
+  }
+
+  /** Returns the number of distinct strings interned so far. */
+  std::size_t size() const {
+    return numSymbols_.load(std::memory_order_acquire);
+  }
+
+ private:
+  CANT_COPY(SymbolTable);
+
+  /** An interned string, stored in its chunk by symbol id. */
+  struct Entry {
+    const char* chars;
+    uint32 length;
+    uint32 hash;
+  };
+
+  /**
+   * Open-addressed hash index: each slot packs a string's 32-bit hash (high
+   * half) with its id + 1 (low half), with 0 for an empty slot.
+   */
+  struct HashIndex {
+    explicit HashIndex(std::size_t numSlots);
+
+    std::size_t mask;
+    std::unique_ptr<std::atomic<uint64>[]> slots;
+  };
+
+  static const uint32 NO_ID = 0xFFFFFFFF;
+
+  /** Entry chunk k holds 2^(FIRST_CHUNK_BITS + k) entries. */
+  static const uint32 FIRST_CHUNK_BITS = 8;
+  static const std::size_t MAX_CHUNKS = 32 - FIRST_CHUNK_BITS;
+
+  /** Returns str's id in index, or NO_ID if it's not there (yet). */
+  uint32 findId(const HashIndex& index, StringRef str, uint32 hash) const;
+
+  Symbol internSlow(StringRef str, uint32 hash);
+
+  /**
+   * Returns which chunk holds the entry for id, given offsetId = id +
+   * 2^FIRST_CHUNK_BITS (so that chunk k starts at offset id
+   * 2^(FIRST_CHUNK_BITS + k)).
+   */
+  static int chunkOf(uint32 offsetId) {
+    return 31 - bits::countLeadingZeros(offsetId)
+        - static_cast<int>(FIRST_CHUNK_BITS);
+  }
+
+  /** Returns the entry for id, which must already have been published. */
+  const Entry& entryAt(uint32 id) const {
+    const uint32 offsetId = id + (1u << FIRST_CHUNK_BITS);
+    const int chunk = chunkOf(offsetId);
+    const Entry* entries = chunks_[chunk].load(std::memory_order_acquire);
+    return entries[offsetId - (1u << (chunk + FIRST_CHUNK_BITS))];
+  }
+
+  /** Adds str (not yet interned) as the next id; requires mutex_. */
+  uint32 addEntry(StringRef str, uint32 hash);
+
+  /** Inserts id into index (which must have room); requires mutex_. */
+  static void insertId(HashIndex* index, uint32 id, uint32 hash);
+
+  std::atomic<const HashIndex*> index_;
+  std::atomic<Entry*> chunks_[MAX_CHUNKS];
+  std::atomic<uint32> numSymbols_;
+
+  // Writer-only state, guarded by mutex_. Replaced indexes are kept until
+  // destruction, since lock-free readers may still be probing them.
+  std::mutex mutex_;
+  StringArena arena_;
+  std::vector<std::unique_ptr<HashIndex>> indexes_;
+  std::vector<std::unique_ptr<Entry[]>> ownedChunks_;
+};
+
+
+}  // namespace oomuse
+
+
+namespace std {
+
+/** Hashes a Symbol by its (already unique) id. */
+template <>
+struct hash<oomuse::Symbol> {
+  std::size_t operator()(oomuse::Symbol symbol) const {
+    return symbol.id();
+  }
+};
+
+}  // namespace std
+
+#endif  // OOMUSE_CORE_SYMBOLTABLE_H
@@ -0,0 +1,157 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OOMUSE_CORE_VALIDATED_H
+#define OOMUSE_CORE_VALIDATED_H
+
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "oomuse/core/Optional.h"
+#include "oomuse/core/Result.h"
+#include "oomuse/core/Validator.h"
+#include "oomuse/core/ValidatorExpressions.h"
+
+namespace oomuse {
+
+
+/**
+ * A value of type T that is known to satisfy Rule, since the only ways to
+ * construct one check it first. Functions that take a Validated<T, Rule> can
+ * skip re-checking the value at every API boundary.
+ *
+ * Rule is a type with a static constexpr expression() function returning a
+ * validator expression (see ValidatorExpressions.h), so checks inline:
+ *
+ *   struct MidiRange {
+ *     static constexpr auto expression() {
+ *       return validation::greaterOrEqual(0) && validation::less(128);
+ *     }
+ *   };
+ *   using MidiValue = Validated<int32, MidiRange>;
+ *
+ *   void playNote(MidiValue note);  // No need to check note again.
+ *
+ *   Optional<MidiValue> note = MidiValue::of(noteNumber);
+ *   if (note.hasValue()) { playNote(note.value()); }
+ *
+ * Validated is the same size as T, and trivially copyable if T is.
+ */
+template<typename T, typename Rule>
+class Validated {
+ public:
+  static_assert(validation::IsValidatorExpression<
+                    decltype(Rule::expression())>::value,
+                "Rule::expression() must return a validator expression");
+
+  /** Type of value this holds. */
+  using value_type = T;
+
+  /** Rule that the value satisfies. */
+  using rule_type = Rule;
+
+  /** Returns true if value satisfies Rule. */
+  static constexpr bool isValid(const T& value) {
+    return Rule::expression().isValid(value);
+  }
+
+  /** Returns which check of Rule value fails, or NONE if it's valid. */
+  static constexpr ValidationErrorCode checkValidationErrorCode(
+      const T& value) {
+    return Rule::expression().checkValidationErrorCode(value);
+  }
+
+  /** Returns Rule's validation errors for value, or "" if it's valid. */
+  static std::string checkValidationErrors(const T& value) {
+    return Rule::expression().checkValidationErrors(value);
+  }
+
+  /** Returns a Validated value if value satisfies Rule, or else empty. */
+  static constexpr Optional<Validated> of(const T& value) {
+    return isValid(value) ? Optional<Validated>(Validated(value))
+                          : Optional<Validated>();
+  }
+
+  /**
+   * Returns a Validated value if value satisfies Rule, or else the code of
+   * the check that failed. Never allocates.
+   */
+  static constexpr Result<Validated, ValidationErrorCode> validate(
+      const T& value) {
+    return isValid(value)
+        ? Result<Validated, ValidationErrorCode>::success(Validated(value))
+        : Result<Validated, ValidationErrorCode>::failure(
+              checkValidationErrorCode(value));
+  }
+
+  /**
+   * Returns a Validated value if both validator and Rule accept value, or
+   * else empty. For Validator<T> chains with checks beyond Rule; Rule is
+   * still checked here (it's inlined, so costs just a few compares), since
+   * validator isn't trusted to imply it.
+   */
+  static Optional<Validated> ofCheckedBy(const Validator<T>& validator,
+                                         const T& value) {
+    return (isValid(value) && validator.isValid(value))
+        ? Optional<Validated>(Validated(value)) : Optional<Validated>();
+  }
+
+  /** Returns Rule as a heap-allocated Validator<T>, to use with Validators. */
+  static std::unique_ptr<Validator<T>> validator() {
+    return validation::toValidator<T>(Rule::expression());
+  }
+
+  /** Returns the (valid) value. */
+  constexpr const T& value() const { return value_; }
+
+  /** Converts implicitly to the plain value, e.g. to pass to other APIs. */
+  constexpr operator const T&() const { return value_; }
+
+ private:
+  constexpr explicit Validated(const T& value) : value_(value) {}
+
+  T value_;
+};
+
+
+/** Returns true if the given Validated values are equal. */
+template<typename T, typename Rule>
+constexpr bool operator==(const Validated<T, Rule>& a,
+                          const Validated<T, Rule>& b) {
+  return (a.value() == b.value());
+}
+
+
+/** Returns true if the given Validated values aren't equal. */
+template<typename T, typename Rule>
+constexpr bool operator!=(const Validated<T, Rule>& a,
+                          const Validated<T, Rule>& b) {
+  return !(a == b);
+}
+
+
+/** Returns true if the first Validated value is less than the second. */
+template<typename T, typename Rule>
+constexpr bool operator<(const Validated<T, Rule>& a,
+                         const Validated<T, Rule>& b) {
+  return (a.value() < b.value());
+}
+
+
+}  // namespace oomuse
+
+#endif  // OOMUSE_CORE_VALIDATED_H
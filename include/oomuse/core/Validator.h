@@ -17,19 +17,146 @@
 #ifndef OOMUSE_CORE_VALIDATOR_H
 #define OOMUSE_CORE_VALIDATOR_H
 
+#include <cstddef>
 #include <string>
 
+#include "oomuse/core/StringBuilder.h"
+#include "oomuse/core/int_types.h"
+
 namespace oomuse {
 
 
-/** Interface for a value validator. See Validators for common cases. */
+/**
+ * Identifies which kind of check a Validator failed, without formatting (or
+ * allocating) an error message. NONE means the value is valid.
+ */
+enum class ValidationErrorCode : uint8 {
+  NONE = 0,
+  MUST_BE_LESS,
+  MUST_BE_LESS_OR_EQUAL,
+  MUST_BE_GREATER,
+  MUST_BE_GREATER_OR_EQUAL,
+  MUST_BE_EQUAL,
+  MUST_NOT_BE_EQUAL,
+  SIZE_MUST_BE_LESS_OR_EQUAL,
+  SIZE_MUST_BE_GREATER_OR_EQUAL,
+  MUST_PASS_ANY_OF,
+  MUST_BE_ASCII,
+  MUST_NOT_HAVE_CONTROL_CHARACTERS,
+  MUST_BE_VALID_UTF8,
+  MUST_HAVE_ALLOWED_CHARACTERS,
+  CODE_POINTS_MUST_BE_LESS_OR_EQUAL,
+  MUST_BE_NUMBER,
+  INVALID  // Generic failure, e.g. from a custom Validator.
+};
+
+
+/**
+ * Implements Validator::markValid() given an inlinable isValid(value)
+ * predicate. Checks 64 values at a time into a byte array, which compilers
+ * can vectorize for simple comparisons, before packing the bytes into bits.
+ */
+template<typename T, typename Predicate>
+void markValidWhere(const T* values, std::size_t length, uint64* validBits,
+                    Predicate isValid) {
+  const std::size_t numWords = (length + 63) / 64;
+  for (std::size_t word = 0; word < numWords; ++word) {
+    const T* block = values + (word * 64);
+    const std::size_t blockLength =
+        (word + 1 < numWords) ? 64 : (length - (word * 64));
+
+    uint8 passed[64] = {};
+    if (blockLength == 64) {
+      // Fixed trip count, so this loop gets unrolled and vectorized.
+      for (std::size_t i = 0; i < 64; ++i) {
+        passed[i] = isValid(block[i]) ? 1 : 0;
+      }
+    } else {
+      for (std::size_t i = 0; i < blockLength; ++i) {
+        passed[i] = isValid(block[i]) ? 1 : 0;
+      }
+    }
+
+    // Pack each 8 (0 or 1) bytes into 8 bits with one multiply: byte i lands
+    // in bit (56 + i) of the product.
+    uint64 bits = 0;
+    for (std::size_t byte = 0; byte < 64; byte += 8) {
+      uint64 eightBytes = 0;
+      for (std::size_t i = 0; i < 8; ++i) {
+        eightBytes |= static_cast<uint64>(passed[byte + i]) << (8 * i);
+      }
+      bits |= ((eightBytes * 0x0102040810204080ULL) >> 56) << byte;
+    }
+    validBits[word] = bits;
+  }
+}
+
+
+/**
+ * Interface for a value validator. See Validators for common cases.
+ *
+ * Prefer isValid() or checkValidationErrorCode() on hot paths; they never
+ * allocate. Only call checkValidationErrors() when a human-readable message is
+ * needed. Custom validators only have to implement checkValidationErrors(), but
+ * should also override isValid() and checkValidationErrorCode() to be fast.
+ */
 template<typename T>
 class Validator {
  public:
   virtual ~Validator() {}
 
+  /** Returns true if value is valid. */
+  virtual bool isValid(const T& value) const {
+    return (checkValidationErrorCode(value) == ValidationErrorCode::NONE);
+  }
+
+  /** Returns which check failed, or ValidationErrorCode::NONE if ok. */
+  virtual ValidationErrorCode checkValidationErrorCode(const T& value) const {
+    return checkValidationErrors(value).empty() ? ValidationErrorCode::NONE
+                                                : ValidationErrorCode::INVALID;
+  }
+
   /** Returns non-empty validation error if invalid, empty string if ok. */
   virtual std::string checkValidationErrors(const T& value) const = 0;
+
+  /**
+   * Appends the same validation error as checkValidationErrors() to out
+   * (nothing if value is valid). The library's validators override this to
+   * format straight into out, so that anyOf() and allOf() trees build their
+   * whole message in one buffer instead of a string per child.
+   */
+  virtual void appendValidationErrors(const T& value,
+                                      StringBuilder& out) const {
+    out.append(checkValidationErrors(value));
+  }
+
+  /**
+   * Checks length values at once, setting bit (i % 64) of validBits[i / 64]
+   * iff values[i] is valid. Writes all (length + 63) / 64 words, with unused
+   * high bits of the last word cleared. See BatchValidator for a friendlier
+   * API; validators that can check many values faster than one at a time
+   * (e.g. with SIMD compares) override this.
+   */
+  virtual void markValid(const T* values, std::size_t length,
+                         uint64* validBits) const {
+    markValidWhere(values, length, validBits,
+                   [this](const T& value) { return isValid(value); });
+  }
+
+ protected:
+  /**
+   * Implements checkValidationErrors() for validators that override
+   * appendValidationErrors(). Valid values skip the builder entirely.
+   */
+  std::string formatValidationErrors(const T& value) const {
+    if (isValid(value)) {
+      return std::string();
+    }
+
+    StringBuilder validationErrors;
+    appendValidationErrors(value, validationErrors);
+    return validationErrors.toString();
+  }
 };
 
 
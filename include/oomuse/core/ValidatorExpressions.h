@@ -0,0 +1,487 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * =============================================================================
+ * Compile-time composable validator expressions, as a lightweight alternative
+ * to the Validators factories. For example:
+ *
+ * namespace v = oomuse::validation;
+ * constexpr auto isMidiValue = v::greaterOrEqual(0) && v::less(128);
+ * if (isMidiValue.isValid(noteNumber)) { ... }
+ *
+ * Expressions are plain values (no heap allocation or virtual calls), so
+ * checks inline down to a few comparisons and can be evaluated in constexpr
+ * contexts. They produce the same error codes & messages as the equivalent
+ * Validators, and toValidator<T>() type-erases one into a Validator<T>.
+ */
+
+#ifndef OOMUSE_CORE_VALIDATOREXPRESSIONS_H
+#define OOMUSE_CORE_VALIDATOREXPRESSIONS_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "oomuse/core/StringBuilder.h"
+#include "oomuse/core/Validator.h"
+#include "oomuse/core/int_types.h"
+
+namespace oomuse {
+namespace validation {
+
+
+/** Base class marking validator expression types (enables && and ||). */
+struct ValidatorExpression {};
+
+
+/** Comparison operation for less(). */
+struct LessOp {
+  template<typename T, typename Bound>
+  static constexpr bool test(const T& value, const Bound& bound) {
+    return (value < bound);
+  }
+  static constexpr ValidationErrorCode errorCode() {
+    return ValidationErrorCode::MUST_BE_LESS;
+  }
+  static constexpr const char* description() { return "Must be less than "; }
+};
+
+
+/** Comparison operation for lessOrEqual(). */
+struct LessOrEqualOp {
+  template<typename T, typename Bound>
+  static constexpr bool test(const T& value, const Bound& bound) {
+    return (value <= bound);
+  }
+  static constexpr ValidationErrorCode errorCode() {
+    return ValidationErrorCode::MUST_BE_LESS_OR_EQUAL;
+  }
+  static constexpr const char* description() {
+    return "Must be less than or equal to ";
+  }
+};
+
+
+/** Comparison operation for greater(). */
+struct GreaterOp {
+  template<typename T, typename Bound>
+  static constexpr bool test(const T& value, const Bound& bound) {
+    return (value > bound);
+  }
+  static constexpr ValidationErrorCode errorCode() {
+    return ValidationErrorCode::MUST_BE_GREATER;
+  }
+  static constexpr const char* description() {
+    return "Must be greater than ";
+  }
+};
+
+
+/** Comparison operation for greaterOrEqual(). */
+struct GreaterOrEqualOp {
+  template<typename T, typename Bound>
+  static constexpr bool test(const T& value, const Bound& bound) {
+    return (value >= bound);
+  }
+  static constexpr ValidationErrorCode errorCode() {
+    return ValidationErrorCode::MUST_BE_GREATER_OR_EQUAL;
+  }
+  static constexpr const char* description() {
+    return "Must be greater than or equal to ";
+  }
+};
+
+
+/** Comparison operation for equal(). */
+struct EqualOp {
+  template<typename T, typename Bound>
+  static constexpr bool test(const T& value, const Bound& bound) {
+    return (value == bound);
+  }
+  static constexpr ValidationErrorCode errorCode() {
+    return ValidationErrorCode::MUST_BE_EQUAL;
+  }
+  static constexpr const char* description() { return "Must be equal to "; }
+};
+
+
+/** Comparison operation for notEqual(). */
+struct NotEqualOp {
+  template<typename T, typename Bound>
+  static constexpr bool test(const T& value, const Bound& bound) {
+    return (value != bound);
+  }
+  static constexpr ValidationErrorCode errorCode() {
+    return ValidationErrorCode::MUST_NOT_BE_EQUAL;
+  }
+  static constexpr const char* description() {
+    return "Must not be equal to ";
+  }
+};
+
+
+/** Comparison operation for sizeLessOrEqual(). */
+struct SizeLessOrEqualOp {
+  template<typename T>
+  static constexpr bool test(const T& value, std::size_t size) {
+    return (value.size() <= size);
+  }
+  static constexpr ValidationErrorCode errorCode() {
+    return ValidationErrorCode::SIZE_MUST_BE_LESS_OR_EQUAL;
+  }
+  static constexpr const char* description() {
+    return "Size/length must be less than or equal to ";
+  }
+};
+
+
+/** Comparison operation for sizeGreaterOrEqual(). */
+struct SizeGreaterOrEqualOp {
+  template<typename T>
+  static constexpr bool test(const T& value, std::size_t size) {
+    return (value.size() >= size);
+  }
+  static constexpr ValidationErrorCode errorCode() {
+    return ValidationErrorCode::SIZE_MUST_BE_GREATER_OR_EQUAL;
+  }
+  static constexpr const char* description() {
+    return "Size/length must be greater than or equal to ";
+  }
+};
+
+
+/** Validator expression comparing values against a fixed bound via Op. */
+template<typename Op, typename Bound>
+class Comparison : public ValidatorExpression {
+ public:
+  constexpr explicit Comparison(const Bound& bound) : bound_(bound) {}
+
+  /** Returns the fixed value being compared against. */
+  constexpr const Bound& bound() const { return bound_; }
+
+  /** Returns true if value is valid. */
+  template<typename T>
+  constexpr bool isValid(const T& value) const {
+    return Op::test(value, bound_);
+  }
+
+  /** Same as isValid(), so expressions can be used as predicates. */
+  template<typename T>
+  constexpr bool operator()(const T& value) const { return isValid(value); }
+
+  /** Returns which check failed, or ValidationErrorCode::NONE if ok. */
+  template<typename T>
+  constexpr ValidationErrorCode checkValidationErrorCode(const T& value) const {
+    return isValid(value) ? ValidationErrorCode::NONE : Op::errorCode();
+  }
+
+  /** Returns non-empty validation error if invalid, empty string if ok. */
+  template<typename T>
+  std::string checkValidationErrors(const T& value) const {
+    StringBuilder validationErrors;
+    appendValidationErrors(value, validationErrors);
+    return validationErrors.toString();
+  }
+
+  /** Appends checkValidationErrors(value) to out. */
+  template<typename T>
+  void appendValidationErrors(const T& value, StringBuilder& out) const {
+    if (!isValid(value)) {
+      appendMessage(out);
+    }
+  }
+
+  /** Appends errors as an allOf() child (only if this check fails). */
+  template<typename T>
+  void appendAllOfErrors(const T& value, StringBuilder& out) const {
+    if (!isValid(value)) {
+      appendMessage(out);
+      out.append('\n');
+    }
+  }
+
+  /** Appends errors as a (failed) anyOf() child. */
+  template<typename T>
+  void appendAnyOfErrors(const T&, StringBuilder& out) const {
+    out.append("  ");
+    appendMessage(out);
+    out.append('\n');
+  }
+
+ private:
+  void appendMessage(StringBuilder& out) const {
+    out.append(Op::description()).appendValue(bound_).append('.');
+  }
+
+  Bound bound_;
+};
+
+
+/** Validator expression requiring both sub-expressions to pass. */
+template<typename A, typename B>
+class AllOf : public ValidatorExpression {
+ public:
+  constexpr AllOf(const A& a, const B& b) : a_(a), b_(b) {}
+
+  /** Returns true if value is valid. */
+  template<typename T>
+  constexpr bool isValid(const T& value) const {
+    return a_.isValid(value) && b_.isValid(value);
+  }
+
+  /** Same as isValid(), so expressions can be used as predicates. */
+  template<typename T>
+  constexpr bool operator()(const T& value) const { return isValid(value); }
+
+  /** Returns the error code of the first sub-expression that fails, if any. */
+  template<typename T>
+  constexpr ValidationErrorCode checkValidationErrorCode(const T& value) const {
+    return !a_.isValid(value) ? a_.checkValidationErrorCode(value)
+                              : b_.checkValidationErrorCode(value);
+  }
+
+  /** Returns non-empty validation error if invalid, empty string if ok. */
+  template<typename T>
+  std::string checkValidationErrors(const T& value) const {
+    StringBuilder validationErrors;
+    appendValidationErrors(value, validationErrors);
+    return validationErrors.toString();
+  }
+
+  /** Appends checkValidationErrors(value) to out. */
+  template<typename T>
+  void appendValidationErrors(const T& value, StringBuilder& out) const {
+    if (!isValid(value)) {
+      appendAllOfErrors(value, out);
+    }
+  }
+
+  /** Appends errors as an allOf() child (flattening nested allOfs). */
+  template<typename T>
+  void appendAllOfErrors(const T& value, StringBuilder& out) const {
+    a_.appendAllOfErrors(value, out);
+    b_.appendAllOfErrors(value, out);
+  }
+
+  /** Appends errors as a (failed) anyOf() child. */
+  template<typename T>
+  void appendAnyOfErrors(const T& value, StringBuilder& out) const {
+    out.append("  ");
+    appendValidationErrors(value, out);
+    out.append('\n');
+  }
+
+ private:
+  A a_;
+  B b_;
+};
+
+
+/** Validator expression requiring either sub-expression to pass. */
+template<typename A, typename B>
+class AnyOf : public ValidatorExpression {
+ public:
+  constexpr AnyOf(const A& a, const B& b) : a_(a), b_(b) {}
+
+  /** Returns true if value is valid. */
+  template<typename T>
+  constexpr bool isValid(const T& value) const {
+    return a_.isValid(value) || b_.isValid(value);
+  }
+
+  /** Same as isValid(), so expressions can be used as predicates. */
+  template<typename T>
+  constexpr bool operator()(const T& value) const { return isValid(value); }
+
+  /** Returns which check failed, or ValidationErrorCode::NONE if ok. */
+  template<typename T>
+  constexpr ValidationErrorCode checkValidationErrorCode(const T& value) const {
+    return isValid(value) ? ValidationErrorCode::NONE
+                          : ValidationErrorCode::MUST_PASS_ANY_OF;
+  }
+
+  /** Returns non-empty validation error if invalid, empty string if ok. */
+  template<typename T>
+  std::string checkValidationErrors(const T& value) const {
+    StringBuilder validationErrors;
+    appendValidationErrors(value, validationErrors);
+    return validationErrors.toString();
+  }
+
+  /** Appends checkValidationErrors(value) to out. */
+  template<typename T>
+  void appendValidationErrors(const T& value, StringBuilder& out) const {
+    if (!isValid(value)) {
+      out.append("Requires one of:\n");
+      appendAnyOfErrors(value, out);
+    }
+  }
+
+  /** Appends errors as an allOf() child (only if this check fails). */
+  template<typename T>
+  void appendAllOfErrors(const T& value, StringBuilder& out) const {
+    if (!isValid(value)) {
+      appendValidationErrors(value, out);
+      out.append('\n');
+    }
+  }
+
+  /** Appends errors as a (failed) anyOf() child (flattening nested anyOfs). */
+  template<typename T>
+  void appendAnyOfErrors(const T& value, StringBuilder& out) const {
+    a_.appendAnyOfErrors(value, out);
+    b_.appendAnyOfErrors(value, out);
+  }
+
+ private:
+  A a_;
+  B b_;
+};
+
+
+/** True if Expr is a validator expression type. */
+template<typename Expr>
+using IsValidatorExpression = std::is_base_of<ValidatorExpression, Expr>;
+
+
+/** Type used to store a bound (e.g. const char* for string literals). */
+template<typename Bound>
+using StoredBound = std::decay_t<const Bound>;
+
+
+/** Returns an expression requiring values to be < bound. */
+template<typename Bound>
+constexpr Comparison<LessOp, StoredBound<Bound>> less(const Bound& bound) {
+  return Comparison<LessOp, StoredBound<Bound>>(bound);
+}
+
+/** Returns an expression requiring values to be <= bound. */
+template<typename Bound>
+constexpr Comparison<LessOrEqualOp, StoredBound<Bound>> lessOrEqual(
+    const Bound& bound) {
+  return Comparison<LessOrEqualOp, StoredBound<Bound>>(bound);
+}
+
+/** Returns an expression requiring values to be > bound. */
+template<typename Bound>
+constexpr Comparison<GreaterOp, StoredBound<Bound>> greater(
+    const Bound& bound) {
+  return Comparison<GreaterOp, StoredBound<Bound>>(bound);
+}
+
+/** Returns an expression requiring values to be >= bound. */
+template<typename Bound>
+constexpr Comparison<GreaterOrEqualOp, StoredBound<Bound>> greaterOrEqual(
+    const Bound& bound) {
+  return Comparison<GreaterOrEqualOp, StoredBound<Bound>>(bound);
+}
+
+/** Returns an expression requiring values to be == bound. */
+template<typename Bound>
+constexpr Comparison<EqualOp, StoredBound<Bound>> equal(const Bound& bound) {
+  return Comparison<EqualOp, StoredBound<Bound>>(bound);
+}
+
+/** Returns an expression requiring values to be != bound. */
+template<typename Bound>
+constexpr Comparison<NotEqualOp, StoredBound<Bound>> notEqual(
+    const Bound& bound) {
+  return Comparison<NotEqualOp, StoredBound<Bound>>(bound);
+}
+
+/** Returns an expression requiring values to have size() <= size. */
+constexpr Comparison<SizeLessOrEqualOp, std::size_t> sizeLessOrEqual(
+    std::size_t size) {
+  return Comparison<SizeLessOrEqualOp, std::size_t>(size);
+}
+
+/** Returns an expression requiring values to have size() >= size. */
+constexpr Comparison<SizeGreaterOrEqualOp, std::size_t> sizeGreaterOrEqual(
+    std::size_t size) {
+  return Comparison<SizeGreaterOrEqualOp, std::size_t>(size);
+}
+
+
+/** Returns an expression that is valid if both a and b pass. */
+template<typename A, typename B,
+         typename = std::enable_if_t<IsValidatorExpression<A>::value
+                                     && IsValidatorExpression<B>::value>>
+constexpr AllOf<A, B> operator&&(const A& a, const B& b) {
+  return AllOf<A, B>(a, b);
+}
+
+/** Returns an expression that is valid if either a or b passes. */
+template<typename A, typename B,
+         typename = std::enable_if_t<IsValidatorExpression<A>::value
+                                     && IsValidatorExpression<B>::value>>
+constexpr AnyOf<A, B> operator||(const A& a, const B& b) {
+  return AnyOf<A, B>(a, b);
+}
+
+
+/** Adapts a validator expression to the (virtual) Validator<T> interface. */
+template<typename T, typename Expr>
+class ExpressionValidator final : public Validator<T> {
+ public:
+  explicit ExpressionValidator(const Expr& expression)
+      : expression_(expression) {}
+
+  virtual bool isValid(const T& value) const {
+    return expression_.isValid(value);
+  }
+
+  virtual ValidationErrorCode checkValidationErrorCode(const T& value) const {
+    return expression_.checkValidationErrorCode(value);
+  }
+
+  virtual std::string checkValidationErrors(const T& value) const {
+    return expression_.checkValidationErrors(value);
+  }
+
+  virtual void appendValidationErrors(const T& value,
+                                      StringBuilder& out) const {
+    expression_.appendValidationErrors(value, out);
+  }
+
+  virtual void markValid(const T* values, std::size_t length,
+                         uint64* validBits) const {
+    const Expr& expression = expression_;
+    markValidWhere(values, length, validBits, [&expression](const T& value) {
+      return expression.isValid(value);
+    });
+  }
+
+ private:
+  const Expr expression_;
+};
+
+
+/**
+ * Returns a heap-allocated Validator<T> wrapping the given expression, for
+ * APIs that need the type-erased interface (like Validators::anyOf()).
+ */
+template<typename T, typename Expr>
+std::unique_ptr<Validator<T>> toValidator(const Expr& expression) {
+  static_assert(IsValidatorExpression<Expr>::value,
+                "toValidator() requires a validator expression");
+  return std::make_unique<ExpressionValidator<T, Expr>>(expression);
+}
+
+
+}  // namespace validation
+}  // namespace oomuse
+
+#endif  // OOMUSE_CORE_VALIDATOREXPRESSIONS_H
@@ -0,0 +1,441 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OOMUSE_CORE_VALIDATORSET_H
+#define OOMUSE_CORE_VALIDATORSET_H
+
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "oomuse/core/FixedArray.h"
+#include "oomuse/core/StringBuilder.h"
+#include "oomuse/core/Validator.h"
+#include "oomuse/core/Validators.h"
+#include "oomuse/core/int_types.h"
+#include "oomuse/core/readability_macros.h"
+
+namespace oomuse {
+
+
+/**
+ * A whole tree of validators laid out as one contiguous array of small nodes
+ * (a single allocation), rather than one heap object, vector, and unique_ptr
+ * per node. The children of each anyOf/allOf node are adjacent, so evaluation
+ * walks memory mostly forward instead of chasing pointers. Build one with
+ * ValidatorSet<T>::Builder:
+ *
+ *   ValidatorSet<int32>::Builder builder;
+ *   auto isMidiValue = builder.allOf({builder.greaterOrEqual(0),
+ *                                     builder.less(128)});
+ *   ValidatorSet<int32> validator =
+ *       builder.build(builder.anyOf({isMidiValue, builder.equal(255)}));
+ *
+ * Validation results, error codes, and messages match the equivalent tree
+ * built with Validators. size() checks and custom validators (added as opaque
+ * leaves) live in a separate side table. T must be default constructible and
+ * support the comparison & stream output operators.
+ */
+template<typename T>
+class ValidatorSet : public Validator<T> {
+ private:
+  enum class NodeKind : uint8 {LEAF, ANY_OF, ALL_OF};
+
+  /**
+   * A comparison leaf against bound, a size() or custom leaf (described by
+   * extras_[index]), or an anyOf/allOf over numChildren nodes starting at
+   * nodes_[index]. Kept small, since evaluation is mostly memory bound.
+   */
+  struct Node {
+    NodeKind kind;
+    ValidationErrorCode errorCode;  // If a leaf or anyOf fails.
+    uint32 index;
+    uint32 numChildren;
+    T bound;
+  };
+
+  /**
+   * Checks for size() & custom leaves. Called through function pointers that
+   * only get instantiated when used, so T needn't have size() unless checked.
+   */
+  struct LeafExtra {
+    bool (*test)(const LeafExtra& extra, const T& value);
+    void (*describe)(const LeafExtra& extra, const T& value,
+                     StringBuilder& out);
+    std::size_t size;
+    const Validator<T>* opaque;
+  };
+
+ public:
+  /** Identifies a node added to a Builder (only valid for that Builder). */
+  using NodeId = uint32;
+
+  /** Collects validator nodes, then lays them out with build(). */
+  class Builder {
+   public:
+    Builder() {}
+
+    /** Adds a node requiring values to be < value. */
+    NodeId less(const T& value) {
+      return addBound(value, ValidationErrorCode::MUST_BE_LESS);
+    }
+
+    /** Adds a node requiring values to be <= value. */
+    NodeId lessOrEqual(const T& value) {
+      return addBound(value, ValidationErrorCode::MUST_BE_LESS_OR_EQUAL);
+    }
+
+    /** Adds a node requiring values to be > value. */
+    NodeId greater(const T& value) {
+      return addBound(value, ValidationErrorCode::MUST_BE_GREATER);
+    }
+
+    /** Adds a node requiring values to be >= value. */
+    NodeId greaterOrEqual(const T& value) {
+      return addBound(value, ValidationErrorCode::MUST_BE_GREATER_OR_EQUAL);
+    }
+
+    /** Adds a node requiring values to be == value. */
+    NodeId equal(const T& value) {
+      return addBound(value, ValidationErrorCode::MUST_BE_EQUAL);
+    }
+
+    /** Adds a node requiring values to be != value. */
+    NodeId notEqual(const T& value) {
+      return addBound(value, ValidationErrorCode::MUST_NOT_BE_EQUAL);
+    }
+
+    /** Adds a node requiring values to have size() <= size. */
+    NodeId sizeLessOrEqual(std::size_t size) {
+      LeafExtra extra = {&isSizeLessOrEqual,
+                         &describeSize<SizeLessOrEqualValidator<T>>, size,
+                         nullptr};
+      return addExtra(extra, ValidationErrorCode::SIZE_MUST_BE_LESS_OR_EQUAL);
+    }
+
+    /** Adds a node requiring values to have size() >= size. */
+    NodeId sizeGreaterOrEqual(std::size_t size) {
+      LeafExtra extra = {&isSizeGreaterOrEqual,
+                         &describeSize<SizeGreaterOrEqualValidator<T>>, size,
+                         nullptr};
+      return addExtra(extra,
+                      ValidationErrorCode::SIZE_MUST_BE_GREATER_OR_EQUAL);
+    }
+
+    /** Adds an opaque node that delegates to the given (custom) validator. */
+    NodeId add(std::unique_ptr<Validator<T>> validator) {
+      LeafExtra extra = {&isOpaqueValid, &describeOpaque, 0, validator.get()};
+      opaqueValidators_.emplace_back(std::move(validator));
+      return addExtra(extra, ValidationErrorCode::INVALID);
+    }
+
+    /** Adds a node that is valid if any of the given nodes pass. */
+    NodeId anyOf(std::initializer_list<NodeId> children) {
+      return addComposite(NodeKind::ANY_OF, children.begin(), children.end());
+    }
+
+    /** Adds a node that is valid if any of the given nodes pass. */
+    NodeId anyOf(const std::vector<NodeId>& children) {
+      return addComposite(NodeKind::ANY_OF, children.data(),
+                          children.data() + children.size());
+    }
+
+    /** Adds a node that is valid if all of the given nodes pass. */
+    NodeId allOf(std::initializer_list<NodeId> children) {
+      return addComposite(NodeKind::ALL_OF, children.begin(), children.end());
+    }
+
+    /** Adds a node that is valid if all of the given nodes pass. */
+    NodeId allOf(const std::vector<NodeId>& children) {
+      return addComposite(NodeKind::ALL_OF, children.data(),
+                          children.data() + children.size());
+    }
+
+    /**
+     * Lays out the tree under root into a new ValidatorSet, in breadth-first
+     * order so that siblings are adjacent. Nodes used under more than one
+     * parent get copied. Moves side tables into the result, so this Builder
+     * shouldn't be used again afterward.
+     */
+    ValidatorSet build(NodeId root) {
+      assert(root < nodes_.size());
+      ValidatorSet validatorSet(countNodes(root), std::move(extras_),
+                                std::move(opaqueValidators_));
+
+      std::vector<NodeId> order;
+      order.reserve(validatorSet.nodes_.length());
+      order.push_back(root);
+      for (std::size_t i = 0; i < order.size(); ++i) {
+        const Node& source = nodes_[order[i]];
+        Node& node = validatorSet.nodes_[i];
+        node = source;
+        if (source.kind != NodeKind::LEAF) {
+          node.index = static_cast<uint32>(order.size());
+          order.insert(order.end(), &childIds_[source.index],
+                       &childIds_[source.index] + source.numChildren);
+        }
+      }
+
+      return validatorSet;
+    }
+
+   private:
+    CANT_COPY(Builder);
+
+    NodeId addBound(const T& bound, ValidationErrorCode errorCode) {
+      Node node = Node();
+      node.kind = NodeKind::LEAF;
+      node.errorCode = errorCode;
+      node.bound = bound;
+      return addNode(std::move(node));
+    }
+
+    NodeId addExtra(const LeafExtra& extra, ValidationErrorCode errorCode) {
+      Node node = Node();
+      node.kind = NodeKind::LEAF;
+      node.errorCode = errorCode;
+      node.index = static_cast<uint32>(extras_.size());
+      extras_.push_back(extra);
+      return addNode(std::move(node));
+    }
+
+    NodeId addComposite(NodeKind kind, const NodeId* begin,
+                        const NodeId* end) {
+      assert(begin != end);
+      Node node = Node();
+      node.kind = kind;
+      node.errorCode = ValidationErrorCode::MUST_PASS_ANY_OF;
+      node.index = static_cast<uint32>(childIds_.size());
+      node.numChildren = static_cast<uint32>(end - begin);
+      for (const NodeId* child = begin; child != end; ++child) {
+        assert(*child < nodes_.size());  // Only existing nodes, so no cycles.
+        childIds_.push_back(*child);
+      }
+      return addNode(std::move(node));
+    }
+
+    NodeId addNode(Node&& node) {
+      nodes_.emplace_back(std::move(node));
+      return static_cast<NodeId>(nodes_.size() - 1);
+    }
+
+    std::size_t countNodes(NodeId id) const {
+      const Node& node = nodes_[id];
+      std::size_t numNodes = 1;
+      for (uint32 i = 0; i < node.numChildren; ++i) {
+        numNodes += countNodes(childIds_[node.index + i]);
+      }
+      return numNodes;
+    }
+
+    std::vector<Node> nodes_;
+    std::vector<NodeId> childIds_;  // Indexed by composite Node::index.
+    std::vector<LeafExtra> extras_;
+    std::vector<std::unique_ptr<Validator<T>>> opaqueValidators_;
+  };
+
+  /** Moves another ValidatorSet into this newly constructed one. */
+  ValidatorSet(ValidatorSet&& other) = default;
+
+  /** Returns the number of nodes in the tree. */
+  std::size_t numNodes() const { return nodes_.length(); }
+
+  virtual bool isValid(const T& value) const {
+    return isValid(nodes_[0], value);
+  }
+
+  virtual ValidationErrorCode checkValidationErrorCode(const T& value) const {
+    return checkValidationErrorCode(nodes_[0], value);
+  }
+
+  virtual std::string checkValidationErrors(const T& value) const {
+    return this->formatValidationErrors(value);
+  }
+
+  virtual void appendValidationErrors(const T& value,
+                                      StringBuilder& out) const {
+    // Only format the (expensive) message once it's known to be needed.
+    if (!isValid(value)) {
+      appendValidationErrors(nodes_[0], value, out);
+    }
+  }
+
+ private:
+  CANT_COPY(ValidatorSet);
+
+  ValidatorSet(std::size_t numNodes, std::vector<LeafExtra>&& extras,
+               std::vector<std::unique_ptr<Validator<T>>>&& opaqueValidators)
+      : nodes_(numNodes), extras_(std::move(extras)),
+        opaqueValidators_(std::move(opaqueValidators)) {}
+
+  bool isValid(const Node& node, const T& value) const {
+    return (node.kind == NodeKind::LEAF) ? isLeafValid(node, value)
+                                         : isCompositeValid(node, value);
+  }
+
+  bool isCompositeValid(const Node& node, const T& value) const {
+    // anyOf passes as soon as one child passes; allOf as soon as one fails.
+    // Leaf children (the common case) get checked without recursing.
+    const bool isAnyOf = (node.kind == NodeKind::ANY_OF);
+    const Node* child = &nodes_[node.index];
+    const Node* end = child + node.numChildren;
+    for (; child != end; ++child) {
+      const bool isChildValid = (child->kind == NodeKind::LEAF)
+          ? isLeafValid(*child, value) : isCompositeValid(*child, value);
+      if (isChildValid == isAnyOf) {
+        return isAnyOf;
+      }
+    }
+    return !isAnyOf;
+  }
+
+  bool isLeafValid(const Node& node, const T& value) const {
+    switch (node.errorCode) {
+      case ValidationErrorCode::MUST_BE_LESS: return (value < node.bound);
+      case ValidationErrorCode::MUST_BE_LESS_OR_EQUAL:
+        return (value <= node.bound);
+      case ValidationErrorCode::MUST_BE_GREATER: return (value > node.bound);
+      case ValidationErrorCode::MUST_BE_GREATER_OR_EQUAL:
+        return (value >= node.bound);
+      case ValidationErrorCode::MUST_BE_EQUAL: return (value == node.bound);
+      case ValidationErrorCode::MUST_NOT_BE_EQUAL: return (value != node.bound);
+      default: {
+        const LeafExtra& extra = extras_[node.index];
+        return extra.test(extra, value);
+      }
+    }
+  }
+
+  ValidationErrorCode checkValidationErrorCode(const Node& node,
+                                               const T& value) const {
+    if (node.kind != NodeKind::ALL_OF) {
+      if (isValid(node, value)) {
+        return ValidationErrorCode::NONE;
+      }
+      return (node.errorCode == ValidationErrorCode::INVALID)
+          ? extras_[node.index].opaque->checkValidationErrorCode(value)
+          : node.errorCode;
+    }
+
+    // Like AndValidator, report the code of the first child that fails.
+    const Node* child = &nodes_[node.index];
+    const Node* end = child + node.numChildren;
+    for (; child != end; ++child) {
+      ValidationErrorCode errorCode = checkValidationErrorCode(*child, value);
+      if (errorCode != ValidationErrorCode::NONE) {
+        return errorCode;
+      }
+    }
+    return ValidationErrorCode::NONE;
+  }
+
+  /** Formats the same messages as the equivalent Validators tree would. */
+  void appendValidationErrors(const Node& node, const T& value,
+                              StringBuilder& out) const {
+    if (node.kind == NodeKind::LEAF) {
+      appendLeafErrors(node, value, out);
+      return;
+    }
+    if (isValid(node, value)) {
+      return;
+    }
+
+    const Node* child = &nodes_[node.index];
+    const Node* end = child + node.numChildren;
+    if (node.kind == NodeKind::ANY_OF) {
+      out.append("Requires one of:\n");
+      for (; child != end; ++child) {
+        out.append("  ");
+        appendValidationErrors(*child, value, out);
+        out.append('\n');
+      }
+    } else {
+      for (; child != end; ++child) {
+        const std::size_t lengthBefore = out.length();
+        appendValidationErrors(*child, value, out);
+        if (out.length() != lengthBefore) {
+          out.append('\n');
+        }
+      }
+    }
+  }
+
+  // Messages are rare, so reuse the regular validators' formatting.
+  void appendLeafErrors(const Node& node, const T& value,
+                        StringBuilder& out) const {
+    switch (node.errorCode) {
+      case ValidationErrorCode::MUST_BE_LESS:
+        LessValidator<T>(node.bound).appendValidationErrors(value, out);
+        break;
+      case ValidationErrorCode::MUST_BE_LESS_OR_EQUAL:
+        LessOrEqualValidator<T>(node.bound).appendValidationErrors(value, out);
+        break;
+      case ValidationErrorCode::MUST_BE_GREATER:
+        GreaterValidator<T>(node.bound).appendValidationErrors(value, out);
+        break;
+      case ValidationErrorCode::MUST_BE_GREATER_OR_EQUAL:
+        GreaterOrEqualValidator<T>(node.bound).appendValidationErrors(value,
+                                                                      out);
+        break;
+      case ValidationErrorCode::MUST_BE_EQUAL:
+        EqualValidator<T>(node.bound).appendValidationErrors(value, out);
+        break;
+      case ValidationErrorCode::MUST_NOT_BE_EQUAL:
+        NotEqualValidator<T>(node.bound).appendValidationErrors(value, out);
+        break;
+      default: {
+        const LeafExtra& extra = extras_[node.index];
+        extra.describe(extra, value, out);
+      }
+    }
+  }
+
+  static bool isSizeLessOrEqual(const LeafExtra& extra, const T& value) {
+    return (value.size() <= extra.size);
+  }
+
+  static bool isSizeGreaterOrEqual(const LeafExtra& extra, const T& value) {
+    return (value.size() >= extra.size);
+  }
+
+  static bool isOpaqueValid(const LeafExtra& extra, const T& value) {
+    return extra.opaque->isValid(value);
+  }
+
+  template<typename LeafValidator>
+  static void describeSize(const LeafExtra& extra, const T& value,
+                           StringBuilder& out) {
+    LeafValidator(extra.size).appendValidationErrors(value, out);
+  }
+
+  static void describeOpaque(const LeafExtra& extra, const T& value,
+                             StringBuilder& out) {
+    extra.opaque->appendValidationErrors(value, out);
+  }
+
+  FixedArray<Node> nodes_;
+  std::vector<LeafExtra> extras_;
+  std::vector<std::unique_ptr<Validator<T>>> opaqueValidators_;
+};
+
+
+}  // namespace oomuse
+
+#endif  // OOMUSE_CORE_VALIDATORSET_H
@@ -17,13 +17,19 @@
 #ifndef OOMUSE_CORE_VALIDATORS_H
 #define OOMUSE_CORE_VALIDATORS_H
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <limits>
 #include <memory>
-#include <sstream>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "oomuse/core/StringBuilder.h"
 #include "oomuse/core/Validator.h"
+#include "oomuse/core/int_types.h"
 #include "oomuse/core/readability_macros.h"
 
 namespace oomuse {
@@ -60,30 +66,54 @@ class Validators {
   /** Returns a Validator requiring all values to have size() >= size. */
   static std::unique_ptr<Validator<T>> sizeGreaterOrEqual(std::size_t size);
 
-  /** Returns a Validator that is valid if any of the given validators pass. */
+  /**
+   * Returns a Validator that is valid if any of the given validators pass.
+   * Takes any number (2+) of validators, so wide rules don't need nesting.
+   */
+  template<typename... MoreValidators>
   static std::unique_ptr<Validator<T>> anyOf(
       std::unique_ptr<Validator<T>> validator1,
-      std::unique_ptr<Validator<T>> validator2);
+      std::unique_ptr<Validator<T>> validator2,
+      MoreValidators... moreValidators);
 
   /** Returns a Validator that is valid if any of the given validators pass. */
   static std::unique_ptr<Validator<T>> anyOf(
-      std::unique_ptr<Validator<T>> validator1,
-      std::unique_ptr<Validator<T>> validator2,
-      std::unique_ptr<Validator<T>> validator3);
+      std::vector<std::unique_ptr<Validator<T>>> validators);
 
-  /** Returns a Validator that is valid if all of the given validators pass. */
+  /**
+   * Returns a Validator that is valid if all of the given validators pass.
+   * Takes any number (2+) of validators, so wide rules don't need nesting.
+   */
+  template<typename... MoreValidators>
   static std::unique_ptr<Validator<T>> allOf(
       std::unique_ptr<Validator<T>> validator1,
-      std::unique_ptr<Validator<T>> validator2);
+      std::unique_ptr<Validator<T>> validator2,
+      MoreValidators... moreValidators);
 
   /** Returns a Validator that is valid if all of the given validators pass. */
   static std::unique_ptr<Validator<T>> allOf(
-      std::unique_ptr<Validator<T>> validator1,
-      std::unique_ptr<Validator<T>> validator2,
-      std::unique_ptr<Validator<T>> validator3);
+      std::vector<std::unique_ptr<Validator<T>>> validators);
+
+  /**
+   * Returns a Validator equivalent to the given one, but faster to check:
+   * trees of anyOf(), allOf(), and comparison validators over arithmetic types
+   * get normalized into a sorted set of disjoint intervals, so isValid() is a
+   * range check or binary search. Other (opaque) validators within the tree
+   * are still evaluated as-is. Error codes & messages for invalid values come
+   * from the original validator, which the returned one takes ownership of.
+   */
+  static std::unique_ptr<Validator<T>> compile(
+      std::unique_ptr<Validator<T>> validator);
 
  private:
   CANT_INSTANTIATE(Validators);
+
+  /** Collects the given validators into one vector, in order. */
+  template<typename... MoreValidators>
+  static std::vector<std::unique_ptr<Validator<T>>> toVector(
+      std::unique_ptr<Validator<T>> validator1,
+      std::unique_ptr<Validator<T>> validator2,
+      MoreValidators... moreValidators);
 };
 
 
@@ -93,14 +123,32 @@ class LessValidator : public Validator<T> {
  public:
   explicit LessValidator(const T& value) : value_(value) {}
 
+  /** Returns the fixed value that values are compared against. */
+  const T& bound() const { return value_; }
+
+  virtual bool isValid(const T& value) const { return (value < value_); }
+
+  virtual ValidationErrorCode checkValidationErrorCode(const T& value) const {
+    return (value < value_) ? ValidationErrorCode::NONE
+        : ValidationErrorCode::MUST_BE_LESS;
+  }
+
   virtual std::string checkValidationErrors(const T& value) const {
-    if (value < value_) {
-      return "";
+    return this->formatValidationErrors(value);
+  }
+
+  virtual void appendValidationErrors(const T& value,
+                                      StringBuilder& out) const {
+    if (!(value < value_)) {
+      out.append("Must be less than ").appendValue(value_).append('.');
     }
+  }
 
-    std::stringstream validationError;
-    validationError << "Must be less than " << value_ << ".";
-    return validationError.str();
+  virtual void markValid(const T* values, std::size_t length,
+                         uint64* validBits) const {
+    const T& bound = value_;
+    markValidWhere(values, length, validBits,
+                   [&bound](const T& value) { return (value < bound); });
   }
 
  private:
@@ -114,14 +162,33 @@ class LessOrEqualValidator : public Validator<T> {
  public:
   explicit LessOrEqualValidator(const T& value) : value_(value) {}
 
+  /** Returns the fixed value that values are compared against. */
+  const T& bound() const { return value_; }
+
+  virtual bool isValid(const T& value) const { return (value <= value_); }
+
+  virtual ValidationErrorCode checkValidationErrorCode(const T& value) const {
+    return (value <= value_) ? ValidationErrorCode::NONE
+        : ValidationErrorCode::MUST_BE_LESS_OR_EQUAL;
+  }
+
   virtual std::string checkValidationErrors(const T& value) const {
-    if (value <= value_) {
-      return "";
+    return this->formatValidationErrors(value);
+  }
+
+  virtual void appendValidationErrors(const T& value,
+                                      StringBuilder& out) const {
+    if (!(value <= value_)) {
+      out.append("Must be less than or equal to ")
+          .appendValue(value_).append('.');
     }
+  }
 
-    std::stringstream validationError;
-    validationError << "Must be less than or equal to " << value_ << ".";
-    return validationError.str();
+  virtual void markValid(const T* values, std::size_t length,
+                         uint64* validBits) const {
+    const T& bound = value_;
+    markValidWhere(values, length, validBits,
+                   [&bound](const T& value) { return (value <= bound); });
   }
 
  private:
@@ -135,14 +202,32 @@ class GreaterValidator : public Validator<T> {
  public:
   explicit GreaterValidator(const T& value) : value_(value) {}
 
+  /** Returns the fixed value that values are compared against. */
+  const T& bound() const { return value_; }
+
+  virtual bool isValid(const T& value) const { return (value > value_); }
+
+  virtual ValidationErrorCode checkValidationErrorCode(const T& value) const {
+    return (value > value_) ? ValidationErrorCode::NONE
+        : ValidationErrorCode::MUST_BE_GREATER;
+  }
+
   virtual std::string checkValidationErrors(const T& value) const {
-    if (value > value_) {
-      return "";
+    return this->formatValidationErrors(value);
+  }
+
+  virtual void appendValidationErrors(const T& value,
+                                      StringBuilder& out) const {
+    if (!(value > value_)) {
+      out.append("Must be greater than ").appendValue(value_).append('.');
     }
+  }
 
-    std::stringstream validationError;
-    validationError << "Must be greater than " << value_ << ".";
-    return validationError.str();
+  virtual void markValid(const T* values, std::size_t length,
+                         uint64* validBits) const {
+    const T& bound = value_;
+    markValidWhere(values, length, validBits,
+                   [&bound](const T& value) { return (value > bound); });
   }
 
  private:
@@ -156,14 +241,33 @@ class GreaterOrEqualValidator : public Validator<T> {
  public:
   explicit GreaterOrEqualValidator(const T& value) : value_(value) {}
 
+  /** Returns the fixed value that values are compared against. */
+  const T& bound() const { return value_; }
+
+  virtual bool isValid(const T& value) const { return (value >= value_); }
+
+  virtual ValidationErrorCode checkValidationErrorCode(const T& value) const {
+    return (value >= value_) ? ValidationErrorCode::NONE
+        : ValidationErrorCode::MUST_BE_GREATER_OR_EQUAL;
+  }
+
   virtual std::string checkValidationErrors(const T& value) const {
-    if (value >= value_) {
-      return "";
+    return this->formatValidationErrors(value);
+  }
+
+  virtual void appendValidationErrors(const T& value,
+                                      StringBuilder& out) const {
+    if (!(value >= value_)) {
+      out.append("Must be greater than or equal to ")
+          .appendValue(value_).append('.');
     }
+  }
 
-    std::stringstream validationError;
-    validationError << "Must be greater than or equal to " << value_ << ".";
-    return validationError.str();
+  virtual void markValid(const T* values, std::size_t length,
+                         uint64* validBits) const {
+    const T& bound = value_;
+    markValidWhere(values, length, validBits,
+                   [&bound](const T& value) { return (value >= bound); });
   }
 
  private:
@@ -177,14 +281,32 @@ class EqualValidator : public Validator<T> {
  public:
   explicit EqualValidator(const T& value) : value_(value) {}
 
+  /** Returns the fixed value that values are compared against. */
+  const T& bound() const { return value_; }
+
+  virtual bool isValid(const T& value) const { return (value == value_); }
+
+  virtual ValidationErrorCode checkValidationErrorCode(const T& value) const {
+    return (value == value_) ? ValidationErrorCode::NONE
+        : ValidationErrorCode::MUST_BE_EQUAL;
+  }
+
   virtual std::string checkValidationErrors(const T& value) const {
-    if (value == value_) {
-      return "";
+    return this->formatValidationErrors(value);
+  }
+
+  virtual void appendValidationErrors(const T& value,
+                                      StringBuilder& out) const {
+    if (!(value == value_)) {
+      out.append("Must be equal to ").appendValue(value_).append('.');
     }
+  }
 
-    std::stringstream validationError;
-    validationError << "Must be equal to " << value_ << ".";
-    return validationError.str();
+  virtual void markValid(const T* values, std::size_t length,
+                         uint64* validBits) const {
+    const T& bound = value_;
+    markValidWhere(values, length, validBits,
+                   [&bound](const T& value) { return (value == bound); });
   }
 
  private:
@@ -198,14 +320,32 @@ class NotEqualValidator : public Validator<T> {
  public:
   explicit NotEqualValidator(const T& value) : value_(value) {}
 
+  /** Returns the fixed value that values are compared against. */
+  const T& bound() const { return value_; }
+
+  virtual bool isValid(const T& value) const { return (value != value_); }
+
+  virtual ValidationErrorCode checkValidationErrorCode(const T& value) const {
+    return (value != value_) ? ValidationErrorCode::NONE
+        : ValidationErrorCode::MUST_NOT_BE_EQUAL;
+  }
+
   virtual std::string checkValidationErrors(const T& value) const {
-    if (value != value_) {
-      return "";
+    return this->formatValidationErrors(value);
+  }
+
+  virtual void appendValidationErrors(const T& value,
+                                      StringBuilder& out) const {
+    if (!(value != value_)) {
+      out.append("Must not be equal to ").appendValue(value_).append('.');
     }
+  }
 
-    std::stringstream validationError;
-    validationError << "Must not be equal to " << value_ << ".";
-    return validationError.str();
+  virtual void markValid(const T* values, std::size_t length,
+                         uint64* validBits) const {
+    const T& bound = value_;
+    markValidWhere(values, length, validBits,
+                   [&bound](const T& value) { return (value != bound); });
   }
 
  private:
@@ -219,15 +359,30 @@ class SizeLessOrEqualValidator : public Validator<T> {
  public:
   explicit SizeLessOrEqualValidator(std::size_t size) : size_(size) {}
 
+  virtual bool isValid(const T& value) const { return (value.size() <= size_); }
+
+  virtual ValidationErrorCode checkValidationErrorCode(const T& value) const {
+    return (value.size() <= size_) ? ValidationErrorCode::NONE
+        : ValidationErrorCode::SIZE_MUST_BE_LESS_OR_EQUAL;
+  }
+
   virtual std::string checkValidationErrors(const T& value) const {
-    if (value.size() <= size_) {
-      return "";
+    return this->formatValidationErrors(value);
+  }
+
+  virtual void appendValidationErrors(const T& value,
+                                      StringBuilder& out) const {
+    if (!(value.size() <= size_)) {
+      out.append("Size/length must be less than or equal to ")
+          .appendValue(size_).append('.');
     }
+  }
 
-    std::stringstream validationError;
-    validationError << "Size/length must be less than or equal to "
-                    << size_ << ".";
-    return validationError.str();
+  virtual void markValid(const T* values, std::size_t length,
+                         uint64* validBits) const {
+    const std::size_t size = size_;
+    markValidWhere(values, length, validBits,
+                   [size](const T& value) { return (value.size() <= size); });
   }
 
  private:
@@ -241,15 +396,30 @@ class SizeGreaterOrEqualValidator : public Validator<T> {
  public:
   explicit SizeGreaterOrEqualValidator(std::size_t size) : size_(size) {}
 
+  virtual bool isValid(const T& value) const { return (value.size() >= size_); }
+
+  virtual ValidationErrorCode checkValidationErrorCode(const T& value) const {
+    return (value.size() >= size_) ? ValidationErrorCode::NONE
+        : ValidationErrorCode::SIZE_MUST_BE_GREATER_OR_EQUAL;
+  }
+
   virtual std::string checkValidationErrors(const T& value) const {
-    if (value.size() >= size_) {
-      return "";
+    return this->formatValidationErrors(value);
+  }
+
+  virtual void appendValidationErrors(const T& value,
+                                      StringBuilder& out) const {
+    if (!(value.size() >= size_)) {
+      out.append("Size/length must be greater than or equal to ")
+          .appendValue(size_).append('.');
     }
+  }
 
-    std::stringstream validationError;
-    validationError << "Size/length must be greater than or equal to "
-                    << size_ << ".";
-    return validationError.str();
+  virtual void markValid(const T* values, std::size_t length,
+                         uint64* validBits) const {
+    const std::size_t size = size_;
+    markValidWhere(values, length, validBits,
+                   [size](const T& value) { return (value.size() >= size); });
   }
 
  private:
@@ -257,6 +427,35 @@ class SizeGreaterOrEqualValidator : public Validator<T> {
 };
 
 
+/**
+ * Implements markValid() for OrValidator & AndValidator, combining the child
+ * validators' bits one chunk of values at a time (so each chunk stays in
+ * cache while every child checks it).
+ */
+template<typename T>
+void markValidCombined(
+    const std::vector<std::unique_ptr<Validator<T>>>& validators,
+    bool isAnyOf, const T* values, std::size_t length, uint64* validBits) {
+  const std::size_t CHUNK_WORDS = 32;
+  uint64 childBits[CHUNK_WORDS];
+  for (std::size_t start = 0; start < length; start += CHUNK_WORDS * 64) {
+    const std::size_t chunkLength =
+        std::min(length - start, CHUNK_WORDS * 64);
+    const std::size_t numWords = (chunkLength + 63) / 64;
+    uint64* chunkBits = validBits + (start / 64);
+
+    validators[0]->markValid(values + start, chunkLength, chunkBits);
+    for (std::size_t i = 1; i < validators.size(); ++i) {
+      validators[i]->markValid(values + start, chunkLength, childBits);
+      for (std::size_t word = 0; word < numWords; ++word) {
+        chunkBits[word] = isAnyOf ? (chunkBits[word] | childBits[word])
+                                  : (chunkBits[word] & childBits[word]);
+      }
+    }
+  }
+}
+
+
 /** Validates that any one of a fixed set of validators passes. */
 template<typename T>
 class OrValidator : public Validator<T> {
@@ -268,19 +467,47 @@ class OrValidator : public Validator<T> {
     assert(!validators_.empty());
   }
 
-  virtual std::string checkValidationErrors(const T& value) const {
-    std::stringstream validationErrors;
-    validationErrors << "Requires one of:" << std::endl;
+  /** Returns the child validators. */
+  const std::vector<UniqueValidator>& validators() const {
+    return validators_;
+  }
 
+  virtual bool isValid(const T& value) const {
     for (auto& validator : validators_) {
-      std::string error = validator->checkValidationErrors(value);
-      if (error.empty()) {
-        return "";  // OK, at least one validator passed.
+      if (validator->isValid(value)) {
+        return true;  // OK, at least one validator passed.
       }
-      validationErrors << "  " << error << std::endl;
     }
+    return false;
+  }
+
+  virtual ValidationErrorCode checkValidationErrorCode(const T& value) const {
+    return isValid(value) ? ValidationErrorCode::NONE
+                          : ValidationErrorCode::MUST_PASS_ANY_OF;
+  }
 
-    return validationErrors.str();
+  virtual std::string checkValidationErrors(const T& value) const {
+    return this->formatValidationErrors(value);
+  }
+
+  virtual void appendValidationErrors(const T& value,
+                                      StringBuilder& out) const {
+    // Only format the (expensive) message once it's known to be needed.
+    if (isValid(value)) {
+      return;
+    }
+
+    out.append("Requires one of:\n");
+    for (auto& validator : validators_) {
+      out.append("  ");
+      validator->appendValidationErrors(value, out);
+      out.append('\n');
+    }
+  }
+
+  virtual void markValid(const T* values, std::size_t length,
+                         uint64* validBits) const {
+    markValidCombined(validators_, true, values, length, validBits);
   }
 
  private:
@@ -299,17 +526,55 @@ class AndValidator : public Validator<T> {
     assert(!validators_.empty());
   }
 
+  /** Returns the child validators. */
+  const std::vector<UniqueValidator>& validators() const {
+    return validators_;
+  }
+
+  virtual bool isValid(const T& value) const {
+    for (auto& validator : validators_) {
+      if (!validator->isValid(value)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /** Returns the error code of the first validator that fails, if any. */
+  virtual ValidationErrorCode checkValidationErrorCode(const T& value) const {
+    for (auto& validator : validators_) {
+      ValidationErrorCode errorCode =
+          validator->checkValidationErrorCode(value);
+      if (errorCode != ValidationErrorCode::NONE) {
+        return errorCode;
+      }
+    }
+    return ValidationErrorCode::NONE;
+  }
+
   virtual std::string checkValidationErrors(const T& value) const {
-    std::stringstream validationErrors;
+    return this->formatValidationErrors(value);
+  }
+
+  virtual void appendValidationErrors(const T& value,
+                                      StringBuilder& out) const {
+    // Only format the (expensive) message once it's known to be needed.
+    if (isValid(value)) {
+      return;
+    }
 
     for (auto& validator : validators_) {
-      std::string error = validator->checkValidationErrors(value);
-      if (!error.empty()) {
-        validationErrors << error << std::endl;
+      const std::size_t lengthBefore = out.length();
+      validator->appendValidationErrors(value, out);
+      if (out.length() != lengthBefore) {
+        out.append('\n');
       }
     }
+  }
 
-    return validationErrors.str();
+  virtual void markValid(const T* values, std::size_t length,
+                         uint64* validBits) const {
+    markValidCombined(validators_, false, values, length, validBits);
   }
 
  private:
@@ -317,6 +582,379 @@ class AndValidator : public Validator<T> {
 };
 
 
+/**
+ * An interval of values, where either end may be unbounded, inclusive, or
+ * exclusive. Used by ValueIntervalSet.
+ */
+template<typename T>
+struct ValueInterval {
+  T lower;
+  T upper;
+  bool hasLower;
+  bool hasUpper;
+  bool lowerInclusive;
+  bool upperInclusive;
+
+  /** Returns the interval of all values. */
+  static ValueInterval all() {
+    return {T(), T(), false, false, false, false};
+  }
+
+  /** Returns the interval (-inf, upper) or (-inf, upper]. */
+  static ValueInterval below(const T& upper, bool inclusive) {
+    return {T(), upper, false, true, false, inclusive};
+  }
+
+  /** Returns the interval (lower, +inf) or [lower, +inf). */
+  static ValueInterval above(const T& lower, bool inclusive) {
+    return {lower, T(), true, false, inclusive, false};
+  }
+
+  /** Returns the single-value interval [value, value]. */
+  static ValueInterval exactly(const T& value) {
+    return {value, value, true, true, true, true};
+  }
+
+  /** Returns true if this interval starts after value. */
+  bool startsAfter(const T& value) const {
+    return hasLower
+        && ((value < lower) || (!lowerInclusive && !(lower < value)));
+  }
+
+  /** Returns true if this interval ends before value. */
+  bool endsBefore(const T& value) const {
+    return hasUpper
+        && ((upper < value) || (!upperInclusive && !(value < upper)));
+  }
+
+  /** Returns true if value is within this interval. */
+  bool contains(const T& value) const {
+    return !startsAfter(value) && !endsBefore(value);
+  }
+
+  /** Returns true if no value is within this interval. */
+  bool isEmpty() const {
+    return hasLower && hasUpper
+        && ((upper < lower)
+            || (!(lower < upper) && !(lowerInclusive && upperInclusive)));
+  }
+};
+
+
+/**
+ * A normalized set of values: a sorted list of disjoint, non-adjacent
+ * intervals. Supports union & intersection, for compiling Validator trees.
+ */
+template<typename T>
+class ValueIntervalSet {
+ public:
+  /** Constructs an empty set. */
+  ValueIntervalSet() {}
+
+  /** Constructs a set containing just the given interval. */
+  explicit ValueIntervalSet(const ValueInterval<T>& interval) {
+    if (!interval.isEmpty()) {
+      intervals_.push_back(interval);
+    }
+  }
+
+  /** Returns the normalized intervals, in increasing order. */
+  const std::vector<ValueInterval<T>>& intervals() const { return intervals_; }
+
+  /** Returns true if value is within this set. */
+  bool contains(const T& value) const {
+    // Common case: a single range check.
+    if (intervals_.size() == 1) {
+      return intervals_[0].contains(value);
+    }
+
+    // Otherwise, binary search for the last interval starting at/before value.
+    auto firstAfter = std::partition_point(
+        intervals_.begin(), intervals_.end(),
+        [&value](const ValueInterval<T>& interval) {
+          return !interval.startsAfter(value);
+        });
+    return (firstAfter != intervals_.begin())
+        && !(firstAfter - 1)->endsBefore(value);
+  }
+
+  /** Returns the union of sets a and b. */
+  static ValueIntervalSet unite(const ValueIntervalSet& a,
+                                const ValueIntervalSet& b) {
+    std::vector<ValueInterval<T>> all = a.intervals_;
+    all.insert(all.end(), b.intervals_.begin(), b.intervals_.end());
+    std::sort(all.begin(), all.end(), &startsBefore);
+
+    ValueIntervalSet result;
+    for (const ValueInterval<T>& interval : all) {
+      if (result.intervals_.empty()
+          || !overlapsOrTouches(result.intervals_.back(), interval)) {
+        result.intervals_.push_back(interval);
+      } else if (endsAfter(interval, result.intervals_.back())) {
+        ValueInterval<T>& merged = result.intervals_.back();
+        merged.upper = interval.upper;
+        merged.hasUpper = interval.hasUpper;
+        merged.upperInclusive = interval.upperInclusive;
+      }
+    }
+    return result;
+  }
+
+  /** Returns the intersection of sets a and b. */
+  static ValueIntervalSet intersect(const ValueIntervalSet& a,
+                                    const ValueIntervalSet& b) {
+    ValueIntervalSet result;
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while ((i < a.intervals_.size()) && (j < b.intervals_.size())) {
+      const ValueInterval<T>& x = a.intervals_[i];
+      const ValueInterval<T>& y = b.intervals_[j];
+
+      ValueInterval<T> overlap = startsBefore(x, y) ? y : x;
+      const ValueInterval<T>& firstEnd = endsAfter(x, y) ? y : x;
+      overlap.upper = firstEnd.upper;
+      overlap.hasUpper = firstEnd.hasUpper;
+      overlap.upperInclusive = firstEnd.upperInclusive;
+      if (!overlap.isEmpty()) {
+        result.intervals_.push_back(overlap);
+      }
+
+      // Advance past whichever interval ends first.
+      if (endsAfter(x, y)) {
+        ++j;
+      } else {
+        ++i;
+      }
+    }
+    return result;
+  }
+
+ private:
+  /** Orders intervals by lower bound (starting earlier first). */
+  static bool startsBefore(const ValueInterval<T>& a,
+                           const ValueInterval<T>& b) {
+    if (!a.hasLower || !b.hasLower) {
+      return !a.hasLower && b.hasLower;
+    }
+    return (a.lower < b.lower)
+        || (!(b.lower < a.lower) && a.lowerInclusive && !b.lowerInclusive);
+  }
+
+  /** Returns true if a's upper bound is beyond b's upper bound. */
+  static bool endsAfter(const ValueInterval<T>& a, const ValueInterval<T>& b) {
+    if (!a.hasUpper || !b.hasUpper) {
+      return !a.hasUpper && b.hasUpper;
+    }
+    return (b.upper < a.upper)
+        || (!(a.upper < b.upper) && a.upperInclusive && !b.upperInclusive);
+  }
+
+  /** Returns true if b (starting at/after a) can be merged into a. */
+  static bool overlapsOrTouches(const ValueInterval<T>& a,
+                                const ValueInterval<T>& b) {
+    if (!a.hasUpper || !b.hasLower) {
+      return true;
+    }
+    return (b.lower < a.upper)
+        || (!(a.upper < b.lower) && (a.upperInclusive || b.lowerInclusive));
+  }
+
+  std::vector<ValueInterval<T>> intervals_;
+};
+
+
+/**
+ * Validator produced by Validators::compile(). Checks values against a plan
+ * where every subtree of comparison validators has been replaced with a
+ * ValueIntervalSet, keeping the original validator for error reporting.
+ */
+template<typename T>
+class CompiledValidator : public Validator<T> {
+ public:
+  /** A node of the evaluation plan: combines intervals, opaque & children. */
+  struct PlanNode {
+    bool isAnyOf;
+    bool hasIntervals;
+    ValueIntervalSet<T> intervals;
+    std::vector<const Validator<T>*> opaqueValidators;
+    std::vector<PlanNode> children;
+  };
+
+  CompiledValidator(std::unique_ptr<Validator<T>> original, PlanNode&& plan,
+                    bool isNanValid)
+      : original_(std::move(original)), plan_(std::move(plan)),
+        isNanValid_(isNanValid) {}
+
+  /** Returns the root of the evaluation plan. */
+  const PlanNode& plan() const { return plan_; }
+
+  virtual bool isValid(const T& value) const {
+    // NaN compares unordered with every bound, so handle it separately.
+    if (value != value) {
+      return isNanValid_;
+    }
+    return isValid(plan_, value);
+  }
+
+  virtual ValidationErrorCode checkValidationErrorCode(const T& value) const {
+    return isValid(value) ? ValidationErrorCode::NONE
+                          : original_->checkValidationErrorCode(value);
+  }
+
+  virtual std::string checkValidationErrors(const T& value) const {
+    return isValid(value) ? "" : original_->checkValidationErrors(value);
+  }
+
+  virtual void appendValidationErrors(const T& value,
+                                      StringBuilder& out) const {
+    if (!isValid(value)) {
+      original_->appendValidationErrors(value, out);
+    }
+  }
+
+ private:
+  static bool isValid(const PlanNode& node, const T& value) {
+    // anyOf passes as soon as one part passes; allOf as soon as one fails.
+    const bool stopResult = node.isAnyOf;
+    if (node.hasIntervals && (node.intervals.contains(value) == stopResult)) {
+      return stopResult;
+    }
+    for (const Validator<T>* validator : node.opaqueValidators) {
+      if (validator->isValid(value) == stopResult) {
+        return stopResult;
+      }
+    }
+    for (const PlanNode& child : node.children) {
+      if (isValid(child, value) == stopResult) {
+        return stopResult;
+      }
+    }
+    return !stopResult;
+  }
+
+  std::unique_ptr<Validator<T>> original_;
+  const PlanNode plan_;
+  const bool isNanValid_;
+};
+
+
+/** Builds CompiledValidator plans (implements Validators::compile()). */
+template<typename T, bool isArithmetic = std::is_arithmetic<T>::value>
+class ValidatorCompiler {
+ public:
+  static std::unique_ptr<Validator<T>> compile(
+      std::unique_ptr<Validator<T>> validator) {
+    // Only ordered arithmetic types can be normalized into intervals.
+    return validator;
+  }
+};
+
+
+template<typename T>
+class ValidatorCompiler<T, true> {
+ public:
+  using PlanNode = typename CompiledValidator<T>::PlanNode;
+
+  static std::unique_ptr<Validator<T>> compile(
+      std::unique_ptr<Validator<T>> validator) {
+    PlanNode plan = buildPlan(*validator);
+    const bool isNanValid = std::numeric_limits<T>::has_quiet_NaN
+        && validator->isValid(std::numeric_limits<T>::quiet_NaN());
+    return std::make_unique<CompiledValidator<T>>(
+        std::move(validator), std::move(plan), isNanValid);
+  }
+
+ private:
+  /** Returns true and sets *set if validator maps exactly to intervals. */
+  static bool toIntervals(const Validator<T>& validator,
+                          ValueIntervalSet<T>* set) {
+    using Interval = ValueInterval<T>;
+    using Set = ValueIntervalSet<T>;
+
+    if (auto less = dynamic_cast<const LessValidator<T>*>(&validator)) {
+      *set = Set(Interval::below(less->bound(), false));
+    } else if (auto lessOrEqual =
+                   dynamic_cast<const LessOrEqualValidator<T>*>(&validator)) {
+      *set = Set(Interval::below(lessOrEqual->bound(), true));
+    } else if (auto greater =
+                   dynamic_cast<const GreaterValidator<T>*>(&validator)) {
+      *set = Set(Interval::above(greater->bound(), false));
+    } else if (auto greaterOrEqual =
+                   dynamic_cast<const GreaterOrEqualValidator<T>*>(
+                       &validator)) {
+      *set = Set(Interval::above(greaterOrEqual->bound(), true));
+    } else if (auto equal =
+                   dynamic_cast<const EqualValidator<T>*>(&validator)) {
+      *set = Set(Interval::exactly(equal->bound()));
+    } else if (auto notEqual =
+                   dynamic_cast<const NotEqualValidator<T>*>(&validator)) {
+      *set = Set::unite(Set(Interval::below(notEqual->bound(), false)),
+                        Set(Interval::above(notEqual->bound(), false)));
+    } else if (auto anyOf = dynamic_cast<const OrValidator<T>*>(&validator)) {
+      Set united;
+      for (auto& child : anyOf->validators()) {
+        Set childSet;
+        if (!toIntervals(*child, &childSet)) {
+          return false;
+        }
+        united = Set::unite(united, childSet);
+      }
+      *set = united;
+    } else if (auto allOf = dynamic_cast<const AndValidator<T>*>(&validator)) {
+      Set intersected(Interval::all());
+      for (auto& child : allOf->validators()) {
+        Set childSet;
+        if (!toIntervals(*child, &childSet)) {
+          return false;
+        }
+        intersected = Set::intersect(intersected, childSet);
+      }
+      *set = intersected;
+    } else {
+      return false;  // Opaque validator.
+    }
+    return true;
+  }
+
+  /** Builds a plan node, merging every compilable child into one set. */
+  static PlanNode buildPlan(const Validator<T>& validator) {
+    PlanNode node = {false, false, ValueIntervalSet<T>(), {}, {}};
+    if (toIntervals(validator, &node.intervals)) {
+      node.hasIntervals = true;
+      return node;
+    }
+
+    auto anyOf = dynamic_cast<const OrValidator<T>*>(&validator);
+    auto allOf = dynamic_cast<const AndValidator<T>*>(&validator);
+    if ((anyOf == nullptr) && (allOf == nullptr)) {
+      node.opaqueValidators.push_back(&validator);
+      return node;
+    }
+
+    node.isAnyOf = (anyOf != nullptr);
+    const auto& children =
+        (anyOf != nullptr) ? anyOf->validators() : allOf->validators();
+    for (auto& child : children) {
+      ValueIntervalSet<T> childSet;
+      if (toIntervals(*child, &childSet)) {
+        node.intervals = !node.hasIntervals ? childSet
+            : node.isAnyOf ? ValueIntervalSet<T>::unite(node.intervals,
+                                                        childSet)
+                           : ValueIntervalSet<T>::intersect(node.intervals,
+                                                            childSet);
+        node.hasIntervals = true;
+      } else if ((dynamic_cast<const OrValidator<T>*>(child.get()) != nullptr)
+          || (dynamic_cast<const AndValidator<T>*>(child.get()) != nullptr)) {
+        node.children.push_back(buildPlan(*child));
+      } else {
+        node.opaqueValidators.push_back(child.get());
+      }
+    }
+    return node;
+  }
+};
+
+
 template<typename T>
 std::unique_ptr<Validator<T>> Validators<T>::less(const T& value) {
   return std::make_unique<LessValidator<T>>(value);
@@ -367,50 +1005,64 @@ std::unique_ptr<Validator<T>> Validators<T>::sizeGreaterOrEqual(
 
 
 template<typename T>
+template<typename... MoreValidators>
 std::unique_ptr<Validator<T>> Validators<T>::anyOf(
     std::unique_ptr<Validator<T>> validator1,
-    std::unique_ptr<Validator<T>> validator2) {
-  std::vector<std::unique_ptr<Validator<T>>> validators;
-  validators.emplace_back(std::move(validator1));
-  validators.emplace_back(std::move(validator2));
-  return std::make_unique<OrValidator<T>>(std::move(validators));
+    std::unique_ptr<Validator<T>> validator2,
+    MoreValidators... moreValidators) {
+  return anyOf(toVector(std::move(validator1), std::move(validator2),
+                        std::move(moreValidators)...));
 }
 
 
 template<typename T>
 std::unique_ptr<Validator<T>> Validators<T>::anyOf(
-    std::unique_ptr<Validator<T>> validator1,
-    std::unique_ptr<Validator<T>> validator2,
-    std::unique_ptr<Validator<T>> validator3) {
-  std::vector<std::unique_ptr<Validator<T>>> validators;
-  validators.emplace_back(std::move(validator1));
-  validators.emplace_back(std::move(validator2));
-  validators.emplace_back(std::move(validator3));
+    std::vector<std::unique_ptr<Validator<T>>> validators) {
   return std::make_unique<OrValidator<T>>(std::move(validators));
 }
 
 
 template<typename T>
+template<typename... MoreValidators>
 std::unique_ptr<Validator<T>> Validators<T>::allOf(
     std::unique_ptr<Validator<T>> validator1,
-    std::unique_ptr<Validator<T>> validator2) {
-  std::vector<std::unique_ptr<Validator<T>>> validators;
-  validators.emplace_back(std::move(validator1));
-  validators.emplace_back(std::move(validator2));
-  return std::make_unique<AndValidator<T>>(std::move(validators));
+    std::unique_ptr<Validator<T>> validator2,
+    MoreValidators... moreValidators) {
+  return allOf(toVector(std::move(validator1), std::move(validator2),
+                        std::move(moreValidators)...));
 }
 
 
 template<typename T>
 std::unique_ptr<Validator<T>> Validators<T>::allOf(
+    std::vector<std::unique_ptr<Validator<T>>> validators) {
+  return std::make_unique<AndValidator<T>>(std::move(validators));
+}
+
+
+template<typename T>
+template<typename... MoreValidators>
+std::vector<std::unique_ptr<Validator<T>>> Validators<T>::toVector(
     std::unique_ptr<Validator<T>> validator1,
     std::unique_ptr<Validator<T>> validator2,
-    std::unique_ptr<Validator<T>> validator3) {
+    MoreValidators... moreValidators) {
   std::vector<std::unique_ptr<Validator<T>>> validators;
+  validators.reserve(2 + sizeof...(moreValidators));
   validators.emplace_back(std::move(validator1));
   validators.emplace_back(std::move(validator2));
-  validators.emplace_back(std::move(validator3));
-  return std::make_unique<AndValidator<T>>(std::move(validators));
+
+  // Expands to one emplace_back() per extra validator, in order.
+  using Expand = int[];
+  (void) Expand{0, (validators.emplace_back(std::move(moreValidators)), 0)...};
+
+  return validators;
+}
+
+
+template<typename T>
+std::unique_ptr<Validator<T>> Validators<T>::compile(
+    std::unique_ptr<Validator<T>> validator) {
+  return ValidatorCompiler<T>::compile(std::move(validator));
 }
 
 
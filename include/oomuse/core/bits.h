@@ -0,0 +1,78 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * =============================================================================
+ * Bit manipulation helpers shared within the library (e.g. by OptionalArray,
+ * BatchValidator, SymbolTable, and strings), with portable fallbacks where
+ * compiler builtins aren't available.
+ */
+
+#ifndef OOMUSE_CORE_BITS_H
+#define OOMUSE_CORE_BITS_H
+
+#include <cstddef>
+
+#include "oomuse/core/int_types.h"
+
+namespace oomuse {
+namespace bits {
+
+
+/** Returns the number of set bits in word (its population count). */
+inline std::size_t countBits(uint64 word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<std::size_t>(__builtin_popcountll(word));
+#else
+  // Portable SWAR popcount.
+  word = word - ((word >> 1) & 0x5555555555555555ULL);
+  word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+  word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return static_cast<std::size_t>((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+
+
+/** Returns the number of leading zero bits in word, which must be nonzero. */
+inline int countLeadingZeros(uint32 word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_clz(word);
+#else
+  int count = 0;
+  for (; (word & 0x80000000U) == 0; word <<= 1) {
+    ++count;
+  }
+  return count;
+#endif
+}
+
+/** Returns the number of leading zero bits in word, which must be nonzero. */
+inline int countLeadingZeros(uint64 word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_clzll(word);
+#else
+  int count = 0;
+  for (; (word & 0x8000000000000000ULL) == 0; word <<= 1) {
+    ++count;
+  }
+  return count;
+#endif
+}
+
+
+}  // namespace bits
+}  // namespace oomuse
+
+#endif  // OOMUSE_CORE_BITS_H
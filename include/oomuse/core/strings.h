@@ -14,60 +14,584 @@
  * limitations under the License.
  *
  * =============================================================================
- * Simple string utilities.
+ * Simple string utilities. Functions take StringRef, so they accept
+ * std::strings, string literals, and char buffers without copying.
+ *
+ * Locale-aware overloads take either a std::locale or, faster when called
+ * repeatedly, LocaleTables precomputed from one.
  */
 
 #ifndef OOMUSE_CORE_STRINGS_H
 #define OOMUSE_CORE_STRINGS_H
 
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
 #include <locale>
+#include <sstream>
 #include <string>
+#include <type_traits>
+
+#include "oomuse/core/CharacterSet.h"
+#include "oomuse/core/LocaleTables.h"
+#include "oomuse/core/Optional.h"
+#include "oomuse/core/StringArena.h"
+#include "oomuse/core/StringRef.h"
+#include "oomuse/core/int_types.h"
 
 namespace oomuse {
 namespace strings {
 
 
 /** Returns true if str is empty or all whitespace, by std::isspace(). */
-bool isEmptyOrWhitespace(const std::string& str);
+bool isEmptyOrWhitespace(StringRef str);
 
 /**
  * Returns true if str is empty or all whitespace, by std::isspace() for the
  * given locale.
  */
-bool isEmptyOrWhitespace(const std::string& str, const std::locale& loc);
+bool isEmptyOrWhitespace(StringRef str, const std::locale& loc);
+
+/**
+ * Returns true if str is empty or all whitespace, by std::isspace() for the
+ * locale that tables were built from.
+ */
+bool isEmptyOrWhitespace(StringRef str, const LocaleTables& tables);
 
 /** Returns true if str starts with prefix. */
-bool startsWith(const std::string& str, const std::string& prefix);
+bool startsWith(StringRef str, StringRef prefix);
 
 /** Returns true if str ends with suffix. */
-bool endsWith(const std::string& str, const std::string& suffix);
+bool endsWith(StringRef str, StringRef suffix);
 
-/** Returns new string with whitespace, by std::isspace(), trimmed from ends. */
+/**
+ * Returns true if a and b are equal ignoring ASCII case (i.e. A-Z match a-z,
+ * as toLowerCase() maps them; other bytes must match exactly). Compares 8
+ * bytes at a time, and never allocates.
+ */
+bool equalsIgnoreCase(StringRef a, StringRef b);
+
+/**
+ * Compares a and b lexicographically by bytes, ignoring ASCII case like
+ * equalsIgnoreCase(). Returns < 0 if a sorts first, 0 if they're equal, or > 0
+ * if b sorts first.
+ */
+int compareIgnoreCase(StringRef a, StringRef b);
+
+/** Returns true if str starts with prefix, ignoring ASCII case. */
+bool startsWithIgnoreCase(StringRef str, StringRef prefix);
+
+/**
+ * Returns a hash of str's chars (case-sensitive). Not stable across platforms
+ * or versions.
+ */
+std::size_t hash(StringRef str);
+
+/**
+ * Returns a hash of str that ignores ASCII case, so strings that are
+ * equalsIgnoreCase() hash the same. Not stable across platforms or versions.
+ */
+std::size_t hashIgnoreCase(StringRef str);
+
+/**
+ * Hash functor for case-insensitive hash containers, together with
+ * IgnoreCaseEqual. For example:
+ *
+ *   std::unordered_map<std::string, Param, strings::IgnoreCaseHash,
+ *                      strings::IgnoreCaseEqual> paramsByName;
+ */
+struct IgnoreCaseHash {
+  std::size_t operator()(StringRef str) const { return hashIgnoreCase(str); }
+};
+
+/** Equality functor for case-insensitive hash containers. */
+struct IgnoreCaseEqual {
+  bool operator()(StringRef a, StringRef b) const {
+    return equalsIgnoreCase(a, b);
+  }
+};
+
+/**
+ * Returns a view of str with whitespace, by std::isspace(), trimmed from both
+ * ends. Never allocates; the result points into str.
+ */
+StringRef trimWhitespace(StringRef str);
+
+/** Same as trimWhitespace(StringRef), for null-terminated strings. */
+StringRef trimWhitespace(const char* str);
+
+/**
+ * Returns new string with whitespace, by std::isspace(), trimmed from ends.
+ * (Returns a copy, so that trimming a temporary std::string is safe.)
+ */
 std::string trimWhitespace(const std::string& str);
 
+/**
+ * Returns a view of str with whitespace trimmed from both ends, by
+ * std::isspace() for the given locale. Never allocates.
+ */
+StringRef trimWhitespace(StringRef str, const std::locale& loc);
+
+/** Same as trimWhitespace(StringRef, loc), for null-terminated strings. */
+StringRef trimWhitespace(const char* str, const std::locale& loc);
+
 /**
  * Returns new string with whitespace trimmed from both ends, by
  * std::isspace() for the given locale.
  */
 std::string trimWhitespace(const std::string& str, const std::locale& loc);
 
-/** Returns a new string with all characters converted via std::tolower(). */
-std::string toLowerCase(const std::string& str);
+/**
+ * Returns a view of str with whitespace trimmed from both ends, by
+ * std::isspace() for the locale that tables were built from. Never
+ * allocates.
+ */
+StringRef trimWhitespace(StringRef str, const LocaleTables& tables);
+
+/** Same as trimWhitespace(StringRef, tables), for null-terminated strings. */
+StringRef trimWhitespace(const char* str, const LocaleTables& tables);
+
+/**
+ * Returns new string with whitespace trimmed from both ends, by
+ * std::isspace() for the locale that tables were built from.
+ */
+std::string trimWhitespace(const std::string& str,
+                           const LocaleTables& tables);
+
+/**
+ * Copies str with whitespace trimmed from both ends into arena, returning a
+ * view of the copy (which, unlike trimWhitespace(StringRef), doesn't depend on
+ * str staying alive).
+ */
+StringRef trimWhitespace(StringRef str, StringArena& arena);
+
+/**
+ * Returns a new string with all characters converted via std::tolower(). Runs
+ * of ASCII are converted 32 bytes at a time, mapping only A-Z (as in the
+ * default "C" locale).
+ */
+std::string toLowerCase(StringRef str);
+
+/** Converts str to lowercase like toLowerCase(), in place. */
+void toLowerCaseInPlace(std::string& str);
+
+/**
+ * Writes str converted to lowercase like toLowerCase() into out, which must
+ * have room for str.length() chars (and may be str.data() itself). Never
+ * allocates.
+ */
+void toLowerCaseInto(StringRef str, char* out);
 
 /**
  * Returns a new string with all characters converted via std::tolower() for
  * the given locale.
  */
-std::string toLowerCase(const std::string& str, const std::locale& loc);
+std::string toLowerCase(StringRef str, const std::locale& loc);
 
-/** Returns a new string with all characters converted via std::toupper(). */
-std::string toUpperCase(const std::string& str);
+/**
+ * Returns a new string with all characters converted via std::tolower() for
+ * the locale that tables were built from.
+ */
+std::string toLowerCase(StringRef str, const LocaleTables& tables);
+
+/**
+ * Writes str converted to lowercase like toLowerCase() into arena, returning a
+ * view of the result. Never allocates, other than arena blocks.
+ */
+StringRef toLowerCase(StringRef str, StringArena& arena);
+
+/**
+ * Returns a new string with all characters converted via std::toupper(). Runs
+ * of ASCII are converted 32 bytes at a time, mapping only a-z (as in the
+ * default "C" locale).
+ */
+std::string toUpperCase(StringRef str);
+
+/** Converts str to uppercase like toUpperCase(), in place. */
+void toUpperCaseInPlace(std::string& str);
+
+/**
+ * Writes str converted to uppercase like toUpperCase() into out, which must
+ * have room for str.length() chars (and may be str.data() itself). Never
+ * allocates.
+ */
+void toUpperCaseInto(StringRef str, char* out);
 
 /**
  * Returns a new string with all characters converted via std::toupper() for
  * the given locale.
  */
-std::string toUpperCase(const std::string& str, const std::locale& loc);
+std::string toUpperCase(StringRef str, const std::locale& loc);
+
+/**
+ * Returns a new string with all characters converted via std::toupper() for
+ * the locale that tables were built from.
+ */
+std::string toUpperCase(StringRef str, const LocaleTables& tables);
+
+/**
+ * Writes str converted to uppercase like toUpperCase() into arena, returning a
+ * view of the result. Never allocates, other than arena blocks.
+ */
+StringRef toUpperCase(StringRef str, StringArena& arena);
+
+/** Returns true if every byte of str is 7-bit ASCII (< 0x80). */
+bool isAscii(StringRef str);
+
+/** Returns true if str has any ASCII control characters (< 0x20 or 0x7F). */
+bool hasControlCharacters(StringRef str);
+
+/**
+ * Returns true if str is well-formed UTF-8: no invalid or truncated
+ * sequences, overlong encodings, surrogates, or code points > U+10FFFF.
+ */
+bool isValidUtf8(StringRef str);
+
+/**
+ * Returns the number of code points in str, which should be valid UTF-8
+ * (otherwise, returns the number of bytes that aren't continuation bytes).
+ */
+std::size_t countCodePoints(StringRef str);
+
+/**
+ * Returns str (which should be UTF-8) with every code point converted by the
+ * Unicode simple (one-to-one) lowercase mapping, independent of locale. Runs
+ * of ASCII are converted 32 bytes at a time. Invalid bytes are left as is.
+ * Note that the result's byte length may differ from str's.
+ */
+std::string toLowerCaseUtf8(StringRef str);
+
+/**
+ * Returns str (which should be UTF-8) with every code point converted by
+ * Unicode simple case folding, for case-insensitive comparison: two strings
+ * that differ only in case (including e.g. final sigma, or the Kelvin sign)
+ * fold to the same string. Otherwise the same as toLowerCaseUtf8().
+ */
+std::string foldCase(StringRef str);
+
+/**
+ * Returns a view of str (which should be UTF-8) with Unicode whitespace (the
+ * White_Space property, e.g. U+00A0 no-break space and U+3000 ideographic
+ * space, as well as ASCII whitespace) trimmed from both ends.
+ */
+StringRef trimUnicodeWhitespace(StringRef str);
+
+/** Same as trimUnicodeWhitespace(StringRef), for null-terminated strings. */
+StringRef trimUnicodeWhitespace(const char* str);
+
+/** Returns new string with Unicode whitespace trimmed from both ends. */
+std::string trimUnicodeWhitespace(const std::string& str);
+
+/**
+ * Parses str as a decimal integer of type T, which must be one of the int_types
+ * aliases (int8 to uint64): an optional sign ('-' only for signed types), then
+ * one or more digits, with nothing else (not even whitespace). Returns an empty
+ * Optional if str isn't in that form, or is out of T's range. Unlike
+ * std::stoi(), never throws, allocates, or depends on locale. Parses 8 digits
+ * at a time.
+ */
+template<typename T>
+Optional<T> parseInt(StringRef str);
+
+/**
+ * Parses str as a decimal number of type T (float or double): an optional
+ * sign, digits with an optional '.' (and at least one digit), then an optional
+ * exponent (e.g. "-1.5e-3"), with nothing else. Rounds to the nearest T, like
+ * std::strtod(). Returns an empty Optional if str isn't in that form, or is
+ * too large for T ("inf" and "nan" aren't accepted; tiny values round to 0).
+ *
+ * Locale-independent ('.' is always the decimal point), and never throws.
+ * Uses the Eisel-Lemire algorithm, so never allocates either, except for rare
+ * inputs with more than 19 significant digits that are too close to halfway
+ * between two Ts to round without them.
+ */
+template<typename T>
+Optional<T> parseFloat(StringRef str);
+
+/**
+ * Most chars that formatInt() writes, for any int_types integer (e.g.
+ * "-9223372036854775808").
+ */
+const std::size_t MAX_INT_CHARS = 20;
+
+/**
+ * Most chars that formatFloat() writes, for float or double (e.g.
+ * "-0.0000012345678901234567").
+ */
+const std::size_t MAX_FLOAT_CHARS = 25;
+
+/**
+ * Writes value (of one of the int_types aliases, int8 to uint64) in decimal to
+ * out, which must have room for MAX_INT_CHARS, without a null terminator.
+ * Returns out past the last char written. Unlike std::to_string() or streams,
+ * never allocates or depends on locale. Writes 2 digits per division.
+ */
+template<typename T>
+char* formatInt(T value, char* out);
+
+/** Same as formatInt(T, char*), but appends to out. */
+template<typename T>
+void formatInt(T value, std::string& out);
+
+/**
+ * Writes value (float or double) to out, which must have room for
+ * MAX_FLOAT_CHARS, without a null terminator. Returns out past the last char
+ * written. Uses the fewest digits that parseFloat<T>() (or std::strtod())
+ * reads back as exactly value, picking the closest to value if there are
+ * several (e.g. 0.1f is "0.1", not "0.100000001").
+ *
+ * Formats like JavaScript: positional notation if value's decimal point is
+ * within 21 digits of its first digit ("123", "0.5", "0.000001"), and
+ * scientific notation otherwise ("1e+21", "1.5e-7"). Also "0", "-0", "inf",
+ * "-inf", and "nan". Never allocates or depends on locale, and uses the Ryu
+ * algorithm, which is several times faster than std::snprintf("%.17g").
+ */
+template<typename T>
+char* formatFloat(T value, char* out);
+
+/** Same as formatFloat(T, char*), but appends to out. */
+template<typename T>
+void formatFloat(T value, std::string& out);
+
+/**
+ * Appends value to out: integers with formatInt() (including int8 and uint8,
+ * which streams would write as characters), floating point numbers with
+ * formatFloat() (long double as a double), and anything else (including
+ * char) with operator<<.
+ */
+template<typename T>
+std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, char>::value>
+formatValue(T value, std::string& out) {
+  using Widest = std::conditional_t<std::is_signed<T>::value, int64, uint64>;
+  formatInt(static_cast<Widest>(value), out);
+}
+
+template<typename T>
+std::enable_if_t<std::is_floating_point<T>::value>
+formatValue(T value, std::string& out) {
+  // Floats format as themselves (0.1f is "0.1"); long doubles as doubles.
+  using Formatted = std::conditional_t<std::is_same<T, float>::value, float,
+                                       double>;
+  formatFloat(static_cast<Formatted>(value), out);
+}
+
+template<typename T>
+std::enable_if_t<!std::is_arithmetic<T>::value || std::is_same<T, char>::value>
+formatValue(const T& value, std::string& out) {
+  std::ostringstream stream;
+  stream << value;
+  out += stream.str();
+}
+
+/**
+ * Converts each string in [first, last) to lowercase into arena, writing a
+ * StringRef for each to out (e.g. a std::back_inserter, or a StringRef*).
+ * Returns out past the last result. Avoids per-string heap allocations, so
+ * is much faster than toLowerCase(StringRef) for many short strings.
+ */
+template<typename InputIt, typename OutputIt>
+OutputIt toLowerCaseAll(InputIt first, InputIt last, StringArena& arena,
+                        OutputIt out) {
+  for (; first != last; ++first, ++out) {
+    *out = toLowerCase(StringRef(*first), arena);
+  }
+  return out;
+}
+
+/** Same as toLowerCaseAll(), but converts to uppercase. */
+template<typename InputIt, typename OutputIt>
+OutputIt toUpperCaseAll(InputIt first, InputIt last, StringArena& arena,
+                        OutputIt out) {
+  for (; first != last; ++first, ++out) {
+    *out = toUpperCase(StringRef(*first), arena);
+  }
+  return out;
+}
+
+/**
+ * Copies each string in [first, last) with whitespace trimmed into arena,
+ * writing a StringRef for each to out. Returns out past the last result.
+ */
+template<typename InputIt, typename OutputIt>
+OutputIt trimWhitespaceAll(InputIt first, InputIt last, StringArena& arena,
+                           OutputIt out) {
+  for (; first != last; ++first, ++out) {
+    *out = trimWhitespace(StringRef(*first), arena);
+  }
+  return out;
+}
+
+
+/** Options for split(), which can be combined with |. */
+enum class SplitOptions : uint8 {
+  NONE = 0,
+
+  /** Trims whitespace from both ends of each field (as trimWhitespace()). */
+  TRIM_WHITESPACE = 1,
+
+  /** Skips empty fields (checked after trimming, if also set). */
+  SKIP_EMPTY = 2
+};
+
+inline SplitOptions operator|(SplitOptions a, SplitOptions b) {
+  return static_cast<SplitOptions>(static_cast<uint8>(a)
+                                   | static_cast<uint8>(b));
+}
+
+inline bool hasOption(SplitOptions options, SplitOptions option) {
+  return (static_cast<uint8>(options) & static_cast<uint8>(option)) != 0;
+}
+
+
+/**
+ * Lazy range of the fields of a string split by delimiters (see split()).
+ * Fields are StringRef views into the original string (which must outlive
+ * them), found one at a time as the range is iterated, so splitting never
+ * allocates.
+ */
+class SplitRange {
+ public:
+  /** Input iterator over the fields of a SplitRange. */
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = StringRef;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const StringRef*;
+    using reference = const StringRef&;
+
+    /** Returns the current field. */
+    const StringRef& operator*() const { return field_; }
+    const StringRef* operator->() const { return &field_; }
+
+    /** Advances to the next field. */
+    Iterator& operator++() {
+      advance();
+      return *this;
+    }
+
+    /** Returns true if both are at the end, or at the same field. */
+    bool operator==(const Iterator& other) const {
+      if ((range_ == nullptr) || (other.range_ == nullptr)) {
+        return (range_ == other.range_);
+      }
+      return (field_.data() == other.field_.data());
+    }
+
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+   private:
+    friend class SplitRange;
+
+    /** Constructs the end iterator. */
+    Iterator() : range_(nullptr), next_(nullptr), isLastField_(true) {}
+
+    /** Constructs an iterator at the first field of range. */
+    explicit Iterator(const SplitRange* range);
+
+    /** Finds the next field (skipping empty ones, if requested). */
+    void advance();
+
+    /** Finds the next raw field, returning false if there are no more. */
+    bool findNextField();
+
+    const SplitRange* range_;  // Or nullptr once past the last field.
+    const char* next_;  // Start of the next field, unless isLastField_.
+    bool isLastField_;
+    StringRef field_;
+  };
+
+  Iterator begin() const { return Iterator(this); }
+  Iterator end() const { return Iterator(); }
+
+ private:
+  friend SplitRange split(StringRef str, char delimiter,
+                          SplitOptions options);
+  friend SplitRange split(StringRef str, const CharacterSet& delimiters,
+                          SplitOptions options);
+
+  /** Max delimiters to search for by bytes, rather than by bitmap. */
+  static const std::size_t MAX_DELIMITER_BYTES = 4;
+
+  SplitRange(StringRef str, const CharacterSet& delimiters,
+             SplitOptions options)
+      : str_(str), delimiters_(delimiters), options_(options) {
+    numDelimiterBytes_ =
+        delimiters.copyMembers(delimiterBytes_, MAX_DELIMITER_BYTES);
+  }
+
+  /** Returns the first delimiter in [begin, end), or end if none. */
+  const char* findDelimiter(const char* begin, const char* end) const;
+
+  StringRef str_;
+  CharacterSet delimiters_;
+  char delimiterBytes_[MAX_DELIMITER_BYTES];
+  std::size_t numDelimiterBytes_;
+  SplitOptions options_;
+};
+
+
+/**
+ * Returns a lazy range of the fields of str between each delimiter. For
+ * example, split("a,b,,c", ',') has fields "a", "b", "", and "c", while
+ * split("", ',') has just one empty field (and none with SKIP_EMPTY). Short
+ * fields are found 8 bytes at a time (SWAR), and longer ones with memchr(),
+ * which the standard library vectorizes:
+ *
+ *   for (StringRef line : strings::split(text, '\n')) {
+ *     for (StringRef field : strings::split(line, ',',
+ *                                           SplitOptions::TRIM_WHITESPACE)) {
+ *       ...
+ *     }
+ *   }
+ */
+SplitRange split(StringRef str, char delimiter,
+                 SplitOptions options = SplitOptions::NONE);
+
+/**
+ * Same as split(str, delimiter), but any byte in delimiters ends a field.
+ * Up to 4 delimiters are found 8 bytes at a time (SWAR); larger sets are
+ * checked 8 bytes at a time against delimiters' bitmap, with one branch per 8.
+ */
+SplitRange split(StringRef str, const CharacterSet& delimiters,
+                 SplitOptions options = SplitOptions::NONE);
+
+/**
+ * Returns the given parts (any range of things convertible to StringRef, e.g.
+ * std::vector<std::string> or a SplitRange) joined with separator between
+ * each. Computes the total length first, so it allocates only once.
+ */
+template<typename Range>
+std::string join(const Range& parts, StringRef separator) {
+  std::size_t length = 0;
+  std::size_t numParts = 0;
+  for (const auto& part : parts) {
+    length += StringRef(part).length();
+    ++numParts;
+  }
+  if (numParts > 1) {
+    length += separator.length() * (numParts - 1);
+  }
+
+  std::string joined;
+  joined.reserve(length);
+  bool isFirst = true;
+  for (const auto& part : parts) {
+    if (!isFirst) {
+      joined.append(separator.data(), separator.length());
+    }
+    isFirst = false;
+    const StringRef partRef(part);
+    joined.append(partRef.data(), partRef.length());
+  }
+  return joined;
+}
+
+/** Same as join(parts, separator), for a braced list of parts. */
+inline std::string join(std::initializer_list<StringRef> parts,
+                        StringRef separator) {
+  return join<std::initializer_list<StringRef>>(parts, separator);
+}
 
 
 }  // namespace strings
@@ -0,0 +1,230 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/InstrumentedValidator.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "oomuse/core/StringBuilder.h"
+#include "oomuse/core/bits.h"
+#include "oomuse/core/int_types.h"
+
+using std::string;
+using std::vector;
+
+namespace oomuse {
+
+namespace {
+
+
+const std::size_t NUM_BUCKETS = ValidatorStatsSnapshot::NUM_LATENCY_BUCKETS;
+
+
+/** Returns this thread's counter shard, assigning shards round-robin. */
+std::size_t currentShardIndex() {
+  static std::atomic<std::size_t> nextShardIndex(0);
+  static thread_local const std::size_t shardIndex =
+      nextShardIndex.fetch_add(1, std::memory_order_relaxed)
+      % ValidatorStats::NUM_SHARDS;
+  return shardIndex;
+}
+
+
+/** Calls on this thread since the last timed one. */
+thread_local uint32 numCallsSinceTimed = 0;
+
+
+/** Returns the histogram bucket for the given latency (1 + floor(log2)). */
+std::size_t latencyBucket(uint64 latencyNanos) {
+  if (latencyNanos == 0) {
+    return 0;
+  }
+
+  const std::size_t bucket =
+      64 - static_cast<std::size_t>(bits::countLeadingZeros(latencyNanos));
+  return (bucket < NUM_BUCKETS) ? bucket : (NUM_BUCKETS - 1);
+}
+
+
+}  // namespace
+
+
+uint64 ValidatorStatsSnapshot::latencyPercentileNanos(double percentile) const {
+  uint64 numTimedCalls = 0;
+  for (uint64 count : latencyHistogram_) {
+    numTimedCalls += count;
+  }
+  if (numTimedCalls == 0) {
+    return 0;
+  }
+
+  // Find the bucket holding the call at the given rank (counting from 1).
+  uint64 rank =
+      static_cast<uint64>(std::ceil(percentile / 100.0 * numTimedCalls));
+  if (rank < 1) {
+    rank = 1;
+  }
+  uint64 numCallsSoFar = 0;
+  for (std::size_t bucket = 0; bucket < NUM_BUCKETS; ++bucket) {
+    numCallsSoFar += latencyHistogram_[bucket];
+    if (numCallsSoFar >= rank) {
+      return (bucket == 0) ? 0 : (static_cast<uint64>(1) << bucket);
+    }
+  }
+  return static_cast<uint64>(1) << (NUM_BUCKETS - 1);
+}
+
+
+ValidatorStats::ValidatorStats(const string& name,
+                               const std::atomic<bool>& enabled)
+    : name_(name), enabled_(enabled), shards_(new Shard[NUM_SHARDS]()) {}
+
+
+bool ValidatorStats::shouldTimeNextCall() {
+  if (++numCallsSinceTimed < LATENCY_SAMPLE_INTERVAL) {
+    return false;
+  }
+  numCallsSinceTimed = 0;
+  return true;
+}
+
+
+void ValidatorStats::record(bool isValid) {
+  Shard& shard = shards_[currentShardIndex()];
+  shard.numCalls.fetch_add(1, std::memory_order_relaxed);
+  if (!isValid) {
+    shard.numFailures.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+
+void ValidatorStats::record(bool isValid, uint64 latencyNanos) {
+  Shard& shard = shards_[currentShardIndex()];
+  shard.numCalls.fetch_add(1, std::memory_order_relaxed);
+  if (!isValid) {
+    shard.numFailures.fetch_add(1, std::memory_order_relaxed);
+  }
+  shard.latencyHistogram[latencyBucket(latencyNanos)].fetch_add(
+      1, std::memory_order_relaxed);
+}
+
+
+void ValidatorStats::recordBatch(const uint64* validBits, std::size_t length,
+                                 uint64 latencyNanos) {
+  if (length == 0) {
+    return;
+  }
+
+  std::size_t numValid = 0;
+  for (std::size_t i = 0; i < (length + 63) / 64; ++i) {
+    numValid += bits::countBits(validBits[i]);
+  }
+
+  Shard& shard = shards_[currentShardIndex()];
+  shard.numCalls.fetch_add(length, std::memory_order_relaxed);
+  shard.numFailures.fetch_add(length - numValid, std::memory_order_relaxed);
+  shard.latencyHistogram[latencyBucket(latencyNanos / length)].fetch_add(
+      length, std::memory_order_relaxed);
+}
+
+
+ValidatorStatsSnapshot ValidatorStats::snapshot() const {
+  ValidatorStatsSnapshot snapshot(name_);
+  for (std::size_t i = 0; i < NUM_SHARDS; ++i) {
+    const Shard& shard = shards_[i];
+    snapshot.numCalls_ += shard.numCalls.load(std::memory_order_relaxed);
+    snapshot.numFailures_ += shard.numFailures.load(std::memory_order_relaxed);
+    for (std::size_t bucket = 0; bucket < NUM_BUCKETS; ++bucket) {
+      snapshot.latencyHistogram_[bucket] +=
+          shard.latencyHistogram[bucket].load(std::memory_order_relaxed);
+    }
+  }
+  return snapshot;
+}
+
+
+void ValidatorStats::reset() {
+  for (std::size_t i = 0; i < NUM_SHARDS; ++i) {
+    Shard& shard = shards_[i];
+    shard.numCalls.store(0, std::memory_order_relaxed);
+    shard.numFailures.store(0, std::memory_order_relaxed);
+    for (std::size_t bucket = 0; bucket < NUM_BUCKETS; ++bucket) {
+      shard.latencyHistogram[bucket].store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+
+ValidatorStatsRegistry& ValidatorStatsRegistry::global() {
+  static ValidatorStatsRegistry globalRegistry;
+  return globalRegistry;
+}
+
+
+ValidatorStats& ValidatorStatsRegistry::statsFor(const string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::unique_ptr<ValidatorStats>& stats = statsByName_[name];
+  if (!stats) {
+    stats.reset(new ValidatorStats(name, enabled_));
+  }
+  return *stats;
+}
+
+
+vector<ValidatorStatsSnapshot> ValidatorStatsRegistry::snapshot() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  vector<ValidatorStatsSnapshot> snapshots;
+  snapshots.reserve(statsByName_.size());
+  for (const auto& nameAndStats : statsByName_) {
+    snapshots.push_back(nameAndStats.second->snapshot());
+  }
+  return snapshots;
+}
+
+
+string ValidatorStatsRegistry::dump() const {
+  StringBuilder summary;
+  for (const ValidatorStatsSnapshot& stats : snapshot()) {
+    // Failure percentage with 1 decimal place.
+    const uint64 permille =
+        static_cast<uint64>(std::llround(stats.failureRate() * 1000.0));
+    summary.append(stats.name()).append(": ").append(stats.numCalls())
+        .append(" calls, ").append(stats.numFailures()).append(" failures (")
+        .append(permille / 10).append('.')
+        .append(static_cast<char>('0' + (permille % 10)))
+        .append("%), p50 <= ").append(stats.latencyPercentileNanos(50.0))
+        .append(" ns, p99 <= ").append(stats.latencyPercentileNanos(99.0))
+        .append(" ns\n");
+  }
+  return summary.toString();
+}
+
+
+void ValidatorStatsRegistry::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& nameAndStats : statsByName_) {
+    nameAndStats.second->reset();
+  }
+}
+
+
+}  // namespace oomuse
@@ -0,0 +1,58 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/LocaleTables.h"
+
+#include <cstddef>
+#include <locale>
+
+#include "oomuse/core/int_types.h"
+
+namespace oomuse {
+
+
+LocaleTables::LocaleTables(const std::locale& loc) {
+  char chars[256];
+  for (std::size_t i = 0; i < 256; ++i) {
+    chars[i] = static_cast<char>(static_cast<uint8>(i));
+  }
+
+  // Classify and convert all 256 chars with one (bulk) call each.
+  const auto& ctype = std::use_facet<std::ctype<char>>(loc);
+  std::ctype_base::mask masks[256];
+  ctype.is(chars, chars + 256, masks);
+  for (std::size_t i = 0; i < 256; ++i) {
+    isSpace_[i] = ((masks[i] & std::ctype_base::space) != 0) ? 1 : 0;
+    toLower_[i] = chars[i];
+    toUpper_[i] = chars[i];
+  }
+  ctype.tolower(toLower_, toLower_ + 256);
+  ctype.toupper(toUpper_, toUpper_ + 256);
+
+  hasStandardAscii_ = true;
+  for (int c = 0; c < 0x80; ++c) {
+    const bool isStandardSpace = ((c >= '\t') && (c <= '\r')) || (c == ' ');
+    const int standardLower = ((c >= 'A') && (c <= 'Z')) ? (c + 0x20) : c;
+    const int standardUpper = ((c >= 'a') && (c <= 'z')) ? (c - 0x20) : c;
+    if (((isSpace_[c] != 0) != isStandardSpace)
+        || (toLower_[c] != standardLower) || (toUpper_[c] != standardUpper)) {
+      hasStandardAscii_ = false;
+    }
+  }
+}
+
+
+}  // namespace oomuse
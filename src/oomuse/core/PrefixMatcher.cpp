@@ -0,0 +1,256 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/PrefixMatcher.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace oomuse {
+
+namespace {
+
+
+/** Trie state whose children haven't been placed yet, during build(). */
+struct PendingState {
+  int32 state;
+  std::size_t lo;  // Range of order[] for keys under this state.
+  std::size_t hi;
+  std::size_t depth;  // Length of the prefix shared by those keys.
+};
+
+
+/** End of SlotAllocator's free slot list. */
+const std::size_t LIST_END = static_cast<std::size_t>(-1);
+
+/** Times a free slot can fail to fit a node before it's no longer tried. */
+const uint8 MAX_FAILURES = 16;
+
+
+/**
+ * Tracks which double-array slots are free, while the trie is built. Free
+ * slots form a linked list, so finding a base skips taken ones. Free slots
+ * that repeatedly fail to fit a node are dropped from the list (though they
+ * stay free), which keeps building near-linear at the cost of a few holes.
+ */
+class SlotAllocator {
+ public:
+  SlotAllocator(std::vector<int32>& base, std::vector<int32>& check,
+                std::vector<int32>& patternIndex)
+      : base_(base), check_(check), patternIndex_(patternIndex),
+        used_(1, true), numFailures_(1, 0), nextFree_(1, LIST_END),
+        prevFree_(1, LIST_END), firstFree_(LIST_END), lastFree_(LIST_END) {
+    base_.assign(1, 0);
+    check_.assign(1, -1);
+    patternIndex_.assign(1, -1);
+  }
+
+  /**
+   * Returns a base >= 1 for which every slot base + label is free. Labels
+   * must be sorted and non-empty.
+   */
+  int32 findBase(const std::vector<uint8>& labels) {
+    const std::size_t minSlot = labels.front() + 1;
+    std::size_t slot = firstFree_;
+    while (true) {
+      if (slot == LIST_END) {
+        slot = std::max(used_.size(), minSlot);
+        reserve(slot + 1);
+      }
+      if (slot >= minSlot) {
+        const std::size_t base = slot - labels.front();
+        reserve(base + labels.back() + 1);
+        if (fits(base, labels)) {
+          return static_cast<int32>(base);
+        }
+      }
+      const std::size_t next = nextFree_[slot];
+      if ((slot >= minSlot) && (++numFailures_[slot] >= MAX_FAILURES)) {
+        unlink(slot);
+      }
+      slot = next;
+    }
+  }
+
+  /** Marks the given slot taken, as a child of parent. */
+  void take(std::size_t slot, int32 parent) {
+    used_[slot] = true;
+    check_[slot] = parent;
+    unlink(slot);
+  }
+
+ private:
+  bool fits(std::size_t base, const std::vector<uint8>& labels) const {
+    for (uint8 label : labels) {
+      if (used_[base + label]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void reserve(std::size_t numSlots) {
+    const std::size_t oldNumSlots = used_.size();
+    if (numSlots <= oldNumSlots) {
+      return;
+    }
+    used_.resize(numSlots, false);
+    numFailures_.resize(numSlots, 0);
+    nextFree_.resize(numSlots, LIST_END);
+    prevFree_.resize(numSlots, LIST_END);
+    base_.resize(numSlots, 0);
+    check_.resize(numSlots, -1);
+    patternIndex_.resize(numSlots, -1);
+    for (std::size_t slot = oldNumSlots; slot < numSlots; ++slot) {
+      prevFree_[slot] = lastFree_;
+      if (lastFree_ == LIST_END) {
+        firstFree_ = slot;
+      } else {
+        nextFree_[lastFree_] = slot;
+      }
+      lastFree_ = slot;
+    }
+  }
+
+  /** Removes a slot from the free list (if it's still in it). */
+  void unlink(std::size_t slot) {
+    const std::size_t prev = prevFree_[slot];
+    const std::size_t next = nextFree_[slot];
+    if ((prev == LIST_END) && (firstFree_ != slot)) {
+      return;  // Already unlinked.
+    }
+    if (prev == LIST_END) {
+      firstFree_ = next;
+    } else {
+      nextFree_[prev] = next;
+    }
+    if (next == LIST_END) {
+      lastFree_ = prev;
+    } else {
+      prevFree_[next] = prev;
+    }
+    prevFree_[slot] = LIST_END;
+    nextFree_[slot] = LIST_END;
+  }
+
+  std::vector<int32>& base_;
+  std::vector<int32>& check_;
+  std::vector<int32>& patternIndex_;
+  std::vector<bool> used_;
+  std::vector<uint8> numFailures_;
+  std::vector<std::size_t> nextFree_;  // Doubly linked list of free slots.
+  std::vector<std::size_t> prevFree_;
+  std::size_t firstFree_;
+  std::size_t lastFree_;
+};
+
+
+/** Copies a vector into a newly allocated FixedArray. */
+FixedArray<int32> toFixedArray(const std::vector<int32>& values) {
+  FixedArray<int32> array(values.size(), FixedArray<int32>::SKIP_DEFAULT_INIT);
+  std::copy(values.begin(), values.end(), array.begin());
+  return array;
+}
+
+
+}  // namespace
+
+
+PatternTrie::PatternTrie(const std::vector<std::string>& keys,
+                         bool reverseKeys)
+    : PatternTrie(build(keys, reverseKeys)) {}
+
+
+PatternTrie::PatternTrie(const Arrays& arrays)
+    : base_(toFixedArray(arrays.base)), check_(toFixedArray(arrays.check)),
+      patternIndex_(toFixedArray(arrays.patternIndex)) {}
+
+
+PatternTrie::Arrays PatternTrie::build(const std::vector<std::string>& keys,
+                                       bool reverseKeys) {
+  std::vector<std::string> reversedKeys;
+  if (reverseKeys) {
+    reversedKeys.reserve(keys.size());
+    for (const std::string& key : keys) {
+      reversedKeys.emplace_back(key.rbegin(), key.rend());
+    }
+  }
+  const std::vector<std::string>& sortedKeys =
+      reverseKeys ? reversedKeys : keys;
+
+  // Sort key indices, so each trie state's keys form a contiguous range (and
+  // duplicates keep the lowest index first).
+  std::vector<int32> order(keys.size());
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    order[i] = static_cast<int32>(i);
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&sortedKeys](int32 a, int32 b) {
+                     return sortedKeys[a] < sortedKeys[b];
+                   });
+
+  Arrays arrays;
+  SlotAllocator slots(arrays.base, arrays.check, arrays.patternIndex);
+  std::vector<PendingState> pending{{0, 0, order.size(), 0}};
+  std::vector<uint8> labels;
+  std::vector<std::size_t> labelStarts;
+  while (!pending.empty()) {
+    PendingState current = pending.back();
+    pending.pop_back();
+
+    // Keys ending here sort first; the first of them is the pattern.
+    if ((current.lo < current.hi)
+        && (sortedKeys[order[current.lo]].size() == current.depth)) {
+      arrays.patternIndex[current.state] = order[current.lo];
+      while ((current.lo < current.hi)
+             && (sortedKeys[order[current.lo]].size() == current.depth)) {
+        ++current.lo;
+      }
+    }
+    if (current.lo == current.hi) {
+      continue;  // Leaf state.
+    }
+
+    // Group the remaining keys by their next byte.
+    labels.clear();
+    labelStarts.clear();
+    for (std::size_t i = current.lo; i < current.hi; ++i) {
+      const uint8 label =
+          static_cast<uint8>(sortedKeys[order[i]][current.depth]);
+      if (labels.empty() || (label != labels.back())) {
+        labels.push_back(label);
+        labelStarts.push_back(i);
+      }
+    }
+    labelStarts.push_back(current.hi);
+
+    const int32 base = slots.findBase(labels);
+    arrays.base[current.state] = base;
+    for (std::size_t i = 0; i < labels.size(); ++i) {
+      const int32 child = base + labels[i];
+      slots.take(static_cast<std::size_t>(child), current.state);
+      pending.push_back({child, labelStarts[i], labelStarts[i + 1],
+                         current.depth + 1});
+    }
+  }
+
+  return arrays;
+}
+
+
+}  // namespace oomuse
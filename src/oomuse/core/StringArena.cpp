@@ -0,0 +1,58 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/StringArena.h"
+
+#include <cstddef>
+#include <memory>
+
+namespace oomuse {
+
+
+StringArena::StringArena(std::size_t blockSize)
+    : blockSize_((blockSize > 0) ? blockSize : 1), numBlocksInUse_(0),
+      next_(nullptr), end_(nullptr), numBytesUsed_(0) {}
+
+
+void StringArena::clear() {
+  largeBlocks_.clear();
+  numBlocksInUse_ = 0;
+  next_ = nullptr;
+  end_ = nullptr;
+  numBytesUsed_ = 0;
+}
+
+
+char* StringArena::allocateSlow(std::size_t length) {
+  if (length > blockSize_ / 4) {
+    // Give large strings their own block, without wasting the rest of the
+    // current one.
+    largeBlocks_.emplace_back(new char[length]);
+    numBytesUsed_ += length;
+    return largeBlocks_.back().get();
+  }
+
+  if (numBlocksInUse_ == blocks_.size()) {
+    blocks_.emplace_back(new char[blockSize_]);
+  }
+  next_ = blocks_[numBlocksInUse_].get();
+  end_ = next_ + blockSize_;
+  ++numBlocksInUse_;
+  return allocate(length);
+}
+
+
+}  // namespace oomuse
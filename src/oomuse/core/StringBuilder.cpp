@@ -0,0 +1,50 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/StringBuilder.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+
+namespace oomuse {
+
+
+const std::size_t StringBuilder::INLINE_CAPACITY;
+
+
+StringBuilder& StringBuilder::appendGrowing(StringRef str) {
+  // Keep the old heap buffer (if any) alive past grow() until str is copied.
+  std::unique_ptr<char[]> oldChars = std::move(heapChars_);
+  grow(length_ + str.length());
+  std::memcpy(data_ + length_, str.data(), str.length());
+  length_ += str.length();
+  return *this;
+}
+
+
+void StringBuilder::grow(std::size_t minCapacity) {
+  const std::size_t capacity = std::max(minCapacity, 2 * capacity_);
+  std::unique_ptr<char[]> chars(new char[capacity]);
+  std::memcpy(chars.get(), data_, length_);
+  heapChars_ = std::move(chars);
+  data_ = heapChars_.get();
+  capacity_ = capacity;
+}
+
+
+}  // namespace oomuse
@@ -0,0 +1,29 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/StringRef.h"
+
+#include <cstddef>
+
+namespace oomuse {
+
+
+// Out-of-line definition, so npos can be bound to references (e.g. by gtest
+// macros) before C++17 inline variables.
+const std::size_t StringRef::npos;
+
+
+}  // namespace oomuse
@@ -0,0 +1,187 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/StringValidators.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "oomuse/core/CharacterSet.h"
+#include "oomuse/core/StringBuilder.h"
+#include "oomuse/core/Validator.h"
+#include "oomuse/core/strings.h"
+
+using std::make_unique;
+using std::string;
+using std::unique_ptr;
+
+namespace oomuse {
+
+namespace {
+
+
+/**
+ * Base class for string validators with a single check and a fixed error
+ * message (subclasses implement isValid()).
+ */
+class FixedMessageStringValidator : public Validator<string> {
+ public:
+  FixedMessageStringValidator(ValidationErrorCode errorCode,
+                              const char* message)
+      : errorCode_(errorCode), message_(message) {}
+
+  virtual ValidationErrorCode checkValidationErrorCode(
+      const string& value) const {
+    return isValid(value) ? ValidationErrorCode::NONE : errorCode_;
+  }
+
+  virtual string checkValidationErrors(const string& value) const {
+    return isValid(value) ? "" : message_;
+  }
+
+  virtual void appendValidationErrors(const string& value,
+                                      StringBuilder& out) const {
+    if (!isValid(value)) {
+      out.append(message_);
+    }
+  }
+
+ private:
+  const ValidationErrorCode errorCode_;
+  const char* const message_;
+};
+
+
+class AsciiOnlyValidator : public FixedMessageStringValidator {
+ public:
+  AsciiOnlyValidator()
+      : FixedMessageStringValidator(ValidationErrorCode::MUST_BE_ASCII,
+                                    "Must contain only ASCII characters.") {}
+
+  virtual bool isValid(const string& value) const {
+    return strings::isAscii(value);
+  }
+};
+
+
+class NoControlCharactersValidator : public FixedMessageStringValidator {
+ public:
+  NoControlCharactersValidator()
+      : FixedMessageStringValidator(
+            ValidationErrorCode::MUST_NOT_HAVE_CONTROL_CHARACTERS,
+            "Must not contain control characters.") {}
+
+  virtual bool isValid(const string& value) const {
+    return !strings::hasControlCharacters(value);
+  }
+};
+
+
+class ValidUtf8Validator : public FixedMessageStringValidator {
+ public:
+  ValidUtf8Validator()
+      : FixedMessageStringValidator(ValidationErrorCode::MUST_BE_VALID_UTF8,
+                                    "Must be valid UTF-8.") {}
+
+  virtual bool isValid(const string& value) const {
+    return strings::isValidUtf8(value);
+  }
+};
+
+
+class CharactersInValidator : public FixedMessageStringValidator {
+ public:
+  explicit CharactersInValidator(const CharacterSet& allowedCharacters)
+      : FixedMessageStringValidator(
+            ValidationErrorCode::MUST_HAVE_ALLOWED_CHARACTERS,
+            "Must contain only allowed characters."),
+        allowedCharacters_(allowedCharacters) {}
+
+  virtual bool isValid(const string& value) const {
+    return allowedCharacters_.containsAll(value);
+  }
+
+ private:
+  const CharacterSet allowedCharacters_;
+};
+
+
+class MaxCodePointsValidator : public Validator<string> {
+ public:
+  explicit MaxCodePointsValidator(std::size_t maxCodePoints)
+      : maxCodePoints_(maxCodePoints) {}
+
+  virtual bool isValid(const string& value) const {
+    // No value has more code points than bytes, so skip counting if short.
+    return (value.length() <= maxCodePoints_)
+        || (strings::countCodePoints(value) <= maxCodePoints_);
+  }
+
+  virtual ValidationErrorCode checkValidationErrorCode(
+      const string& value) const {
+    return isValid(value) ? ValidationErrorCode::NONE
+        : ValidationErrorCode::CODE_POINTS_MUST_BE_LESS_OR_EQUAL;
+  }
+
+  virtual string checkValidationErrors(const string& value) const {
+    return formatValidationErrors(value);
+  }
+
+  virtual void appendValidationErrors(const string& value,
+                                      StringBuilder& out) const {
+    if (!isValid(value)) {
+      out.append("Length must be less than or equal to ")
+          .appendValue(maxCodePoints_).append(" characters (code points).");
+    }
+  }
+
+ private:
+  const std::size_t maxCodePoints_;
+};
+
+
+}  // namespace
+
+
+unique_ptr<Validator<string>> StringValidators::asciiOnly() {
+  return make_unique<AsciiOnlyValidator>();
+}
+
+
+unique_ptr<Validator<string>> StringValidators::noControlCharacters() {
+  return make_unique<NoControlCharactersValidator>();
+}
+
+
+unique_ptr<Validator<string>> StringValidators::validUtf8() {
+  return make_unique<ValidUtf8Validator>();
+}
+
+
+unique_ptr<Validator<string>> StringValidators::charactersIn(
+    const CharacterSet& allowedCharacters) {
+  return make_unique<CharactersInValidator>(allowedCharacters);
+}
+
+
+unique_ptr<Validator<string>> StringValidators::maxCodePoints(
+    std::size_t maxCodePoints) {
+  return make_unique<MaxCodePointsValidator>(maxCodePoints);
+}
+
+
+}  // namespace oomuse
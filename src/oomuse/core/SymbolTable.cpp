@@ -0,0 +1,174 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/SymbolTable.h"
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+#include "oomuse/core/strings.h"
+
+namespace oomuse {
+
+
+const uint32 SymbolTable::NO_ID;
+const uint32 SymbolTable::FIRST_CHUNK_BITS;
+const std::size_t SymbolTable::MAX_CHUNKS;
+
+
+namespace {
+
+
+/** Hash index size for a new table; doubled to stay at most half full. */
+const std::size_t INITIAL_NUM_SLOTS = 64;
+
+
+uint32 hashOf(StringRef str) {
+  // strings::hash() already folds its high bits into its low ones.
+  return static_cast<uint32>(strings::hash(str));
+}
+
+
+}  // namespace
+
+
+SymbolTable::HashIndex::HashIndex(std::size_t numSlots)
+    : mask(numSlots - 1), slots(new std::atomic<uint64>[numSlots]) {
+  for (std::size_t i = 0; i < numSlots; ++i) {
+    slots[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+
+SymbolTable::SymbolTable() : index_(nullptr), numSymbols_(0) {
+  for (auto& chunk : chunks_) {
+    chunk.store(nullptr, std::memory_order_relaxed);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  indexes_.emplace_back(new HashIndex(INITIAL_NUM_SLOTS));
+  const uint32 emptyHash = hashOf(StringRef());
+  insertId(indexes_.back().get(), addEntry(StringRef(), emptyHash),
+           emptyHash);
+  numSymbols_.store(1, std::memory_order_release);
+  index_.store(indexes_.back().get(), std::memory_order_release);
+}
+
+
+SymbolTable::~SymbolTable() = default;
+
+
+Symbol SymbolTable::intern(StringRef str) {
+  const uint32 hash = hashOf(str);
+  const uint32 id =
+      findId(*index_.load(std::memory_order_acquire), str, hash);
+  return (id != NO_ID) ? Symbol(id) : internSlow(str, hash);
+}
+
+
+Optional<Symbol> SymbolTable::find(StringRef str) const {
+  const uint32 id =
+      findId(*index_.load(std::memory_order_acquire), str, hashOf(str));
+  return (id != NO_ID) ? Optional<Symbol>(Symbol(id)) : Optional<Symbol>();
+}
+
+
+uint32 SymbolTable::findId(const HashIndex& index, StringRef str,
+                           uint32 hash) const {
+  // Linear probing; the index is never full, so this always hits an empty
+  // slot eventually.
+  for (std::size_t i = hash & index.mask; ; i = (i + 1) & index.mask) {
+    const uint64 slot = index.slots[i].load(std::memory_order_acquire);
+    if (slot == 0) {
+      return NO_ID;
+    }
+    if (static_cast<uint32>(slot >> 32) == hash) {
+      const uint32 id = static_cast<uint32>(slot) - 1;
+      const Entry& entry = entryAt(id);
+      if (StringRef(entry.chars, entry.length) == str) {
+        return id;
+      }
+    }
+  }
+}
+
+
+Symbol SymbolTable::internSlow(StringRef str, uint32 hash) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // Another thread may have interned str since the lock-free lookup.
+  HashIndex* index = indexes_.back().get();
+  const uint32 existingId = findId(*index, str, hash);
+  if (existingId != NO_ID) {
+    return Symbol(existingId);
+  }
+
+  const uint32 id = addEntry(str, hash);
+  const std::size_t numSymbols = static_cast<std::size_t>(id) + 1;
+  if (2 * numSymbols <= index->mask + 1) {
+    insertId(index, id, hash);
+  } else {
+    // Readers may still be probing the old index, so build a bigger one on
+    // the side and then swap it in whole.
+    std::unique_ptr<HashIndex> bigger(new HashIndex(2 * (index->mask + 1)));
+    for (uint32 i = 0; i <= id; ++i) {
+      insertId(bigger.get(), i, entryAt(i).hash);
+    }
+    indexes_.push_back(std::move(bigger));
+    index_.store(indexes_.back().get(), std::memory_order_release);
+  }
+  numSymbols_.store(static_cast<uint32>(numSymbols),
+                    std::memory_order_release);
+  return Symbol(id);
+}
+
+
+uint32 SymbolTable::addEntry(StringRef str, uint32 hash) {
+  const uint32 id = numSymbols_.load(std::memory_order_relaxed);
+  assert(id <= NO_ID - (1u << FIRST_CHUNK_BITS));
+  assert(str.length() <= NO_ID);
+
+  const uint32 offsetId = id + (1u << FIRST_CHUNK_BITS);
+  const int chunk = chunkOf(offsetId);
+  Entry* entries = chunks_[chunk].load(std::memory_order_relaxed);
+  if (entries == nullptr) {
+    entries = new Entry[std::size_t(1) << (chunk + FIRST_CHUNK_BITS)];
+    ownedChunks_.emplace_back(entries);
+    chunks_[chunk].store(entries, std::memory_order_release);
+  }
+
+  // Readers only find this entry once insertId() publishes its slot.
+  Entry& entry = entries[offsetId - (1u << (chunk + FIRST_CHUNK_BITS))];
+  entry.chars = str.empty() ? "" : arena_.copy(str).data();
+  entry.length = static_cast<uint32>(str.length());
+  entry.hash = hash;
+  return id;
+}
+
+
+void SymbolTable::insertId(HashIndex* index, uint32 id, uint32 hash) {
+  std::size_t i = hash & index->mask;
+  while (index->slots[i].load(std::memory_order_relaxed) != 0) {
+    i = (i + 1) & index->mask;
+  }
+  index->slots[i].store((static_cast<uint64>(hash) << 32) | (id + 1),
+                        std::memory_order_release);
+}
+
+
+}  // namespace oomuse
@@ -18,112 +18,1919 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
 #include <functional>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <type_traits>
+
+#include "oomuse/core/CharacterSet.h"
+#include "oomuse/core/LocaleTables.h"
+#include "oomuse/core/Optional.h"
+#include "oomuse/core/StringArena.h"
+#include "oomuse/core/StringRef.h"
+#include "oomuse/core/bits.h"
+#include "oomuse/core/int_types.h"
+#include "oomuse/core/readability_macros.h"
 
 using std::all_of;
-using std::find_if;
-using std::isspace;
 using std::isspace;
 using std::locale;
 using std::string;
 using std::tolower;
 using std::toupper;
-using std::transform;
 
 namespace oomuse {
 namespace strings {
 
+namespace {
+
+
+// The byte-scanning functions below work on 8 bytes at a time as one uint64
+// (SWAR: "SIMD within a register"), which is portable, and finish up any
+// remaining bytes one at a time.
 
-bool isEmptyOrWhitespace(const string& str) {
-  return all_of(str.begin(), str.end(), [](char c) { return isspace(c); });
+const uint64 ONES = 0x0101010101010101ULL;  // 0x01 in every byte.
+const uint64 HIGH_BITS = 0x8080808080808080ULL;  // 0x80 in every byte.
+
+
+/** Loads 8 bytes (in any alignment) as one word. */
+uint64 loadWord(const char* bytes) {
+  uint64 word;
+  std::memcpy(&word, bytes, sizeof(word));
+  return word;
 }
 
 
-bool isEmptyOrWhitespace(const string& str, const locale& loc) {
-  return all_of(str.begin(), str.end(),
-                [&loc](char c) { return isspace(c, loc); });
+/** Returns nonzero iff any byte of word is < n (for n <= 0x80). */
+uint64 hasByteLess(uint64 word, uint8 n) {
+  return (word - (ONES * n)) & ~word & HIGH_BITS;
 }
 
 
-bool startsWith(const string& str, const string& prefix) {
-  return (str.compare(0, prefix.length(), prefix) == 0);
+/** Returns nonzero iff any byte of word == n. */
+uint64 hasByte(uint64 word, uint8 n) {
+  return hasByteLess(word ^ (ONES * n), 1);
 }
 
 
-bool endsWith(const string& str, const string& suffix) {
-  return (str.length() >= suffix.length())
-      && (str.compare(str.length() - suffix.length(),
-                      suffix.length(), suffix) == 0);
+/** Returns true if all 32 bytes at chars are ASCII (with one branch). */
+bool isAsciiBlock(const char* chars) {
+  const uint64 anyHighBits = loadWord(chars) | loadWord(chars + 8)
+      | loadWord(chars + 16) | loadWord(chars + 24);
+  return ((anyHighBits & HIGH_BITS) == 0);
 }
 
 
-string trimWhitespace(const string& str) {
-  auto firstRealChar = find_if(str.begin(), str.end(), [](char c) {
-    return !isspace(c);
-  });
-  if (firstRealChar == str.end()) {
-    return "";
+/**
+ * Returns ASCII byte c with the case of letters starting at firstLetter ('A'
+ * for lowercase, 'a' for uppercase) flipped, without branching.
+ */
+template<char firstLetter>
+char flipAsciiCase(uint8 c) {
+  const uint8 isLetter = (static_cast<uint8>(c - firstLetter) < 26);
+  return static_cast<char>(c ^ (isLetter << 5));
+}
+
+
+/**
+ * Applies flipAsciiCase() to the 8 bytes of word, which must all be ASCII.
+ */
+template<char firstLetter>
+uint64 flipAsciiCaseWord(uint64 word) {
+  // With all bytes < 0x80, these adds can't carry between bytes: the high
+  // bit of each byte is set iff it's >= firstLetter (or > its last letter).
+  const uint64 atLeastFirst = word + (ONES * (0x80 - firstLetter));
+  const uint64 pastLast = word + (ONES * (0x80 - (firstLetter + 26)));
+  const uint64 isLetter = (atLeastFirst ^ pastLast) & HIGH_BITS;
+  return word ^ (isLetter >> 2);  // Flips 0x20 bits.
+}
+
+
+/** Applies flipAsciiCase() to 32 ASCII bytes, which compilers vectorize. */
+template<char firstLetter>
+void flipAsciiCaseBlock(const char* in, char* out) {
+  for (std::size_t i = 0; i < 32; ++i) {
+    out[i] = flipAsciiCase<firstLetter>(static_cast<uint8>(in[i]));
   }
+}
 
-  auto lastRealChar = find_if(str.rbegin(), str.rend(), [](char c) {
-    return !isspace(c);
-  });
 
-  auto startIndex = firstRealChar - str.begin();
-  auto endIndexExclusive = str.rend() - lastRealChar;
-  return str.substr(startIndex, endIndexExclusive - startIndex);
+/**
+ * Loads the length < 8 bytes at bytes as one word (with the rest zero), with
+ * fixed-size loads rather than a memcpy() call.
+ */
+uint64 loadShortWord(const char* bytes, std::size_t length) {
+  uint64 word = 0;
+  int shift = 0;
+  if ((length & 4) != 0) {
+    uint32 part;
+    std::memcpy(&part, bytes, sizeof(part));
+    word = part;
+    bytes += 4;
+    shift = 32;
+  }
+  if ((length & 2) != 0) {
+    uint16 part;
+    std::memcpy(&part, bytes, sizeof(part));
+    word |= static_cast<uint64>(part) << shift;
+    bytes += 2;
+    shift += 16;
+  }
+  if ((length & 1) != 0) {
+    word |= static_cast<uint64>(static_cast<uint8>(*bytes)) << shift;
+  }
+  return word;
+}
+
+
+/**
+ * Converts A-Z in all 8 bytes of word (which may include non-ASCII bytes,
+ * left as is) to lowercase.
+ */
+uint64 toLowerAsciiWord(uint64 word) {
+  // Masking off high bits first means the adds can't carry between bytes.
+  const uint64 low7 = word & ~HIGH_BITS;
+  const uint64 atLeastA = low7 + (ONES * (0x80 - 'A'));
+  const uint64 pastZ = low7 + (ONES * (0x80 - ('Z' + 1)));
+  const uint64 isUpper = (atLeastA ^ pastZ) & ~word & HIGH_BITS;
+  return word | (isUpper >> 2);  // Sets 0x20 bits.
 }
 
 
-string trimWhitespace(const string& str, const locale& loc) {
-  auto firstRealChar = find_if(str.begin(), str.end(), [&loc](char c) {
-    return !isspace(c, loc);
+/** Mixes an 8-byte word into hash. */
+uint64 mixHash(uint64 hash, uint64 word) {
+  hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+  return hash ^ (hash >> 32);
+}
+
+
+bool isContinuationByte(uint8 byte) { return ((byte & 0xC0) == 0x80); }
+
+
+/**
+ * Returns the length of the valid UTF-8 sequence starting with a non-ASCII
+ * lead byte at bytes[0], or 0 if it isn't valid (per the Unicode Standard,
+ * table 3-7). Never reads past end.
+ */
+std::size_t validUtf8SequenceLength(const uint8* bytes, const uint8* end) {
+  const uint8 lead = bytes[0];
+  std::size_t length;
+  uint8 secondMin = 0x80;
+  uint8 secondMax = 0xBF;
+  if ((lead >= 0xC2) && (lead <= 0xDF)) {
+    length = 2;
+  } else if ((lead >= 0xE0) && (lead <= 0xEF)) {
+    length = 3;
+    if (lead == 0xE0) {
+      secondMin = 0xA0;  // No overlong encodings.
+    } else if (lead == 0xED) {
+      secondMax = 0x9F;  // No UTF-16 surrogates.
+    }
+  } else if ((lead >= 0xF0) && (lead <= 0xF4)) {
+    length = 4;
+    if (lead == 0xF0) {
+      secondMin = 0x90;  // No overlong encodings.
+    } else if (lead == 0xF4) {
+      secondMax = 0x8F;  // Nothing past U+10FFFF.
+    }
+  } else {
+    return 0;  // Continuation byte, overlong lead (0xC0, 0xC1), or > 0xF4.
+  }
+
+  if (static_cast<std::size_t>(end - bytes) < length) {
+    return 0;  // Truncated.
+  }
+  if ((bytes[1] < secondMin) || (bytes[1] > secondMax)) {
+    return 0;
+  }
+  for (std::size_t i = 2; i < length; ++i) {
+    if (!isContinuationByte(bytes[i])) {
+      return 0;
+    }
+  }
+  return length;
+}
+
+
+/**
+ * Decodes the code point of the valid UTF-8 sequence at bytes, whose length
+ * (2-4) was returned by validUtf8SequenceLength().
+ */
+uint32 decodeUtf8(const uint8* bytes, std::size_t length) {
+  switch (length) {
+    case 2:
+      return ((bytes[0] & 0x1Fu) << 6) | (bytes[1] & 0x3Fu);
+    case 3:
+      return ((bytes[0] & 0x0Fu) << 12) | ((bytes[1] & 0x3Fu) << 6)
+          | (bytes[2] & 0x3Fu);
+    default:
+      return ((bytes[0] & 0x07u) << 18) | ((bytes[1] & 0x3Fu) << 12)
+          | ((bytes[2] & 0x3Fu) << 6) | (bytes[3] & 0x3Fu);
+  }
+}
+
+
+/** Writes codePoint to out as UTF-8, returning its length (1-4). */
+std::size_t encodeUtf8(uint32 codePoint, char* out) {
+  if (codePoint < 0x80) {
+    out[0] = static_cast<char>(codePoint);
+    return 1;
+  }
+  if (codePoint < 0x800) {
+    out[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+    out[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    return 2;
+  }
+  if (codePoint < 0x10000) {
+    out[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+    out[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    out[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    return 3;
+  }
+  out[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+  out[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+  out[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+  out[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+  return 4;
+}
+
+
+// Defines LOWER_CASE_* and FOLD_CASE_* tables (see the generator script).
+#include "unicode_case_tables.inc"
+
+
+/**
+ * Looks up codePoint in one set of generated two-level case mapping tables:
+ * its block of the code point space, then its delta within that block.
+ */
+uint32 mapCodePoint(uint32 codePoint, uint32 limit, unsigned shift,
+                    const int32* deltas, const uint8* blocks,
+                    const uint8* deltaIndexes) {
+  if (codePoint >= limit) {
+    return codePoint;
+  }
+  const uint32 block = blocks[codePoint >> shift];
+  const uint32 index = (block << shift) | (codePoint & ((1u << shift) - 1));
+  return static_cast<uint32>(static_cast<int32>(codePoint)
+                             + deltas[deltaIndexes[index]]);
+}
+
+
+/** Returns the Unicode simple lowercase mapping of codePoint. */
+uint32 toLowerCaseCodePoint(uint32 codePoint) {
+  return mapCodePoint(codePoint, LOWER_CASE_LIMIT, LOWER_CASE_SHIFT,
+                      LOWER_CASE_DELTAS, LOWER_CASE_BLOCKS,
+                      LOWER_CASE_DELTA_INDEXES);
+}
+
+
+/** Returns the Unicode simple case folding of codePoint. */
+uint32 foldCaseCodePoint(uint32 codePoint) {
+  return mapCodePoint(codePoint, FOLD_CASE_LIMIT, FOLD_CASE_SHIFT,
+                      FOLD_CASE_DELTAS, FOLD_CASE_BLOCKS,
+                      FOLD_CASE_DELTA_INDEXES);
+}
+
+
+/**
+ * Returns str with every valid UTF-8 code point mapped through mapCodePoint()
+ * (which must lowercase ASCII letters, and leave other ASCII alone). ASCII is
+ * converted 32 or 8 bytes at a time where possible, without decoding. Invalid
+ * bytes are copied as is.
+ */
+template<typename MapCodePoint>
+string convertUtf8(StringRef str, MapCodePoint mapCodePoint) {
+  // Simple case mappings grow UTF-8 by at most 3 bytes per 2 (which the table
+  // generator checks), so this is always enough room.
+  string result(str.length() + (str.length() / 2), '\0');
+  const char* in = str.begin();
+  const char* end = str.end();
+  char* out = &result[0];
+  while (in < end) {
+    const uint8* bytes = reinterpret_cast<const uint8*>(in);
+    if (bytes[0] < 0x80) {
+      if ((end - in >= 32) && isAsciiBlock(in)) {
+        flipAsciiCaseBlock<'A'>(in, out);
+        in += 32;
+        out += 32;
+      } else if ((end - in >= 8) && ((loadWord(in) & HIGH_BITS) == 0)) {
+        const uint64 converted = flipAsciiCaseWord<'A'>(loadWord(in));
+        std::memcpy(out, &converted, sizeof(converted));
+        in += 8;
+        out += 8;
+      } else {
+        *out++ = flipAsciiCase<'A'>(bytes[0]);
+        ++in;
+      }
+      continue;
+    }
+
+    const std::size_t length =
+        validUtf8SequenceLength(bytes, reinterpret_cast<const uint8*>(end));
+    if (length == 0) {
+      *out++ = *in++;
+      continue;
+    }
+    const uint32 codePoint = decodeUtf8(bytes, length);
+    const uint32 mappedCodePoint = mapCodePoint(codePoint);
+    if (mappedCodePoint == codePoint) {
+      // E.g. CJK, which has no case. (A loop, since memcpy() of a variable
+      // 2-4 bytes would be a library call.)
+      for (std::size_t i = 0; i < length; ++i) {
+        out[i] = in[i];
+      }
+      out += length;
+    } else {
+      out += encodeUtf8(mappedCodePoint, out);
+    }
+    in += length;
+  }
+  result.resize(static_cast<std::size_t>(out - result.data()));
+  return result;
+}
+
+
+/**
+ * Returns true for non-ASCII code points with the Unicode White_Space
+ * property (the ASCII ones agree with isAsciiSpace()).
+ */
+bool isNonAsciiUnicodeSpace(uint32 codePoint) {
+  return (codePoint == 0x85) || (codePoint == 0xA0) || (codePoint == 0x1680)
+      || ((codePoint >= 0x2000) && (codePoint <= 0x200A))
+      || (codePoint == 0x2028) || (codePoint == 0x2029)
+      || (codePoint == 0x202F) || (codePoint == 0x205F)
+      || (codePoint == 0x3000);
+}
+
+
+/** Returns true for the 6 ASCII whitespace bytes: \t \n \v \f \r and ' '. */
+bool isAsciiSpace(uint8 c) {
+  return (static_cast<uint8>(c - '\t') < 5) | (c == ' ');
+}
+
+
+/**
+ * Same as std::isspace(c) for the default "C" locale (and for ASCII in every
+ * locale), without a table lookup for ASCII bytes.
+ */
+bool isSpace(char c) {
+  const uint8 byte = static_cast<uint8>(c);
+  return (byte < 0x80) ? isAsciiSpace(byte) : (isspace(c) != 0);
+}
+
+
+/** Returns true if all 32 bytes at chars are ASCII whitespace. */
+bool isAsciiSpaceBlock(const char* chars) {
+  // Branchless, so compilers vectorize it into byte compares.
+  uint8 allSpace = 1;
+  for (std::size_t i = 0; i < 32; ++i) {
+    allSpace &= isAsciiSpace(static_cast<uint8>(chars[i]));
+  }
+  return (allSpace != 0);
+}
+
+
+/**
+ * Returns a pointer to the first char that isn't whitespace by isSpace(c)
+ * (which must agree with isAsciiSpace() for ASCII), or end if none.
+ */
+template<typename IsSpace>
+const char* skipWhitespaceForward(const char* begin, const char* end,
+                                  IsSpace isSpace) {
+  while ((end - begin >= 32) && isAsciiSpaceBlock(begin)) {
+    begin += 32;
+  }
+  while ((begin < end) && isSpace(*begin)) {
+    ++begin;
+  }
+  return begin;
+}
+
+
+/** Returns one past the last char that isn't whitespace, or begin if none. */
+template<typename IsSpace>
+const char* skipWhitespaceBackward(const char* begin, const char* end,
+                                   IsSpace isSpace) {
+  while ((end - begin >= 32) && isAsciiSpaceBlock(end - 32)) {
+    end -= 32;
+  }
+  while ((begin < end) && isSpace(*(end - 1))) {
+    --end;
+  }
+  return end;
+}
+
+
+/**
+ * Returns the length of the UTF-8 whitespace code point starting at begin,
+ * or 0 if there isn't one.
+ */
+std::size_t unicodeSpaceLength(const char* begin, const char* end) {
+  const uint8* bytes = reinterpret_cast<const uint8*>(begin);
+  if (bytes[0] < 0x80) {
+    return isAsciiSpace(bytes[0]) ? 1 : 0;
+  }
+  const std::size_t length =
+      validUtf8SequenceLength(bytes, reinterpret_cast<const uint8*>(end));
+  return ((length > 0) && isNonAsciiUnicodeSpace(decodeUtf8(bytes, length)))
+      ? length : 0;
+}
+
+
+/**
+ * Trims Unicode whitespace from both ends of str (which should be UTF-8),
+ * skipping 32 ASCII whitespace bytes at a time wherever possible.
+ */
+StringRef trimUnicodeWhitespaceByBlocks(StringRef str) {
+  const char* begin = str.begin();
+  const char* end = str.end();
+  while (begin < end) {
+    if ((end - begin >= 32) && isAsciiSpaceBlock(begin)) {
+      begin += 32;
+      continue;
+    }
+    const std::size_t length = unicodeSpaceLength(begin, end);
+    if (length == 0) {
+      break;
+    }
+    begin += length;
+  }
+
+  while (begin < end) {
+    if ((end - begin >= 32) && isAsciiSpaceBlock(end - 32)) {
+      end -= 32;
+      continue;
+    }
+
+    // Back up to the lead byte of the last code point (at most 3 back).
+    const char* lead = end - 1;
+    while ((lead > begin) && (end - lead < 4)
+           && isContinuationByte(static_cast<uint8>(*lead))) {
+      --lead;
+    }
+    const std::size_t length = unicodeSpaceLength(lead, end);
+    if ((length == 0) || (lead + length != end)) {
+      break;
+    }
+    end = lead;
+  }
+  return StringRef(begin, static_cast<std::size_t>(end - begin));
+}
+
+
+/** Trims whitespace by isSpace(c), which must agree with isAsciiSpace(). */
+template<typename IsSpace>
+StringRef trimWhitespaceByBlocks(StringRef str, IsSpace isSpace) {
+  const char* begin = skipWhitespaceForward(str.begin(), str.end(), isSpace);
+  const char* end = skipWhitespaceBackward(begin, str.end(), isSpace);
+  return StringRef(begin, static_cast<std::size_t>(end - begin));
+}
+
+
+/**
+ * Converts length chars from in to out (which may be the same), flipping the
+ * case of ASCII letters starting at firstLetter ('A' for lowercase, 'a' for
+ * uppercase). Blocks of 32 ASCII bytes are converted without branching, which
+ * compilers vectorize; other ASCII bytes are flipped one at a time, and
+ * non-ASCII bytes go through convertChar.
+ */
+template<char firstLetter, typename ConvertChar>
+void convertCase(const char* in, std::size_t length, char* out,
+                 ConvertChar convertChar) {
+  std::size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    if (isAsciiBlock(in + i)) {
+      flipAsciiCaseBlock<firstLetter>(in + i, out + i);
+    } else {
+      for (std::size_t j = i; j < i + 32; ++j) {
+        out[j] = convertChar(in[j]);
+      }
+    }
+  }
+  for (; i + 8 <= length; i += 8) {
+    const uint64 word = loadWord(in + i);
+    if ((word & HIGH_BITS) != 0) {
+      for (std::size_t j = i; j < i + 8; ++j) {
+        out[j] = convertChar(in[j]);
+      }
+      continue;
+    }
+    const uint64 converted = flipAsciiCaseWord<firstLetter>(word);
+    std::memcpy(out + i, &converted, sizeof(converted));
+  }
+  for (; i < length; ++i) {
+    // Leftover bytes are common for short strings, so keep ASCII inline too.
+    const uint8 c = static_cast<uint8>(in[i]);
+    if (c < 0x80) {
+      out[i] = flipAsciiCase<firstLetter>(c);
+    } else {
+      out[i] = convertChar(in[i]);
+    }
+  }
+}
+
+
+/** Returns the std::ctype<char> facet of loc (looked up once per call). */
+const std::ctype<char>& ctypeFacet(const locale& loc) {
+  return std::use_facet<std::ctype<char>>(loc);
+}
+
+
+/** Trims chars from both ends of str for which isSpace(c) is true. */
+template<typename IsSpace>
+StringRef trimWhere(StringRef str, IsSpace isSpace) {
+  const char* begin = str.begin();
+  const char* end = str.end();
+  while ((begin < end) && isSpace(*begin)) {
+    ++begin;
+  }
+  while ((begin < end) && isSpace(*(end - 1))) {
+    --end;
+  }
+  return StringRef(begin, static_cast<std::size_t>(end - begin));
+}
+
+
+}  // namespace
+
+
+bool isEmptyOrWhitespace(StringRef str) {
+  return (skipWhitespaceForward(str.begin(), str.end(), isSpace)
+          == str.end());
+}
+
+
+bool isEmptyOrWhitespace(StringRef str, const locale& loc) {
+  const std::ctype<char>& ctype = ctypeFacet(loc);
+  return all_of(str.begin(), str.end(), [&ctype](char c) {
+    return ctype.is(std::ctype_base::space, c);
   });
-  if (firstRealChar == str.end()) {
-    return "";
+}
+
+
+bool isEmptyOrWhitespace(StringRef str, const LocaleTables& tables) {
+  auto isSpaceByTables = [&tables](char c) { return tables.isSpace(c); };
+  if (!tables.hasStandardAscii()) {
+    return all_of(str.begin(), str.end(), isSpaceByTables);
   }
+  return (skipWhitespaceForward(str.begin(), str.end(), isSpaceByTables)
+          == str.end());
+}
+
+
+bool startsWith(StringRef str, StringRef prefix) {
+  return (str.length() >= prefix.length())
+      && (str.substr(0, prefix.length()) == prefix);
+}
+
+
+bool endsWith(StringRef str, StringRef suffix) {
+  return (str.length() >= suffix.length())
+      && (str.substr(str.length() - suffix.length()) == suffix);
+}
+
+
+bool equalsIgnoreCase(StringRef a, StringRef b) {
+  if (a.length() != b.length()) {
+    return false;
+  }
+  const std::size_t length = a.length();
+  if (length < 8) {
+    return (toLowerAsciiWord(loadShortWord(a.data(), length))
+            == toLowerAsciiWord(loadShortWord(b.data(), length)));
+  }
+
+  // Compare all words but the last, then the last 8 bytes (which may overlap
+  // the previous word).
+  for (std::size_t i = 0; i + 8 < length; i += 8) {
+    const uint64 wordA = loadWord(a.data() + i);
+    const uint64 wordB = loadWord(b.data() + i);
+    if ((wordA != wordB)
+        && (toLowerAsciiWord(wordA) != toLowerAsciiWord(wordB))) {
+      return false;
+    }
+  }
+  return (toLowerAsciiWord(loadWord(a.end() - 8))
+          == toLowerAsciiWord(loadWord(b.end() - 8)));
+}
+
+
+int compareIgnoreCase(StringRef a, StringRef b) {
+  const std::size_t minLength = std::min(a.length(), b.length());
+  std::size_t i = 0;
+
+  // Skip past words that are equal ignoring case.
+  while ((i + 8 <= minLength)
+         && (toLowerAsciiWord(loadWord(a.data() + i))
+             == toLowerAsciiWord(loadWord(b.data() + i)))) {
+    i += 8;
+  }
+
+  for (; i < minLength; ++i) {
+    const uint8 charA = static_cast<uint8>(
+        flipAsciiCase<'A'>(static_cast<uint8>(a[i])));
+    const uint8 charB = static_cast<uint8>(
+        flipAsciiCase<'A'>(static_cast<uint8>(b[i])));
+    if (charA != charB) {
+      return (charA < charB) ? -1 : 1;
+    }
+  }
+
+  if (a.length() == b.length()) {
+    return 0;
+  }
+  return (a.length() < b.length()) ? -1 : 1;
+}
+
+
+bool startsWithIgnoreCase(StringRef str, StringRef prefix) {
+  return (str.length() >= prefix.length())
+      && equalsIgnoreCase(str.substr(0, prefix.length()), prefix);
+}
+
+
+std::size_t hash(StringRef str) {
+  const std::size_t length = str.length();
+  uint64 hash = 0xCBF29CE484222325ULL;
+  if (length < 8) {
+    hash = mixHash(hash, loadShortWord(str.data(), length));
+  } else {
+    for (std::size_t i = 0; i + 8 < length; i += 8) {
+      hash = mixHash(hash, loadWord(str.data() + i));
+    }
+    hash = mixHash(hash, loadWord(str.end() - 8));
+  }
+  return static_cast<std::size_t>(mixHash(hash, length));
+}
+
+
+std::size_t hashIgnoreCase(StringRef str) {
+  const std::size_t length = str.length();
+  uint64 hash = 0xCBF29CE484222325ULL;
+  if (length < 8) {
+    hash = mixHash(hash, toLowerAsciiWord(loadShortWord(str.data(), length)));
+  } else {
+    // Like equalsIgnoreCase(), the last 8 bytes may overlap the last word.
+    for (std::size_t i = 0; i + 8 < length; i += 8) {
+      hash = mixHash(hash, toLowerAsciiWord(loadWord(str.data() + i)));
+    }
+    hash = mixHash(hash, toLowerAsciiWord(loadWord(str.end() - 8)));
+  }
+  return static_cast<std::size_t>(mixHash(hash, length));
+}
+
+
+StringRef trimWhitespace(StringRef str) {
+  return trimWhitespaceByBlocks(str, isSpace);
+}
 
-  auto lastRealChar = find_if(str.rbegin(), str.rend(), [&loc](char c) {
-    return !isspace(c, loc);
+
+StringRef trimWhitespace(const char* str) {
+  return trimWhitespace(StringRef(str));
+}
+
+
+string trimWhitespace(const string& str) {
+  return trimWhitespace(StringRef(str)).toString();
+}
+
+
+StringRef trimWhitespace(StringRef str, const locale& loc) {
+  const std::ctype<char>& ctype = ctypeFacet(loc);
+  return trimWhere(str, [&ctype](char c) {
+    return ctype.is(std::ctype_base::space, c);
   });
+}
+
+
+StringRef trimWhitespace(const char* str, const locale& loc) {
+  return trimWhitespace(StringRef(str), loc);
+}
+
+
+string trimWhitespace(const string& str, const locale& loc) {
+  return trimWhitespace(StringRef(str), loc).toString();
+}
 
-  auto startIndex = firstRealChar - str.begin();
-  auto endIndexExclusive = str.rend() - lastRealChar;
-  return str.substr(startIndex, endIndexExclusive - startIndex);
+
+StringRef trimWhitespace(StringRef str, const LocaleTables& tables) {
+  auto isSpaceByTables = [&tables](char c) { return tables.isSpace(c); };
+  return tables.hasStandardAscii()
+      ? trimWhitespaceByBlocks(str, isSpaceByTables)
+      : trimWhere(str, isSpaceByTables);
+}
+
+
+StringRef trimWhitespace(const char* str, const LocaleTables& tables) {
+  return trimWhitespace(StringRef(str), tables);
+}
+
+
+string trimWhitespace(const string& str, const LocaleTables& tables) {
+  return trimWhitespace(StringRef(str), tables).toString();
+}
+
+
+StringRef trimWhitespace(StringRef str, StringArena& arena) {
+  return arena.copy(trimWhitespace(str));
 }
 
 
-string toLowerCase(const string& str) {
-  string lowerStr = str;
-  transform(lowerStr.begin(), lowerStr.end(), lowerStr.begin(),
-            [](char c) { return tolower(c); });
+string toLowerCase(StringRef str) {
+  string lowerStr(str.length(), '\0');
+  toLowerCaseInto(str, &lowerStr[0]);
   return lowerStr;
 }
 
 
-string toLowerCase(const string& str, const locale& loc) {
-  string lowerStr = str;
-  transform(lowerStr.begin(), lowerStr.end(), lowerStr.begin(),
-            [&loc](char c) { return tolower(c, loc); });
+void toLowerCaseInPlace(string& str) {
+  toLowerCaseInto(str, &str[0]);
+}
+
+
+void toLowerCaseInto(StringRef str, char* out) {
+  convertCase<'A'>(str.data(), str.length(), out,
+                   [](char c) { return static_cast<char>(tolower(c)); });
+}
+
+
+string toLowerCase(StringRef str, const locale& loc) {
+  string lowerStr = str.toString();
+  ctypeFacet(loc).tolower(&lowerStr[0], &lowerStr[0] + lowerStr.length());
   return lowerStr;
 }
 
 
-string toUpperCase(const string& str) {
-  string upperStr = str;
-  transform(upperStr.begin(), upperStr.end(), upperStr.begin(),
-            [](char c) { return toupper(c); });
+string toLowerCase(StringRef str, const LocaleTables& tables) {
+  string lowerStr(str.length(), '\0');
+
+  auto convertChar = [&tables](char c) { return tables.toLower(c); };
+  if (tables.hasStandardAscii()) {
+    convertCase<'A'>(str.data(), str.length(), &lowerStr[0], convertChar);
+  } else {
+    std::transform(str.begin(), str.end(), lowerStr.begin(), convertChar);
+  }
+  return lowerStr;
+}
+
+
+StringRef toLowerCase(StringRef str, StringArena& arena) {
+  char* out = arena.allocate(str.length());
+  toLowerCaseInto(str, out);
+  return StringRef(out, str.length());
+}
+
+
+string toUpperCase(StringRef str) {
+  string upperStr(str.length(), '\0');
+  toUpperCaseInto(str, &upperStr[0]);
   return upperStr;
 }
 
 
-string toUpperCase(const string& str, const locale& loc) {
-  string upperStr = str;
-  transform(upperStr.begin(), upperStr.end(), upperStr.begin(),
-            [&loc](char c) { return toupper(c, loc); });
+void toUpperCaseInPlace(string& str) {
+  toUpperCaseInto(str, &str[0]);
+}
+
+
+void toUpperCaseInto(StringRef str, char* out) {
+  convertCase<'a'>(str.data(), str.length(), out,
+                   [](char c) { return static_cast<char>(toupper(c)); });
+}
+
+
+string toUpperCase(StringRef str, const locale& loc) {
+  string upperStr = str.toString();
+  ctypeFacet(loc).toupper(&upperStr[0], &upperStr[0] + upperStr.length());
   return upperStr;
 }
 
 
+string toUpperCase(StringRef str, const LocaleTables& tables) {
+  string upperStr(str.length(), '\0');
+
+  auto convertChar = [&tables](char c) { return tables.toUpper(c); };
+  if (tables.hasStandardAscii()) {
+    convertCase<'a'>(str.data(), str.length(), &upperStr[0], convertChar);
+  } else {
+    std::transform(str.begin(), str.end(), upperStr.begin(), convertChar);
+  }
+  return upperStr;
+}
+
+
+StringRef toUpperCase(StringRef str, StringArena& arena) {
+  char* out = arena.allocate(str.length());
+  toUpperCaseInto(str, out);
+  return StringRef(out, str.length());
+}
+
+
+bool isAscii(StringRef str) {
+  const char* bytes = str.data();
+  const std::size_t length = str.length();
+  std::size_t i = 0;
+
+  for (; i + 32 <= length; i += 32) {
+    if (!isAsciiBlock(bytes + i)) {
+      return false;
+    }
+  }
+  for (; i < length; ++i) {
+    if ((static_cast<uint8>(bytes[i]) & 0x80) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+bool hasControlCharacters(StringRef str) {
+  const uint8* bytes = reinterpret_cast<const uint8*>(str.data());
+  const std::size_t length = str.length();
+  std::size_t i = 0;
+
+  // Check 64 bytes at a time without branching, which compilers vectorize.
+  for (; i + 64 <= length; i += 64) {
+    uint8 isControl = 0;
+    for (std::size_t j = i; j < i + 64; ++j) {
+      isControl |= (bytes[j] < 0x20) | (bytes[j] == 0x7F);
+    }
+    if (isControl != 0) {
+      return true;
+    }
+  }
+  for (; i + 8 <= length; i += 8) {
+    const uint64 word = loadWord(str.data() + i);
+    if ((hasByteLess(word, 0x20) | hasByte(word, 0x7F)) != 0) {
+      return true;
+    }
+  }
+  for (; i < length; ++i) {
+    if ((bytes[i] < 0x20) || (bytes[i] == 0x7F)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+bool isValidUtf8(StringRef str) {
+  const uint8* bytes = reinterpret_cast<const uint8*>(str.data());
+  const uint8* end = bytes + str.length();
+  while (bytes < end) {
+    // Skip quickly over runs of ASCII, which is always valid.
+    if ((end - bytes >= 16)
+        && (((loadWord(reinterpret_cast<const char*>(bytes))
+              | loadWord(reinterpret_cast<const char*>(bytes + 8)))
+             & HIGH_BITS) == 0)) {
+      bytes += 16;
+    } else if (*bytes < 0x80) {
+      ++bytes;
+    } else {
+      const std::size_t sequenceLength = validUtf8SequenceLength(bytes, end);
+      if (sequenceLength == 0) {
+        return false;
+      }
+      bytes += sequenceLength;
+    }
+  }
+  return true;
+}
+
+
+std::size_t countCodePoints(StringRef str) {
+  const uint8* bytes = reinterpret_cast<const uint8*>(str.data());
+  const std::size_t length = str.length();
+
+  // Count continuation bytes (10xxxxxx) without branching, 64 bytes at a
+  // time into a byte-sized counter, which compilers vectorize well.
+  std::size_t numContinuationBytes = 0;
+  std::size_t i = 0;
+  for (; i + 64 <= length; i += 64) {
+    uint8 blockCount = 0;
+    for (std::size_t j = i; j < i + 64; ++j) {
+      blockCount += isContinuationByte(bytes[j]) ? 1 : 0;
+    }
+    numContinuationBytes += blockCount;
+  }
+  for (; i < length; ++i) {
+    numContinuationBytes += isContinuationByte(bytes[i]) ? 1 : 0;
+  }
+  return length - numContinuationBytes;
+}
+
+
+string toLowerCaseUtf8(StringRef str) {
+  return convertUtf8(str, [](uint32 c) { return toLowerCaseCodePoint(c); });
+}
+
+
+string foldCase(StringRef str) {
+  return convertUtf8(str, [](uint32 c) { return foldCaseCodePoint(c); });
+}
+
+
+StringRef trimUnicodeWhitespace(StringRef str) {
+  return trimUnicodeWhitespaceByBlocks(str);
+}
+
+
+StringRef trimUnicodeWhitespace(const char* str) {
+  return trimUnicodeWhitespace(StringRef(str));
+}
+
+
+string trimUnicodeWhitespace(const string& str) {
+  return trimUnicodeWhitespace(StringRef(str)).toString();
+}
+
+
+SplitRange::Iterator::Iterator(const SplitRange* range)
+    : range_(range), next_(range->str_.begin()), isLastField_(false) {
+  advance();
+}
+
+
+bool SplitRange::Iterator::findNextField() {
+  if (isLastField_) {
+    return false;
+  }
+  const char* end = range_->str_.end();
+  const char* delimiter = range_->findDelimiter(next_, end);
+  field_ = StringRef(next_, static_cast<std::size_t>(delimiter - next_));
+  isLastField_ = (delimiter == end);
+  next_ = isLastField_ ? end : (delimiter + 1);
+  return true;
+}
+
+
+void SplitRange::Iterator::advance() {
+  const SplitOptions options = range_->options_;
+  while (findNextField()) {
+    if (hasOption(options, SplitOptions::TRIM_WHITESPACE)) {
+      field_ = trimWhitespace(field_);
+    }
+    if (!field_.empty() || !hasOption(options, SplitOptions::SKIP_EMPTY)) {
+      return;
+    }
+  }
+
+  // Past the last field: become equal to end().
+  range_ = nullptr;
+  field_ = StringRef();
+}
+
+
+/**
+ * Returns the index of the first byte of word (in memory order) that's
+ * flagged in found, a nonzero result of hasByte() (or an OR of them).
+ */
+std::size_t firstFoundByte(uint64 word, uint64 found, const char* bytes,
+                           std::size_t numBytes) {
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__BYTE_ORDER__)  \
+    && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+  // The lowest flagged byte is exact (false positives from borrows are only
+  // in higher bytes), and it's first in memory.
+  UNREF_PARAM(word);
+  UNREF_PARAM(bytes);
+  UNREF_PARAM(numBytes);
+  return static_cast<std::size_t>(__builtin_ctzll(found)) / 8;
+#else
+  UNREF_PARAM(found);
+  char chars[8];
+  std::memcpy(chars, &word, sizeof(chars));
+  for (std::size_t i = 0;; ++i) {
+    for (std::size_t j = 0; j < numBytes; ++j) {
+      if (chars[i] == bytes[j]) {
+        return i;
+      }
+    }
+  }
+#endif
+}
+
+
+const char* SplitRange::findDelimiter(const char* begin,
+                                      const char* end) const {
+  const char* c = begin;
+  if (numDelimiterBytes_ == 1) {
+    // Fields are often short, so check up to 4 words inline (SWAR) before
+    // paying for a memchr() call, which is vectorized for longer ones.
+    const uint8 delimiter = static_cast<uint8>(delimiterBytes_[0]);
+    for (std::size_t i = 0; (i < 4) && (end - c >= 8); ++i, c += 8) {
+      const uint64 word = loadWord(c);
+      const uint64 found = hasByte(word, delimiter);
+      if (found != 0) {
+        return c + firstFoundByte(word, found, delimiterBytes_, 1);
+      }
+    }
+    if (end - c >= 8) {
+      const void* found =
+          std::memchr(c, delimiter, static_cast<std::size_t>(end - c));
+      return (found != nullptr) ? static_cast<const char*>(found) : end;
+    }
+  } else if (numDelimiterBytes_ <= MAX_DELIMITER_BYTES) {
+    // Check for each delimiter byte 8 bytes at a time (SWAR).
+    for (; end - c >= 8; c += 8) {
+      const uint64 word = loadWord(c);
+      uint64 found = 0;
+      for (std::size_t i = 0; i < numDelimiterBytes_; ++i) {
+        found |= hasByte(word, static_cast<uint8>(delimiterBytes_[i]));
+      }
+      if (found != 0) {
+        return c + firstFoundByte(word, found, delimiterBytes_,
+                                  numDelimiterBytes_);
+      }
+    }
+  } else {
+    // OR together 8 bitmap lookups at a time, so there's one branch per 8.
+    for (; end - c >= 8; c += 8) {
+      bool anyDelimiter = false;
+      for (std::size_t i = 0; i < 8; ++i) {
+        anyDelimiter |= delimiters_.contains(c[i]);
+      }
+      if (anyDelimiter) {
+        break;
+      }
+    }
+  }
+
+  while ((c < end) && !delimiters_.contains(*c)) {
+    ++c;
+  }
+  return c;
+}
+
+
+SplitRange split(StringRef str, char delimiter, SplitOptions options) {
+  return SplitRange(str, CharacterSet().add(delimiter), options);
+}
+
+
+SplitRange split(StringRef str, const CharacterSet& delimiters,
+                 SplitOptions options) {
+  return SplitRange(str, delimiters, options);
+}
+
+
+namespace {
+
+
+/** Returns true if the 8 bytes of word are all ASCII digits ('0' to '9'). */
+bool isEightDigits(uint64 word) {
+  // Each byte must have a high nibble of 3, and still have one after adding
+  // 6 (so its low nibble is <= 9).
+  const uint64 highNibbles = word & 0xF0F0F0F0F0F0F0F0ULL;
+  const uint64 highNibblesPlus6 =
+      (word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL;
+  return ((highNibbles | (highNibblesPlus6 >> 4)) == 0x3333333333333333ULL);
+}
+
+
+/** Returns the value of the 8 ASCII digits at chars. */
+uint32 parseEightDigits(const char* chars) {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+  // Combines adjacent digits, then adjacent pairs & quads, with 3 multiplies.
+  const uint64 mask = 0x000000FF000000FFULL;
+  uint64 word = loadWord(chars) - 0x3030303030303030ULL;
+  word = (word * 10) + (word >> 8);
+  word = (((word & mask) * (100 + (1000000ULL << 32)))
+          + (((word >> 16) & mask) * (1 + (10000ULL << 32)))) >> 32;
+  return static_cast<uint32>(word);
+#else
+  uint32 value = 0;
+  for (std::size_t i = 0; i < 8; ++i) {
+    value = (value * 10) + static_cast<uint32>(chars[i] - '0');
+  }
+  return value;
+#endif
+}
+
+
+/**
+ * Parses the digits [begin, end) as a uint64. Returns false if there are none,
+ * any aren't digits, or the value overflows.
+ */
+bool parseDigits(const char* begin, const char* end, uint64* value) {
+  if (begin == end) {
+    return false;
+  }
+  while ((end - begin > 1) && (*begin == '0')) {
+    ++begin;  // Leading zeros don't count toward the 20 digits that fit.
+  }
+  const std::size_t numDigits = static_cast<std::size_t>(end - begin);
+  if (numDigits > 20) {
+    return false;
+  }
+
+  // Any 19 digits fit, so only a 20th digit needs an overflow check.
+  const char* const safeEnd = (numDigits == 20) ? (end - 1) : end;
+  const char* c = begin;
+  uint64 result = 0;
+  for (; safeEnd - c >= 8; c += 8) {
+    if (!isEightDigits(loadWord(c))) {
+      return false;
+    }
+    result = (result * 100000000) + parseEightDigits(c);
+  }
+  for (; c != end; ++c) {
+    const uint8 digit = static_cast<uint8>(*c - '0');
+    if (digit > 9) {
+      return false;
+    }
+    const uint64 maxTimes10 = std::numeric_limits<uint64>::max() / 10;
+    if ((c == safeEnd) && ((result > maxTimes10)
+        || ((result == maxTimes10)
+            && (digit > std::numeric_limits<uint64>::max() % 10)))) {
+      return false;
+    }
+    result = (result * 10) + digit;
+  }
+  *value = result;
+  return true;
+}
+
+
+/**
+ * A decimal number, as mantissa * 10^exponent, with the mantissa limited to
+ * its first 19 significant digits (so it fits a uint64).
+ */
+struct Decimal {
+  uint64 mantissa;
+  int64 exponent;
+  bool negative;
+  bool truncated;  // Whether nonzero digits past the 19th were dropped.
+};
+
+
+/** Accumulates a run of digits into a Decimal, during parseDecimal(). */
+class DecimalDigits {
+ public:
+  explicit DecimalDigits(Decimal* decimal)
+      : decimal_(decimal), numSignificantDigits_(0), numDigits_(0) {}
+
+  /**
+   * Adds the digits starting at c (from the integer part, or the fraction part
+   * if isFraction) until a non-digit, and returns past them.
+   */
+  const char* addDigits(const char* c, const char* end, bool isFraction) {
+    Decimal& decimal = *decimal_;
+    const char* const start = c;
+    for (; c != end; ++c) {
+      // Take 8 digits at a time once past any leading zeros, while they fit.
+      while ((decimal.mantissa != 0) && (numSignificantDigits_ + 8 <= 19)
+             && (end - c >= 8) && isEightDigits(loadWord(c))) {
+        decimal.mantissa =
+            (decimal.mantissa * 100000000) + parseEightDigits(c);
+        numSignificantDigits_ += 8;
+        decimal.exponent -= isFraction ? 8 : 0;
+        c += 8;
+      }
+      if (c == end) {
+        break;
+      }
+
+      const uint8 digit = static_cast<uint8>(*c - '0');
+      if (digit > 9) {
+        break;
+      }
+      if ((decimal.mantissa == 0) && (digit == 0)) {
+        decimal.exponent -= isFraction ? 1 : 0;  // Leading zero.
+      } else if (numSignificantDigits_ < 19) {
+        decimal.mantissa = (decimal.mantissa * 10) + digit;
+        ++numSignificantDigits_;
+        decimal.exponent -= isFraction ? 1 : 0;
+      } else {
+        decimal.exponent += isFraction ? 0 : 1;
+        decimal.truncated = decimal.truncated || (digit != 0);
+      }
+    }
+    numDigits_ += static_cast<std::size_t>(c - start);
+    return c;
+  }
+
+  /** Returns the total number of digits added. */
+  std::size_t numDigits() const { return numDigits_; }
+
+ private:
+  Decimal* const decimal_;
+  std::size_t numSignificantDigits_;  // Digits in mantissa.
+  std::size_t numDigits_;
+};
+
+
+/**
+ * Parses str (in parseFloat()'s format) into decimal. Returns false if str
+ * isn't in that format.
+ */
+bool parseDecimal(StringRef str, Decimal* decimal) {
+  *decimal = {0, 0, false, false};
+  const char* c = str.begin();
+  const char* const end = str.end();
+  if ((c != end) && ((*c == '-') || (*c == '+'))) {
+    decimal->negative = (*c == '-');
+    ++c;
+  }
+
+  DecimalDigits digits(decimal);
+  c = digits.addDigits(c, end, false);
+  if ((c != end) && (*c == '.')) {
+    c = digits.addDigits(c + 1, end, true);
+  }
+  if (digits.numDigits() == 0) {
+    return false;
+  }
+
+  if ((c != end) && ((*c == 'e') || (*c == 'E'))) {
+    ++c;
+    bool isNegativeExponent = false;
+    if ((c != end) && ((*c == '-') || (*c == '+'))) {
+      isNegativeExponent = (*c == '-');
+      ++c;
+    }
+    if ((c == end) || (static_cast<uint8>(*c - '0') > 9)) {
+      return false;
+    }
+    int64 exponent = 0;
+    for (; (c != end) && (static_cast<uint8>(*c - '0') <= 9); ++c) {
+      if (exponent < 1000000) {  // Way past overflow or underflow already.
+        exponent = (exponent * 10) + (*c - '0');
+      }
+    }
+    decimal->exponent += isNegativeExponent ? -exponent : exponent;
+  }
+  return (c == end);
+}
+
+
+/**
+ * Describes the binary format of float or double, for parseFloat() and
+ * formatFloat().
+ */
+template<typename T>
+struct FloatFormat;
+
+template<>
+struct FloatFormat<double> {
+  using Bits = uint64;
+  static const int MANTISSA_BITS = 52;  // Explicitly stored bits.
+  static const int MIN_EXPONENT = -1023;
+  static const int INFINITE_POWER = 0x7FF;  // Biased exponent of infinity.
+  static const int SMALLEST_POWER_OF_TEN = -342;  // Smaller rounds to 0.
+  static const int LARGEST_POWER_OF_TEN = 308;  // Larger overflows.
+  static const int MIN_EXPONENT_ROUND_TO_EVEN = -4;
+  static const int MAX_EXPONENT_ROUND_TO_EVEN = 23;
+  static const int MAX_EXACT_POWER_OF_TEN = 22;
+};
+
+template<>
+struct FloatFormat<float> {
+  using Bits = uint32;
+  static const int MANTISSA_BITS = 23;
+  static const int MIN_EXPONENT = -127;
+  static const int INFINITE_POWER = 0xFF;
+  static const int SMALLEST_POWER_OF_TEN = -65;
+  static const int LARGEST_POWER_OF_TEN = 38;
+  static const int MIN_EXPONENT_ROUND_TO_EVEN = -17;
+  static const int MAX_EXPONENT_ROUND_TO_EVEN = 10;
+  static const int MAX_EXACT_POWER_OF_TEN = 10;
+};
+
+
+/** Powers of ten that are exactly representable as doubles. */
+const double EXACT_POWERS_OF_TEN[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+    1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+
+#include "power_of_five_table.inc"
+
+
+struct UInt128 {
+  uint64 high;
+  uint64 low;
+};
+
+
+/** Returns the full 128-bit product of a and b. */
+UInt128 multiplyFull(uint64 a, uint64 b) {
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+  return {static_cast<uint64>(product >> 64), static_cast<uint64>(product)};
+#else
+  const uint64 aLow = a & 0xFFFFFFFF;
+  const uint64 aHigh = a >> 32;
+  const uint64 bLow = b & 0xFFFFFFFF;
+  const uint64 bHigh = b >> 32;
+  const uint64 lowLow = aLow * bLow;
+  const uint64 highLow = aHigh * bLow;
+  const uint64 lowHigh = aLow * bHigh;
+  const uint64 highHigh = aHigh * bHigh;
+  const uint64 middle = (lowLow >> 32) + (highLow & 0xFFFFFFFF) + lowHigh;
+  return {highHigh + (highLow >> 32) + (middle >> 32),
+          (middle << 32) | (lowLow & 0xFFFFFFFF)};
+#endif
+}
+
+
+/**
+ * A float's explicit mantissa bits and biased exponent. power2 is -1 if it
+ * couldn't be computed without more digits or precision.
+ */
+struct BinaryFloat {
+  uint64 mantissa;
+  int32 power2;
+};
+
+
+/**
+ * Returns w * 10^q rounded to the nearest T, by the Eisel-Lemire algorithm
+ * (see Daniel Lemire, "Number Parsing at a Gigabyte per Second", 2021): w is
+ * normalized and multiplied by a 128-bit approximation of 5^q, whose top bits
+ * are exact except in rare, detectable cases.
+ */
+template<typename T>
+BinaryFloat computeFloat(int64 q, uint64 w) {
+  using Format = FloatFormat<T>;
+  BinaryFloat answer = {0, 0};
+  if ((w == 0) || (q < Format::SMALLEST_POWER_OF_TEN)) {
+    return answer;  // Zero.
+  }
+  if (q > Format::LARGEST_POWER_OF_TEN) {
+    answer.power2 = Format::INFINITE_POWER;
+    return answer;
+  }
+
+  const int leadingZeros = bits::countLeadingZeros(w);
+  w <<= leadingZeros;
+
+  // Only the top MANTISSA_BITS + 3 bits of the product matter. Those are
+  // exact from the high half of 5^q, unless the bits below them are all ones
+  // (so that the low half could carry into them).
+  const std::size_t index =
+      2 * static_cast<std::size_t>(q - SMALLEST_POWER_OF_FIVE);
+  const uint64 precisionMask = ~0ULL >> (Format::MANTISSA_BITS + 3);
+  UInt128 product = multiplyFull(w, POWERS_OF_FIVE[index]);
+  if ((product.high & precisionMask) == precisionMask) {
+    const UInt128 lowProduct = multiplyFull(w, POWERS_OF_FIVE[index + 1]);
+    product.low += lowProduct.high;
+    if (lowProduct.high > product.low) {
+      ++product.high;
+    }
+    // 5^q is exact for 0 <= q <= 55 (and its reciprocal precise enough for
+    // q >= -27); otherwise, the truncated low bits might still carry.
+    if ((product.low == ~0ULL) && ((q < -27) || (q > 55))) {
+      answer.power2 = -1;
+      return answer;
+    }
+  }
+
+  const int upperBit = static_cast<int>(product.high >> 63);
+  const int shift = upperBit + 64 - Format::MANTISSA_BITS - 3;
+  answer.mantissa = product.high >> shift;
+  // floor(log2(10^q)) + 63, from 217706 / 2^16 ~= log2(10).
+  const int32 power10Bits =
+      ((static_cast<int32>(q) * (152170 + 65536)) >> 16) + 63;
+  answer.power2 = power10Bits + upperBit - leadingZeros - Format::MIN_EXPONENT;
+
+  if (answer.power2 <= 0) {
+    // Subnormal: shift out bits below the minimum exponent, then round.
+    if (-answer.power2 + 1 >= 64) {
+      answer.mantissa = 0;
+      answer.power2 = 0;
+      return answer;
+    }
+    answer.mantissa >>= -answer.power2 + 1;
+    answer.mantissa += (answer.mantissa & 1);
+    answer.mantissa >>= 1;
+    // Rounding up may have made it the smallest normal number.
+    answer.power2 =
+        (answer.mantissa < (1ULL << Format::MANTISSA_BITS)) ? 0 : 1;
+    return answer;
+  }
+
+  // An exact halfway value (only possible for small q) rounds to even.
+  if ((product.low <= 1) && (q >= Format::MIN_EXPONENT_ROUND_TO_EVEN)
+      && (q <= Format::MAX_EXPONENT_ROUND_TO_EVEN)
+      && ((answer.mantissa & 3) == 1)
+      && ((answer.mantissa << shift) == product.high)) {
+    answer.mantissa &= ~1ULL;
+  }
+
+  answer.mantissa += (answer.mantissa & 1);  // Round half up.
+  answer.mantissa >>= 1;
+  if (answer.mantissa >= (2ULL << Format::MANTISSA_BITS)) {
+    answer.mantissa = (1ULL << Format::MANTISSA_BITS);  // Carried out.
+    ++answer.power2;
+  }
+  answer.mantissa &= ~(1ULL << Format::MANTISSA_BITS);  // Implicit bit.
+  if (answer.power2 >= Format::INFINITE_POWER) {
+    answer.mantissa = 0;
+    answer.power2 = Format::INFINITE_POWER;
+  }
+  return answer;
+}
+
+
+/** Returns the T with the given bits, and sign. */
+template<typename T>
+T toFloat(BinaryFloat binary, bool negative) {
+  using Bits = typename FloatFormat<T>::Bits;
+  const Bits bits = static_cast<Bits>(binary.mantissa)
+      | (static_cast<Bits>(binary.power2) << FloatFormat<T>::MANTISSA_BITS)
+      | (static_cast<Bits>(negative ? 1 : 0) << ((8 * sizeof(T)) - 1));
+  T value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+
+/**
+ * Parses str (already known to be in parseFloat()'s format) with the C++
+ * library, which is slow and allocates, but is exact for any number of digits.
+ */
+template<typename T>
+Optional<T> parseFloatWithStream(StringRef str) {
+  std::istringstream stream(str.toString());
+  stream.imbue(locale::classic());
+  T value;
+  stream >> value;
+  if (stream.fail() || std::isinf(value)) {
+    return Optional<T>();
+  }
+  return value;
+}
+
+
+}  // namespace
+
+
+template<typename T>
+Optional<T> parseInt(StringRef str) {
+  static_assert(std::is_integral<T>::value && (sizeof(T) <= 8),
+                "parseInt() requires an int_types integer type");
+  const char* c = str.begin();
+  bool negative = false;
+  if ((c != str.end()) && ((*c == '-') || (*c == '+'))) {
+    negative = (*c == '-');
+    ++c;
+  }
+  uint64 magnitude;
+  if ((negative && std::is_unsigned<T>::value)
+      || !parseDigits(c, str.end(), &magnitude)) {
+    return Optional<T>();
+  }
+
+  const uint64 maxValue = static_cast<uint64>(std::numeric_limits<T>::max());
+  if (!negative) {
+    return (magnitude <= maxValue) ? Optional<T>(static_cast<T>(magnitude))
+                                   : Optional<T>();
+  }
+  if (magnitude > maxValue + 1) {
+    return Optional<T>();
+  }
+  // Negate in unsigned arithmetic, since -(max + 1) has no positive T.
+  using Unsigned = typename std::make_unsigned<T>::type;
+  return Optional<T>(static_cast<T>(static_cast<Unsigned>(0 - magnitude)));
+}
+
+
+template<typename T>
+Optional<T> parseFloat(StringRef str) {
+  using Format = FloatFormat<T>;
+  Decimal decimal;
+  if (!parseDecimal(str, &decimal)) {
+    return Optional<T>();
+  }
+
+  // Clinger's fast path: if the mantissa and 10^|exponent| are both exact Ts,
+  // one (correctly rounded) multiply or divide gives the nearest T.
+  if (!decimal.truncated
+      && (decimal.exponent >= -Format::MAX_EXACT_POWER_OF_TEN)
+      && (decimal.exponent <= Format::MAX_EXACT_POWER_OF_TEN)
+      && (decimal.mantissa <= (1ULL << (Format::MANTISSA_BITS + 1)))) {
+    T value = static_cast<T>(decimal.mantissa);
+    const T powerOfTen = static_cast<T>(EXACT_POWERS_OF_TEN[
+        (decimal.exponent < 0) ? -decimal.exponent : decimal.exponent]);
+    value = (decimal.exponent < 0) ? (value / powerOfTen)
+                                   : (value * powerOfTen);
+    return Optional<T>(decimal.negative ? -value : value);
+  }
+
+  BinaryFloat binary = computeFloat<T>(decimal.exponent, decimal.mantissa);
+  if (decimal.truncated && (binary.power2 >= 0)) {
+    // The exact value is between mantissa and mantissa + 1 (* 10^exponent),
+    // so if those round the same way, that's the answer.
+    const BinaryFloat upper =
+        computeFloat<T>(decimal.exponent, decimal.mantissa + 1);
+    if ((upper.mantissa != binary.mantissa)
+        || (upper.power2 != binary.power2)) {
+      binary.power2 = -1;
+    }
+  }
+  if (binary.power2 < 0) {
+    return parseFloatWithStream<T>(str);
+  }
+  if (binary.power2 == Format::INFINITE_POWER) {
+    return Optional<T>();  // Too large.
+  }
+  return Optional<T>(toFloat<T>(binary, decimal.negative));
+}
+
+
+namespace {
+
+
+/** "00" to "99", for writing integers 2 digits at a time. */
+const char DIGIT_PAIRS[] =
+    "00010203040506070809" "10111213141516171819" "20212223242526272829"
+    "30313233343536373839" "40414243444546474849" "50515253545556575859"
+    "60616263646566676869" "70717273747576777879" "80818283848586878889"
+    "90919293949596979899";
+
+
+/** Powers of ten that fit a uint64. */
+const uint64 POWERS_OF_TEN[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+    10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+    100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL,
+    10000000000000000000ULL};
+
+
+/** Returns the number of decimal digits in value (1 for 0). */
+int countDigits(uint64 value) {
+  // 1233 / 4096 ~= log10(2), so this is floor(log10(value)) or 1 more.
+  value |= 1;  // 0 has 1 digit, too.
+  const int bitLength = 64 - bits::countLeadingZeros(value);
+  const int log10 = (bitLength * 1233) >> 12;
+  return log10 + ((value < POWERS_OF_TEN[log10]) ? 0 : 1);
+}
+
+
+/** Writes the digits of value so that the last one is just before end. */
+void writeDigits(uint64 value, char* end) {
+  while (value >= 100) {
+    const uint64 pair = value % 100;
+    value /= 100;
+    end -= 2;
+    std::memcpy(end, &DIGIT_PAIRS[2 * pair], 2);
+  }
+  if (value >= 10) {
+    std::memcpy(end - 2, &DIGIT_PAIRS[2 * value], 2);
+  } else {
+    end[-1] = static_cast<char>('0' + value);
+  }
+}
+
+
+/** Writes value's digits to out, returning out past the last one. */
+char* writeInt(uint64 value, char* out) {
+  out += countDigits(value);
+  writeDigits(value, out);
+  return out;
+}
+
+
+#include "ryu_tables.inc"
+
+
+/** Returns floor(log2(5^e)) + 1, for 0 <= e <= 3528. */
+int32 pow5Bits(int32 e) {
+  return ((e * 1217359) >> 19) + 1;
+}
+
+
+/** Returns floor(log10(2^e)), for 0 <= e <= 1650. */
+int32 log10Pow2(int32 e) {
+  return (e * 78913) >> 18;
+}
+
+
+/** Returns floor(log10(5^e)), for 0 <= e <= 2620. */
+int32 log10Pow5(int32 e) {
+  return (e * 732923) >> 20;
+}
+
+
+/** Returns true if value is divisible by 5^p. */
+bool isMultipleOfPowerOf5(uint64 value, int32 p) {
+  for (int32 i = 0; i < p; ++i, value /= 5) {
+    if (value % 5 != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/** Returns true if value is divisible by 2^p, for p < 64. */
+bool isMultipleOfPowerOf2(uint64 value, int32 p) {
+  return ((value & ((1ULL << p) - 1)) == 0);
+}
+
+
+/**
+ * Returns (m * factor) >> shift, for a 125-bit factor (high half first) from
+ * ryu_tables.inc, and 64 < shift < 128.
+ */
+uint64 multiplyShift(uint64 m, const uint64* factor, int32 shift) {
+  const UInt128 low = multiplyFull(m, factor[1]);
+  UInt128 product = multiplyFull(m, factor[0]);
+  product.low += low.high;
+  product.high += (product.low < low.high) ? 1 : 0;
+  shift -= 64;
+  return (product.high << (64 - shift)) | (product.low >> shift);
+}
+
+
+/**
+ * Returns the shortest decimal that parses back as the finite, positive T
+ * with the given explicit mantissa bits and biased exponent (the closest to
+ * its exact value, if there are several), by the Ryu algorithm (see Ulf Adams,
+ * "Ryu: Fast Float-to-String Conversion", 2018).
+ *
+ * The T rounds from exactly the values between the midpoints to its
+ * neighbors, u and w, so the answer is the decimal with the most trailing
+ * zeros in that interval. Ryu scales u, the T itself (v), and w by 10^-e10
+ * (with one 128-bit multiply each), then removes digits while u and w still
+ * differ. Floats use the double tables, which are precise enough for any T
+ * with at most 53 mantissa bits.
+ */
+template<typename T>
+Decimal toShortestDecimal(uint64 mantissaBits, int32 power2) {
+  using Format = FloatFormat<T>;
+  const int32 bias = -Format::MIN_EXPONENT;
+  Decimal decimal = {0, 0, false, false};
+
+  // Integers with only MANTISSA_BITS + 1 bits are exact, so just need their
+  // trailing zeros removed.
+  const uint64 implicitBit = 1ULL << Format::MANTISSA_BITS;
+  const int32 fractionBits = Format::MANTISSA_BITS + bias - power2;
+  if ((power2 != 0) && (fractionBits >= 0)
+      && (fractionBits <= Format::MANTISSA_BITS)) {
+    const uint64 mantissa = implicitBit | mantissaBits;
+    if ((mantissa & ((1ULL << fractionBits) - 1)) == 0) {
+      decimal.mantissa = mantissa >> fractionBits;
+      while (decimal.mantissa % 10 == 0) {
+        decimal.mantissa /= 10;
+        ++decimal.exponent;
+      }
+      return decimal;
+    }
+  }
+
+  // The T is m2 * 2^e2, with 2 extra bits (so u and w are integers).
+  const int32 e2 = ((power2 == 0) ? 1 : power2) - bias
+      - Format::MANTISSA_BITS - 2;
+  const uint64 m2 = (power2 == 0) ? mantissaBits : (implicitBit | mantissaBits);
+  const bool acceptBounds = ((m2 & 1) == 0);  // Ties round to even.
+  const uint64 mv = 4 * m2;
+  // u is closer at powers of two (other than the smallest normal T).
+  const uint64 mmShift = ((mantissaBits != 0) || (power2 <= 1)) ? 1 : 0;
+
+  uint64 vr;  // v * 10^-e10, and likewise for w & u.
+  uint64 vp;
+  uint64 vm;
+  int32 e10;
+  bool vmIsTrailingZeros = false;  // Whether the scaling was exact.
+  bool vrIsTrailingZeros = false;
+  if (e2 >= 0) {
+    const int32 q = log10Pow2(e2) - ((e2 > 3) ? 1 : 0);
+    e10 = q;
+    const int32 k = RYU_POWER_OF_FIVE_BITS + pow5Bits(q) - 1;
+    const int32 shift = -e2 + q + k;
+    const uint64* factor = &RYU_INVERSE_POWERS_OF_FIVE[2 * q];
+    vr = multiplyShift(mv, factor, shift);
+    vp = multiplyShift(mv + 2, factor, shift);
+    vm = multiplyShift(mv - 1 - mmShift, factor, shift);
+    if (q <= 21) {
+      // Only one of mv, mv + 2, and mv - 1 - mmShift can be a multiple of 5.
+      if (mv % 5 == 0) {
+        vrIsTrailingZeros = isMultipleOfPowerOf5(mv, q);
+      } else if (acceptBounds) {
+        vmIsTrailingZeros = isMultipleOfPowerOf5(mv - 1 - mmShift, q);
+      } else {
+        vp -= isMultipleOfPowerOf5(mv + 2, q) ? 1 : 0;  // w is excluded.
+      }
+    }
+  } else {
+    const int32 q = log10Pow5(-e2) - ((-e2 > 1) ? 1 : 0);
+    e10 = q + e2;
+    const int32 i = -e2 - q;
+    const int32 shift = q - (pow5Bits(i) - RYU_POWER_OF_FIVE_BITS);
+    const uint64* factor = &RYU_POWERS_OF_FIVE[2 * i];
+    vr = multiplyShift(mv, factor, shift);
+    vp = multiplyShift(mv + 2, factor, shift);
+    vm = multiplyShift(mv - 1 - mmShift, factor, shift);
+    if (q <= 1) {
+      // mv, mv + 2, and mv - 1 - mmShift all have at least q trailing 0 bits,
+      // but only mv - 1 - mmShift (if mmShift is 1) is even.
+      vrIsTrailingZeros = true;
+      if (acceptBounds) {
+        vmIsTrailingZeros = (mmShift == 1);
+      } else {
+        --vp;
+      }
+    } else if (q < 63) {
+      vrIsTrailingZeros = isMultipleOfPowerOf2(mv, q);
+    }
+  }
+
+  int32 removed = 0;
+  uint8 lastRemovedDigit = 0;
+  if (vmIsTrailingZeros || vrIsTrailingZeros) {
+    // Rare (~0.7% of doubles): u may be in the interval, or v may be exactly
+    // halfway between two candidates.
+    for (; vp / 10 > vm / 10; ++removed) {
+      vmIsTrailingZeros &= (vm % 10 == 0);
+      vrIsTrailingZeros &= (lastRemovedDigit == 0);
+      lastRemovedDigit = static_cast<uint8>(vr % 10);
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+    }
+    if (vmIsTrailingZeros) {
+      for (; vm % 10 == 0; ++removed) {
+        vrIsTrailingZeros &= (lastRemovedDigit == 0);
+        lastRemovedDigit = static_cast<uint8>(vr % 10);
+        vr /= 10;
+        vp /= 10;
+        vm /= 10;
+      }
+    }
+    if (vrIsTrailingZeros && (lastRemovedDigit == 5) && (vr % 2 == 0)) {
+      lastRemovedDigit = 4;  // Exactly halfway, so round to even.
+    }
+    const bool roundUp = ((vr == vm) && (!acceptBounds || !vmIsTrailingZeros))
+        || (lastRemovedDigit >= 5);
+    decimal.mantissa = vr + (roundUp ? 1 : 0);
+  } else {
+    bool roundUp = false;
+    if (vp / 100 > vm / 100) {  // Usually at least 2 digits can go.
+      roundUp = (vr % 100 >= 50);
+      vr /= 100;
+      vp /= 100;
+      vm /= 100;
+      removed += 2;
+    }
+    for (; vp / 10 > vm / 10; ++removed) {
+      roundUp = (vr % 10 >= 5);
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+    }
+    decimal.mantissa = vr + (((vr == vm) || roundUp) ? 1 : 0);
+  }
+  decimal.exponent = e10 + removed;
+  return decimal;
+}
+
+
+/** Writes decimal in formatFloat()'s notation, returning out past the end. */
+char* writeDecimal(const Decimal& decimal, char* out) {
+  if (decimal.negative) {
+    *out++ = '-';
+  }
+  const int32 numDigits = countDigits(decimal.mantissa);
+  const int32 exponent = static_cast<int32>(decimal.exponent);
+  const int32 point = numDigits + exponent;  // Digits before the point.
+  if ((exponent >= 0) && (point <= 21)) {
+    out = writeInt(decimal.mantissa, out);  // An integer.
+    std::memset(out, '0', static_cast<std::size_t>(exponent));
+    return out + exponent;
+  }
+  if ((point > 0) && (point <= 21)) {
+    // Writes the digits 1 char ahead, then moves the integer part back.
+    writeDigits(decimal.mantissa, out + numDigits + 1);
+    std::memmove(out, out + 1, static_cast<std::size_t>(point));
+    out[point] = '.';
+    return out + numDigits + 1;
+  }
+  if ((point > -6) && (point <= 0)) {
+    out[0] = '0';
+    out[1] = '.';
+    std::memset(out + 2, '0', static_cast<std::size_t>(-point));
+    return writeInt(decimal.mantissa, out + 2 - point);
+  }
+
+  // Scientific notation: d[.ddd]e[+-]x.
+  writeDigits(decimal.mantissa, out + numDigits + 1);
+  out[0] = out[1];
+  if (numDigits > 1) {
+    out[1] = '.';
+    out += numDigits + 1;
+  } else {
+    ++out;
+  }
+  *out++ = 'e';
+  *out++ = (point > 0) ? '+' : '-';
+  return writeInt(static_cast<uint64>((point > 0) ? (point - 1) : (1 - point)),
+                  out);
+}
+
+
+}  // namespace
+
+
+template<typename T>
+char* formatInt(T value, char* out) {
+  static_assert(std::is_integral<T>::value && (sizeof(T) <= 8),
+                "formatInt() requires an int_types integer type");
+  uint64 magnitude = static_cast<uint64>(value);
+  if (value < 0) {
+    *out++ = '-';
+    magnitude = 0 - magnitude;  // Unsigned, since -min() has no positive T.
+  }
+  return writeInt(magnitude, out);
+}
+
+
+template<typename T>
+void formatInt(T value, std::string& out) {
+  char buffer[MAX_INT_CHARS];
+  out.append(buffer, formatInt(value, buffer));
+}
+
+
+template<typename T>
+char* formatFloat(T value, char* out) {
+  using Format = FloatFormat<T>;
+  using Bits = typename Format::Bits;
+  Bits bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const bool negative = ((bits >> ((8 * sizeof(T)) - 1)) != 0);
+  const uint64 mantissaBits =
+      bits & ((static_cast<Bits>(1) << Format::MANTISSA_BITS) - 1);
+  const int32 power2 = static_cast<int32>(bits >> Format::MANTISSA_BITS)
+      & Format::INFINITE_POWER;
+
+  if (power2 == Format::INFINITE_POWER) {
+    const char* const name = (mantissaBits != 0) ? "nan"
+        : (negative ? "-inf" : "inf");
+    const std::size_t length = std::strlen(name);
+    std::memcpy(out, name, length);
+    return out + length;
+  }
+  if ((power2 == 0) && (mantissaBits == 0)) {
+    if (negative) {
+      *out++ = '-';
+    }
+    *out++ = '0';
+    return out;
+  }
+
+  Decimal decimal = toShortestDecimal<T>(mantissaBits, power2);
+  decimal.negative = negative;
+  return writeDecimal(decimal, out);
+}
+
+
+template<typename T>
+void formatFloat(T value, std::string& out) {
+  char buffer[MAX_FLOAT_CHARS];
+  out.append(buffer, formatFloat(value, buffer));
+}
+
+
+// Instantiate for each supported type (the declarations are in strings.h).
+template Optional<int8> parseInt<int8>(StringRef str);
+template Optional<int16> parseInt<int16>(StringRef str);
+template Optional<int32> parseInt<int32>(StringRef str);
+template Optional<int64> parseInt<int64>(StringRef str);
+template Optional<uint8> parseInt<uint8>(StringRef str);
+template Optional<uint16> parseInt<uint16>(StringRef str);
+template Optional<uint32> parseInt<uint32>(StringRef str);
+template Optional<uint64> parseInt<uint64>(StringRef str);
+template Optional<float> parseFloat<float>(StringRef str);
+template Optional<double> parseFloat<double>(StringRef str);
+template char* formatInt<int8>(int8 value, char* out);
+template char* formatInt<int16>(int16 value, char* out);
+template char* formatInt<int32>(int32 value, char* out);
+template char* formatInt<int64>(int64 value, char* out);
+template char* formatInt<uint8>(uint8 value, char* out);
+template char* formatInt<uint16>(uint16 value, char* out);
+template char* formatInt<uint32>(uint32 value, char* out);
+template char* formatInt<uint64>(uint64 value, char* out);
+template void formatInt<int8>(int8 value, std::string& out);
+template void formatInt<int16>(int16 value, std::string& out);
+template void formatInt<int32>(int32 value, std::string& out);
+template void formatInt<int64>(int64 value, std::string& out);
+template void formatInt<uint8>(uint8 value, std::string& out);
+template void formatInt<uint16>(uint16 value, std::string& out);
+template void formatInt<uint32>(uint32 value, std::string& out);
+template void formatInt<uint64>(uint64 value, std::string& out);
+template char* formatFloat<float>(float value, char* out);
+template char* formatFloat<double>(double value, char* out);
+template void formatFloat<float>(float value, std::string& out);
+template void formatFloat<double>(double value, std::string& out);
+
+
 }  // namespace strings
 }  // namespace oomuse
@@ -0,0 +1,230 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/BatchValidator.h"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "oomuse/core/FixedArray.h"
+#include "oomuse/core/Validator.h"
+#include "oomuse/core/ValidatorExpressions.h"
+#include "oomuse/core/Validators.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::BatchValidationResult;
+using oomuse::BatchValidator;
+using oomuse::FixedArray;
+using oomuse::Validator;
+using oomuse::Validators;
+using std::string;
+using std::unique_ptr;
+
+namespace v = oomuse::validation;
+
+namespace {
+
+
+/** Expects result to match checking each value with isValid(). */
+template<typename T>
+void expectMatchesIsValid(const Validator<T>& validator, const T* values,
+                          std::size_t length,
+                          const BatchValidationResult& result) {
+  ASSERT_EQ(length, result.length());
+  ASSERT_EQ((length + 63) / 64, result.validBits().length());
+
+  std::size_t numFailures = 0;
+  bool hasFailure = false;
+  std::size_t firstFailure = 0;
+  for (std::size_t i = 0; i < length; ++i) {
+    const bool isValid = validator.isValid(values[i]);
+    ASSERT_EQ(isValid, result.isValid(i)) << "at index " << i;
+    if (!isValid) {
+      if (!hasFailure) {
+        hasFailure = true;
+        firstFailure = i;
+      }
+      ++numFailures;
+    }
+  }
+
+  EXPECT_EQ(numFailures, result.numFailures());
+  EXPECT_EQ(numFailures == 0, result.allValid());
+  EXPECT_EQ(hasFailure, result.firstFailure().hasValue());
+  if (hasFailure) {
+    EXPECT_EQ(firstFailure, result.firstFailure().value());
+  }
+
+  // Bits past the end are always cleared.
+  if (length % 64 != 0) {
+    EXPECT_EQ(0u, result.validBits()[length / 64] >> (length % 64));
+  }
+}
+
+
+TEST(BatchValidator, midiValues) {
+  auto isMidiValue = Validators<int32>::allOf(
+      Validators<int32>::greaterOrEqual(0),
+      Validators<int32>::less(128));
+  BatchValidator<int32> batchValidator(*isMidiValue);
+
+  for (std::size_t length : {0, 1, 63, 64, 65, 1000, 5000}) {
+    FixedArray<int32> values(length);
+    for (std::size_t i = 0; i < length; ++i) {
+      values[i] = static_cast<int32>((i * 37) % 140) - 5;
+    }
+    expectMatchesIsValid(*isMidiValue, values.data(), length,
+                         batchValidator.validate(values));
+  }
+}
+
+
+TEST(BatchValidator, allValid) {
+  auto isSample = Validators<float>::allOf(
+      Validators<float>::greaterOrEqual(-1.0f),
+      Validators<float>::lessOrEqual(1.0f));
+  FixedArray<float> samples(300);
+  for (std::size_t i = 0; i < samples.length(); ++i) {
+    samples[i] = (i % 3 == 0) ? -1.0f : 0.5f;
+  }
+
+  BatchValidationResult result = BatchValidator<float>(*isSample).validate(
+      samples);
+  EXPECT_TRUE(result.allValid());
+  EXPECT_EQ(0u, result.numFailures());
+  EXPECT_FALSE(result.firstFailure().hasValue());
+}
+
+
+TEST(BatchValidator, everyValidatorKind) {
+  std::vector<unique_ptr<Validator<int32>>> validators;
+  validators.emplace_back(Validators<int32>::less(10));
+  validators.emplace_back(Validators<int32>::lessOrEqual(10));
+  validators.emplace_back(Validators<int32>::greater(10));
+  validators.emplace_back(Validators<int32>::greaterOrEqual(10));
+  validators.emplace_back(Validators<int32>::equal(10));
+  validators.emplace_back(Validators<int32>::notEqual(10));
+  validators.emplace_back(Validators<int32>::anyOf(
+      Validators<int32>::less(3), Validators<int32>::greater(17)));
+  validators.emplace_back(Validators<int32>::compile(
+      Validators<int32>::anyOf(Validators<int32>::less(3),
+                               Validators<int32>::equal(9))));
+  validators.emplace_back(oomuse::validation::toValidator<int32>(
+      v::greater(2) && v::notEqual(12)));
+
+  FixedArray<int32> values(200);
+  for (std::size_t i = 0; i < values.length(); ++i) {
+    values[i] = static_cast<int32>(i % 21);
+  }
+  for (auto& validator : validators) {
+    expectMatchesIsValid(*validator, values.data(), values.length(),
+                         BatchValidator<int32>(*validator).validate(values));
+  }
+}
+
+
+class IsEvenValidator : public Validator<int32> {
+ public:
+  virtual std::string checkValidationErrors(const int32& value) const {
+    return (value % 2 == 0) ? "" : "Must be even.";
+  }
+};
+
+
+TEST(BatchValidator, customValidator) {
+  // Custom validators fall back to checking one value at a time.
+  IsEvenValidator isEven;
+  FixedArray<int32> values({2, 4, 6, 7, 8, 9});
+  BatchValidationResult result = BatchValidator<int32>(isEven).validate(
+      values);
+  expectMatchesIsValid<int32>(isEven, values.data(), values.length(), result);
+  EXPECT_EQ(3u, result.firstFailure().value());
+  EXPECT_EQ(2u, result.numFailures());
+}
+
+
+TEST(BatchValidator, sizes) {
+  auto isShortName = Validators<string>::allOf(
+      Validators<string>::sizeGreaterOrEqual(1),
+      Validators<string>::sizeLessOrEqual(4));
+  FixedArray<string> names({"eric", "", "bob", "alexander"});
+  BatchValidationResult result =
+      BatchValidator<string>(*isShortName).validate(names);
+  expectMatchesIsValid(*isShortName, names.data(), names.length(), result);
+}
+
+
+/** Validator that throws on a sentinel value, as a stand-in for any error. */
+class ThrowingValidator : public Validator<int32> {
+ public:
+  virtual bool isValid(const int32& value) const {
+    if (value < 0) {
+      throw std::runtime_error("can't check negative values");
+    }
+    return true;
+  }
+
+  virtual string checkValidationErrors(const int32& value) const {
+    return isValid(value) ? "" : "Invalid.";
+  }
+};
+
+
+TEST(BatchValidator, exceptionJoinsStartedThreads) {
+  // The last range runs on the calling thread; throwing there must still
+  // join the other threads (rather than std::terminate()).
+  ThrowingValidator validator;
+  FixedArray<int32> values(4096);
+  for (std::size_t i = 0; i < values.length(); ++i) {
+    values[i] = 1;
+  }
+  values[4000] = -1;
+
+  EXPECT_THROW(BatchValidator<int32>(validator, 4, 64).validate(values),
+               std::runtime_error);
+}
+
+
+TEST(BatchValidator, threadsAreDeterministic) {
+  auto isMidiValue = Validators<int32>::allOf(
+      Validators<int32>::greaterOrEqual(0),
+      Validators<int32>::less(128));
+  FixedArray<int32> values(100000);
+  for (std::size_t i = 0; i < values.length(); ++i) {
+    values[i] = static_cast<int32>(i % 127);
+  }
+  values[70001] = 200;
+  values[99999] = -1;
+  values[31337] = 128;
+
+  BatchValidationResult serial =
+      BatchValidator<int32>(*isMidiValue).validate(values);
+  for (std::size_t maxThreads : {2, 3, 4, 7}) {
+    BatchValidationResult parallel =
+        BatchValidator<int32>(*isMidiValue, maxThreads, 1000).validate(values);
+    expectMatchesIsValid(*isMidiValue, values.data(), values.length(),
+                         parallel);
+    EXPECT_EQ(serial.validBits(), parallel.validBits());
+    EXPECT_EQ(3u, parallel.numFailures());
+    EXPECT_EQ(31337u, parallel.firstFailure().value());
+  }
+}
+
+
+}  // namespace
@@ -0,0 +1,90 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/CharacterSet.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+using oomuse::CharacterSet;
+using std::string;
+
+namespace {
+
+
+TEST(CharacterSet, empty) {
+  CharacterSet none;
+  EXPECT_FALSE(none.contains('a'));
+  EXPECT_FALSE(none.contains('\0'));
+  EXPECT_TRUE(none.containsAll(""));
+  EXPECT_FALSE(none.containsAll("a"));
+}
+
+
+TEST(CharacterSet, charactersAndRanges) {
+  CharacterSet tagChars = CharacterSet::range('a', 'z')
+      | CharacterSet::range('0', '9') | CharacterSet("-_");
+  EXPECT_TRUE(tagChars.contains('a'));
+  EXPECT_TRUE(tagChars.contains('z'));
+  EXPECT_TRUE(tagChars.contains('5'));
+  EXPECT_TRUE(tagChars.contains('_'));
+  EXPECT_FALSE(tagChars.contains('A'));
+  EXPECT_FALSE(tagChars.contains(' '));
+
+  EXPECT_TRUE(tagChars.containsAll("my-tag_42"));
+  EXPECT_TRUE(tagChars.containsAll("a-long-tag-with-many-words-in-it"));
+  EXPECT_FALSE(tagChars.containsAll("My-tag"));
+  EXPECT_FALSE(tagChars.containsAll("a-long-tag-with-one-bad-character!"));
+}
+
+
+TEST(CharacterSet, highBytes) {
+  CharacterSet highBytes = CharacterSet::range('\x80', '\xFF');
+  EXPECT_TRUE(highBytes.contains('\x80'));
+  EXPECT_TRUE(highBytes.contains('\xFF'));
+  EXPECT_FALSE(highBytes.contains('\x7F'));
+  EXPECT_TRUE(highBytes.containsAll("\xC3\xA9\xE2\x82\xAC"));
+
+  CharacterSet everything = CharacterSet::range('\0', '\xFF');
+  EXPECT_TRUE(everything.containsAll(string("any\0thing\xFF", 10)));
+}
+
+
+TEST(CharacterSet, add) {
+  CharacterSet vowels;
+  vowels.add('a').add('e').add('i').add('o').add('u');
+  EXPECT_TRUE(vowels.containsAll("aeiou"));
+  EXPECT_FALSE(vowels.containsAll("aeiouy"));
+}
+
+
+TEST(CharacterSet, copyMembers) {
+  char members[4] = {};
+  EXPECT_EQ(0u, CharacterSet().copyMembers(members, 4));
+
+  EXPECT_EQ(3u, CharacterSet("\n,\xFF").copyMembers(members, 4));
+  EXPECT_EQ('\n', members[0]);
+  EXPECT_EQ(',', members[1]);
+  EXPECT_EQ('\xFF', members[2]);
+
+  // Only copies up to maxChars, but still counts all members.
+  EXPECT_EQ(26u, CharacterSet::range('a', 'z').copyMembers(members, 4));
+  EXPECT_EQ(string("abcd"), string(members, 4));
+}
+
+
+}  // namespace
@@ -0,0 +1,255 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/InstrumentedValidator.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "oomuse/core/BatchValidator.h"
+#include "oomuse/core/Validator.h"
+#include "oomuse/core/Validators.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::BatchValidator;
+using oomuse::ValidationErrorCode;
+using oomuse::Validator;
+using oomuse::ValidatorStats;
+using oomuse::ValidatorStatsRegistry;
+using oomuse::ValidatorStatsSnapshot;
+using oomuse::Validators;
+using oomuse::instrument;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace {
+
+
+unique_ptr<Validator<int32>> makeMidiValidator(
+    ValidatorStatsRegistry& registry) {
+  return instrument("midiValue",
+                    Validators<int32>::allOf(
+                        Validators<int32>::greaterOrEqual(0),
+                        Validators<int32>::less(128)),
+                    registry);
+}
+
+
+uint64 sumHistogram(const ValidatorStatsSnapshot& stats) {
+  uint64 sum = 0;
+  for (uint64 count : stats.latencyHistogram()) {
+    sum += count;
+  }
+  return sum;
+}
+
+
+TEST(InstrumentedValidator, forwardsResults) {
+  ValidatorStatsRegistry registry;
+  auto isMidiValue = makeMidiValidator(registry);
+
+  EXPECT_TRUE(isMidiValue->isValid(0));
+  EXPECT_FALSE(isMidiValue->isValid(128));
+  EXPECT_EQ(ValidationErrorCode::NONE,
+            isMidiValue->checkValidationErrorCode(127));
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_GREATER_OR_EQUAL,
+            isMidiValue->checkValidationErrorCode(-1));
+  EXPECT_EQ("", isMidiValue->checkValidationErrors(64));
+  EXPECT_EQ("Must be less than 128.\n",
+            isMidiValue->checkValidationErrors(200));
+}
+
+
+TEST(InstrumentedValidator, countsCallsAndFailures) {
+  ValidatorStatsRegistry registry;
+  auto isMidiValue = makeMidiValidator(registry);
+
+  isMidiValue->isValid(0);
+  isMidiValue->isValid(128);
+  isMidiValue->checkValidationErrorCode(-1);
+  isMidiValue->checkValidationErrors(64);
+
+  vector<ValidatorStatsSnapshot> snapshots = registry.snapshot();
+  ASSERT_EQ(1u, snapshots.size());
+  EXPECT_EQ("midiValue", snapshots[0].name());
+  EXPECT_EQ(4u, snapshots[0].numCalls());
+  EXPECT_EQ(2u, snapshots[0].numFailures());
+  EXPECT_DOUBLE_EQ(0.5, snapshots[0].failureRate());
+  EXPECT_LE(1u, sumHistogram(snapshots[0]));  // checkValidationErrors().
+  EXPECT_GE(4u, sumHistogram(snapshots[0]));
+}
+
+
+TEST(InstrumentedValidator, countsBatches) {
+  ValidatorStatsRegistry registry;
+  auto isMidiValue = makeMidiValidator(registry);
+
+  vector<int32> values;
+  for (int32 i = -50; i < 150; ++i) {
+    values.push_back(i);
+  }
+  BatchValidator<int32> batchValidator(*isMidiValue);
+  EXPECT_EQ(72u, batchValidator.validate(values.data(), values.size())
+                     .numFailures());
+
+  ValidatorStatsSnapshot stats = registry.statsFor("midiValue").snapshot();
+  EXPECT_EQ(200u, stats.numCalls());
+  EXPECT_EQ(72u, stats.numFailures());
+  EXPECT_EQ(200u, sumHistogram(stats));
+}
+
+
+TEST(InstrumentedValidator, disabledRecordsNothing) {
+  ValidatorStatsRegistry registry;
+  auto isMidiValue = makeMidiValidator(registry);
+
+  registry.setEnabled(false);
+  EXPECT_FALSE(registry.isEnabled());
+  EXPECT_TRUE(isMidiValue->isValid(0));
+  EXPECT_FALSE(isMidiValue->isValid(-5));
+  EXPECT_EQ(0u, registry.statsFor("midiValue").snapshot().numCalls());
+
+  registry.setEnabled(true);
+  isMidiValue->isValid(0);
+  EXPECT_EQ(1u, registry.statsFor("midiValue").snapshot().numCalls());
+}
+
+
+TEST(InstrumentedValidator, sameNameSharesStats) {
+  ValidatorStatsRegistry registry;
+  auto isMidiValue1 = makeMidiValidator(registry);
+  auto isMidiValue2 = makeMidiValidator(registry);
+  auto isPositive =
+      instrument("positive", Validators<int32>::greater(0), registry);
+
+  isMidiValue1->isValid(1);
+  isMidiValue2->isValid(2);
+  isPositive->isValid(0);
+
+  vector<ValidatorStatsSnapshot> snapshots = registry.snapshot();
+  ASSERT_EQ(2u, snapshots.size());
+  EXPECT_EQ("midiValue", snapshots[0].name());
+  EXPECT_EQ(2u, snapshots[0].numCalls());
+  EXPECT_EQ("positive", snapshots[1].name());
+  EXPECT_EQ(1u, snapshots[1].numCalls());
+  EXPECT_EQ(1u, snapshots[1].numFailures());
+}
+
+
+TEST(InstrumentedValidator, reset) {
+  ValidatorStatsRegistry registry;
+  auto isMidiValue = makeMidiValidator(registry);
+  isMidiValue->isValid(500);
+
+  registry.reset();
+  ValidatorStatsSnapshot stats = registry.statsFor("midiValue").snapshot();
+  EXPECT_EQ(0u, stats.numCalls());
+  EXPECT_EQ(0u, stats.numFailures());
+  EXPECT_EQ(0u, sumHistogram(stats));
+  EXPECT_DOUBLE_EQ(0.0, stats.failureRate());
+  EXPECT_EQ(0u, stats.latencyPercentileNanos(50.0));
+}
+
+
+TEST(InstrumentedValidator, latencyPercentiles) {
+  ValidatorStatsRegistry registry;
+  ValidatorStats& stats = registry.statsFor("timed");
+  for (int i = 0; i < 98; ++i) {
+    stats.record(true, 10);  // Bucket [8, 16).
+  }
+  stats.record(true, 0);
+  stats.record(false, 1000);  // Bucket [512, 1024).
+
+  ValidatorStatsSnapshot snapshot = stats.snapshot();
+  EXPECT_EQ(1u, snapshot.latencyHistogram()[0]);
+  EXPECT_EQ(98u, snapshot.latencyHistogram()[4]);
+  EXPECT_EQ(1u, snapshot.latencyHistogram()[10]);
+  EXPECT_EQ(0u, snapshot.latencyPercentileNanos(0.0));
+  EXPECT_EQ(16u, snapshot.latencyPercentileNanos(50.0));
+  EXPECT_EQ(16u, snapshot.latencyPercentileNanos(99.0));
+  EXPECT_EQ(1024u, snapshot.latencyPercentileNanos(100.0));
+
+  // Very slow calls land in the last bucket.
+  stats.record(true, static_cast<uint64>(1) << 40);
+  EXPECT_EQ(1u, stats.snapshot().latencyHistogram()[
+      ValidatorStatsSnapshot::NUM_LATENCY_BUCKETS - 1]);
+}
+
+
+TEST(InstrumentedValidator, dump) {
+  ValidatorStatsRegistry registry;
+  ValidatorStats& stats = registry.statsFor("note");
+  for (int i = 0; i < 7; ++i) {
+    stats.record(i != 0, 10);
+  }
+  registry.statsFor("alpha");
+
+  EXPECT_EQ("alpha: 0 calls, 0 failures (0.0%), p50 <= 0 ns, p99 <= 0 ns\n"
+            "note: 7 calls, 1 failures (14.3%), p50 <= 16 ns, p99 <= 16 ns\n",
+            registry.dump());
+}
+
+
+TEST(InstrumentedValidator, countsFromManyThreads) {
+  ValidatorStatsRegistry registry;
+  auto isMidiValue = makeMidiValidator(registry);
+
+  const int numThreads = 2 * static_cast<int>(ValidatorStats::NUM_SHARDS) + 1;
+  const int callsPerThread = 1000;
+  vector<std::thread> threads;
+  for (int t = 0; t < numThreads; ++t) {
+    threads.emplace_back([&isMidiValue, callsPerThread]() {
+      for (int i = 0; i < callsPerThread; ++i) {
+        isMidiValue->isValid(i % 256);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ValidatorStatsSnapshot stats = registry.statsFor("midiValue").snapshot();
+  EXPECT_EQ(static_cast<uint64>(numThreads * callsPerThread),
+            stats.numCalls());
+  EXPECT_EQ(static_cast<uint64>(numThreads * 488), stats.numFailures());
+
+  // Only every LATENCY_SAMPLE_INTERVAL-th call per thread gets timed.
+  EXPECT_EQ(static_cast<uint64>(
+                numThreads
+                * (callsPerThread / ValidatorStats::LATENCY_SAMPLE_INTERVAL)),
+            sumHistogram(stats));
+}
+
+
+TEST(InstrumentedValidator, globalRegistry) {
+  EXPECT_EQ(&ValidatorStatsRegistry::global(),
+            &ValidatorStatsRegistry::global());
+  auto isPositive = instrument("InstrumentedValidator_test.positive",
+                               Validators<int32>::greater(0));
+  ValidatorStats& stats = ValidatorStatsRegistry::global().statsFor(
+      "InstrumentedValidator_test.positive");
+  const uint64 numCallsBefore = stats.snapshot().numCalls();
+  isPositive->isValid(1);
+  EXPECT_EQ(numCallsBefore + 1, stats.snapshot().numCalls());
+}
+
+
+}  // namespace
@@ -0,0 +1,148 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/LocaleTables.h"
+
+#include <locale>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "oomuse/core/strings.h"
+
+using oomuse::LocaleTables;
+using std::locale;
+using std::string;
+
+namespace strings = oomuse::strings;
+
+namespace {
+
+
+/** Classic ctype, except that '_' counts as whitespace and '1' <-> '!'. */
+class UnderscoreSpaceCtype : public std::ctype<char> {
+ public:
+  UnderscoreSpaceCtype() : std::ctype<char>(makeTable()) {}
+
+ protected:
+  virtual char do_tolower(char c) const {
+    return (c == '!') ? '1' : std::ctype<char>::do_tolower(c);
+  }
+  virtual const char* do_tolower(char* begin, const char* end) const {
+    for (char* c = begin; c != end; ++c) {
+      *c = do_tolower(*c);
+    }
+    return end;
+  }
+  virtual char do_toupper(char c) const {
+    return (c == '1') ? '!' : std::ctype<char>::do_toupper(c);
+  }
+  virtual const char* do_toupper(char* begin, const char* end) const {
+    for (char* c = begin; c != end; ++c) {
+      *c = do_toupper(*c);
+    }
+    return end;
+  }
+
+ private:
+  static const mask* makeTable() {
+    static std::vector<mask> table(classic_table(),
+                                   classic_table() + table_size);
+    table['_'] |= space;
+    return table.data();
+  }
+};
+
+
+locale makeUnderscoreSpaceLocale() {
+  return locale(locale::classic(), new UnderscoreSpaceCtype());
+}
+
+
+void expectMatchesLocale(const locale& loc) {
+  LocaleTables tables(loc);
+  for (int i = 0; i < 256; ++i) {
+    const char c = static_cast<char>(i);
+    EXPECT_EQ(std::isspace(c, loc), tables.isSpace(c)) << "char " << i;
+    EXPECT_EQ(std::tolower(c, loc), tables.toLower(c)) << "char " << i;
+    EXPECT_EQ(std::toupper(c, loc), tables.toUpper(c)) << "char " << i;
+  }
+}
+
+
+TEST(LocaleTables, matchesClassicLocale) {
+  expectMatchesLocale(locale::classic());
+  expectMatchesLocale(locale());
+  EXPECT_TRUE(LocaleTables(locale::classic()).hasStandardAscii());
+}
+
+
+TEST(LocaleTables, matchesCustomFacet) {
+  expectMatchesLocale(makeUnderscoreSpaceLocale());
+
+  LocaleTables tables(makeUnderscoreSpaceLocale());
+  EXPECT_FALSE(tables.hasStandardAscii());
+  EXPECT_TRUE(tables.isSpace('_'));
+  EXPECT_TRUE(tables.isSpace(' '));
+  EXPECT_FALSE(tables.isSpace('a'));
+  EXPECT_EQ('!', tables.toUpper('1'));
+  EXPECT_EQ('1', tables.toLower('!'));
+}
+
+
+TEST(LocaleTables, stringsOverloads) {
+  const locale loc = makeUnderscoreSpaceLocale();
+  LocaleTables tables(loc);
+
+  EXPECT_TRUE(strings::isEmptyOrWhitespace("_ _\t", tables));
+  EXPECT_TRUE(strings::isEmptyOrWhitespace("_ _\t", loc));
+  EXPECT_FALSE(strings::isEmptyOrWhitespace("_ x", tables));
+  EXPECT_FALSE(strings::isEmptyOrWhitespace("_ _\t"));
+
+  EXPECT_EQ("a_b", strings::trimWhitespace("__ a_b _", tables));
+  EXPECT_EQ("a_b", strings::trimWhitespace("__ a_b _", loc));
+  EXPECT_EQ("", strings::trimWhitespace("___", tables));
+  EXPECT_EQ(string("a_b"), strings::trimWhitespace(string("_a_b_"), tables));
+
+  EXPECT_EQ("take 11", strings::toLowerCase("TAKE 1!", loc));
+  EXPECT_EQ("take 11", strings::toLowerCase("TAKE 1!", tables));
+  EXPECT_EQ("TAKE !!", strings::toUpperCase("take 1!", loc));
+  EXPECT_EQ("TAKE !!", strings::toUpperCase("take 1!", tables));
+  EXPECT_EQ("", strings::toUpperCase("", tables));
+  EXPECT_EQ("", strings::toUpperCase("", loc));
+}
+
+
+TEST(LocaleTables, stringsOverloadsMatchLocaleOverloads) {
+  // Long runs, to cover the 32-byte block paths taken for standard ASCII.
+  const string padding(40, ' ');
+  const string text = padding + "_Mixed CASE text, long enough for blocks_"
+      + "\xC3\xA9" + padding;
+  for (const locale& loc : {locale::classic(), makeUnderscoreSpaceLocale()}) {
+    LocaleTables tables(loc);
+    EXPECT_EQ(strings::trimWhitespace(text, loc),
+              strings::trimWhitespace(text, tables));
+    EXPECT_EQ(strings::toLowerCase(text, loc),
+              strings::toLowerCase(text, tables));
+    EXPECT_EQ(strings::toUpperCase(text, loc),
+              strings::toUpperCase(text, tables));
+    EXPECT_TRUE(strings::isEmptyOrWhitespace(padding + padding, tables));
+    EXPECT_FALSE(strings::isEmptyOrWhitespace(text, tables));
+  }
+}
+
+
+}  // namespace
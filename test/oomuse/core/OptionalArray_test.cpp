@@ -0,0 +1,146 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/OptionalArray.h"
+
+#include <cstddef>
+
+#include "gtest/gtest.h"
+#include "oomuse/core/Optional.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::Optional;
+using oomuse::OptionalArray;
+
+namespace {
+
+
+TEST(OptionalArray, startsEmpty) {
+  OptionalArray<int32> optArray(100);
+  EXPECT_EQ(100, optArray.length());
+  EXPECT_EQ(0, optArray.countValid());
+  EXPECT_EQ(100, optArray.countNulls());
+  EXPECT_EQ(2, optArray.validityBitmapLength());
+
+  for (std::size_t i = 0; i < optArray.length(); ++i) {
+    EXPECT_FALSE(optArray.isValid(i));
+    EXPECT_FALSE(optArray.get(i).hasValue());
+  }
+}
+
+
+TEST(OptionalArray, setAndClear) {
+  OptionalArray<int32> optArray(130);
+  optArray.set(0, 5);
+  optArray.set(64, -3);
+  optArray.set(129, 12);
+
+  EXPECT_EQ(3, optArray.countValid());
+  EXPECT_EQ(Optional<int32>(5), optArray.get(0));
+  EXPECT_EQ(Optional<int32>(-3), optArray.get(64));
+  EXPECT_EQ(Optional<int32>(12), optArray.get(129));
+  EXPECT_FALSE(optArray.get(1).hasValue());
+  EXPECT_FALSE(optArray.get(63).hasValue());
+  EXPECT_FALSE(optArray.get(128).hasValue());
+
+  optArray.clear(64);
+  EXPECT_FALSE(optArray.isValid(64));
+  EXPECT_EQ(0, optArray.values()[64]);  // Missing positions hold T().
+  EXPECT_EQ(2, optArray.countValid());
+
+  optArray.set(1, Optional<int32>(8));
+  optArray.set(0, Optional<int32>());
+  EXPECT_FALSE(optArray.isValid(0));
+  EXPECT_EQ(Optional<int32>(8), optArray.get(1));
+  EXPECT_EQ(2, optArray.countValid());
+}
+
+
+TEST(OptionalArray, initializerList) {
+  OptionalArray<float> optArray = {1.5F, Optional<float>(), -2.0F};
+  ASSERT_EQ(3, optArray.length());
+  EXPECT_EQ(Optional<float>(1.5F), optArray.get(0));
+  EXPECT_FALSE(optArray.isValid(1));
+  EXPECT_EQ(Optional<float>(-2.0F), optArray.get(2));
+
+  // Values are stored contiguously, with validity tracked separately.
+  EXPECT_EQ(1.5F, optArray.values()[0]);
+  EXPECT_EQ(-2.0F, optArray.values()[2]);
+  EXPECT_EQ(5U, optArray.validityBitmap()[0]);
+}
+
+
+TEST(OptionalArray, sum) {
+  OptionalArray<int64> empty(0);
+  EXPECT_EQ(0, empty.sum());
+
+  OptionalArray<int64> optArray(200);
+  EXPECT_EQ(0, optArray.sum());
+
+  int64 expectedSum = 0;
+  for (std::size_t i = 0; i < 200; ++i) {
+    // Fill a full first block, then a sparse pattern afterward.
+    if ((i < 64) || (i % 3 == 0)) {
+      optArray.set(i, static_cast<int64>(i));
+      expectedSum += static_cast<int64>(i);
+    }
+  }
+  EXPECT_EQ(expectedSum, optArray.sum());
+}
+
+
+TEST(OptionalArray, minAndMax) {
+  OptionalArray<int32> optArray(150);
+  EXPECT_FALSE(optArray.min().hasValue());
+  EXPECT_FALSE(optArray.max().hasValue());
+
+  optArray.set(70, 4);
+  EXPECT_EQ(Optional<int32>(4), optArray.min());
+  EXPECT_EQ(Optional<int32>(4), optArray.max());
+
+  for (std::size_t i = 0; i < 64; ++i) {
+    optArray.set(i, 10 + static_cast<int32>(i));
+  }
+  optArray.set(149, -6);
+  optArray.set(148, 99);
+  EXPECT_EQ(Optional<int32>(-6), optArray.min());
+  EXPECT_EQ(Optional<int32>(99), optArray.max());
+
+  // Values at missing positions must be ignored.
+  optArray.clear(148);
+  EXPECT_EQ(Optional<int32>(73), optArray.max());
+}
+
+
+TEST(OptionalArray, fillNulls) {
+  OptionalArray<int32> optArray(70);
+  optArray.set(3, 9);
+  optArray.set(69, 1);
+
+  optArray.fillNulls(-1);
+  EXPECT_EQ(70, optArray.countValid());
+  EXPECT_EQ(0, optArray.countNulls());
+  EXPECT_EQ(Optional<int32>(9), optArray.get(3));
+  EXPECT_EQ(Optional<int32>(1), optArray.get(69));
+  EXPECT_EQ(Optional<int32>(-1), optArray.get(0));
+  EXPECT_EQ(Optional<int32>(-1), optArray.get(68));
+
+  // Unused bits in the last bitmap word stay clear.
+  EXPECT_EQ(0x3FU, optArray.validityBitmap()[1]);
+}
+
+
+}  // namespace
@@ -16,9 +16,19 @@
 
 #include "oomuse/core/Optional.h"
 
+#include <limits>
+#include <string>
+#include <utility>
+
 #include "gtest/gtest.h"
+#include "oomuse/core/int_types.h"
 
+using oomuse::CompactOptional;
 using oomuse::Optional;
+using oomuse::SentinelOptionalPolicy;
+using std::move;
+using std::numeric_limits;
+using std::string;
 
 namespace {
 
@@ -167,4 +177,184 @@ TEST(Optional, destructorCalls) {
 }
 
 
+TEST(Optional, compactSizes) {
+  EXPECT_EQ(sizeof(float), sizeof(CompactOptional<float>));
+  EXPECT_EQ(sizeof(double), sizeof(CompactOptional<double>));
+  EXPECT_EQ(sizeof(int*), sizeof(CompactOptional<int*>));
+  EXPECT_EQ(sizeof(int32),
+            sizeof(Optional<int32, SentinelOptionalPolicy<int32, -1>>));
+
+  // The default policy needs room for a separate flag.
+  EXPECT_LT(sizeof(float), sizeof(Optional<float>));
+}
+
+
+TEST(Optional, compactFloat) {
+  CompactOptional<float> optVal;
+  EXPECT_FALSE(optVal.hasValue());
+
+  optVal = 0.0F;
+  ASSERT_TRUE(optVal.hasValue());
+  EXPECT_EQ(0.0F, optVal.value());
+
+  optVal = -numeric_limits<float>::infinity();
+  ASSERT_TRUE(optVal.hasValue());
+  EXPECT_EQ(-numeric_limits<float>::infinity(), optVal.value());
+
+  optVal.clear();
+  EXPECT_FALSE(optVal.hasValue());
+
+  CompactOptional<double> optDouble(2.5);
+  ASSERT_TRUE(optDouble.hasValue());
+  EXPECT_EQ(2.5, optDouble.value());
+}
+
+
+TEST(Optional, compactPointer) {
+  int target = 5;
+
+  CompactOptional<int*> optPtr;
+  EXPECT_FALSE(optPtr.hasValue());
+
+  optPtr = &target;
+  ASSERT_TRUE(optPtr.hasValue());
+  EXPECT_EQ(&target, optPtr.value());
+
+  optPtr.clear();
+  EXPECT_FALSE(optPtr.hasValue());
+}
+
+
+TEST(Optional, compactSentinel) {
+  using OptIndex = Optional<int32, SentinelOptionalPolicy<int32, -1>>;
+
+  OptIndex optIndex;
+  EXPECT_FALSE(optIndex.hasValue());
+
+  optIndex = 0;
+  ASSERT_TRUE(optIndex.hasValue());
+  EXPECT_EQ(0, optIndex.value());
+
+  optIndex = numeric_limits<int32>::max();
+  ASSERT_TRUE(optIndex.hasValue());
+  EXPECT_EQ(numeric_limits<int32>::max(), optIndex.value());
+
+  optIndex.clear();
+  EXPECT_FALSE(optIndex.hasValue());
+}
+
+
+TEST(Optional, compactEqualsAcrossPolicies) {
+  Optional<float> flagVal = 1.5F;
+  CompactOptional<float> compactVal = 1.5F;
+  EXPECT_TRUE(flagVal == compactVal);
+  EXPECT_TRUE(compactVal == flagVal);
+
+  compactVal.clear();
+  EXPECT_FALSE(flagVal == compactVal);
+  EXPECT_TRUE(compactVal < flagVal);
+
+  flagVal.clear();
+  EXPECT_TRUE(flagVal == compactVal);
+}
+
+
+TEST(Optional, copyAndMove) {
+  numInstances = 0;
+
+  /* Open scope */ {
+    Optional<InstanceCounter> optObj = InstanceCounter();
+    EXPECT_EQ(1, numInstances);
+
+    Optional<InstanceCounter> copiedObj(optObj);
+    EXPECT_EQ(2, numInstances);
+
+    Optional<InstanceCounter> emptyObj;
+    copiedObj = emptyObj;
+    EXPECT_FALSE(copiedObj.hasValue());
+    EXPECT_EQ(1, numInstances);
+  }
+
+  EXPECT_EQ(0, numInstances);
+
+  Optional<string> optStr = string("moved");
+  Optional<string> movedStr(move(optStr));
+  ASSERT_TRUE(movedStr.hasValue());
+  EXPECT_EQ("moved", movedStr.value());
+
+  Optional<string> assignedStr;
+  assignedStr = movedStr;
+  ASSERT_TRUE(assignedStr.hasValue());
+  EXPECT_EQ("moved", assignedStr.value());
+}
+
+
+struct alignas(32) Aligned32 {
+  float lanes[8];
+};
+
+static_assert(alignof(Optional<double>) == alignof(double),
+              "Optional<double> should be aligned like double");
+static_assert(alignof(Optional<int64>) == alignof(int64),
+              "Optional<int64> should be aligned like int64");
+static_assert(alignof(Optional<Aligned32>) == 32,
+              "Optional should respect over-aligned value types");
+static_assert(alignof(CompactOptional<double>) == alignof(double),
+              "CompactOptional<double> should be aligned like double");
+
+
+TEST(Optional, alignment) {
+  Optional<Aligned32> optVals[3];
+  for (auto& optVal : optVals) {
+    optVal = Aligned32();
+    uintptr_t address = reinterpret_cast<uintptr_t>(&optVal.value());
+    EXPECT_EQ(0U, address % 32);
+  }
+
+  Optional<double> optDouble = 1.0;
+  EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(&optDouble.value())
+                    % alignof(double));
+}
+
+
+/** Compile-time table of integer square roots (empty if not a square). */
+struct IntegerSqrtTable {
+  Optional<int32> roots[50];
+};
+
+constexpr IntegerSqrtTable makeIntegerSqrtTable() {
+  IntegerSqrtTable table{};
+  for (int32 root = 0; root * root < 50; ++root) {
+    table.roots[root * root] = Optional<int32>(root);
+  }
+  return table;
+}
+
+constexpr IntegerSqrtTable kIntegerSqrts = makeIntegerSqrtTable();
+
+static_assert(kIntegerSqrts.roots[0].value() == 0, "sqrt(0) == 0");
+static_assert(kIntegerSqrts.roots[1].value() == 1, "sqrt(1) == 1");
+static_assert(!kIntegerSqrts.roots[2].hasValue(), "2 isn't a square");
+static_assert(kIntegerSqrts.roots[49].value() == 7, "sqrt(49) == 7");
+
+constexpr CompactOptional<float> kCompactTable[] = {
+  0.5F, CompactOptional<float>(), 2.0F
+};
+
+static_assert(kCompactTable[0].value() == 0.5F, "constexpr compact value");
+static_assert(!kCompactTable[1].hasValue(), "constexpr compact empty");
+
+
+TEST(Optional, constexprTables) {
+  int32 numSquares = 0;
+  for (const auto& root : kIntegerSqrts.roots) {
+    if (root.hasValue()) {
+      ++numSquares;
+    }
+  }
+  EXPECT_EQ(8, numSquares);
+  EXPECT_EQ(2.0F, kCompactTable[2].value());
+}
+
+
 }  // namespace
@@ -0,0 +1,181 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/PrefixMatcher.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "oomuse/core/strings.h"
+
+using oomuse::PrefixMatcher;
+using oomuse::SuffixMatcher;
+using std::size_t;
+using std::string;
+using std::vector;
+
+namespace strings = oomuse::strings;
+
+namespace {
+
+
+TEST(PrefixMatcher, longestMatch) {
+  PrefixMatcher routes({"/synth/", "/synth/osc/", "/mixer/"});
+  EXPECT_EQ(3u, routes.numPatterns());
+  EXPECT_EQ("/synth/osc/", routes.pattern(1));
+
+  EXPECT_EQ(1u, routes.longestMatch("/synth/osc/1/freq").value());
+  EXPECT_EQ(0u, routes.longestMatch("/synth/filter/cutoff").value());
+  EXPECT_EQ(0u, routes.longestMatch("/synth/").value());
+  EXPECT_EQ(2u, routes.longestMatch("/mixer/gain").value());
+  EXPECT_FALSE(routes.longestMatch("/synth").hasValue());
+  EXPECT_FALSE(routes.longestMatch("/mix/").hasValue());
+  EXPECT_FALSE(routes.longestMatch("").hasValue());
+}
+
+
+TEST(PrefixMatcher, matchesAny) {
+  PrefixMatcher matcher({"ab", "abcd", "x"});
+  EXPECT_TRUE(matcher.matchesAny("abc"));
+  EXPECT_TRUE(matcher.matchesAny("abcde"));
+  EXPECT_TRUE(matcher.matchesAny("x"));
+  EXPECT_FALSE(matcher.matchesAny("a"));
+  EXPECT_FALSE(matcher.matchesAny("bab"));
+  EXPECT_FALSE(matcher.matchesAny(""));
+}
+
+
+TEST(PrefixMatcher, allMatches) {
+  PrefixMatcher matcher({"abcd", "a", "abc", "b", "ab"});
+  EXPECT_EQ((vector<size_t>{1, 4, 2, 0}), matcher.allMatches("abcde"));
+  EXPECT_EQ((vector<size_t>{1, 4}), matcher.allMatches("abx"));
+  EXPECT_EQ((vector<size_t>{3}), matcher.allMatches("b"));
+  EXPECT_TRUE(matcher.allMatches("c").empty());
+}
+
+
+TEST(PrefixMatcher, emptyPatternMatchesEverything) {
+  PrefixMatcher matcher({"", "a"});
+  EXPECT_EQ(0u, matcher.longestMatch("").value());
+  EXPECT_EQ(0u, matcher.longestMatch("b").value());
+  EXPECT_EQ(1u, matcher.longestMatch("ab").value());
+  EXPECT_TRUE(matcher.matchesAny("zzz"));
+}
+
+
+TEST(PrefixMatcher, noPatterns) {
+  PrefixMatcher matcher(vector<string>{});
+  EXPECT_EQ(0u, matcher.numPatterns());
+  EXPECT_FALSE(matcher.matchesAny("a"));
+  EXPECT_FALSE(matcher.longestMatch("").hasValue());
+  EXPECT_TRUE(matcher.allMatches("a").empty());
+}
+
+
+TEST(PrefixMatcher, duplicatePatternsReportLowestIndex) {
+  PrefixMatcher matcher({"b", "ab", "b", "ab"});
+  EXPECT_EQ(4u, matcher.numPatterns());
+  EXPECT_EQ(1u, matcher.longestMatch("abc").value());
+  EXPECT_EQ((vector<size_t>{0}), matcher.allMatches("bb"));
+}
+
+
+TEST(PrefixMatcher, allByteValues) {
+  vector<string> patterns;
+  for (int c = 0; c < 256; ++c) {
+    patterns.push_back(string(1, static_cast<char>(c)) + "\xff");
+  }
+  PrefixMatcher matcher(patterns);
+  for (int c = 0; c < 256; ++c) {
+    const string str = patterns[c] + "rest";
+    EXPECT_EQ(static_cast<size_t>(c), matcher.longestMatch(str).value());
+    EXPECT_FALSE(matcher.matchesAny(string(1, static_cast<char>(c))));
+  }
+}
+
+
+TEST(PrefixMatcher, agreesWithStartsWith) {
+  std::mt19937 random(12345);
+  auto randomString = [&random](size_t maxLength) {
+    std::uniform_int_distribution<size_t> length(0, maxLength);
+    std::uniform_int_distribution<int> letter('a', 'd');
+    string str(length(random), ' ');
+    for (char& c : str) {
+      c = static_cast<char>(letter(random));
+    }
+    return str;
+  };
+
+  vector<string> patterns;
+  for (int i = 0; i < 300; ++i) {
+    patterns.push_back(randomString(6));
+  }
+  PrefixMatcher matcher(patterns);
+
+  for (int i = 0; i < 2000; ++i) {
+    const string str = randomString(10);
+    vector<size_t> expected;
+    for (size_t p = 0; p < patterns.size(); ++p) {
+      bool isDuplicate = false;
+      for (size_t q = 0; q < p; ++q) {
+        isDuplicate = isDuplicate || (patterns[q] == patterns[p]);
+      }
+      if (!isDuplicate && strings::startsWith(str, patterns[p])) {
+        expected.push_back(p);
+      }
+    }
+    std::sort(expected.begin(), expected.end(),
+              [&patterns](size_t a, size_t b) {
+                return patterns[a].size() < patterns[b].size();
+              });
+
+    ASSERT_EQ(expected, matcher.allMatches(str)) << str;
+    ASSERT_EQ(!expected.empty(), matcher.matchesAny(str)) << str;
+    if (!expected.empty()) {
+      ASSERT_EQ(expected.back(), matcher.longestMatch(str).value()) << str;
+    }
+  }
+}
+
+
+TEST(SuffixMatcher, longestMatch) {
+  SuffixMatcher extensions({".wav", ".tar.gz", ".gz"});
+  EXPECT_EQ(3u, extensions.numPatterns());
+  EXPECT_EQ(".gz", extensions.pattern(2));
+
+  EXPECT_EQ(0u, extensions.longestMatch("kick.wav").value());
+  EXPECT_EQ(1u, extensions.longestMatch("samples.tar.gz").value());
+  EXPECT_EQ(2u, extensions.longestMatch("samples.gz").value());
+  EXPECT_FALSE(extensions.longestMatch("kick.wave").hasValue());
+  EXPECT_FALSE(extensions.longestMatch("").hasValue());
+}
+
+
+TEST(SuffixMatcher, matchesAnyAndAllMatches) {
+  SuffixMatcher matcher({"example.com", "com", ".example.com"});
+  EXPECT_TRUE(matcher.matchesAny("www.example.com"));
+  EXPECT_FALSE(matcher.matchesAny("example.org"));
+  EXPECT_EQ((vector<size_t>{1, 0, 2}),
+            matcher.allMatches("www.example.com"));
+  EXPECT_EQ((vector<size_t>{1, 0}), matcher.allMatches("example.com"));
+}
+
+
+}  // namespace
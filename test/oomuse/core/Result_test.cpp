@@ -0,0 +1,233 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/Result.h"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::Error;
+using oomuse::Result;
+using std::is_trivially_copyable;
+using std::make_unique;
+using std::move;
+using std::string;
+using std::to_string;
+using std::unique_ptr;
+
+namespace {
+
+
+const uint32 OUT_OF_RANGE = 1;
+const uint32 NOT_A_DIGIT = 2;
+
+int numFormatCalls;
+
+string formatOutOfRange(const Error& error) {
+  ++numFormatCalls;
+  return string(error.description()) + ": " + to_string(error.context());
+}
+
+Result<int32> checkMidiRange(int32 value) {
+  if ((value < 0) || (value > 127)) {
+    return Result<int32>::failure(
+        Error(OUT_OF_RANGE, "Out of MIDI range", &formatOutOfRange, value));
+  }
+  return Result<int32>::success(value);
+}
+
+Result<int32> parseDigit(char c) {
+  if ((c < '0') || (c > '9')) {
+    return Result<int32>::failure(Error(NOT_A_DIGIT, "Not a digit"));
+  }
+  return Result<int32>::success(c - '0');
+}
+
+
+static_assert(is_trivially_copyable<Error>::value,
+              "Error should be trivially copyable");
+static_assert(is_trivially_copyable<Result<int32>>::value,
+              "Result of trivial types should be trivially copyable");
+static_assert(is_trivially_copyable<Result<double, uint8>>::value,
+              "Result of trivial types should be trivially copyable");
+static_assert(!is_trivially_copyable<Result<string>>::value,
+              "Result of non-trivial types can't be trivially copyable");
+
+constexpr Result<int32, uint8> kConstexprResult =
+    Result<int32, uint8>::success(7);
+static_assert(kConstexprResult.isOk() && (kConstexprResult.value() == 7),
+              "Result should be usable in constexpr contexts");
+
+
+TEST(Result, successAndFailure) {
+  Result<int32> ok = checkMidiRange(60);
+  ASSERT_TRUE(ok.isOk());
+  EXPECT_FALSE(ok.hasError());
+  EXPECT_EQ(60, ok.value());
+
+  Result<int32> failed = checkMidiRange(128);
+  ASSERT_TRUE(failed.hasError());
+  EXPECT_FALSE(failed.isOk());
+  EXPECT_EQ(OUT_OF_RANGE, failed.error().code());
+  EXPECT_STREQ("Out of MIDI range", failed.error().description());
+  EXPECT_EQ(128, failed.error().context());
+}
+
+
+TEST(Result, lazyMessageFormatting) {
+  numFormatCalls = 0;
+
+  Result<int32> failed = checkMidiRange(-1);
+  Result<int32> copied = failed;
+  EXPECT_EQ(OUT_OF_RANGE, copied.error().code());
+  EXPECT_EQ(0, numFormatCalls);  // Nothing formatted until asked.
+
+  EXPECT_EQ("Out of MIDI range: -1", copied.error().message());
+  EXPECT_EQ(1, numFormatCalls);
+
+  // Errors without a format function just use the static description.
+  EXPECT_EQ("Not a digit", parseDigit('x').error().message());
+}
+
+
+TEST(Result, valueOrAndToOptional) {
+  EXPECT_EQ(5, parseDigit('5').valueOr(-1));
+  EXPECT_EQ(-1, parseDigit('?').valueOr(-1));
+
+  EXPECT_EQ(5, parseDigit('5').toOptional().value());
+  EXPECT_FALSE(parseDigit('?').toOptional().hasValue());
+}
+
+
+TEST(Result, map) {
+  auto timesTwenty = [](int32 value) { return value * 20; };
+  Result<int32> mapped = parseDigit('6').map(timesTwenty);
+  ASSERT_TRUE(mapped.isOk());
+  EXPECT_EQ(120, mapped.value());
+
+  Result<string> asString =
+      parseDigit('3').map([](int32 value) { return to_string(value); });
+  ASSERT_TRUE(asString.isOk());
+  EXPECT_EQ("3", asString.value());
+
+  Result<int32> failed = parseDigit('z').map(timesTwenty);
+  ASSERT_TRUE(failed.hasError());
+  EXPECT_EQ(NOT_A_DIGIT, failed.error().code());
+}
+
+
+TEST(Result, andThen) {
+  auto toNote = [](int32 digit) { return checkMidiRange(digit * 20); };
+
+  Result<int32> note = parseDigit('6').andThen(toNote);
+  ASSERT_TRUE(note.isOk());
+  EXPECT_EQ(120, note.value());
+
+  // Second step fails.
+  Result<int32> tooHigh = parseDigit('7').andThen(toNote);
+  ASSERT_TRUE(tooHigh.hasError());
+  EXPECT_EQ(OUT_OF_RANGE, tooHigh.error().code());
+
+  // First step fails, second step is skipped.
+  Result<int32> notDigit = parseDigit('-').andThen(toNote);
+  ASSERT_TRUE(notDigit.hasError());
+  EXPECT_EQ(NOT_A_DIGIT, notDigit.error().code());
+}
+
+
+TEST(Result, mapError) {
+  auto toCode = [](const Error& error) { return error.code(); };
+
+  Result<int32, uint32> failed = parseDigit('a').mapError(toCode);
+  ASSERT_TRUE(failed.hasError());
+  EXPECT_EQ(NOT_A_DIGIT, failed.error());
+
+  Result<int32, uint32> ok = parseDigit('4').mapError(toCode);
+  ASSERT_TRUE(ok.isOk());
+  EXPECT_EQ(4, ok.value());
+}
+
+
+TEST(Result, moveOnlyValues) {
+  using UniqueResult = Result<unique_ptr<int32>>;
+
+  UniqueResult ok = UniqueResult::success(make_unique<int32>(9));
+  UniqueResult moved = move(ok);
+  ASSERT_TRUE(moved.isOk());
+  EXPECT_EQ(9, *moved.value());
+
+  unique_ptr<int32> taken = move(moved).value();
+  EXPECT_EQ(9, *taken);
+
+  UniqueResult failed = UniqueResult::failure(Error(3, "No pointer"));
+  failed = UniqueResult::success(make_unique<int32>(1));
+  ASSERT_TRUE(failed.isOk());
+  EXPECT_EQ(1, *failed.value());
+}
+
+
+TEST(Result, nonTrivialCopies) {
+  Result<string> ok = Result<string>::success("value");
+  Result<string> copied = ok;
+  ASSERT_TRUE(copied.isOk());
+  EXPECT_EQ("value", copied.value());
+  EXPECT_EQ("value", ok.value());
+
+  copied = Result<string>::failure(Error(4, "Bad string"));
+  ASSERT_TRUE(copied.hasError());
+  EXPECT_EQ(4U, copied.error().code());
+
+  ok = Result<string>::success("other");
+  copied = ok;
+  ASSERT_TRUE(copied.isOk());
+  EXPECT_EQ("other", copied.value());
+}
+
+
+/** Value whose copies throw (if asked to), but whose moves never do. */
+struct ThrowingCopy {
+  explicit ThrowingCopy(bool shouldThrow) : throwOnCopy(shouldThrow) {}
+  ThrowingCopy(const ThrowingCopy& other) : throwOnCopy(other.throwOnCopy) {
+    if (throwOnCopy) {
+      throw std::runtime_error("copy failed");
+    }
+  }
+  ThrowingCopy(ThrowingCopy&& other) noexcept = default;
+  ThrowingCopy& operator=(const ThrowingCopy& other) = default;
+  ThrowingCopy& operator=(ThrowingCopy&& other) noexcept = default;
+
+  bool throwOnCopy;
+};
+
+
+TEST(Result, throwingCopyLeavesTargetUnchanged) {
+  using ThrowingResult = Result<ThrowingCopy>;
+  const ThrowingResult ok = ThrowingResult::success(ThrowingCopy(true));
+  ThrowingResult failed = ThrowingResult::failure(Error(5, "Unchanged"));
+
+  EXPECT_THROW(failed = ok, std::runtime_error);
+  ASSERT_TRUE(failed.hasError());
+  EXPECT_EQ(5U, failed.error().code());
+}
+
+
+}  // namespace
@@ -0,0 +1,124 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/StringArena.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "oomuse/core/StringRef.h"
+
+using oomuse::StringArena;
+using oomuse::StringRef;
+using std::string;
+
+namespace {
+
+
+TEST(StringArena, startsEmpty) {
+  StringArena arena;
+  EXPECT_EQ(0u, arena.numBlocks());
+  EXPECT_EQ(0u, arena.numBytesUsed());
+}
+
+
+TEST(StringArena, copy) {
+  StringArena arena;
+  string original = "temporary";
+  StringRef copy = arena.copy(original);
+  original.assign("overwritten");
+
+  EXPECT_EQ("temporary", copy);
+  EXPECT_EQ(9u, arena.numBytesUsed());
+  EXPECT_EQ(1u, arena.numBlocks());
+
+  StringRef empty = arena.copy("");
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(9u, arena.numBytesUsed());
+}
+
+
+TEST(StringArena, allocateIsContiguousWithinBlock) {
+  StringArena arena(64);
+  char* first = arena.allocate(5);
+  char* second = arena.allocate(7);
+  EXPECT_EQ(first + 5, second);
+  EXPECT_EQ(1u, arena.numBlocks());
+}
+
+
+TEST(StringArena, startsNewBlockWhenFull) {
+  StringArena arena(64);
+  std::vector<StringRef> copies;
+  for (int i = 0; i < 20; ++i) {
+    copies.push_back(arena.copy(std::to_string(1000000 + i)));
+  }
+
+  // 20 * 7 chars, at most 9 strings per 64-char block.
+  EXPECT_EQ(140u, arena.numBytesUsed());
+  EXPECT_EQ(3u, arena.numBlocks());
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_EQ(std::to_string(1000000 + i), copies[i]);
+  }
+}
+
+
+TEST(StringArena, largeStringsGetOwnBlocks) {
+  StringArena arena(64);
+  char* small1 = arena.allocate(4);
+  string large(100, 'x');
+  StringRef largeCopy = arena.copy(large);
+  char* small2 = arena.allocate(4);
+
+  EXPECT_EQ(large, largeCopy);
+  EXPECT_EQ(small1 + 4, small2);  // Current block was kept.
+  EXPECT_EQ(2u, arena.numBlocks());
+  EXPECT_EQ(108u, arena.numBytesUsed());
+}
+
+
+TEST(StringArena, clearReusesStandardBlocks) {
+  StringArena arena(64);
+  char* first = arena.allocate(1);
+  for (int i = 0; i < 20; ++i) {
+    arena.copy("0123456789");
+  }
+  arena.copy(string(100, 'x'));
+  EXPECT_EQ(5u, arena.numBlocks());
+
+  arena.clear();
+  EXPECT_EQ(4u, arena.numBlocks());  // Large block was freed.
+  EXPECT_EQ(0u, arena.numBytesUsed());
+
+  EXPECT_EQ(first, arena.allocate(1));
+  for (int i = 0; i < 20; ++i) {
+    arena.copy("0123456789");
+  }
+  EXPECT_EQ(4u, arena.numBlocks());
+  EXPECT_EQ("reused", arena.copy("reused"));
+}
+
+
+TEST(StringArena, clearWhenEmpty) {
+  StringArena arena;
+  arena.clear();
+  EXPECT_EQ(0u, arena.numBlocks());
+  EXPECT_EQ("ok", arena.copy("ok"));
+}
+
+
+}  // namespace
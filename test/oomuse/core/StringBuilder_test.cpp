@@ -0,0 +1,179 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/StringBuilder.h"
+
+#include <cstddef>
+#include <limits>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "oomuse/core/StringRef.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::StringBuilder;
+using oomuse::StringRef;
+using std::string;
+
+namespace {
+
+
+TEST(StringBuilder, startsEmpty) {
+  StringBuilder builder;
+  EXPECT_TRUE(builder.empty());
+  EXPECT_EQ(0u, builder.length());
+  EXPECT_EQ(StringBuilder::INLINE_CAPACITY, builder.capacity());
+  EXPECT_EQ("", builder.toString());
+}
+
+
+TEST(StringBuilder, appendStrings) {
+  const string str = "string";
+  StringBuilder builder;
+  builder.append("literal ").append(str).append(' ')
+      .append(StringRef("view", 2)).append(3, '!').append("");
+
+  EXPECT_EQ("literal string vi!!!", builder.toString());
+  EXPECT_EQ("literal string vi!!!", builder.toStringRef());
+  EXPECT_EQ(20u, builder.length());
+  EXPECT_FALSE(builder.empty());
+}
+
+
+TEST(StringBuilder, appendNumbers) {
+  StringBuilder builder;
+  builder.append(static_cast<int8>(-128)).append(' ')
+      .append(static_cast<uint8>(255)).append(' ')
+      .append(static_cast<int16>(-7)).append(' ')
+      .append(static_cast<uint16>(7)).append(' ')
+      .append(-42).append(' ')
+      .append(42u).append(' ')
+      .append(std::numeric_limits<int64>::min()).append(' ')
+      .append(std::numeric_limits<uint64>::max()).append(' ')
+      .append(0.1f).append(' ')
+      .append(-2.5);
+
+  EXPECT_EQ("-128 255 -7 7 -42 42 -9223372036854775808 18446744073709551615 "
+                "0.1 -2.5",
+            builder.toString());
+}
+
+
+TEST(StringBuilder, appendAnyIntegerType) {
+  // long long, unsigned long long, and std::size_t may not be the same types
+  // as int64 & uint64 (e.g. int64 is long on 64-bit Linux).
+  StringBuilder builder;
+  builder.append(-1LL).append(' ')
+      .append(std::numeric_limits<long long>::min()).append(' ')
+      .append(std::numeric_limits<unsigned long long>::max()).append(' ')
+      .append(std::size_t(12)).append(' ')
+      .append(-3L).append(' ')
+      .append(4UL);
+
+  EXPECT_EQ("-1 -9223372036854775808 18446744073709551615 12 -3 4",
+            builder.toString());
+}
+
+
+TEST(StringBuilder, appendValue) {
+  StringBuilder builder;
+  builder.appendValue(static_cast<uint8>(200)).append(' ')
+      .appendValue(std::size_t(12)).append(' ')
+      .appendValue(0.25f).append(' ')
+      .appendValue(0.1f).append(' ')
+      .appendValue(0.1).append(' ')
+      .appendValue('c').append(' ')
+      .appendValue(string("text"));
+  EXPECT_EQ("200 12 0.25 0.1 0.1 c text", builder.toString());
+}
+
+
+TEST(StringBuilder, growsPastInlineCapacity) {
+  StringBuilder builder;
+  string expected;
+  for (int i = 0; i < 1000; ++i) {
+    builder.append(i).append(',');
+    expected += std::to_string(i) + ",";
+  }
+
+  EXPECT_EQ(expected, builder.toString());
+  EXPECT_GE(builder.capacity(), expected.length());
+  // Doubling from the inline capacity.
+  EXPECT_EQ(StringBuilder::INLINE_CAPACITY * 16, builder.capacity());
+}
+
+
+TEST(StringBuilder, growsToFitLongAppend) {
+  StringBuilder builder;
+  builder.append('x');
+  const string longStr(10 * StringBuilder::INLINE_CAPACITY, 'y');
+  builder.append(longStr);
+
+  EXPECT_EQ("x" + longStr, builder.toString());
+  EXPECT_EQ(longStr.length() + 1, builder.capacity());
+}
+
+
+TEST(StringBuilder, appendOwnChars) {
+  // Doubling each time crosses from inline to heap, then heap to heap.
+  StringBuilder builder;
+  string expected = "abc";
+  builder.append(expected);
+  while (expected.length() < 4 * StringBuilder::INLINE_CAPACITY) {
+    builder.append(builder.toStringRef());
+    expected += expected;
+    ASSERT_EQ(expected, builder.toString());
+  }
+
+  builder.append(builder.toStringRef().substr(1, 2));
+  EXPECT_EQ(expected + "bc", builder.toString());
+}
+
+
+TEST(StringBuilder, reserve) {
+  StringBuilder builder;
+  builder.append("kept");
+  builder.reserve(1000);
+  EXPECT_EQ(1000u, builder.capacity());
+  EXPECT_EQ("kept", builder.toString());
+
+  const char* data = builder.data();
+  builder.append(string(996, 'z'));
+  EXPECT_EQ(data, builder.data());  // No reallocation.
+
+  builder.reserve(10);  // Never shrinks.
+  EXPECT_EQ(1000u, builder.capacity());
+}
+
+
+TEST(StringBuilder, resetKeepsBuffer) {
+  StringBuilder builder;
+  builder.append(string(1000, 'a'));
+  const std::size_t capacity = builder.capacity();
+  const char* data = builder.data();
+
+  builder.reset();
+  EXPECT_TRUE(builder.empty());
+  EXPECT_EQ("", builder.toString());
+
+  builder.append("reused");
+  EXPECT_EQ("reused", builder.toString());
+  EXPECT_EQ(capacity, builder.capacity());
+  EXPECT_EQ(data, builder.data());
+}
+
+
+}  // namespace
@@ -0,0 +1,120 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/StringRef.h"
+
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+using oomuse::StringRef;
+using std::string;
+
+namespace {
+
+
+constexpr StringRef kEmpty;
+static_assert(kEmpty.empty(), "Default StringRef should be empty");
+static_assert(StringRef("abc", 3).substr(1).length() == 2,
+              "substr() should work at compile time");
+
+
+TEST(StringRef, construction) {
+  EXPECT_TRUE(StringRef().empty());
+  EXPECT_EQ(0u, StringRef().length());
+
+  StringRef literal("hello");
+  EXPECT_EQ(5u, literal.length());
+  EXPECT_EQ(5u, literal.size());
+  EXPECT_EQ('h', literal[0]);
+  EXPECT_EQ('o', literal[4]);
+
+  string str = "world";
+  StringRef fromString(str);
+  EXPECT_EQ(str.data(), fromString.data());
+  EXPECT_EQ(5u, fromString.length());
+
+  const char buffer[] = {'a', 'b', 'c'};  // Not null-terminated.
+  StringRef fromBuffer(buffer, 2);
+  EXPECT_EQ(buffer, fromBuffer.data());
+  EXPECT_EQ("ab", fromBuffer);
+}
+
+
+TEST(StringRef, substr) {
+  StringRef str("key=value");
+  EXPECT_EQ("key", str.substr(0, 3));
+  EXPECT_EQ("value", str.substr(4));
+  EXPECT_EQ("value", str.substr(4, 100));
+  EXPECT_TRUE(str.substr(9).empty());
+  EXPECT_EQ(str.data() + 4, str.substr(4).data());
+}
+
+
+TEST(StringRef, removePrefixAndSuffix) {
+  StringRef str("[section]");
+  str.removePrefix(1);
+  EXPECT_EQ("section]", str);
+  str.removeSuffix(1);
+  EXPECT_EQ("section", str);
+  str.removePrefix(7);
+  EXPECT_TRUE(str.empty());
+}
+
+
+TEST(StringRef, find) {
+  StringRef str("a=b=c");
+  EXPECT_EQ(1u, str.find('='));
+  EXPECT_EQ(3u, str.find('=', 2));
+  EXPECT_EQ(StringRef::npos, str.find('=', 4));
+  EXPECT_EQ(StringRef::npos, str.find('x'));
+  EXPECT_EQ(StringRef::npos, str.find('a', 5));
+  EXPECT_EQ(StringRef::npos, StringRef().find('a'));
+}
+
+
+TEST(StringRef, comparisons) {
+  EXPECT_TRUE(StringRef("abc") == StringRef("abc"));
+  EXPECT_TRUE(StringRef("abc") == string("abc"));
+  EXPECT_TRUE(StringRef("abc", 2) == "ab");
+  EXPECT_TRUE(StringRef("abc") != "abd");
+  EXPECT_TRUE(StringRef("abc") != "ab");
+  EXPECT_TRUE(StringRef() == "");
+
+  EXPECT_TRUE(StringRef("ab") < StringRef("abc"));
+  EXPECT_TRUE(StringRef("abc") < StringRef("abd"));
+  EXPECT_FALSE(StringRef("abc") < StringRef("abc"));
+  EXPECT_TRUE(StringRef("a") < StringRef("\xC3\xA9"));  // Unsigned chars.
+
+  EXPECT_EQ(0, StringRef("abc").compare("abc"));
+  EXPECT_GT(0, StringRef("ab").compare("abc"));
+  EXPECT_LT(0, StringRef("b").compare("abc"));
+}
+
+
+TEST(StringRef, toString) {
+  StringRef str("key=value");
+  EXPECT_EQ(string("value"), str.substr(4).toString());
+  EXPECT_EQ(string("key"), static_cast<string>(str.substr(0, 3)));
+
+  std::stringstream out;
+  out << "[" << str.substr(0, 3) << "]";
+  EXPECT_EQ("[key]", out.str());
+}
+
+
+}  // namespace
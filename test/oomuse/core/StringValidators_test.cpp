@@ -0,0 +1,141 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/StringValidators.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "oomuse/core/CharacterSet.h"
+#include "oomuse/core/Validator.h"
+#include "oomuse/core/Validators.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::CharacterSet;
+using oomuse::StringValidators;
+using oomuse::ValidationErrorCode;
+using oomuse::Validators;
+using std::string;
+
+namespace {
+
+
+TEST(StringValidators, asciiOnly) {
+  auto isAscii = StringValidators::asciiOnly();
+  EXPECT_EQ("", isAscii->checkValidationErrors("hello"));
+  EXPECT_EQ("Must contain only ASCII characters.",
+            isAscii->checkValidationErrors("caf\xC3\xA9"));
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_ASCII,
+            isAscii->checkValidationErrorCode("caf\xC3\xA9"));
+}
+
+
+TEST(StringValidators, noControlCharacters) {
+  auto hasNoControls = StringValidators::noControlCharacters();
+  EXPECT_TRUE(hasNoControls->isValid("a normal name"));
+  EXPECT_FALSE(hasNoControls->isValid("a\tname"));
+  EXPECT_EQ("Must not contain control characters.",
+            hasNoControls->checkValidationErrors("bell\a"));
+  EXPECT_EQ(ValidationErrorCode::MUST_NOT_HAVE_CONTROL_CHARACTERS,
+            hasNoControls->checkValidationErrorCode("bell\a"));
+}
+
+
+TEST(StringValidators, validUtf8) {
+  auto isUtf8 = StringValidators::validUtf8();
+  EXPECT_TRUE(isUtf8->isValid("caf\xC3\xA9"));
+  EXPECT_FALSE(isUtf8->isValid("caf\xE9"));  // Latin-1, not UTF-8.
+  EXPECT_EQ("Must be valid UTF-8.", isUtf8->checkValidationErrors("\xC0"));
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_VALID_UTF8,
+            isUtf8->checkValidationErrorCode("\xC0"));
+}
+
+
+TEST(StringValidators, charactersIn) {
+  auto isIdentifier = StringValidators::charactersIn(
+      CharacterSet::range('a', 'z') | CharacterSet("_"));
+  EXPECT_TRUE(isIdentifier->isValid("snake_case"));
+  EXPECT_FALSE(isIdentifier->isValid("camelCase"));
+  EXPECT_EQ("Must contain only allowed characters.",
+            isIdentifier->checkValidationErrors("no spaces"));
+  EXPECT_EQ(ValidationErrorCode::MUST_HAVE_ALLOWED_CHARACTERS,
+            isIdentifier->checkValidationErrorCode("no spaces"));
+}
+
+
+TEST(StringValidators, maxCodePoints) {
+  auto isShort = StringValidators::maxCodePoints(4);
+  EXPECT_TRUE(isShort->isValid(""));
+  EXPECT_TRUE(isShort->isValid("abcd"));
+  EXPECT_TRUE(isShort->isValid("caf\xC3\xA9"));  // 5 bytes, 4 code points.
+  EXPECT_TRUE(isShort->isValid("\xF0\x9D\x84\x9E\xF0\x9D\x84\x9E"));
+  EXPECT_FALSE(isShort->isValid("abcde"));
+  EXPECT_FALSE(isShort->isValid("caf\xC3\xA9s"));
+  EXPECT_EQ("Length must be less than or equal to 4 characters (code points).",
+            isShort->checkValidationErrors("abcde"));
+  EXPECT_EQ(ValidationErrorCode::CODE_POINTS_MUST_BE_LESS_OR_EQUAL,
+            isShort->checkValidationErrorCode("abcde"));
+}
+
+
+TEST(StringValidators, combinedWithValidators) {
+  auto isTag = Validators<string>::allOf(
+      Validators<string>::sizeGreaterOrEqual(1),
+      StringValidators::validUtf8(),
+      StringValidators::noControlCharacters(),
+      StringValidators::maxCodePoints(8));
+  EXPECT_TRUE(isTag->isValid("m\xC3\xBAsica"));
+  EXPECT_FALSE(isTag->isValid(""));
+  EXPECT_FALSE(isTag->isValid("tab\t"));
+  EXPECT_FALSE(isTag->isValid("much too long"));
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_VALID_UTF8,
+            isTag->checkValidationErrorCode("\xFF"));
+}
+
+
+TEST(StringValidators, parsesAs) {
+  auto isMidiNote = StringValidators::parsesAs<int32>(
+      Validators<int32>::allOf(Validators<int32>::greaterOrEqual(0),
+                               Validators<int32>::lessOrEqual(127)));
+  EXPECT_TRUE(isMidiNote->isValid("60"));
+  EXPECT_TRUE(isMidiNote->isValid("127"));
+  EXPECT_FALSE(isMidiNote->isValid("128"));
+  EXPECT_FALSE(isMidiNote->isValid("C4"));
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_LESS_OR_EQUAL,
+            isMidiNote->checkValidationErrorCode("128"));
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_NUMBER,
+            isMidiNote->checkValidationErrorCode("C4"));
+  EXPECT_EQ("Must be an integer in range.",
+            isMidiNote->checkValidationErrors("C4"));
+  EXPECT_EQ("", isMidiNote->checkValidationErrors("60"));
+  EXPECT_NE("", isMidiNote->checkValidationErrors("-1"));
+
+  auto isGain = StringValidators::parsesAs<float>(
+      Validators<float>::lessOrEqual(1.0f));
+  EXPECT_TRUE(isGain->isValid("0.5"));
+  EXPECT_TRUE(isGain->isValid("-6e-1"));
+  EXPECT_FALSE(isGain->isValid("1.5"));
+  EXPECT_EQ("Must be a number in range.",
+            isGain->checkValidationErrors("loud"));
+
+  auto isByte = StringValidators::parsesAs<uint8>();
+  EXPECT_TRUE(isByte->isValid("255"));
+  EXPECT_FALSE(isByte->isValid("256"));
+  EXPECT_EQ(ValidationErrorCode::NONE, isByte->checkValidationErrorCode("0"));
+}
+
+
+}  // namespace
@@ -0,0 +1,149 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/SymbolTable.h"
+
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "oomuse/core/StringRef.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::StringRef;
+using oomuse::Symbol;
+using oomuse::SymbolTable;
+using std::string;
+
+namespace {
+
+
+TEST(SymbolTable, emptyStringIsDefaultSymbol) {
+  SymbolTable symbols;
+  EXPECT_EQ(1u, symbols.size());
+  EXPECT_EQ(Symbol(), symbols.intern(""));
+  EXPECT_EQ(0u, Symbol().id());
+  EXPECT_EQ("", symbols.str(Symbol()));
+  EXPECT_EQ(1u, symbols.size());
+}
+
+
+TEST(SymbolTable, intern) {
+  SymbolTable symbols;
+  string name = "CutoffFrequency";
+  const Symbol cutoff = symbols.intern(name);
+  const Symbol gain = symbols.intern("Gain");
+  name.assign("overwritten");
+
+  EXPECT_EQ(1u, cutoff.id());
+  EXPECT_EQ(2u, gain.id());
+  EXPECT_NE(cutoff, gain);
+  EXPECT_TRUE(cutoff < gain);
+  EXPECT_EQ(cutoff, symbols.intern("CutoffFrequency"));
+  EXPECT_EQ(gain, symbols.intern(string("Gain")));
+  EXPECT_NE(gain, symbols.intern("gain"));
+  EXPECT_EQ(4u, symbols.size());
+
+  EXPECT_EQ("CutoffFrequency", symbols.str(cutoff));
+  EXPECT_EQ("Gain", symbols.str(gain));
+
+  const Symbol withNul = symbols.intern(StringRef("a\0b", 3));
+  EXPECT_NE(withNul, symbols.intern("a"));
+  EXPECT_EQ(StringRef("a\0b", 3), symbols.str(withNul));
+}
+
+
+TEST(SymbolTable, find) {
+  SymbolTable symbols;
+  EXPECT_FALSE(symbols.find("Gain").hasValue());
+  EXPECT_EQ(1u, symbols.size());
+
+  const Symbol gain = symbols.intern("Gain");
+  ASSERT_TRUE(symbols.find("Gain").hasValue());
+  EXPECT_EQ(gain, symbols.find("Gain").value());
+  EXPECT_EQ(Symbol(), symbols.find("").value());
+}
+
+
+TEST(SymbolTable, grows) {
+  // Enough symbols to span several entry chunks and hash index doublings.
+  const std::size_t numNames = 100000;
+  SymbolTable symbols;
+  for (std::size_t i = 1; i < numNames; ++i) {
+    ASSERT_EQ(i, symbols.intern("param" + std::to_string(i)).id());
+  }
+  EXPECT_EQ(numNames, symbols.size());
+
+  for (std::size_t i = 1; i < numNames; ++i) {
+    const string name = "param" + std::to_string(i);
+    const Symbol symbol = symbols.intern(name);
+    ASSERT_EQ(i, symbol.id());
+    ASSERT_EQ(name, symbols.str(symbol));
+    ASSERT_EQ(symbol, symbols.find(name).value());
+  }
+  EXPECT_EQ(numNames, symbols.size());
+}
+
+
+TEST(SymbolTable, threadsAgreeOnSymbols) {
+  const std::size_t numThreads = 8;
+  const std::size_t numNames = 5000;
+  SymbolTable symbols;
+
+  // Every thread interns every name, each starting at a different point.
+  std::vector<std::vector<Symbol>> symbolsByThread(numThreads);
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < numThreads; ++t) {
+    threads.emplace_back([&symbols, &symbolsByThread, t, numNames]() {
+      std::vector<Symbol>& found = symbolsByThread[t];
+      found.resize(numNames);
+      for (std::size_t j = 0; j < numNames; ++j) {
+        const std::size_t i = (j + t * (numNames / numThreads)) % numNames;
+        found[i] = symbols.intern("event" + std::to_string(i));
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(numNames + 1, symbols.size());
+  for (std::size_t i = 0; i < numNames; ++i) {
+    const Symbol symbol = symbolsByThread[0][i];
+    EXPECT_EQ("event" + std::to_string(i), symbols.str(symbol));
+    for (std::size_t t = 1; t < numThreads; ++t) {
+      ASSERT_EQ(symbol, symbolsByThread[t][i]) << i;
+    }
+  }
+}
+
+
+TEST(SymbolTable, hashContainerKeys) {
+  SymbolTable symbols;
+  std::unordered_map<Symbol, int32> params;
+  params[symbols.intern("Gain")] = 1;
+  params[symbols.intern("CutoffFrequency")] = 2;
+
+  EXPECT_EQ(1, params.at(symbols.intern(string("Gain"))));
+  EXPECT_EQ(2, params.at(symbols.intern("CutoffFrequency")));
+  EXPECT_EQ(0u, params.count(symbols.intern("Resonance")));
+}
+
+
+}  // namespace
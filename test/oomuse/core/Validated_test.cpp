@@ -0,0 +1,158 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/Validated.h"
+
+#include <string>
+#include <type_traits>
+
+#include "gtest/gtest.h"
+#include "oomuse/core/Optional.h"
+#include "oomuse/core/Result.h"
+#include "oomuse/core/ValidatorExpressions.h"
+#include "oomuse/core/Validators.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::Optional;
+using oomuse::Result;
+using oomuse::ValidationErrorCode;
+using oomuse::Validated;
+using oomuse::Validators;
+using std::string;
+
+namespace v = oomuse::validation;
+
+namespace {
+
+
+struct MidiRange {
+  static constexpr auto expression() {
+    return v::greaterOrEqual(0) && v::less(128);
+  }
+};
+
+using MidiValue = Validated<int32, MidiRange>;
+
+
+struct NonEmptyName {
+  static constexpr auto expression() {
+    return v::sizeGreaterOrEqual(1) && v::sizeLessOrEqual(8);
+  }
+};
+
+using Name = Validated<string, NonEmptyName>;
+
+
+static_assert(sizeof(MidiValue) == sizeof(int32),
+              "Validated should add no space");
+static_assert(std::is_trivially_copyable<MidiValue>::value,
+              "Validated should be trivially copyable for trivial T");
+static_assert(MidiValue::isValid(127), "127 is a MIDI value");
+static_assert(!MidiValue::of(128).hasValue(), "128 isn't a MIDI value");
+constexpr Optional<MidiValue> kMiddleC = MidiValue::of(60);
+static_assert(kMiddleC.value().value() == 60,
+              "Validated values can be built at compile time");
+
+
+/** Stands in for an API that relies on its argument already being valid. */
+int32 transposeOctave(MidiValue note) {
+  return (note < 116) ? (note + 12) : static_cast<int32>(note);
+}
+
+
+TEST(Validated, of) {
+  Optional<MidiValue> note = MidiValue::of(60);
+  ASSERT_TRUE(note.hasValue());
+  EXPECT_EQ(60, note.value().value());
+  EXPECT_EQ(72, transposeOctave(note.value()));
+
+  EXPECT_FALSE(MidiValue::of(-1).hasValue());
+  EXPECT_FALSE(MidiValue::of(128).hasValue());
+}
+
+
+TEST(Validated, validate) {
+  Result<MidiValue, ValidationErrorCode> note = MidiValue::validate(127);
+  ASSERT_TRUE(note.isOk());
+  EXPECT_EQ(127, note.value().value());
+
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_GREATER_OR_EQUAL,
+            MidiValue::validate(-1).error());
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_LESS,
+            MidiValue::validate(128).error());
+
+  int32 transposed = MidiValue::validate(100).map(transposeOctave).value();
+  EXPECT_EQ(112, transposed);
+}
+
+
+TEST(Validated, checks) {
+  EXPECT_TRUE(MidiValue::isValid(0));
+  EXPECT_FALSE(MidiValue::isValid(128));
+  EXPECT_EQ(ValidationErrorCode::NONE, MidiValue::checkValidationErrorCode(0));
+  EXPECT_EQ("", MidiValue::checkValidationErrors(0));
+  EXPECT_EQ("Must be less than 128.\n", MidiValue::checkValidationErrors(128));
+}
+
+
+TEST(Validated, nonTrivialValues) {
+  Optional<Name> name = Name::of("Clara");
+  ASSERT_TRUE(name.hasValue());
+  EXPECT_EQ("Clara", name.value().value());
+  const string& nameString = name.value();
+  EXPECT_EQ(5u, nameString.length());
+
+  EXPECT_FALSE(Name::of("").hasValue());
+  EXPECT_EQ(ValidationErrorCode::SIZE_MUST_BE_LESS_OR_EQUAL,
+            Name::validate("Wolfgang Amadeus").error());
+}
+
+
+TEST(Validated, interoperatesWithValidators) {
+  auto isMidiValue = MidiValue::validator();
+  EXPECT_TRUE(isMidiValue->isValid(0));
+  EXPECT_FALSE(isMidiValue->isValid(-1));
+  EXPECT_EQ("Must be less than 128.\n",
+            isMidiValue->checkValidationErrors(200));
+
+  // A wider Validator chain that includes the rule can produce values too.
+  auto isPlayableNote = Validators<int32>::allOf(
+      MidiValue::validator(), Validators<int32>::lessOrEqual(120));
+  Optional<MidiValue> note = MidiValue::ofCheckedBy(*isPlayableNote, 120);
+  ASSERT_TRUE(note.hasValue());
+  EXPECT_EQ(120, note.value().value());
+  EXPECT_FALSE(MidiValue::ofCheckedBy(*isPlayableNote, 121).hasValue());
+
+  // Rule is always enforced, even if the validator doesn't imply it.
+  auto isBelowThousand = Validators<int32>::less(1000);
+  EXPECT_FALSE(MidiValue::ofCheckedBy(*isBelowThousand, 500).hasValue());
+  EXPECT_FALSE(MidiValue::ofCheckedBy(*isBelowThousand, -1).hasValue());
+  EXPECT_EQ(100, MidiValue::ofCheckedBy(*isBelowThousand, 100).value().value());
+}
+
+
+TEST(Validated, comparisons) {
+  MidiValue c4 = MidiValue::of(60).value();
+  MidiValue d4 = MidiValue::of(62).value();
+  EXPECT_TRUE(c4 == MidiValue::of(60).value());
+  EXPECT_TRUE(c4 != d4);
+  EXPECT_TRUE(c4 < d4);
+  EXPECT_FALSE(d4 < c4);
+  EXPECT_TRUE(MidiValue::of(60) == Optional<MidiValue>(c4));
+}
+
+
+}  // namespace
@@ -0,0 +1,136 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/ValidatorExpressions.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "oomuse/core/Validators.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::ValidationErrorCode;
+using oomuse::Validators;
+using std::string;
+
+namespace v = oomuse::validation;
+
+namespace {
+
+
+constexpr auto isMidiValue = v::greaterOrEqual(0) && v::less(128);
+
+static_assert(isMidiValue.isValid(0), "0 is a MIDI value");
+static_assert(isMidiValue.isValid(127), "127 is a MIDI value");
+static_assert(!isMidiValue.isValid(-1), "-1 isn't a MIDI value");
+static_assert(!isMidiValue(128), "128 isn't a MIDI value");
+static_assert(isMidiValue.checkValidationErrorCode(128)
+                  == ValidationErrorCode::MUST_BE_LESS,
+              "Error codes should be available at compile time");
+
+
+TEST(ValidatorExpressions, comparisons) {
+  EXPECT_EQ("", v::less(5).checkValidationErrors(4));
+  EXPECT_EQ("Must be less than 5.", v::less(5).checkValidationErrors(5));
+  EXPECT_EQ("Must be less than or equal to 2.",
+            v::lessOrEqual(2).checkValidationErrors(3));
+  EXPECT_EQ("Must be greater than 0.", v::greater(0).checkValidationErrors(0));
+  EXPECT_EQ("Must be greater than or equal to 0.",
+            v::greaterOrEqual(0).checkValidationErrors(-1));
+  EXPECT_EQ("Must be equal to 42.", v::equal(42).checkValidationErrors(41));
+  EXPECT_EQ("", v::equal(42).checkValidationErrors(42));
+
+  EXPECT_EQ("", v::notEqual("irregardless").checkValidationErrors(
+                    string("regardless")));
+  EXPECT_EQ("Must not be equal to irregardless.",
+            v::notEqual("irregardless").checkValidationErrors(
+                string("irregardless")));
+
+  EXPECT_EQ("", v::sizeLessOrEqual(2).checkValidationErrors(string("12")));
+  EXPECT_EQ("Size/length must be less than or equal to 2.",
+            v::sizeLessOrEqual(2).checkValidationErrors(string("123")));
+  EXPECT_EQ("Size/length must be greater than or equal to 2.",
+            v::sizeGreaterOrEqual(2).checkValidationErrors(string("1")));
+}
+
+
+TEST(ValidatorExpressions, allOf) {
+  auto isNonFridayWeekdayIndex =
+      v::greaterOrEqual(0) && v::notEqual(4) && v::less(7);
+  EXPECT_TRUE(isNonFridayWeekdayIndex.isValid(0));
+  EXPECT_FALSE(isNonFridayWeekdayIndex.isValid(4));
+  EXPECT_EQ("Must be greater than or equal to 0.\n",
+            isNonFridayWeekdayIndex.checkValidationErrors(-1));
+  EXPECT_EQ("", isNonFridayWeekdayIndex.checkValidationErrors(6));
+  EXPECT_EQ("Must not be equal to 4.\n",
+            isNonFridayWeekdayIndex.checkValidationErrors(4));
+  EXPECT_EQ(ValidationErrorCode::MUST_NOT_BE_EQUAL,
+            isNonFridayWeekdayIndex.checkValidationErrorCode(4));
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_LESS,
+            isNonFridayWeekdayIndex.checkValidationErrorCode(7));
+}
+
+
+TEST(ValidatorExpressions, anyOf) {
+  auto luckyNumbers = v::equal(7) || v::equal(13) || v::equal(21);
+  EXPECT_TRUE(luckyNumbers.isValid(13));
+  EXPECT_FALSE(luckyNumbers.isValid(42));
+  EXPECT_EQ("", luckyNumbers.checkValidationErrors(21));
+  EXPECT_EQ(
+      "Requires one of:\n  Must be equal to 7.\n  Must be equal to 13.\n"
+          "  Must be equal to 21.\n",
+      luckyNumbers.checkValidationErrors(42));
+  EXPECT_EQ(ValidationErrorCode::MUST_PASS_ANY_OF,
+            luckyNumbers.checkValidationErrorCode(42));
+}
+
+
+TEST(ValidatorExpressions, matchesValidatorsMessages) {
+  auto expression = (v::greaterOrEqual(0) && v::less(128)) || v::equal(255);
+  auto validator = Validators<int32>::anyOf(
+      Validators<int32>::allOf(
+          Validators<int32>::greaterOrEqual(0),
+          Validators<int32>::less(128)),
+      Validators<int32>::equal(255));
+
+  for (int32 value : {-5, 0, 64, 127, 128, 200, 255, 256}) {
+    EXPECT_EQ(validator->isValid(value), expression.isValid(value));
+    EXPECT_EQ(validator->checkValidationErrorCode(value),
+              expression.checkValidationErrorCode(value));
+    EXPECT_EQ(validator->checkValidationErrors(value),
+              expression.checkValidationErrors(value));
+  }
+}
+
+
+TEST(ValidatorExpressions, toValidator) {
+  auto validator = v::toValidator<int32>(isMidiValue);
+  EXPECT_TRUE(validator->isValid(60));
+  EXPECT_FALSE(validator->isValid(200));
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_GREATER_OR_EQUAL,
+            validator->checkValidationErrorCode(-1));
+  EXPECT_EQ("Must be less than 128.\n",
+            validator->checkValidationErrors(128));
+
+  // Type-erased expressions combine with the Validators factories.
+  auto midiOrOff = Validators<int32>::anyOf(
+      std::move(validator), Validators<int32>::equal(-1));
+  EXPECT_TRUE(midiOrOff->isValid(-1));
+  EXPECT_FALSE(midiOrOff->isValid(-2));
+}
+
+
+}  // namespace
@@ -0,0 +1,189 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/ValidatorSet.h"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "oomuse/core/Validator.h"
+#include "oomuse/core/Validators.h"
+#include "oomuse/core/int_types.h"
+
+using oomuse::ValidationErrorCode;
+using oomuse::Validator;
+using oomuse::ValidatorSet;
+using oomuse::Validators;
+using std::string;
+using std::unique_ptr;
+
+namespace {
+
+
+TEST(ValidatorSet, range) {
+  ValidatorSet<int32>::Builder builder;
+  auto isMidiValue = builder.allOf({builder.greaterOrEqual(0),
+                                    builder.less(128)});
+  ValidatorSet<int32> validator =
+      builder.build(builder.anyOf({isMidiValue, builder.equal(255)}));
+  EXPECT_EQ(5u, validator.numNodes());
+
+  EXPECT_TRUE(validator.isValid(0));
+  EXPECT_TRUE(validator.isValid(127));
+  EXPECT_TRUE(validator.isValid(255));
+  EXPECT_FALSE(validator.isValid(-1));
+  EXPECT_FALSE(validator.isValid(128));
+
+  EXPECT_EQ(ValidationErrorCode::NONE, validator.checkValidationErrorCode(1));
+  EXPECT_EQ(ValidationErrorCode::MUST_PASS_ANY_OF,
+            validator.checkValidationErrorCode(128));
+  EXPECT_EQ("", validator.checkValidationErrors(1));
+  EXPECT_EQ("Requires one of:\n  Must be less than 128.\n\n"
+                "  Must be equal to 255.\n",
+            validator.checkValidationErrors(128));
+}
+
+
+TEST(ValidatorSet, allOfErrorCode) {
+  // Like AndValidator, reports the code of the first failing node.
+  ValidatorSet<int32>::Builder builder;
+  ValidatorSet<int32> isWeekdayIndex = builder.build(builder.allOf(
+      {builder.greaterOrEqual(0), builder.notEqual(4), builder.less(7)}));
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_GREATER_OR_EQUAL,
+            isWeekdayIndex.checkValidationErrorCode(-1));
+  EXPECT_EQ(ValidationErrorCode::MUST_NOT_BE_EQUAL,
+            isWeekdayIndex.checkValidationErrorCode(4));
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_LESS,
+            isWeekdayIndex.checkValidationErrorCode(7));
+  EXPECT_EQ("Must not be equal to 4.\n",
+            isWeekdayIndex.checkValidationErrors(4));
+}
+
+
+TEST(ValidatorSet, sizes) {
+  ValidatorSet<string>::Builder builder;
+  ValidatorSet<string> isShortName = builder.build(builder.allOf(
+      {builder.sizeGreaterOrEqual(1), builder.sizeLessOrEqual(8),
+       builder.notEqual("root")}));
+  EXPECT_TRUE(isShortName.isValid("eric"));
+  EXPECT_FALSE(isShortName.isValid(""));
+  EXPECT_FALSE(isShortName.isValid("root"));
+  EXPECT_EQ(ValidationErrorCode::SIZE_MUST_BE_LESS_OR_EQUAL,
+            isShortName.checkValidationErrorCode("much too long"));
+  EXPECT_EQ("Size/length must be greater than or equal to 1.\n",
+            isShortName.checkValidationErrors(""));
+}
+
+
+class IsEvenValidator : public Validator<int32> {
+ public:
+  virtual std::string checkValidationErrors(const int32& value) const {
+    return (value % 2 == 0) ? "" : "Must be even.";
+  }
+};
+
+
+TEST(ValidatorSet, opaqueAndSharedNodes) {
+  ValidatorSet<int32>::Builder builder;
+  auto isEven = builder.add(std::make_unique<IsEvenValidator>());
+  auto small = builder.allOf({isEven, builder.less(10)});
+  auto large = builder.allOf({isEven, builder.greater(100)});
+  ValidatorSet<int32> validator = builder.build(builder.anyOf({small, large}));
+  EXPECT_EQ(7u, validator.numNodes());  // isEven gets laid out twice.
+
+  EXPECT_TRUE(validator.isValid(4));
+  EXPECT_TRUE(validator.isValid(102));
+  EXPECT_FALSE(validator.isValid(5));
+  EXPECT_FALSE(validator.isValid(50));
+
+  // Moving keeps opaque validators alive.
+  ValidatorSet<int32> moved(std::move(validator));
+  EXPECT_TRUE(moved.isValid(4));
+  EXPECT_EQ("Requires one of:\n  Must be even.\n\n"
+                "  Must be even.\nMust be greater than 100.\n\n",
+            moved.checkValidationErrors(5));
+}
+
+
+/**
+ * Adds the same random tree to both a Builder (returning its node) and a
+ * regular Validators tree (returned in *validator).
+ */
+ValidatorSet<int32>::NodeId addRandomTree(
+    std::mt19937* random, int32 depth, ValidatorSet<int32>::Builder* builder,
+    unique_ptr<Validator<int32>>* validator) {
+  std::uniform_int_distribution<int32> kinds(0, depth > 0 ? 7 : 5);
+  std::uniform_int_distribution<int32> bounds(-20, 20);
+  const int32 bound = bounds(*random);
+  switch (kinds(*random)) {
+    case 0:
+      *validator = Validators<int32>::less(bound);
+      return builder->less(bound);
+    case 1:
+      *validator = Validators<int32>::lessOrEqual(bound);
+      return builder->lessOrEqual(bound);
+    case 2:
+      *validator = Validators<int32>::greater(bound);
+      return builder->greater(bound);
+    case 3:
+      *validator = Validators<int32>::greaterOrEqual(bound);
+      return builder->greaterOrEqual(bound);
+    case 4:
+      *validator = Validators<int32>::equal(bound);
+      return builder->equal(bound);
+    case 5:
+      *validator = Validators<int32>::notEqual(bound);
+      return builder->notEqual(bound);
+    default:
+      break;
+  }
+
+  std::vector<ValidatorSet<int32>::NodeId> children;
+  std::vector<unique_ptr<Validator<int32>>> validators(3);
+  for (auto& child : validators) {
+    children.push_back(addRandomTree(random, depth - 1, builder, &child));
+  }
+  const bool isAnyOf = (bounds(*random) < 0);
+  *validator = isAnyOf ? Validators<int32>::anyOf(std::move(validators))
+                       : Validators<int32>::allOf(std::move(validators));
+  return isAnyOf ? builder->anyOf(std::move(children))
+                 : builder->allOf(std::move(children));
+}
+
+
+TEST(ValidatorSet, equivalentToValidatorsTree) {
+  std::mt19937 random(20160101);
+  for (int32 trial = 0; trial < 200; ++trial) {
+    ValidatorSet<int32>::Builder builder;
+    unique_ptr<Validator<int32>> tree;
+    ValidatorSet<int32> validatorSet =
+        builder.build(addRandomTree(&random, 3, &builder, &tree));
+    for (int32 value = -25; value <= 25; ++value) {
+      ASSERT_EQ(tree->isValid(value), validatorSet.isValid(value));
+      ASSERT_EQ(tree->checkValidationErrorCode(value),
+                validatorSet.checkValidationErrorCode(value));
+      ASSERT_EQ(tree->checkValidationErrors(value),
+                validatorSet.checkValidationErrors(value));
+    }
+  }
+}
+
+
+}  // namespace
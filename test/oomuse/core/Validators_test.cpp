@@ -16,13 +16,25 @@
 
 #include "oomuse/core/Validators.h"
 
+#include <limits>
+#include <memory>
+#include <random>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "oomuse/core/StringBuilder.h"
 #include "oomuse/core/int_types.h"
 
+using oomuse::CompiledValidator;
+using oomuse::StringBuilder;
+using oomuse::ValidationErrorCode;
+using oomuse::Validator;
 using oomuse::Validators;
+using std::numeric_limits;
 using std::string;
+using std::unique_ptr;
 
 namespace {
 
@@ -65,6 +77,15 @@ TEST(Validators, greater) {
 }
 
 
+TEST(Validators, floatBoundMessage) {
+  // Float bounds print as written, not as their value widened to double.
+  EXPECT_EQ("Must be less than 0.1.",
+            Validators<float>::less(0.1F)->checkValidationErrors(1.0F));
+  EXPECT_EQ("Must be greater than 0.3333333333333333.",
+            Validators<double>::greater(1.0 / 3)->checkValidationErrors(0.0));
+}
+
+
 TEST(Validators, greaterOrEqual) {
   auto nonNegative = Validators<double>::greaterOrEqual(0.0);
   EXPECT_CONTAINS("Must be greater than or equal to 0",
@@ -170,4 +191,325 @@ TEST(Validators, allOf_triple) {
 }
 
 
+TEST(Validators, anyOf_variadic) {
+  auto primesUnder20 = Validators<int32>::anyOf(
+      Validators<int32>::equal(2), Validators<int32>::equal(3),
+      Validators<int32>::equal(5), Validators<int32>::equal(7),
+      Validators<int32>::equal(11), Validators<int32>::equal(13),
+      Validators<int32>::equal(17), Validators<int32>::equal(19));
+  EXPECT_TRUE(primesUnder20->isValid(2));
+  EXPECT_TRUE(primesUnder20->isValid(19));
+  EXPECT_FALSE(primesUnder20->isValid(9));
+
+  // Wide rules still form a single (flat) node.
+  auto orValidator =
+      dynamic_cast<const oomuse::OrValidator<int32>*>(primesUnder20.get());
+  ASSERT_TRUE(orValidator != nullptr);
+  EXPECT_EQ(8u, orValidator->validators().size());
+}
+
+
+TEST(Validators, allOf_variadic) {
+  auto isNonWeekendDayOfMonth = Validators<int32>::allOf(
+      Validators<int32>::greaterOrEqual(1),
+      Validators<int32>::lessOrEqual(31),
+      Validators<int32>::notEqual(6),
+      Validators<int32>::notEqual(7));
+  EXPECT_TRUE(isNonWeekendDayOfMonth->isValid(1));
+  EXPECT_FALSE(isNonWeekendDayOfMonth->isValid(7));
+  EXPECT_EQ("Must be less than or equal to 31.\n",
+            isNonWeekendDayOfMonth->checkValidationErrors(32));
+}
+
+
+TEST(Validators, anyOfAndAllOf_vector) {
+  std::vector<unique_ptr<Validator<int32>>> multiplesOf10;
+  for (int32 i = 0; i < 100; i += 10) {
+    multiplesOf10.emplace_back(Validators<int32>::equal(i));
+  }
+  auto isMultipleOf10 = Validators<int32>::anyOf(std::move(multiplesOf10));
+  EXPECT_TRUE(isMultipleOf10->isValid(0));
+  EXPECT_TRUE(isMultipleOf10->isValid(90));
+  EXPECT_FALSE(isMultipleOf10->isValid(15));
+
+  std::vector<unique_ptr<Validator<int32>>> notMultiplesOf10;
+  for (int32 i = 0; i < 100; i += 10) {
+    notMultiplesOf10.emplace_back(Validators<int32>::notEqual(i));
+  }
+  auto isNotMultipleOf10 =
+      Validators<int32>::allOf(std::move(notMultiplesOf10));
+  EXPECT_FALSE(isNotMultipleOf10->isValid(0));
+  EXPECT_FALSE(isNotMultipleOf10->isValid(90));
+  EXPECT_TRUE(isNotMultipleOf10->isValid(15));
+}
+
+
+TEST(Validators, isValid) {
+  EXPECT_TRUE(Validators<int32>::less(5)->isValid(4));
+  EXPECT_FALSE(Validators<int32>::less(5)->isValid(5));
+  EXPECT_TRUE(Validators<int32>::lessOrEqual(5)->isValid(5));
+  EXPECT_FALSE(Validators<int32>::lessOrEqual(5)->isValid(6));
+  EXPECT_TRUE(Validators<float>::greater(0.0F)->isValid(0.5F));
+  EXPECT_FALSE(Validators<float>::greater(0.0F)->isValid(0.0F));
+  EXPECT_TRUE(Validators<double>::greaterOrEqual(0.0)->isValid(0.0));
+  EXPECT_FALSE(Validators<double>::greaterOrEqual(0.0)->isValid(-0.5));
+  EXPECT_TRUE(Validators<int32>::equal(42)->isValid(42));
+  EXPECT_FALSE(Validators<int32>::equal(42)->isValid(41));
+  EXPECT_TRUE(Validators<string>::notEqual("a")->isValid("b"));
+  EXPECT_FALSE(Validators<string>::notEqual("a")->isValid("a"));
+  EXPECT_TRUE(Validators<string>::sizeLessOrEqual(2)->isValid("ab"));
+  EXPECT_FALSE(Validators<string>::sizeLessOrEqual(2)->isValid("abc"));
+  EXPECT_TRUE(Validators<string>::sizeGreaterOrEqual(2)->isValid("ab"));
+  EXPECT_FALSE(Validators<string>::sizeGreaterOrEqual(2)->isValid("a"));
+
+  auto luckyNumbers = Validators<int32>::anyOf(
+      Validators<int32>::equal(7),
+      Validators<int32>::equal(13));
+  EXPECT_TRUE(luckyNumbers->isValid(7));
+  EXPECT_TRUE(luckyNumbers->isValid(13));
+  EXPECT_FALSE(luckyNumbers->isValid(21));
+
+  auto isWeekdayIndex = Validators<int32>::allOf(
+      Validators<int32>::greaterOrEqual(0),
+      Validators<int32>::less(7));
+  EXPECT_FALSE(isWeekdayIndex->isValid(-1));
+  EXPECT_TRUE(isWeekdayIndex->isValid(0));
+  EXPECT_TRUE(isWeekdayIndex->isValid(6));
+  EXPECT_FALSE(isWeekdayIndex->isValid(7));
+}
+
+
+TEST(Validators, checkValidationErrorCode) {
+  EXPECT_EQ(ValidationErrorCode::NONE,
+            Validators<int32>::less(5)->checkValidationErrorCode(4));
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_LESS,
+            Validators<int32>::less(5)->checkValidationErrorCode(5));
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_LESS_OR_EQUAL,
+            Validators<int32>::lessOrEqual(5)->checkValidationErrorCode(6));
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_GREATER,
+            Validators<int32>::greater(5)->checkValidationErrorCode(5));
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_GREATER_OR_EQUAL,
+            Validators<int32>::greaterOrEqual(5)->checkValidationErrorCode(4));
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_EQUAL,
+            Validators<int32>::equal(5)->checkValidationErrorCode(4));
+  EXPECT_EQ(ValidationErrorCode::MUST_NOT_BE_EQUAL,
+            Validators<int32>::notEqual(5)->checkValidationErrorCode(5));
+  EXPECT_EQ(ValidationErrorCode::SIZE_MUST_BE_LESS_OR_EQUAL,
+            Validators<string>::sizeLessOrEqual(0)->checkValidationErrorCode(
+                "a"));
+  EXPECT_EQ(ValidationErrorCode::SIZE_MUST_BE_GREATER_OR_EQUAL,
+            Validators<string>::sizeGreaterOrEqual(2)->checkValidationErrorCode(
+                "a"));
+
+  auto luckyNumbers = Validators<int32>::anyOf(
+      Validators<int32>::equal(7),
+      Validators<int32>::equal(13));
+  EXPECT_EQ(ValidationErrorCode::NONE,
+            luckyNumbers->checkValidationErrorCode(13));
+  EXPECT_EQ(ValidationErrorCode::MUST_PASS_ANY_OF,
+            luckyNumbers->checkValidationErrorCode(21));
+
+  // allOf reports the code of the first failing validator.
+  auto isWeekdayIndex = Validators<int32>::allOf(
+      Validators<int32>::greaterOrEqual(0),
+      Validators<int32>::less(7));
+  EXPECT_EQ(ValidationErrorCode::NONE,
+            isWeekdayIndex->checkValidationErrorCode(3));
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_GREATER_OR_EQUAL,
+            isWeekdayIndex->checkValidationErrorCode(-1));
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_LESS,
+            isWeekdayIndex->checkValidationErrorCode(7));
+}
+
+
+/** Custom validator that only implements checkValidationErrors(). */
+class IsEvenValidator : public Validator<int32> {
+ public:
+  virtual std::string checkValidationErrors(const int32& value) const {
+    return (value % 2 == 0) ? "" : "Must be even.";
+  }
+};
+
+
+TEST(Validators, customValidatorDefaults) {
+  IsEvenValidator isEven;
+  EXPECT_TRUE(isEven.isValid(4));
+  EXPECT_FALSE(isEven.isValid(5));
+  EXPECT_EQ(ValidationErrorCode::NONE, isEven.checkValidationErrorCode(4));
+  EXPECT_EQ(ValidationErrorCode::INVALID, isEven.checkValidationErrorCode(5));
+
+  StringBuilder errors;
+  errors.append("Errors: ");
+  isEven.appendValidationErrors(4, errors);
+  isEven.appendValidationErrors(5, errors);
+  EXPECT_EQ("Errors: Must be even.", errors.toString());
+}
+
+
+TEST(Validators, appendValidationErrors) {
+  auto isSmallEven = Validators<int32>::anyOf(
+      Validators<int32>::allOf(Validators<int32>::greaterOrEqual(0),
+                               Validators<int32>::less(10),
+                               std::make_unique<IsEvenValidator>()),
+      Validators<int32>::equal(-1));
+
+  // Appends to what's already in the builder, and nothing if valid.
+  StringBuilder errors;
+  errors.append("> ");
+  isSmallEven->appendValidationErrors(4, errors);
+  EXPECT_EQ("> ", errors.toString());
+  isSmallEven->appendValidationErrors(11, errors);
+  EXPECT_EQ("> Requires one of:\n"
+                "  Must be less than 10.\nMust be even.\n\n"
+                "  Must be equal to -1.\n",
+            errors.toString());
+  EXPECT_EQ(errors.toStringRef().substr(2).toString(),
+            isSmallEven->checkValidationErrors(11));
+}
+
+
+TEST(Validators, compile_range) {
+  auto isMidiValue = Validators<int32>::compile(Validators<int32>::allOf(
+      Validators<int32>::greaterOrEqual(0),
+      Validators<int32>::less(128)));
+
+  auto compiled = dynamic_cast<CompiledValidator<int32>*>(isMidiValue.get());
+  ASSERT_TRUE(compiled != nullptr);
+  EXPECT_TRUE(compiled->plan().hasIntervals);
+  EXPECT_EQ(1, compiled->plan().intervals.intervals().size());
+
+  EXPECT_FALSE(isMidiValue->isValid(-1));
+  EXPECT_TRUE(isMidiValue->isValid(0));
+  EXPECT_TRUE(isMidiValue->isValid(127));
+  EXPECT_FALSE(isMidiValue->isValid(128));
+
+  // Errors still come from the original validator.
+  EXPECT_EQ("", isMidiValue->checkValidationErrors(64));
+  EXPECT_EQ("Must be less than 128.\n",
+            isMidiValue->checkValidationErrors(128));
+  EXPECT_EQ(ValidationErrorCode::MUST_BE_GREATER_OR_EQUAL,
+            isMidiValue->checkValidationErrorCode(-1));
+}
+
+
+TEST(Validators, compile_mergesIntervals) {
+  // [0, 10] or [5, 20) or 20, excluding 7 => [0, 7) (7, 20].
+  auto validator = Validators<int32>::compile(Validators<int32>::allOf(
+      Validators<int32>::anyOf(
+          Validators<int32>::allOf(
+              Validators<int32>::greaterOrEqual(0),
+              Validators<int32>::lessOrEqual(10)),
+          Validators<int32>::allOf(
+              Validators<int32>::greaterOrEqual(5),
+              Validators<int32>::less(20)),
+          Validators<int32>::equal(20)),
+      Validators<int32>::notEqual(7)));
+
+  auto compiled = dynamic_cast<CompiledValidator<int32>*>(validator.get());
+  ASSERT_TRUE(compiled != nullptr);
+  EXPECT_EQ(2, compiled->plan().intervals.intervals().size());
+
+  for (int32 value = -5; value <= 25; ++value) {
+    bool expected = (value >= 0) && (value <= 20) && (value != 7);
+    EXPECT_EQ(expected, validator->isValid(value)) << value;
+  }
+}
+
+
+TEST(Validators, compile_opaqueFallback) {
+  auto validator = Validators<int32>::compile(Validators<int32>::anyOf(
+      Validators<int32>::less(0),
+      std::make_unique<IsEvenValidator>(),
+      Validators<int32>::equal(101)));
+
+  EXPECT_TRUE(validator->isValid(-3));
+  EXPECT_TRUE(validator->isValid(4));
+  EXPECT_FALSE(validator->isValid(5));
+  EXPECT_TRUE(validator->isValid(101));
+  EXPECT_EQ(ValidationErrorCode::MUST_PASS_ANY_OF,
+            validator->checkValidationErrorCode(5));
+}
+
+
+TEST(Validators, compile_nonArithmetic) {
+  auto validator = Validators<string>::compile(Validators<string>::allOf(
+      Validators<string>::sizeGreaterOrEqual(1),
+      Validators<string>::notEqual("none")));
+  EXPECT_TRUE(validator->isValid("some"));
+  EXPECT_FALSE(validator->isValid("none"));
+  EXPECT_FALSE(validator->isValid(""));
+}
+
+
+/** Returns a random validator tree over small int bounds. */
+unique_ptr<Validator<int32>> makeRandomTree(std::minstd_rand* random,
+                                            int32 depth) {
+  const int32 bound = static_cast<int32>((*random)() % 21) - 10;
+  const uint32 kind = (*random)() % ((depth > 0) ? 9 : 7);
+  switch (kind) {
+    case 0: return Validators<int32>::less(bound);
+    case 1: return Validators<int32>::lessOrEqual(bound);
+    case 2: return Validators<int32>::greater(bound);
+    case 3: return Validators<int32>::greaterOrEqual(bound);
+    case 4: return Validators<int32>::equal(bound);
+    case 5: return Validators<int32>::notEqual(bound);
+    case 6: return std::make_unique<IsEvenValidator>();
+    case 7:
+      return Validators<int32>::anyOf(makeRandomTree(random, depth - 1),
+                                      makeRandomTree(random, depth - 1),
+                                      makeRandomTree(random, depth - 1));
+    default:
+      return Validators<int32>::allOf(makeRandomTree(random, depth - 1),
+                                      makeRandomTree(random, depth - 1));
+  }
+}
+
+
+TEST(Validators, compile_equivalentToTree) {
+  for (int32 trial = 0; trial < 500; ++trial) {
+    // Build two identical trees from the same seed, and compile one of them.
+    std::minstd_rand seed1(static_cast<uint32>(trial) + 1);
+    std::minstd_rand seed2(static_cast<uint32>(trial) + 1);
+    unique_ptr<Validator<int32>> tree = makeRandomTree(&seed1, 4);
+    unique_ptr<Validator<int32>> compiled =
+        Validators<int32>::compile(makeRandomTree(&seed2, 4));
+
+    for (int32 value = -15; value <= 15; ++value) {
+      ASSERT_EQ(tree->isValid(value), compiled->isValid(value))
+          << "trial " << trial << ", value " << value;
+      ASSERT_EQ(tree->checkValidationErrorCode(value),
+                compiled->checkValidationErrorCode(value));
+      ASSERT_EQ(tree->checkValidationErrors(value),
+                compiled->checkValidationErrors(value));
+    }
+  }
+}
+
+
+TEST(Validators, compile_floatingPoint) {
+  auto tree = []() {
+    return Validators<double>::anyOf(
+        Validators<double>::allOf(
+            Validators<double>::greater(-1.0),
+            Validators<double>::lessOrEqual(1.0)),
+        Validators<double>::notEqual(5.0));
+  };
+  auto original = tree();
+  auto compiled = Validators<double>::compile(tree());
+
+  const double testValues[] = {
+    -numeric_limits<double>::infinity(), -2.0, -1.0, -0.999, 0.0, 1.0,
+    1.001, 5.0, 6.0, numeric_limits<double>::infinity(),
+    numeric_limits<double>::quiet_NaN()
+  };
+  for (double value : testValues) {
+    EXPECT_EQ(original->isValid(value), compiled->isValid(value)) << value;
+  }
+
+  // NaN passes notEqual(), and so the whole anyOf().
+  EXPECT_TRUE(compiled->isValid(numeric_limits<double>::quiet_NaN()));
+  EXPECT_FALSE(compiled->isValid(5.0));
+}
+
+
 }  // namespace
@@ -0,0 +1,49 @@
+/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "oomuse/core/bits.h"
+
+#include "gtest/gtest.h"
+#include "oomuse/core/int_types.h"
+
+namespace bits = oomuse::bits;
+
+namespace {
+
+
+TEST(bits, countBits) {
+  EXPECT_EQ(0u, bits::countBits(0));
+  EXPECT_EQ(1u, bits::countBits(1));
+  EXPECT_EQ(1u, bits::countBits(0x8000000000000000ULL));
+  EXPECT_EQ(8u, bits::countBits(0xFF));
+  EXPECT_EQ(32u, bits::countBits(0xAAAAAAAAAAAAAAAAULL));
+  EXPECT_EQ(64u, bits::countBits(~static_cast<uint64>(0)));
+}
+
+
+TEST(bits, countLeadingZeros) {
+  EXPECT_EQ(31, bits::countLeadingZeros(static_cast<uint32>(1)));
+  EXPECT_EQ(24, bits::countLeadingZeros(static_cast<uint32>(0xFF)));
+  EXPECT_EQ(0, bits::countLeadingZeros(static_cast<uint32>(0x80000000U)));
+
+  EXPECT_EQ(63, bits::countLeadingZeros(static_cast<uint64>(1)));
+  EXPECT_EQ(32, bits::countLeadingZeros(static_cast<uint64>(0xFFFFFFFFU)));
+  EXPECT_EQ(0, bits::countLeadingZeros(
+                   static_cast<uint64>(0x8000000000000000ULL)));
+}
+
+
+}  // namespace
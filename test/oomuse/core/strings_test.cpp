@@ -16,11 +16,30 @@
 
 #include "oomuse/core/strings.h"
 
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <random>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "oomuse/core/CharacterSet.h"
+#include "oomuse/core/StringArena.h"
+#include "oomuse/core/StringRef.h"
+#include "oomuse/core/int_types.h"
 
+using oomuse::CharacterSet;
+using oomuse::StringArena;
+using oomuse::StringRef;
 using std::locale;
+using oomuse::strings::SplitOptions;
 using std::string;
 
 namespace strings = oomuse::strings;
@@ -88,6 +107,111 @@ TEST(strings, endsWith) {
 }
 
 
+TEST(strings, equalsIgnoreCase) {
+  EXPECT_TRUE(strings::equalsIgnoreCase("", ""));
+  EXPECT_TRUE(strings::equalsIgnoreCase("Awesome", "aWESOME"));
+  EXPECT_TRUE(strings::equalsIgnoreCase("OscillatorFrequency2",
+                                        "oscillatorfrequency2"));
+  EXPECT_FALSE(strings::equalsIgnoreCase("Awesome", "Awesome!"));
+  EXPECT_FALSE(strings::equalsIgnoreCase("OscillatorFrequency2",
+                                         "OscillatorFrequency3"));
+
+  // Only A-Z and a-z match each other.
+  EXPECT_FALSE(strings::equalsIgnoreCase("@[`{", "`{@["));
+  EXPECT_FALSE(strings::equalsIgnoreCase("caf\xc3\x89", "caf\xc3\xa9"));
+  EXPECT_TRUE(strings::equalsIgnoreCase("CAF\xc3\xa9", "caf\xc3\xa9"));
+}
+
+
+TEST(strings, compareIgnoreCase) {
+  EXPECT_EQ(0, strings::compareIgnoreCase("", ""));
+  EXPECT_EQ(0, strings::compareIgnoreCase("Awesome", "aWESOME"));
+  EXPECT_LT(strings::compareIgnoreCase("apple", "Banana"), 0);
+  EXPECT_GT(strings::compareIgnoreCase("Banana", "apple"), 0);
+  EXPECT_LT(strings::compareIgnoreCase("Awe", "awesome"), 0);
+  EXPECT_GT(strings::compareIgnoreCase("AWESOME", "awe"), 0);
+  EXPECT_LT(strings::compareIgnoreCase("OscillatorFrequency2",
+                                       "oscillatorfrequency3"), 0);
+
+  // Compares lowercased bytes as unsigned ('Z' compares as 'z', so sorts
+  // after '_', unlike in a case-sensitive comparison).
+  EXPECT_LT(strings::compareIgnoreCase("_", "Z"), 0);
+  EXPECT_LT(strings::compareIgnoreCase("z", "\x80"), 0);
+}
+
+
+TEST(strings, startsWithIgnoreCase) {
+  EXPECT_TRUE(strings::startsWithIgnoreCase("Awesome", ""));
+  EXPECT_TRUE(strings::startsWithIgnoreCase("Awesome", "aWE"));
+  EXPECT_TRUE(strings::startsWithIgnoreCase("Awesome", "AWESOME"));
+  EXPECT_FALSE(strings::startsWithIgnoreCase("Awesome", "awesome!"));
+  EXPECT_FALSE(strings::startsWithIgnoreCase("Awesome", "some"));
+}
+
+
+TEST(strings, ignoreCase_matchesLowerCaseForAllBytes) {
+  string allBytes;
+  for (int c = 0; c < 256; ++c) {
+    allBytes += static_cast<char>(c);
+  }
+
+  // Covers short strings, whole words, and overlapping last words.
+  for (std::size_t start = 0; start < 256; start += 9) {
+    for (std::size_t length = 0; length <= 24; ++length) {
+      const string str = allBytes.substr(start, length);
+      const string upper = strings::toUpperCase(str);
+      const string lower = strings::toLowerCase(str);
+      ASSERT_TRUE(strings::equalsIgnoreCase(upper, lower)) << str;
+      ASSERT_EQ(0, strings::compareIgnoreCase(upper, lower)) << str;
+      ASSERT_EQ(strings::hashIgnoreCase(upper), strings::hashIgnoreCase(lower))
+          << str;
+
+      // Changing any one byte to a different lowercase byte is a mismatch.
+      for (std::size_t i = 0; i < str.length(); ++i) {
+        string changed = lower;
+        changed[i] = (changed[i] == 'x') ? 'y' : 'x';
+        const int expected = (lower.compare(changed) < 0) ? -1 : 1;
+        ASSERT_FALSE(strings::equalsIgnoreCase(upper, changed)) << i;
+        ASSERT_EQ(expected, strings::compareIgnoreCase(upper, changed)) << i;
+        ASSERT_NE(strings::hashIgnoreCase(upper),
+                  strings::hashIgnoreCase(changed)) << i;
+      }
+    }
+  }
+}
+
+
+TEST(strings, hash) {
+  EXPECT_EQ(strings::hash("OscillatorFrequency2"),
+            strings::hash(string("OscillatorFrequency2")));
+  EXPECT_NE(strings::hash("OscillatorFrequency2"),
+            strings::hash("oscillatorFrequency2"));
+  EXPECT_NE(strings::hash("Gain"), strings::hash("Gain "));
+  EXPECT_NE(strings::hash(""), strings::hash(StringRef("\0", 1)));
+}
+
+
+TEST(strings, hashIgnoreCase) {
+  EXPECT_EQ(strings::hashIgnoreCase("OscillatorFrequency2"),
+            strings::hashIgnoreCase("oscillatorFREQUENCY2"));
+  EXPECT_NE(strings::hashIgnoreCase("OscillatorFrequency2"),
+            strings::hashIgnoreCase("OscillatorFrequency3"));
+  EXPECT_NE(strings::hashIgnoreCase(""), strings::hashIgnoreCase(StringRef(
+      "\0", 1)));
+
+  std::unordered_map<string, int, strings::IgnoreCaseHash,
+                     strings::IgnoreCaseEqual> params;
+  params["Gain"] = 1;
+  params["CutoffFrequency"] = 2;
+  EXPECT_EQ(1, params.at("GAIN"));
+  EXPECT_EQ(2, params.at("cutoffFrequency"));
+  params["gain"] = 3;
+  EXPECT_EQ(2u, params.size());
+  EXPECT_EQ(3, params.at("Gain"));
+  EXPECT_EQ(0u, params.count("Resonance"));
+}
+
+
 TEST(strings, trimWhitespace) {
   EXPECT_EQ("abcdefghijklmnop",
             strings::trimWhitespace(" \t abcdefghijklmnop \t "));
@@ -136,6 +260,93 @@ TEST(strings, trimWhitespace_locale) {
 }
 
 
+TEST(strings, trimWhitespace_returnsView) {
+  const char buffer[] = "  key = value  \n";
+  StringRef trimmed = strings::trimWhitespace(buffer);
+  EXPECT_EQ("key = value", trimmed);
+  EXPECT_EQ(buffer + 2, trimmed.data());
+
+  // Trims only within the given view, even if not null-terminated.
+  StringRef value = strings::trimWhitespace(StringRef(buffer + 7, 7));
+  EXPECT_EQ("value", value);
+  EXPECT_EQ(buffer + 8, value.data());
+
+  EXPECT_TRUE(strings::trimWhitespace(StringRef(buffer, 2)).empty());
+  EXPECT_EQ("key = value", strings::trimWhitespace(buffer, locale()));
+  EXPECT_EQ(buffer + 2, strings::trimWhitespace(buffer, locale()).data());
+}
+
+
+TEST(strings, stringRefArguments) {
+  const char buffer[] = "# comment\nname = value";
+  StringRef firstLine(buffer, 9);
+  StringRef secondLine(buffer + 10);
+
+  EXPECT_TRUE(strings::startsWith(firstLine, "#"));
+  EXPECT_FALSE(strings::startsWith(secondLine, "#"));
+  EXPECT_TRUE(strings::endsWith(firstLine, "comment"));
+  EXPECT_FALSE(strings::endsWith(firstLine, "value"));
+  EXPECT_TRUE(strings::endsWith(secondLine, string("value")));
+  EXPECT_FALSE(strings::startsWith(StringRef(buffer, 1), "# "));
+  EXPECT_TRUE(strings::isEmptyOrWhitespace(StringRef(buffer + 1, 1)));
+  EXPECT_FALSE(strings::isEmptyOrWhitespace(firstLine));
+  EXPECT_EQ("# COMMENT", strings::toUpperCase(firstLine));
+  EXPECT_TRUE(strings::isAscii(secondLine));
+  EXPECT_FALSE(strings::hasControlCharacters(firstLine));
+  EXPECT_TRUE(strings::hasControlCharacters(StringRef(buffer, 10)));
+}
+
+
+/** Reference trim, scanning one char at a time with std::isspace(). */
+string trimWhitespaceByChar(const string& str) {
+  std::size_t begin = 0;
+  while ((begin < str.length()) && std::isspace(str[begin])) {
+    ++begin;
+  }
+  std::size_t end = str.length();
+  while ((end > begin) && std::isspace(str[end - 1])) {
+    --end;
+  }
+  return str.substr(begin, end - begin);
+}
+
+
+TEST(strings, whitespaceScanning_matchesIsspace) {
+  // Mostly whitespace, so that runs cross 32-byte blocks, plus every other
+  // byte value (including non-ASCII) now and then.
+  const string whitespace = " \t\n\v\f\r";
+  uint32 random = 12345;
+  for (int trial = 0; trial < 2000; ++trial) {
+    string str;
+    const std::size_t length = trial % 150;
+    for (std::size_t i = 0; i < length; ++i) {
+      random = random * 1103515245u + 12345u;
+      const uint32 choice = (random >> 16) % 64;
+      str += (choice < 60) ? whitespace[choice % whitespace.length()]
+                           : static_cast<char>((random >> 8) & 0xFF);
+    }
+
+    const string expected = trimWhitespaceByChar(str);
+    ASSERT_EQ(expected, strings::trimWhitespace(StringRef(str)))
+        << "trial " << trial;
+    ASSERT_EQ(expected, strings::trimWhitespace(str)) << "trial " << trial;
+    ASSERT_EQ(expected.empty(), strings::isEmptyOrWhitespace(str))
+        << "trial " << trial;
+  }
+
+  // Every single byte value, alone and surrounded by long whitespace runs.
+  const string padding(70, ' ');
+  for (int c = 0; c < 256; ++c) {
+    const string single(1, static_cast<char>(c));
+    EXPECT_EQ(trimWhitespaceByChar(single), strings::trimWhitespace(single));
+    const string padded = padding + single + padding;
+    EXPECT_EQ(trimWhitespaceByChar(padded), strings::trimWhitespace(padded));
+    EXPECT_EQ(trimWhitespaceByChar(padded).empty(),
+              strings::isEmptyOrWhitespace(padded));
+  }
+}
+
+
 TEST(strings, toLowerCase) {
   string str = "tO lOWeRCase";
   EXPECT_EQ("to lowercase", strings::toLowerCase(str));
@@ -166,4 +377,758 @@ TEST(strings, toUpperCase_locale) {
 }
 
 
+TEST(strings, caseConversion_matchesStdForAllBytes) {
+  // Long enough to use the 32-byte, 8-byte, and one-at-a-time paths.
+  string allBytes;
+  for (int repeat = 0; repeat < 2; ++repeat) {
+    for (int c = 0; c < 256; ++c) {
+      allBytes += static_cast<char>(c);
+    }
+  }
+
+  for (std::size_t start = 0; start < 40; ++start) {
+    const string str = allBytes.substr(start);
+    string expectedLower = str;
+    string expectedUpper = str;
+    for (std::size_t i = 0; i < str.length(); ++i) {
+      expectedLower[i] = static_cast<char>(std::tolower(str[i]));
+      expectedUpper[i] = static_cast<char>(std::toupper(str[i]));
+    }
+    ASSERT_EQ(expectedLower, strings::toLowerCase(str)) << "start " << start;
+    ASSERT_EQ(expectedUpper, strings::toUpperCase(str)) << "start " << start;
+  }
+}
+
+
+TEST(strings, toLowerCaseInPlaceAndInto) {
+  string str = "MIXED Case Text, Long Enough For Whole Blocks: ABCXYZ@[`{";
+  const string expected =
+      "mixed case text, long enough for whole blocks: abcxyz@[`{";
+
+  char buffer[64] = {};
+  strings::toLowerCaseInto(str, buffer);
+  EXPECT_EQ(expected, string(buffer, str.length()));
+
+  strings::toLowerCaseInPlace(str);
+  EXPECT_EQ(expected, str);
+
+  string empty;
+  strings::toLowerCaseInPlace(empty);
+  EXPECT_EQ("", empty);
+}
+
+
+TEST(strings, toUpperCaseInPlaceAndInto) {
+  string str = "mixed Case text, long enough for whole blocks: abcxyz@[`{";
+  const string expected =
+      "MIXED CASE TEXT, LONG ENOUGH FOR WHOLE BLOCKS: ABCXYZ@[`{";
+
+  char buffer[64] = {};
+  strings::toUpperCaseInto(str, buffer);
+  EXPECT_EQ(expected, string(buffer, str.length()));
+
+  strings::toUpperCaseInPlace(str);
+  EXPECT_EQ(expected, str);
+
+  // Converting a view in place only touches the viewed chars.
+  char chars[] = "abc def";
+  strings::toUpperCaseInto(StringRef(chars, 3), chars);
+  EXPECT_EQ("ABC def", string(chars));
+}
+
+
+TEST(strings, toLowerCaseUtf8) {
+  EXPECT_EQ("", strings::toLowerCaseUtf8(""));
+  EXPECT_EQ("plain ascii @[`{", strings::toLowerCaseUtf8("Plain ASCII @[`{"));
+  EXPECT_EQ("\xC3\xA0\xC3\xA9\xC3\xBC",  // àéü
+            strings::toLowerCaseUtf8("\xC3\x80\xC3\x89\xC3\x9C"));  // ÀÉÜ
+  EXPECT_EQ("\xD0\xBF\xD1\x80\xD0\xB8",  // при
+            strings::toLowerCaseUtf8("\xD0\x9F\xD0\xA0\xD0\x98"));  // ПРИ
+  EXPECT_EQ("\xF0\x90\x90\xA8",  // U+10428
+            strings::toLowerCaseUtf8("\xF0\x90\x90\x80"));  // U+10400
+  EXPECT_EQ("\xE9\x9F\xB3\xE6\xA5\xBD",  // CJK is unchanged.
+            strings::toLowerCaseUtf8("\xE9\x9F\xB3\xE6\xA5\xBD"));
+  EXPECT_EQ("i", strings::toLowerCaseUtf8("\xC4\xB0"));  // U+0130
+
+  // Mappings can shrink or grow the UTF-8 length.
+  EXPECT_EQ("k", strings::toLowerCaseUtf8("\xE2\x84\xAA"));  // Kelvin sign.
+  EXPECT_EQ("\xE2\xB1\xA5\xE2\xB1\xA5",  // U+2C65 U+2C65
+            strings::toLowerCaseUtf8("\xC8\xBA\xC8\xBA"));  // U+023A U+023A
+
+  // Invalid bytes are left alone.
+  EXPECT_EQ("a\xFF" "b\xC3", strings::toLowerCaseUtf8("A\xFF" "B\xC3"));
+  EXPECT_EQ("\xC0\xAF", strings::toLowerCaseUtf8("\xC0\xAF"));
+
+  // A non-ASCII letter at every position of a string with 32-byte blocks.
+  const string ascii = "Preset Names Long Enough For Whole Blocks, ABC XYZ";
+  for (std::size_t i = 0; i <= ascii.length(); ++i) {
+    const string str = ascii.substr(0, i) + "\xC3\x89" + ascii.substr(i);
+    EXPECT_EQ(strings::toLowerCase(ascii.substr(0, i)) + "\xC3\xA9"
+                  + strings::toLowerCase(ascii.substr(i)),
+              strings::toLowerCaseUtf8(str)) << "at index " << i;
+  }
+}
+
+
+TEST(strings, caseMappingsKeepOneValidCodePoint) {
+  // Encode every code point (skipping surrogates), and map it both ways.
+  for (uint32 codePoint = 0x80; codePoint <= 0x10FFFF; ++codePoint) {
+    if ((codePoint >= 0xD800) && (codePoint <= 0xDFFF)) {
+      continue;
+    }
+    char utf8[4];
+    std::size_t length;
+    if (codePoint < 0x800) {
+      utf8[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+      length = 2;
+    } else if (codePoint < 0x10000) {
+      utf8[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+      utf8[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+      length = 3;
+    } else {
+      utf8[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+      utf8[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+      utf8[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+      length = 4;
+    }
+    utf8[length - 1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    const StringRef str(utf8, length);
+
+    const string lower = strings::toLowerCaseUtf8(str);
+    const string folded = strings::foldCase(str);
+    ASSERT_TRUE(strings::isValidUtf8(lower)) << std::hex << codePoint;
+    ASSERT_EQ(1u, strings::countCodePoints(lower)) << std::hex << codePoint;
+    ASSERT_TRUE(strings::isValidUtf8(folded)) << std::hex << codePoint;
+    ASSERT_EQ(1u, strings::countCodePoints(folded)) << std::hex << codePoint;
+  }
+}
+
+
+TEST(strings, foldCase) {
+  EXPECT_EQ("mixed case", strings::foldCase("MiXeD CaSe"));
+
+  // Final sigma and the micro sign fold, but don't lowercase.
+  EXPECT_EQ("\xCF\x83", strings::foldCase("\xCF\x82"));  // ς -> σ
+  EXPECT_EQ("\xCF\x82", strings::toLowerCaseUtf8("\xCF\x82"));
+  EXPECT_EQ("\xCE\xBC", strings::foldCase("\xC2\xB5"));  // µ -> μ
+  EXPECT_EQ("\xC2\xB5", strings::toLowerCaseUtf8("\xC2\xB5"));
+
+  // Simple folding maps one code point to one: U+1E9E -> ß, but ß -> ß.
+  EXPECT_EQ("\xC3\x9F", strings::foldCase("\xE1\xBA\x9E"));
+  EXPECT_EQ("\xC3\x9F", strings::foldCase("\xC3\x9F"));
+  EXPECT_EQ("\xC4\xB0", strings::foldCase("\xC4\xB0"));  // U+0130
+
+  // ΟΔΥΣΣΕΥΣ and οδυσσευς compare equal once folded.
+  EXPECT_EQ(
+      strings::foldCase("\xCE\x9F\xCE\x94\xCE\xA5\xCE\xA3\xCE\xA3\xCE\x95"
+                        "\xCE\xA5\xCE\xA3"),
+      strings::foldCase("\xCE\xBF\xCE\xB4\xCF\x85\xCF\x83\xCF\x83\xCE\xB5"
+                        "\xCF\x85\xCF\x82"));
+}
+
+
+TEST(strings, trimUnicodeWhitespace) {
+  EXPECT_EQ("", strings::trimUnicodeWhitespace(""));
+  EXPECT_EQ("", strings::trimUnicodeWhitespace(" \t\xC2\xA0\xE3\x80\x80\n"));
+  EXPECT_EQ("text", strings::trimUnicodeWhitespace(" text\t"));
+  EXPECT_EQ("\xE6\x96\x87 \xE5\xAD\x97",  // Inner whitespace is kept.
+            strings::trimUnicodeWhitespace(
+                "\xE3\x80\x80\xC2\xA0\xE6\x96\x87 \xE5\xAD\x97\xE2\x80\x83"
+                "\xE2\x80\xA8\xC2\x85"));
+
+  // U+200B zero width space isn't White_Space; invalid bytes aren't either.
+  EXPECT_EQ("\xE2\x80\x8B" "x", strings::trimUnicodeWhitespace(
+      "\xE2\x80\x8B" "x "));
+  EXPECT_EQ("\xA0" "x\xC2", strings::trimUnicodeWhitespace("\xA0" "x\xC2"));
+  EXPECT_EQ("x\xA0", strings::trimUnicodeWhitespace("x\xA0 "));
+
+  // Long runs of ASCII whitespace on each side, then Unicode whitespace.
+  const string padding(70, ' ');
+  EXPECT_EQ("value", strings::trimUnicodeWhitespace(
+      padding + "\xE3\x80\x80" + padding + "value" + padding + "\xC2\xA0"
+      + padding));
+
+  string str = "\xC2\xA0owned\xC2\xA0";
+  EXPECT_EQ("owned", strings::trimUnicodeWhitespace(str));
+}
+
+
+TEST(strings, arenaOverloads) {
+  StringArena arena;
+  string input = "  Mixed Case  ";
+  StringRef trimmed = strings::trimWhitespace(input, arena);
+  StringRef lower = strings::toLowerCase(strings::trimWhitespace(input), arena);
+  StringRef upper = strings::toUpperCase(input, arena);
+  input.assign("overwritten");
+
+  EXPECT_EQ("Mixed Case", trimmed);
+  EXPECT_EQ("mixed case", lower);
+  EXPECT_EQ("  MIXED CASE  ", upper);
+  EXPECT_EQ(34u, arena.numBytesUsed());
+  EXPECT_EQ("", strings::toLowerCase("", arena));
+}
+
+
+TEST(strings, batchTransforms) {
+  const std::vector<string> inputs = {
+      " Alpha ", "BETA", "", "\tgamma Delta\n",
+      "A Long Enough Input To Cover Whole 32-Byte Blocks"};
+  StringArena arena;
+
+  std::vector<StringRef> lower;
+  strings::toLowerCaseAll(inputs.begin(), inputs.end(), arena,
+                          std::back_inserter(lower));
+  ASSERT_EQ(inputs.size(), lower.size());
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    EXPECT_EQ(strings::toLowerCase(inputs[i]), lower[i]);
+  }
+
+  StringRef upper[5];
+  StringRef* upperEnd =
+      strings::toUpperCaseAll(inputs.begin(), inputs.end(), arena, upper);
+  EXPECT_EQ(upper + 5, upperEnd);
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    EXPECT_EQ(strings::toUpperCase(inputs[i]), upper[i]);
+  }
+
+  const char* const rawInputs[] = {"  a  ", "b", "\t\n"};
+  std::vector<StringRef> trimmed;
+  strings::trimWhitespaceAll(std::begin(rawInputs), std::end(rawInputs),
+                             arena, std::back_inserter(trimmed));
+  ASSERT_EQ(3u, trimmed.size());
+  EXPECT_EQ("a", trimmed[0]);
+  EXPECT_EQ("b", trimmed[1]);
+  EXPECT_EQ("", trimmed[2]);
+
+  // All results share one arena block.
+  EXPECT_EQ(1u, arena.numBlocks());
+}
+
+
+TEST(strings, isAscii) {
+  EXPECT_TRUE(strings::isAscii(""));
+  EXPECT_TRUE(strings::isAscii("plain ASCII, with punctuation!"));
+  EXPECT_TRUE(strings::isAscii(string(100, '~')));
+  EXPECT_FALSE(strings::isAscii("caf\xC3\xA9"));
+
+  // Non-ASCII bytes anywhere within long strings (both the 32-byte blocks and
+  // the leftover bytes at the end).
+  for (std::size_t i = 0; i < 70; ++i) {
+    string str(70, 'a');
+    str[i] = '\x80';
+    EXPECT_FALSE(strings::isAscii(str)) << "at index " << i;
+  }
+}
+
+
+TEST(strings, hasControlCharacters) {
+  EXPECT_FALSE(strings::hasControlCharacters(""));
+  EXPECT_FALSE(strings::hasControlCharacters("No controls here ~"));
+  EXPECT_FALSE(strings::hasControlCharacters("caf\xC3\xA9 \xFF\x80"));
+  EXPECT_TRUE(strings::hasControlCharacters("tab\there"));
+  EXPECT_TRUE(strings::hasControlCharacters("line\n"));
+  EXPECT_TRUE(strings::hasControlCharacters(string("nul\0", 4)));
+
+  for (std::size_t i = 0; i < 20; ++i) {
+    string str(20, ' ');
+    str[i] = '\x7F';
+    EXPECT_TRUE(strings::hasControlCharacters(str)) << "at index " << i;
+    str[i] = '\x1F';
+    EXPECT_TRUE(strings::hasControlCharacters(str)) << "at index " << i;
+  }
+}
+
+
+TEST(strings, isValidUtf8) {
+  EXPECT_TRUE(strings::isValidUtf8(""));
+  EXPECT_TRUE(strings::isValidUtf8("ASCII is valid UTF-8"));
+  EXPECT_TRUE(strings::isValidUtf8("caf\xC3\xA9"));  // U+00E9
+  EXPECT_TRUE(strings::isValidUtf8("\xE2\x82\xAC"));  // U+20AC
+  EXPECT_TRUE(strings::isValidUtf8("\xF0\x9D\x84\x9E"));  // U+1D11E
+  EXPECT_TRUE(strings::isValidUtf8("\xF4\x8F\xBF\xBF"));  // U+10FFFF
+  EXPECT_TRUE(strings::isValidUtf8(
+      "A long ASCII run before a multi-byte \xE2\x99\xAB character"));
+
+  EXPECT_FALSE(strings::isValidUtf8("\x80"));  // Lone continuation byte.
+  EXPECT_FALSE(strings::isValidUtf8("caf\xC3"));  // Truncated.
+  EXPECT_FALSE(strings::isValidUtf8("\xC3("));  // Bad continuation byte.
+  EXPECT_FALSE(strings::isValidUtf8("\xC0\xAF"));  // Overlong '/'.
+  EXPECT_FALSE(strings::isValidUtf8("\xE0\x80\xAF"));  // Overlong '/'.
+  EXPECT_FALSE(strings::isValidUtf8("\xED\xA0\x80"));  // Surrogate U+D800.
+  EXPECT_FALSE(strings::isValidUtf8("\xF4\x90\x80\x80"));  // > U+10FFFF.
+  EXPECT_FALSE(strings::isValidUtf8("\xFF"));
+  EXPECT_FALSE(strings::isValidUtf8(
+      "A long ASCII run before a truncated character \xE2\x99"));
+}
+
+
+TEST(strings, countCodePoints) {
+  EXPECT_EQ(0u, strings::countCodePoints(""));
+  EXPECT_EQ(5u, strings::countCodePoints("ascii"));
+  EXPECT_EQ(4u, strings::countCodePoints("caf\xC3\xA9"));
+  EXPECT_EQ(3u, strings::countCodePoints("\xE2\x82\xAC\xF0\x9D\x84\x9Ez"));
+  EXPECT_EQ(20u, strings::countCodePoints(
+      "\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9"
+      "\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9" "abcdefghij"));
+}
+
+
+/** Collects the fields of a SplitRange, for comparison. */
+std::vector<string> fieldsOf(const strings::SplitRange& fields) {
+  std::vector<string> strs;
+  for (StringRef field : fields) {
+    strs.push_back(field.toString());
+  }
+  return strs;
+}
+
+
+/** Returns value formatted by strings::formatInt(T, char*). */
+template<typename T>
+string formatInt(T value) {
+  char buffer[strings::MAX_INT_CHARS];
+  return string(buffer, strings::formatInt(value, buffer));
+}
+
+
+/** Returns value formatted by strings::formatFloat(T, char*). */
+template<typename T>
+string formatFloat(T value) {
+  char buffer[strings::MAX_FLOAT_CHARS];
+  return string(buffer, strings::formatFloat(value, buffer));
+}
+
+
+/** Returns the number of significant digits in a formatFloat() result. */
+std::size_t countSignificantDigits(const string& str) {
+  string digits;
+  for (char c : str.substr(0, str.find('e'))) {
+    if (std::isdigit(c) && (!digits.empty() || (c != '0'))) {
+      digits += c;
+    }
+  }
+  while ((digits.length() > 1) && (digits.back() == '0')) {
+    digits.pop_back();
+  }
+  return digits.length();
+}
+
+
+/**
+ * Checks that formatFloat(value) parses back as value, with no more digits
+ * than the shortest std::snprintf("%.*e") that does.
+ */
+template<typename T>
+void expectShortestRoundTrip(T value) {
+  const string str = formatFloat(value);
+  ASSERT_EQ(value, strings::parseFloat<T>(str).value()) << str;
+  char buffer[64];
+  int precision = 0;
+  for (; precision < 17; ++precision) {
+    std::snprintf(buffer, sizeof(buffer), "%.*e", precision,
+                  static_cast<double>(value));
+    if (static_cast<T>(std::strtod(buffer, nullptr)) == value) {
+      break;
+    }
+  }
+  ASSERT_LE(countSignificantDigits(str),
+            static_cast<std::size_t>(precision) + 1) << str;
+}
+
+
+TEST(strings, parseInt) {
+  EXPECT_EQ(0, strings::parseInt<int32>("0").value());
+  EXPECT_EQ(42, strings::parseInt<int32>("42").value());
+  EXPECT_EQ(-42, strings::parseInt<int32>("-42").value());
+  EXPECT_EQ(42, strings::parseInt<int32>("+42").value());
+  EXPECT_EQ(7, strings::parseInt<int32>("0000000000000000000000007").value());
+  EXPECT_EQ(1234567890123456789LL,
+            strings::parseInt<int64>("1234567890123456789").value());
+
+  EXPECT_FALSE(strings::parseInt<int32>("").hasValue());
+  EXPECT_FALSE(strings::parseInt<int32>("-").hasValue());
+  EXPECT_FALSE(strings::parseInt<int32>(" 42").hasValue());
+  EXPECT_FALSE(strings::parseInt<int32>("42 ").hasValue());
+  EXPECT_FALSE(strings::parseInt<int32>("4 2").hasValue());
+  EXPECT_FALSE(strings::parseInt<int32>("0x2A").hasValue());
+  EXPECT_FALSE(strings::parseInt<int32>("42.0").hasValue());
+  EXPECT_FALSE(strings::parseInt<int32>("--42").hasValue());
+  EXPECT_FALSE(strings::parseInt<int32>("1234567a").hasValue());
+  EXPECT_FALSE(strings::parseInt<int64>("12345678901234567a").hasValue());
+  EXPECT_FALSE(strings::parseInt<uint32>("-1").hasValue());
+  EXPECT_FALSE(strings::parseInt<uint32>("-0").hasValue());
+}
+
+
+TEST(strings, parseInt_ranges) {
+  EXPECT_EQ(-128, strings::parseInt<int8>("-128").value());
+  EXPECT_EQ(127, strings::parseInt<int8>("127").value());
+  EXPECT_FALSE(strings::parseInt<int8>("-129").hasValue());
+  EXPECT_FALSE(strings::parseInt<int8>("128").hasValue());
+  EXPECT_EQ(255u, strings::parseInt<uint8>("255").value());
+  EXPECT_FALSE(strings::parseInt<uint8>("256").hasValue());
+
+  EXPECT_EQ(-32768, strings::parseInt<int16>("-32768").value());
+  EXPECT_FALSE(strings::parseInt<int16>("32768").hasValue());
+  EXPECT_EQ(65535u, strings::parseInt<uint16>("65535").value());
+  EXPECT_FALSE(strings::parseInt<uint16>("65536").hasValue());
+
+  EXPECT_EQ(std::numeric_limits<int32>::min(),
+            strings::parseInt<int32>("-2147483648").value());
+  EXPECT_EQ(2147483647, strings::parseInt<int32>("2147483647").value());
+  EXPECT_FALSE(strings::parseInt<int32>("2147483648").hasValue());
+  EXPECT_FALSE(strings::parseInt<int32>("-2147483649").hasValue());
+  EXPECT_EQ(4294967295u, strings::parseInt<uint32>("4294967295").value());
+  EXPECT_FALSE(strings::parseInt<uint32>("4294967296").hasValue());
+
+  EXPECT_EQ(std::numeric_limits<int64>::min(),
+            strings::parseInt<int64>("-9223372036854775808").value());
+  EXPECT_EQ(std::numeric_limits<int64>::max(),
+            strings::parseInt<int64>("9223372036854775807").value());
+  EXPECT_FALSE(strings::parseInt<int64>("9223372036854775808").hasValue());
+  EXPECT_EQ(std::numeric_limits<uint64>::max(),
+            strings::parseInt<uint64>("18446744073709551615").value());
+  EXPECT_FALSE(strings::parseInt<uint64>("18446744073709551616").hasValue());
+  EXPECT_FALSE(strings::parseInt<uint64>("18446744073709551620").hasValue());
+  EXPECT_FALSE(strings::parseInt<uint64>("99999999999999999999").hasValue());
+  EXPECT_FALSE(strings::parseInt<uint64>("100000000000000000000").hasValue());
+}
+
+
+TEST(strings, parseInt_roundTrips) {
+  std::mt19937_64 random(42);
+  for (int i = 0; i < 20000; ++i) {
+    // Vary the length, so every mix of 8-digit & single-digit steps is used.
+    const uint64 value = random() >> (random() % 64);
+    const string str = std::to_string(value);
+    ASSERT_EQ(value, strings::parseInt<uint64>(str).value()) << str;
+    const int64 negated = -static_cast<int64>(value >> 1);
+    ASSERT_EQ(negated, strings::parseInt<int64>(std::to_string(negated))
+                           .value());
+
+    // Any non-digit in any position is rejected.
+    string corrupted = str;
+    corrupted[random() % str.length()] = "/:a. "[random() % 5];
+    ASSERT_FALSE(strings::parseInt<uint64>(corrupted).hasValue())
+        << corrupted;
+  }
+}
+
+
+TEST(strings, parseFloat) {
+  EXPECT_EQ(0.0, strings::parseFloat<double>("0").value());
+  EXPECT_EQ(1.5, strings::parseFloat<double>("1.5").value());
+  EXPECT_EQ(-1.5e-3, strings::parseFloat<double>("-1.5e-3").value());
+  EXPECT_EQ(1.5e3, strings::parseFloat<double>("+1.5E+3").value());
+  EXPECT_EQ(0.5, strings::parseFloat<double>(".5").value());
+  EXPECT_EQ(5.0, strings::parseFloat<double>("5.").value());
+  EXPECT_EQ(0.1, strings::parseFloat<double>("0.1").value());
+  EXPECT_EQ(0.1f, strings::parseFloat<float>("0.1").value());
+  EXPECT_EQ(440.0f, strings::parseFloat<float>("440").value());
+  EXPECT_TRUE(std::signbit(strings::parseFloat<double>("-0.0").value()));
+
+  EXPECT_FALSE(strings::parseFloat<double>("").hasValue());
+  EXPECT_FALSE(strings::parseFloat<double>(".").hasValue());
+  EXPECT_FALSE(strings::parseFloat<double>("-").hasValue());
+  EXPECT_FALSE(strings::parseFloat<double>("1e").hasValue());
+  EXPECT_FALSE(strings::parseFloat<double>("1e+").hasValue());
+  EXPECT_FALSE(strings::parseFloat<double>("e5").hasValue());
+  EXPECT_FALSE(strings::parseFloat<double>(" 1.5").hasValue());
+  EXPECT_FALSE(strings::parseFloat<double>("1.5 ").hasValue());
+  EXPECT_FALSE(strings::parseFloat<double>("1,5").hasValue());
+  EXPECT_FALSE(strings::parseFloat<double>("1.2.3").hasValue());
+  EXPECT_FALSE(strings::parseFloat<double>("0x1p3").hasValue());
+  EXPECT_FALSE(strings::parseFloat<double>("inf").hasValue());
+  EXPECT_FALSE(strings::parseFloat<double>("nan").hasValue());
+}
+
+
+TEST(strings, parseFloat_limits) {
+  EXPECT_EQ(std::numeric_limits<double>::max(),
+            strings::parseFloat<double>("1.7976931348623157e308").value());
+  EXPECT_FALSE(strings::parseFloat<double>("1.8e308").hasValue());
+  EXPECT_FALSE(strings::parseFloat<double>("-1e400").hasValue());
+  EXPECT_EQ(std::numeric_limits<double>::denorm_min(),
+            strings::parseFloat<double>("4.9406564584124654e-324").value());
+  EXPECT_EQ(0.0, strings::parseFloat<double>("1e-400").value());
+  EXPECT_EQ(0.0, strings::parseFloat<double>("0e999999999").value());
+
+  EXPECT_EQ(std::numeric_limits<float>::max(),
+            strings::parseFloat<float>("3.4028235e38").value());
+  EXPECT_FALSE(strings::parseFloat<float>("3.5e38").hasValue());
+  EXPECT_EQ(std::numeric_limits<float>::denorm_min(),
+            strings::parseFloat<float>("1.4e-45").value());
+  EXPECT_EQ(0.0f, strings::parseFloat<float>("1e-50").value());
+
+  // Long inputs only need their first 19 digits, unless they're this close to
+  // halfway between two doubles (2^53 + 1, plus a tiny bit).
+  EXPECT_EQ(1.0 / 3, strings::parseFloat<double>(
+      "0.333333333333333333333333333333333333333333").value());
+  EXPECT_EQ(9007199254740994.0, strings::parseFloat<double>(
+      "9007199254740993.00000000000000000001").value());
+  EXPECT_EQ(9007199254740992.0, strings::parseFloat<double>(
+      "9007199254740993.00000000000000000000").value());
+}
+
+
+TEST(strings, parseFloat_matchesStrtod) {
+  // The test runs in the "C" locale, where strtod() is also exact.
+  std::mt19937_64 random(42);
+  char buffer[64];
+  for (int i = 0; i < 20000; ++i) {
+    const uint64 bits = random();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    if (!std::isfinite(value)) {
+      continue;
+    }
+    const int precision = static_cast<int>(random() % 18) + 1;
+    std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+    ASSERT_EQ(std::strtod(buffer, nullptr),
+              strings::parseFloat<double>(buffer).value()) << buffer;
+    const float expectedFloat = std::strtof(buffer, nullptr);
+    if (std::isinf(expectedFloat)) {
+      ASSERT_FALSE(strings::parseFloat<float>(buffer).hasValue()) << buffer;
+    } else {
+      ASSERT_EQ(expectedFloat, strings::parseFloat<float>(buffer).value())
+          << buffer;
+    }
+  }
+}
+
+
+TEST(strings, formatInt) {
+  EXPECT_EQ("0", formatInt<int32>(0));
+  EXPECT_EQ("7", formatInt<int32>(7));
+  EXPECT_EQ("-7", formatInt<int32>(-7));
+  EXPECT_EQ("10", formatInt<int32>(10));
+  EXPECT_EQ("99", formatInt<int32>(99));
+  EXPECT_EQ("100", formatInt<int32>(100));
+  EXPECT_EQ("-128", formatInt<int8>(-128));
+  EXPECT_EQ("255", formatInt<uint8>(255));
+  EXPECT_EQ("-32768", formatInt<int16>(-32768));
+  EXPECT_EQ("65535", formatInt<uint16>(65535));
+  EXPECT_EQ("-2147483648",
+            formatInt<int32>(std::numeric_limits<int32>::min()));
+  EXPECT_EQ("4294967295", formatInt<uint32>(4294967295u));
+  EXPECT_EQ("-9223372036854775808",
+            formatInt<int64>(std::numeric_limits<int64>::min()));
+  EXPECT_EQ("9223372036854775807",
+            formatInt<int64>(std::numeric_limits<int64>::max()));
+  EXPECT_EQ("18446744073709551615",
+            formatInt<uint64>(std::numeric_limits<uint64>::max()));
+
+  string appended = "x = ";
+  strings::formatInt<int32>(-42, appended);
+  EXPECT_EQ("x = -42", appended);
+}
+
+
+TEST(strings, formatInt_matchesToString) {
+  std::mt19937_64 random(42);
+  for (int i = 0; i < 20000; ++i) {
+    // Vary the length, so every number of digits is used.
+    const uint64 value = random() >> (random() % 64);
+    ASSERT_EQ(std::to_string(value), formatInt(value));
+    const int64 negated = -static_cast<int64>(value >> 1);
+    ASSERT_EQ(std::to_string(negated), formatInt(negated));
+    ASSERT_EQ(std::to_string(static_cast<int32>(value)),
+              formatInt(static_cast<int32>(value)));
+  }
+}
+
+
+TEST(strings, formatFloat) {
+  EXPECT_EQ("0", formatFloat(0.0));
+  EXPECT_EQ("-0", formatFloat(-0.0));
+  EXPECT_EQ("1", formatFloat(1.0));
+  EXPECT_EQ("-2.5", formatFloat(-2.5));
+  EXPECT_EQ("0.1", formatFloat(0.1));
+  EXPECT_EQ("0.3", formatFloat(0.3));
+  EXPECT_EQ("0.30000000000000004", formatFloat(0.1 + 0.2));
+  EXPECT_EQ("1234567", formatFloat(1234567.0));
+  EXPECT_EQ("123.456", formatFloat(123.456));
+  EXPECT_EQ("0.1", formatFloat(0.1f));
+  EXPECT_EQ("440", formatFloat(440.0f));
+  EXPECT_EQ("16777216", formatFloat(16777216.0f));
+
+  // Positional notation as long as the point is within 21 digits.
+  EXPECT_EQ("100000000000000000000", formatFloat(1e20));
+  EXPECT_EQ("123456789012345680000", formatFloat(123456789012345678901.0));
+  EXPECT_EQ("1e+21", formatFloat(1e21));
+  EXPECT_EQ("0.000001", formatFloat(1e-6));
+  EXPECT_EQ("0.0000012345", formatFloat(1.2345e-6));
+  EXPECT_EQ("1e-7", formatFloat(1e-7));
+  EXPECT_EQ("1.5e-7", formatFloat(1.5e-7));
+  EXPECT_EQ("-1.5e+300", formatFloat(-1.5e300));
+
+  EXPECT_EQ("1.7976931348623157e+308",
+            formatFloat(std::numeric_limits<double>::max()));
+  EXPECT_EQ("2.2250738585072014e-308",
+            formatFloat(std::numeric_limits<double>::min()));
+  EXPECT_EQ("5e-324", formatFloat(std::numeric_limits<double>::denorm_min()));
+  EXPECT_EQ("3.4028235e+38", formatFloat(std::numeric_limits<float>::max()));
+  EXPECT_EQ("1e-45", formatFloat(std::numeric_limits<float>::denorm_min()));
+  EXPECT_EQ("inf", formatFloat(std::numeric_limits<double>::infinity()));
+  EXPECT_EQ("-inf", formatFloat(-std::numeric_limits<float>::infinity()));
+  EXPECT_EQ("nan", formatFloat(std::numeric_limits<double>::quiet_NaN()));
+
+  // The longest possible result.
+  EXPECT_EQ(strings::MAX_FLOAT_CHARS,
+            formatFloat(-0.0000012345678901234567).length());
+
+  string appended = "x = ";
+  strings::formatFloat(0.5, appended);
+  EXPECT_EQ("x = 0.5", appended);
+}
+
+
+TEST(strings, formatFloat_shortestRoundTrip) {
+  std::mt19937_64 random(42);
+  for (int i = 0; i < 20000; ++i) {
+    const uint64 bits = random();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    if (std::isfinite(value)) {
+      expectShortestRoundTrip(value);
+    }
+    const uint32 floatBits = static_cast<uint32>(bits);
+    float floatValue;
+    std::memcpy(&floatValue, &floatBits, sizeof(floatValue));
+    if (std::isfinite(floatValue)) {
+      expectShortestRoundTrip(floatValue);
+    }
+  }
+
+  // Every exponent, with the mantissas at its edges (including subnormals,
+  // and powers of two, whose lower neighbor is closer).
+  for (uint64 power2 = 0; power2 < 0x7FF; ++power2) {
+    for (uint64 mantissa : {0ULL, 1ULL, 2ULL, (1ULL << 52) - 1}) {
+      const uint64 bits = (power2 << 52) | mantissa;
+      double value;
+      std::memcpy(&value, &bits, sizeof(value));
+      expectShortestRoundTrip(value);
+    }
+  }
+  for (uint32 power2 = 0; power2 < 0xFF; ++power2) {
+    for (uint32 mantissa : {0u, 1u, 2u, (1u << 23) - 1}) {
+      const uint32 bits = (power2 << 23) | mantissa;
+      float value;
+      std::memcpy(&value, &bits, sizeof(value));
+      expectShortestRoundTrip(value);
+    }
+  }
+}
+
+
+TEST(strings, formatValue) {
+  string out;
+  strings::formatValue(static_cast<uint8>(200), out);
+  out += ' ';
+  strings::formatValue(static_cast<int8>(-5), out);
+  out += ' ';
+  strings::formatValue(std::size_t(12), out);
+  out += ' ';
+  strings::formatValue(0.25f, out);
+  out += ' ';
+  strings::formatValue(0.1f, out);
+  out += ' ';
+  strings::formatValue('c', out);
+  out += ' ';
+  strings::formatValue(string("text"), out);
+  out += ' ';
+  strings::formatValue("literal", out);
+  EXPECT_EQ("200 -5 12 0.25 0.1 c text literal", out);
+}
+
+
+TEST(strings, split) {
+  using Fields = std::vector<string>;
+  EXPECT_EQ(Fields({"a", "b", "", "c"}),
+            fieldsOf(strings::split("a,b,,c", ',')));
+  EXPECT_EQ(Fields({""}), fieldsOf(strings::split("", ',')));
+  EXPECT_EQ(Fields({"", ""}), fieldsOf(strings::split(",", ',')));
+  EXPECT_EQ(Fields({"no delimiter"}),
+            fieldsOf(strings::split("no delimiter", ',')));
+  EXPECT_EQ(Fields({"a", "b", ""}), fieldsOf(strings::split("a\nb\n", '\n')));
+
+  // Fields are views into the original string.
+  const string line = "key=value";
+  strings::SplitRange fields = strings::split(line, '=');
+  strings::SplitRange::Iterator field = fields.begin();
+  EXPECT_EQ(line.data(), field->data());
+  ++field;
+  EXPECT_EQ(line.data() + 4, field->data());
+  EXPECT_EQ("value", *field);
+  ++field;
+  EXPECT_TRUE(field == fields.end());
+}
+
+
+TEST(strings, split_options) {
+  using Fields = std::vector<string>;
+  const char* const csv = " name , 42 ,, \t ,last";
+  EXPECT_EQ(Fields({"name", "42", "", "", "last"}),
+            fieldsOf(strings::split(csv, ',', SplitOptions::TRIM_WHITESPACE)));
+  EXPECT_EQ(Fields({" name ", " 42 ", " \t ", "last"}),
+            fieldsOf(strings::split(csv, ',', SplitOptions::SKIP_EMPTY)));
+  EXPECT_EQ(Fields({"name", "42", "last"}),
+            fieldsOf(strings::split(csv, ',', SplitOptions::TRIM_WHITESPACE
+                                              | SplitOptions::SKIP_EMPTY)));
+  EXPECT_EQ(Fields(),
+            fieldsOf(strings::split("", ',', SplitOptions::SKIP_EMPTY)));
+  EXPECT_EQ(Fields(),
+            fieldsOf(strings::split(",,,", ',', SplitOptions::SKIP_EMPTY)));
+}
+
+
+TEST(strings, split_characterSet) {
+  using Fields = std::vector<string>;
+  const CharacterSet delimiters(",;\t");
+  EXPECT_EQ(Fields({"a", "b", "c", "", "d"}),
+            fieldsOf(strings::split("a,b;c\t\td", delimiters)));
+  EXPECT_EQ(Fields({"words", "split", "by", "runs", "of", "whitespace"}),
+            fieldsOf(strings::split("  words split\tby\n runs of whitespace ",
+                                    CharacterSet(" \t\n"),
+                                    SplitOptions::SKIP_EMPTY)));
+
+  EXPECT_EQ(Fields({"no delimiters"}),
+            fieldsOf(strings::split("no delimiters", CharacterSet())));
+
+  // Delimiters at every position of strings long enough for 8-byte groups,
+  // with few delimiters (searched for by byte) and many (by bitmap).
+  const CharacterSet punctuation(",;:.!?");
+  for (std::size_t i = 0; i < 50; ++i) {
+    string str(50, 'x');
+    str[i] = ';';
+    const Fields expected({string(i, 'x'), string(49 - i, 'x')});
+    EXPECT_EQ(expected, fieldsOf(strings::split(str, delimiters)))
+        << "at index " << i;
+    EXPECT_EQ(expected, fieldsOf(strings::split(str, punctuation)))
+        << "at index " << i;
+    EXPECT_EQ(expected, fieldsOf(strings::split(str, ';'))) << "at index " << i;
+  }
+}
+
+
+TEST(strings, join) {
+  EXPECT_EQ("", strings::join(std::vector<string>(), ", "));
+  EXPECT_EQ("one", strings::join(std::vector<string>({"one"}), ", "));
+  EXPECT_EQ("a, b, c",
+            strings::join(std::vector<string>({"a", "b", "c"}), ", "));
+  EXPECT_EQ("abc", strings::join({"a", "b", "c"}, ""));
+  EXPECT_EQ("x--y", strings::join({"x", "", "y"}, "-"));
+
+  // Joining a SplitRange re-splits lazily, without intermediate copies.
+  EXPECT_EQ("a|b|c", strings::join(
+      strings::split(" a , b ,, c ", ',',
+                     SplitOptions::TRIM_WHITESPACE | SplitOptions::SKIP_EMPTY),
+      "|"));
+
+  const string joined = strings::join(
+      std::vector<string>(20, "a long enough part"), " + ");
+  EXPECT_EQ(20u * 18u + 19u * 3u, joined.length());
+}
+
+
 }  // namespace
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+#
+# Copyright 2016 Eric W. Barndollar. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Generates src/oomuse/core/power_of_five_table.inc.
+
+Writes 128-bit approximations of 5^q for every decimal exponent q that can
+produce a finite, nonzero double, for Eisel-Lemire float parsing (see
+strings::parseFloat). Each is normalized so its top bit is set, and stored as
+two uint64 halves (high first):
+
+  5^q ~= (POWERS_OF_FIVE[2 * i] << 64 | POWERS_OF_FIVE[2 * i + 1]) * 2^e
+
+for i = q - SMALLEST_POWER_OF_FIVE and some binary exponent e. Positive powers
+are truncated; negative powers (reciprocals) are rounded up.
+
+Usage: tools/generate_power_of_five_table.py > \\
+           src/oomuse/core/power_of_five_table.inc
+"""
+
+import sys
+
+SMALLEST_POWER_OF_FIVE = -342
+LARGEST_POWER_OF_FIVE = 308
+
+
+def power_of_five_128(q):
+    if q >= 0:
+        power = 5 ** q
+        while power < (1 << 127):
+            power *= 2
+        while power >= (1 << 128):
+            power //= 2
+        return power
+
+    power = 5 ** -q
+    z = power.bit_length()
+    if q >= -27:
+        # 5^-q < 2^64, so one division gives 128 exact-enough bits.
+        reciprocal = 2 ** (z + 127) // power + 1
+    else:
+        reciprocal = 2 ** (2 * z + 128) // power + 1
+        while reciprocal >= (1 << 128):
+            reciprocal //= 2
+    return reciprocal
+
+
+LICENSE_HEADER = """/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+"""
+
+
+def main():
+    out = sys.stdout
+    out.write(LICENSE_HEADER)
+    out.write('// Generated by tools/generate_power_of_five_table.py.\n')
+    out.write('// Do not edit by hand.\n\n')
+    out.write('const int SMALLEST_POWER_OF_FIVE = %d;\n'
+              % SMALLEST_POWER_OF_FIVE)
+    out.write('const int LARGEST_POWER_OF_FIVE = %d;\n'
+              % LARGEST_POWER_OF_FIVE)
+    out.write('const uint64 POWERS_OF_FIVE[] = {\n')
+    lines = []
+    for q in range(SMALLEST_POWER_OF_FIVE, LARGEST_POWER_OF_FIVE + 1):
+        power = power_of_five_128(q)
+        assert (1 << 127) <= power < (1 << 128), q
+        lines.append('    0x%016XULL, 0x%016XULL,  // 5^%d'
+                     % (power >> 64, power & ((1 << 64) - 1), q))
+    lines[-1] = lines[-1].replace('ULL,  //', 'ULL   //')
+    out.write('\n'.join(lines) + '\n};\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+#
+# Copyright 2016 Eric W. Barndollar. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Generates src/oomuse/core/ryu_tables.inc.
+
+Writes the 125-bit powers of five that Ryu shortest float formatting (see
+strings::formatFloat) multiplies by, stored as two uint64 halves (high first):
+
+  RYU_POWERS_OF_FIVE[i] = 5^i, truncated to its top 125 bits
+  RYU_INVERSE_POWERS_OF_FIVE[i] = 2^(bits(5^i) - 1 + 125) / 5^i + 1
+
+where bits(x) is the bit length of x. These can't share power_of_five_table.inc
+(for parsing), since Ryu's error bounds depend on this exact precision and
+rounding.
+
+Usage: tools/generate_ryu_tables.py > src/oomuse/core/ryu_tables.inc
+"""
+
+import sys
+
+POWER_OF_FIVE_BITS = 125
+NUM_POWERS_OF_FIVE = 326  # Enough for the smallest subnormal double.
+NUM_INVERSE_POWERS_OF_FIVE = 342  # Enough for the largest double.
+
+
+def power_of_five(i):
+    power = 5 ** i
+    shift = power.bit_length() - POWER_OF_FIVE_BITS
+    return (power >> shift) if shift >= 0 else (power << -shift)
+
+
+def inverse_power_of_five(i):
+    power = 5 ** i
+    return (1 << (power.bit_length() - 1 + POWER_OF_FIVE_BITS)) // power + 1
+
+
+LICENSE_HEADER = """/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+"""
+
+
+def write_table(out, name, values, comment):
+    out.write('const uint64 %s[] = {\n' % name)
+    lines = []
+    for i, value in enumerate(values):
+        assert value < (1 << 128), (name, i)
+        lines.append('    0x%016XULL, 0x%016XULL,  // %s'
+                     % (value >> 64, value & ((1 << 64) - 1), comment % i))
+    lines[-1] = lines[-1].replace('ULL,  //', 'ULL   //')
+    out.write('\n'.join(lines) + '\n};\n')
+
+
+def main():
+    out = sys.stdout
+    out.write(LICENSE_HEADER)
+    out.write('// Generated by tools/generate_ryu_tables.py.\n')
+    out.write('// Do not edit by hand.\n\n')
+    out.write('const int RYU_POWER_OF_FIVE_BITS = %d;\n' % POWER_OF_FIVE_BITS)
+    write_table(out, 'RYU_POWERS_OF_FIVE',
+                [power_of_five(i) for i in range(NUM_POWERS_OF_FIVE)],
+                '5^%d')
+    out.write('\n')
+    write_table(out, 'RYU_INVERSE_POWERS_OF_FIVE',
+                [inverse_power_of_five(i)
+                 for i in range(NUM_INVERSE_POWERS_OF_FIVE)],
+                '2^k / 5^%d')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+#
+# Copyright 2016 Eric W. Barndollar. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Generates src/oomuse/core/unicode_case_tables.inc.
+
+Writes two-level lookup tables for the Unicode simple lowercase mapping and
+simple case folding (status C + S), from the Unicode data built into Python's
+unicodedata module. Each code point maps to an index into a short list of
+distinct code point deltas:
+
+  delta = DELTAS[DELTA_INDEXES[(BLOCKS[cp >> SHIFT] << SHIFT) | (cp & MASK)]]
+
+Identical blocks (most of them: all-zero deltas) are stored only once.
+
+Usage: tools/generate_unicode_case_tables.py > \\
+           src/oomuse/core/unicode_case_tables.inc
+"""
+
+import sys
+import unicodedata
+
+MAX_CODE_POINT = 0x10FFFF
+DOTTED_CAPITAL_I = 0x130  # Full lowercase & folding are 2 code points.
+
+
+def code_points():
+    for cp in range(MAX_CODE_POINT + 1):
+        if not 0xD800 <= cp <= 0xDFFF:  # Skip UTF-16 surrogates.
+            yield cp
+
+
+def simple_lower(cp):
+    """Simple (1:1) lowercase mapping, from Python's full mapping."""
+    lower = chr(cp).lower()
+    if len(lower) == 1:
+        return ord(lower)
+    assert cp == DOTTED_CAPITAL_I, hex(cp)
+    return ord('i')
+
+
+def simple_fold(cp):
+    """Simple case folding (CaseFolding.txt status C + S)."""
+    if cp == DOTTED_CAPITAL_I:
+        return cp  # Only has F and T (Turkic) foldings.
+    folded = chr(cp).casefold()
+    if len(folded) == 1:
+        return ord(folded)
+    # Full (F) foldings that expand. Where an S folding exists, it's the
+    # simple lowercase mapping (e.g. U+1E9E -> U+00DF); otherwise, identity.
+    return simple_lower(cp)
+
+
+def utf8_length(cp):
+    return len(chr(cp).encode('utf-8', 'surrogatepass'))
+
+
+def build_tables(mapping, shift):
+    deltas = [0]
+    delta_index = {0: 0}
+    limit = 0
+    per_cp = {}
+    for cp in code_points():
+        delta = mapping(cp) - cp
+        if delta != 0:
+            if delta not in delta_index:
+                delta_index[delta] = len(deltas)
+                deltas.append(delta)
+            per_cp[cp] = delta_index[delta]
+            limit = cp + 1
+            # Case mapping can grow UTF-8 by at most 3 bytes per 2.
+            assert 2 * utf8_length(cp + delta) <= 3 * utf8_length(cp)
+
+    block_size = 1 << shift
+    limit = (limit + block_size - 1) // block_size * block_size
+    blocks = []
+    unique_blocks = []
+    block_numbers = {}
+    for start in range(0, limit, block_size):
+        block = tuple(per_cp.get(cp, 0)
+                      for cp in range(start, start + block_size))
+        if block not in block_numbers:
+            block_numbers[block] = len(unique_blocks)
+            unique_blocks.append(block)
+        blocks.append(block_numbers[block])
+    assert len(deltas) <= 256 and len(unique_blocks) <= 256
+    return limit, deltas, blocks, unique_blocks
+
+
+def table_size(tables):
+    limit, deltas, blocks, unique_blocks = tables
+    return (4 * len(deltas) + len(blocks)
+            + len(unique_blocks) * len(unique_blocks[0]))
+
+
+def format_array(c_type, name, values, per_line):
+    lines = ['const %s %s[] = {' % (c_type, name)]
+    for i in range(0, len(values), per_line):
+        lines.append('    ' + ', '.join(str(v) for v in
+                                          values[i:i + per_line]) + ',')
+    lines[-1] = lines[-1].rstrip(',')
+    lines.append('};')
+    return '\n'.join(lines)
+
+
+def write_tables(out, prefix, description, mapping):
+    best = min((build_tables(mapping, shift) + (shift,)
+                for shift in range(4, 10)),
+               key=lambda tables: table_size(tables[:4]))
+    limit, deltas, blocks, unique_blocks, shift = best
+    index_values = [i for block in unique_blocks for i in block]
+
+    out.write('\n\n// %s (%d bytes).\n' % (description, table_size(best[:4])))
+    out.write('const uint32 %s_LIMIT = 0x%X;  // No mappings at or past.\n'
+              % (prefix, limit))
+    out.write('const unsigned %s_SHIFT = %d;\n' % (prefix, shift))
+    out.write(format_array('int32', prefix + '_DELTAS', deltas, 8) + '\n')
+    out.write(format_array('uint8', prefix + '_BLOCKS', blocks, 16) + '\n')
+    out.write(format_array('uint8', prefix + '_DELTA_INDEXES', index_values,
+                           16) + '\n')
+
+
+LICENSE_HEADER = """/**
+ * Copyright 2016 Eric W. Barndollar. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+"""
+
+
+def main():
+    out = sys.stdout
+    out.write(LICENSE_HEADER)
+    out.write('// Generated by tools/generate_unicode_case_tables.py from '
+              'Unicode %s data.\n' % unicodedata.unidata_version)
+    out.write('// Do not edit by hand.\n')
+    write_tables(out, 'LOWER_CASE', 'Simple lowercase mapping', simple_lower)
+    write_tables(out, 'FOLD_CASE', 'Simple case folding (C + S)',
+                 simple_fold)
+
+
+if __name__ == '__main__':
+    main()